@@ -65,6 +65,9 @@
 #if defined(_WIN32) || defined(__MINGW32__)
 # include <direct.h>  // mkdir
 #endif
+#ifdef VL_HAVE_SIMD_DISPATCH
+# include <immintrin.h>
+#endif
 // clang-format on
 
 // Max characters in static char string for VL_VALUE_STRING
@@ -162,6 +165,8 @@ void vl_stop_maybe(const char* filename, int linenum, const char* hier, bool may
         VL_PRINTF(  // Not VL_PRINTF_MT, already on main thread
             "-Info: %s:%d: %s\n", filename, linenum,
             "Verilog $stop, ignored due to +verilator+error+limit");
+        // Flush, so traces may write any flight recording of the error
+        Verilated::runFlushCallbacks();
     } else {
         vl_stop(filename, linenum, hier);
     }
@@ -343,8 +348,13 @@ QData VL_RAND_RESET_Q(int obits) VL_MT_SAFE {
     return data;
 }
 WDataOutP VL_RAND_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE {
+#ifdef VL_EDATA64
+    for (int i = 0; i < VL_WORDS_I(obits) - 1; ++i) outwp[i] = VL_RAND_RESET_Q(64);
+    outwp[VL_WORDS_I(obits) - 1] = VL_RAND_RESET_Q(64) & VL_MASK_E(obits);
+#else
     for (int i = 0; i < VL_WORDS_I(obits) - 1; ++i) outwp[i] = VL_RAND_RESET_I(32);
     outwp[VL_WORDS_I(obits) - 1] = VL_RAND_RESET_I(32) & VL_MASK_E(obits);
+#endif
     return outwp;
 }
 
@@ -358,31 +368,196 @@ WDataOutP VL_ZERO_RESET_W(int obits, WDataOutP outwp) VL_MT_SAFE {
 
 void _vl_debug_print_w(int lbits, WDataInP iwp) VL_MT_SAFE {
     VL_PRINTF_MT("  Data: w%d: ", lbits);
-    for (int i = VL_WORDS_I(lbits) - 1; i >= 0; --i) VL_PRINTF_MT("%08x ", iwp[i]);
+    for (int i = VL_WORDS_I(lbits) - 1; i >= 0; --i) {
+        VL_PRINTF_MT("%0*" VL_PRI64 "x ", VL_EDATASIZE / 4, static_cast<QData>(iwp[i]));
+    }
     VL_PRINTF_MT("\n");
 }
 
+//===========================================================================
+// Wide kernels selected at run time, see VL_SIMD_DISPATCH in verilated.h
+
+// Kernels using what the compile flags allow
+static WDataOutP vl_wide_and_base(int words, WDataOutP owp, WDataInP lwp,
+                                  WDataInP rwp) VL_MT_SAFE {
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_and_si512, _mm256_and_si256, _mm_and_si128, words, i, owp, lwp,
+                       rwp);
+    for (; i < words; ++i) owp[i] = lwp[i] & rwp[i];
+    return owp;
+}
+static WDataOutP vl_wide_or_base(int words, WDataOutP owp, WDataInP lwp,
+                                 WDataInP rwp) VL_MT_SAFE {
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_or_si512, _mm256_or_si256, _mm_or_si128, words, i, owp, lwp, rwp);
+    for (; i < words; ++i) owp[i] = lwp[i] | rwp[i];
+    return owp;
+}
+static WDataOutP vl_wide_xor_base(int words, WDataOutP owp, WDataInP lwp,
+                                  WDataInP rwp) VL_MT_SAFE {
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_xor_si512, _mm256_xor_si256, _mm_xor_si128, words, i, owp, lwp,
+                       rwp);
+    for (; i < words; ++i) owp[i] = lwp[i] ^ rwp[i];
+    return owp;
+}
+static IData vl_wide_changexor_base(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    return _vl_simd_fold_w(false, words, lwp, rwp);
+}
+static EData vl_wide_xorwords_base(int words, WDataInP lwp) VL_MT_SAFE {
+    return _vl_simd_fold_w(true, words, lwp, nullptr);
+}
+static const VlWideKernels vl_wide_kernels_base = {
+#if defined(VL_HAVE_AVX512F)
+    "avx512f",
+#elif defined(VL_HAVE_AVX2)
+    "avx2",
+#elif defined(VL_HAVE_SSE2)
+    "sse2",
+#else
+    "portable",
+#endif
+    vl_wide_and_base, vl_wide_or_base, vl_wide_xor_base, vl_wide_changexor_base,
+    vl_wide_xorwords_base};
+
+// clang-format off
+#if defined(VL_HAVE_SIMD_DISPATCH) && !defined(VL_HAVE_AVX512F)
+// Kernels for instruction sets beyond the compile flags, only called when
+// the running CPU supports them
+# define VL_WIDE_KERNELS_TARGET(isa, vtype, vwords, vload, vstore, vzero, vand, vor, vxor, \
+                                vtest) \
+    __attribute__((target(isa))) static WDataOutP vl_wide_and_##vtype( \
+        int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+        int i = 0; \
+        for (; i + (vwords) <= words; i += (vwords)) { \
+            vstore(owp + i, vand(vload(lwp + i), vload(rwp + i))); \
+        } \
+        for (; i < words; ++i) owp[i] = lwp[i] & rwp[i]; \
+        return owp; \
+    } \
+    __attribute__((target(isa))) static WDataOutP vl_wide_or_##vtype( \
+        int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+        int i = 0; \
+        for (; i + (vwords) <= words; i += (vwords)) { \
+            vstore(owp + i, vor(vload(lwp + i), vload(rwp + i))); \
+        } \
+        for (; i < words; ++i) owp[i] = lwp[i] | rwp[i]; \
+        return owp; \
+    } \
+    __attribute__((target(isa))) static WDataOutP vl_wide_xor_##vtype( \
+        int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+        int i = 0; \
+        for (; i + (vwords) <= words; i += (vwords)) { \
+            vstore(owp + i, vxor(vload(lwp + i), vload(rwp + i))); \
+        } \
+        for (; i < words; ++i) owp[i] = lwp[i] ^ rwp[i]; \
+        return owp; \
+    } \
+    __attribute__((target(isa))) static IData vl_wide_changexor_##vtype( \
+        int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE { \
+        int i = 0; \
+        auto acc = vzero(); \
+        for (; i + (vwords) <= words; i += (vwords)) { \
+            acc = vor(acc, vxor(vload(lwp + i), vload(rwp + i))); \
+        } \
+        EData od = vtest(acc) ? 1 : 0; \
+        for (; i < words; ++i) od |= lwp[i] ^ rwp[i]; \
+        return od; \
+    } \
+    __attribute__((target(isa))) static EData vl_wide_xorwords_##vtype( \
+        int words, WDataInP lwp) VL_MT_SAFE { \
+        int i = 0; \
+        auto acc = vzero(); \
+        for (; i + (vwords) <= words; i += (vwords)) acc = vxor(acc, vload(lwp + i)); \
+        EData lanes[vwords]; \
+        vstore(lanes, acc); \
+        EData r = 0; \
+        for (int j = 0; j < (vwords); ++j) r ^= lanes[j]; \
+        for (; i < words; ++i) r ^= lwp[i]; \
+        return r; \
+    } \
+    static const VlWideKernels vl_wide_kernels_##vtype \
+        = {isa, vl_wide_and_##vtype, vl_wide_or_##vtype, vl_wide_xor_##vtype, \
+           vl_wide_changexor_##vtype, vl_wide_xorwords_##vtype};
+
+# define VL_LOAD256_(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))
+# define VL_STORE256_(p, v) _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), (v))
+# define VL_TEST256_(v) !_mm256_testz_si256((v), (v))
+# define VL_LOAD512_(p) _mm512_loadu_si512(p)
+# define VL_STORE512_(p, v) _mm512_storeu_si512(reinterpret_cast<void*>(p), (v))
+# define VL_TEST512_(v) (_mm512_test_epi32_mask((v), (v)) != 0)
+# ifndef VL_HAVE_AVX2
+VL_WIDE_KERNELS_TARGET("avx2", avx2, VL_SIMD_WORDS_256_, VL_LOAD256_, VL_STORE256_,
+                       _mm256_setzero_si256, _mm256_and_si256, _mm256_or_si256, _mm256_xor_si256,
+                       VL_TEST256_)
+# endif
+VL_WIDE_KERNELS_TARGET("avx512f", avx512f, VL_SIMD_WORDS_512_, VL_LOAD512_, VL_STORE512_,
+                       _mm512_setzero_si512, _mm512_and_si512, _mm512_or_si512, _mm512_xor_si512,
+                       VL_TEST512_)
+# undef VL_LOAD256_
+# undef VL_STORE256_
+# undef VL_TEST256_
+# undef VL_LOAD512_
+# undef VL_STORE512_
+# undef VL_TEST512_
+# undef VL_WIDE_KERNELS_TARGET
+#endif
+
+static const VlWideKernels* vl_wide_kernels_select() VL_MT_SAFE {
+#if defined(VL_HAVE_SIMD_DISPATCH) && !defined(VL_HAVE_AVX512F)
+    __builtin_cpu_init();  // As may run before other static constructors
+    if (__builtin_cpu_supports("avx512f")) return &vl_wide_kernels_avx512f;
+# ifndef VL_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) return &vl_wide_kernels_avx2;
+# endif
+#endif
+    return &vl_wide_kernels_base;
+}
+
+// clang-format on
+
+// Internal note: Globals may multi-construct, see verilated.cpp top.
+// Starts as the base kernels so is usable by earlier static constructors.
+const VlWideKernels* vl_wide_kernelsp = &vl_wide_kernels_base;
+static struct VlWideKernelsInit final {
+    VlWideKernelsInit() { vl_wide_kernelsp = vl_wide_kernels_select(); }
+} s_vlWideKernelsInit;
+
 //===========================================================================
 // Slow math
 
-WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp,
-                       bool is_modulus) VL_MT_SAFE {
+// Digits of the division below, 32 bits each, and most a wide operand needs
+constexpr int VL_MODDIV_DIGITS_MAX = VL_MULS_MAX_WORDS * (VL_EDATASIZE / VL_IDATASIZE);
+
+static int _vl_mostsetbitp1_32(int words, const vluint32_t* lwp) VL_MT_SAFE {
+    // MSB set bit plus one; 0=value is zero
+    for (int i = words - 1; i >= 0; --i) {
+        if (VL_UNLIKELY(lwp[i])) {
+            for (int bit = VL_IDATASIZE - 1; bit >= 0; --bit) {
+                if (VL_BITISSET_I(lwp[i], bit)) return i * VL_IDATASIZE + bit + 1;
+            }
+        }
+    }
+    return 0;
+}
+
+static vluint32_t* _vl_moddiv_32(int words, vluint32_t* owp, const vluint32_t* lwp,
+                                 const vluint32_t* rwp, bool is_modulus) VL_MT_SAFE {
     // See Knuth Algorithm D.  Computes u/v = q.r
     // This isn't massively tuned, as wide division is rare
     // for debug see V3Number version
     // Requires clean input
-    int words = VL_WORDS_I(lbits);
     for (int i = 0; i < words; ++i) owp[i] = 0;
     // Find MSB and check for zero.
-    int umsbp1 = VL_MOSTSETBITP1_W(words, lwp);  // dividend
-    int vmsbp1 = VL_MOSTSETBITP1_W(words, rwp);  // divisor
+    int umsbp1 = _vl_mostsetbitp1_32(words, lwp);  // dividend
+    int vmsbp1 = _vl_mostsetbitp1_32(words, rwp);  // divisor
     if (VL_UNLIKELY(vmsbp1 == 0)  // rwp==0 so division by zero.  Return 0.
         || VL_UNLIKELY(umsbp1 == 0)) {  // 0/x so short circuit and return 0
         return owp;
     }
 
-    int uw = VL_WORDS_I(umsbp1);  // aka "m" in the algorithm
-    int vw = VL_WORDS_I(vmsbp1);  // aka "n" in the algorithm
+    int uw = VL_BITWORD_I(umsbp1 - 1) + 1;  // aka "m" in the algorithm
+    int vw = VL_BITWORD_I(vmsbp1 - 1) + 1;  // aka "n" in the algorithm
 
     if (vw == 1) {  // Single divisor word breaks rest of algorithm
         vluint64_t k = 0;
@@ -399,8 +574,8 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp,
     }
 
     // +1 word as we may shift during normalization
-    vluint32_t un[VL_MULS_MAX_WORDS + 1];  // Fixed size, as MSVC++ doesn't allow [words] here
-    vluint32_t vn[VL_MULS_MAX_WORDS + 1];  // v normalized
+    vluint32_t un[VL_MODDIV_DIGITS_MAX + 1];  // Fixed size, as MSVC++ doesn't allow [words] here
+    vluint32_t vn[VL_MODDIV_DIGITS_MAX + 1];  // v normalized
 
     // Zero for ease of debugging and to save having to zero for shifts
     // Note +1 as loop will use extra word
@@ -478,6 +653,31 @@ WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp,
     }
 }
 
+WDataOutP _vl_moddiv_w(int lbits, WDataOutP owp, WDataInP lwp, WDataInP rwp,
+                       bool is_modulus) VL_MT_SAFE {
+#ifdef VL_EDATA64
+    // Split each word into two digits; the estimate of each quotient digit
+    // needs a type twice the digit size
+    const int words = VL_WORDS_I(lbits);
+    vluint32_t l32[VL_MODDIV_DIGITS_MAX];
+    vluint32_t r32[VL_MODDIV_DIGITS_MAX];
+    vluint32_t o32[VL_MODDIV_DIGITS_MAX];
+    for (int i = 0; i < words; ++i) {
+        l32[2 * i] = static_cast<vluint32_t>(lwp[i]);
+        l32[2 * i + 1] = static_cast<vluint32_t>(lwp[i] >> VL_IDATASIZE);
+        r32[2 * i] = static_cast<vluint32_t>(rwp[i]);
+        r32[2 * i + 1] = static_cast<vluint32_t>(rwp[i] >> VL_IDATASIZE);
+    }
+    _vl_moddiv_32(2 * words, o32, l32, r32, is_modulus);
+    for (int i = 0; i < words; ++i) {
+        owp[i] = (static_cast<EData>(o32[2 * i + 1]) << VL_IDATASIZE) | o32[2 * i];
+    }
+    return owp;
+#else
+    return _vl_moddiv_32(VL_WORDS_I(lbits), owp, lwp, rwp, is_modulus);
+#endif
+}
+
 WDataOutP VL_POW_WWW(int obits, int, int rbits, WDataOutP owp, WDataInP lwp,
                      WDataInP rwp) VL_MT_SAFE {
     // obits==lbits, rbits can be different
@@ -575,6 +775,12 @@ double VL_ITOR_D_W(int lbits, WDataInP lwp) VL_PURE {
     int ms_word = VL_WORDS_I(lbits) - 1;
     for (; !lwp[ms_word] && ms_word > 0;) --ms_word;
     if (ms_word == 0) return static_cast<double>(lwp[0]);
+#ifdef VL_EDATA64
+    // Two words always hold the 53 bits of mantissa needed
+    double hi = static_cast<double>(lwp[ms_word]) * std::exp2(VL_EDATASIZE);
+    double lo = static_cast<double>(lwp[ms_word - 1]);
+    return (hi + lo) * std::exp2(VL_EDATASIZE * (ms_word - 1));
+#else
     if (ms_word == 1) return static_cast<double>(VL_SET_QW(lwp));
     // We need 53 bits of mantissa, which might mean looking at 3 words
     // namely ms_word, ms_word-1 and ms_word-2
@@ -586,10 +792,11 @@ double VL_ITOR_D_W(int lbits, WDataInP lwp) VL_PURE {
     double lo = static_cast<double>(ilo);
     double d = (hi + mid + lo) * std::exp2(VL_EDATASIZE * (ms_word - 2));
     return d;
+#endif
 }
 double VL_ISTOR_D_W(int lbits, WDataInP lwp) VL_PURE {
     if (!VL_SIGN_W(lbits, lwp)) return VL_ITOR_D_W(lbits, lwp);
-    vluint32_t pos[VL_MULS_MAX_WORDS + 1];  // Fixed size, as MSVC++ doesn't allow [words] here
+    WData pos[VL_MULS_MAX_WORDS + 1];  // Fixed size, as MSVC++ doesn't allow [words] here
     VL_NEGATE_W(VL_WORDS_I(lbits), pos, lwp);
     _vl_clean_inplace_w(lbits, pos);
     return -VL_ITOR_D_W(lbits, pos);
@@ -1958,16 +2165,17 @@ void VlWriteMem::print(QData addr, bool addrstamp, const void* valuep) {
         }
     } else {
         WDataInP datap = reinterpret_cast<WDataInP>(valuep);
-        // output as a sequence of VL_EDATASIZE'd words
+        // output as a sequence of 32-bit words (whatever VL_EDATASIZE is)
         // from MSB to LSB. Mask off the MSB word which could
         // contain junk above the top of valid data.
-        int word_idx = ((m_bits - 1) / VL_EDATASIZE);
+        int word_idx = ((m_bits - 1) / VL_IDATASIZE);
         bool first = true;
         while (word_idx >= 0) {
-            EData data = datap[word_idx];
+            const int lsb = word_idx * VL_IDATASIZE;
+            IData data = static_cast<IData>(datap[VL_BITWORD_E(lsb)] >> VL_BITBIT_E(lsb));
             if (first) {
-                data &= VL_MASK_E(m_bits);
-                int top_word_nbits = VL_BITBIT_E(m_bits - 1) + 1;
+                data &= VL_MASK_I(m_bits);
+                int top_word_nbits = VL_BITBIT_I(m_bits - 1) + 1;
                 if (m_hex) {
                     fprintf(m_fp, memhFormat(top_word_nbits), data);
                 } else {
@@ -2482,15 +2690,17 @@ void VerilatedContext::scopesDump() const VL_MT_SAFE {
 void VerilatedContextImp::scopeInsert(const VerilatedScope* scopep) VL_MT_SAFE {
     // Slow ok - called once/scope at construction
     const VerilatedLockGuard lock(m_impdatap->m_nameMutex);
-    const auto it = m_impdatap->m_nameMap.find(scopep->name());
-    if (it == m_impdatap->m_nameMap.end()) m_impdatap->m_nameMap.emplace(scopep->name(), scopep);
+    m_impdatap->m_nameMap.emplace(scopep->name(), scopep);  // Keeps any existing entry
 }
 void VerilatedContextImp::scopeErase(const VerilatedScope* scopep) VL_MT_SAFE {
     // Slow ok - called once/scope at destruction
     const VerilatedLockGuard lock(m_impdatap->m_nameMutex);
     VerilatedImp::userEraseScope(scopep);
+    // Another model's scope of the same name may be the one kept
     const auto it = m_impdatap->m_nameMap.find(scopep->name());
-    if (it != m_impdatap->m_nameMap.end()) m_impdatap->m_nameMap.erase(it);
+    if (it != m_impdatap->m_nameMap.end() && it->second == scopep) {
+        m_impdatap->m_nameMap.erase(it);
+    }
 }
 const VerilatedScope* VerilatedContext::scopeFind(const char* namep) const VL_MT_SAFE {
     // Thread save only assuming this is called only after model construction completed
@@ -2831,6 +3041,22 @@ void VerilatedScope::varInsert(int finalize, const char* namep, void* datap, boo
     m_varsp->emplace(namep, var);
 }
 
+void VerilatedScope::varHashTable(int finalize, vluint32_t count, vluint32_t slotMask,
+                                  const vluint32_t* slotsp) VL_MT_UNSAFE {
+    // Slowpath - called once/scope with public variables at construction,
+    // before the variables are inserted in name order
+    if (!finalize) return;
+    if (!m_varsp) m_varsp = new VerilatedVarNameMap();
+    m_varsp->hashTable(count, slotMask, slotsp);
+}
+
+void VerilatedScope::varDirtyInsert(int finalize, const char* namep,
+                                    CData* dirtyp) VL_MT_UNSAFE {
+    // Flag set by the model on each write of the variable, see --vpi-dirty
+    if (!finalize) return;
+    if (VerilatedVar* varp = varFind(namep)) varp->m_dirtyp = dirtyp;
+}
+
 // cppcheck-suppress unusedFunction  // Used by applications
 VerilatedVar* VerilatedScope::varFind(const char* namep) const VL_MT_SAFE_POSTINIT {
     if (VL_LIKELY(m_varsp)) {
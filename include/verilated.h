@@ -32,6 +32,7 @@
 
 // clang-format off
 #include "verilatedos.h"
+#include "verilated_intrinsics.h"
 #if VM_SC
 # include "verilated_sc.h"  // Get SYSTEMC_VERSION and time declarations
 #endif
@@ -98,7 +99,11 @@ using CData = vluint8_t;    ///< Data representing 'bit' of 1-8 packed bits
 using SData = vluint16_t;   ///< Data representing 'bit' of 9-16 packed bits
 using IData = vluint32_t;   ///< Data representing 'bit' of 17-32 packed bits
 using QData = vluint64_t;   ///< Data representing 'bit' of 33-64 packed bits
+#ifdef VL_EDATA64
+using EData = vluint64_t;   ///< Data representing one element of WData array
+#else
 using EData = vluint32_t;   ///< Data representing one element of WData array
+#endif
 using WData = EData;        ///< Data representing >64 packed bits (used as pointer)
 //    F     = float;        // No typedef needed; Verilator uses float
 //    D     = double;       // No typedef needed; Verilator uses double
@@ -599,6 +604,9 @@ public:  // But internals only - called from VerilatedModule's
     void exportInsert(int finalize, const char* namep, void* cb) VL_MT_UNSAFE;
     void varInsert(int finalize, const char* namep, void* datap, bool isParam,
                    VerilatedVarType vltype, int vlflags, int dims, ...) VL_MT_UNSAFE;
+    void varDirtyInsert(int finalize, const char* namep, CData* dirtyp) VL_MT_UNSAFE;
+    void varHashTable(int finalize, vluint32_t count, vluint32_t slotMask,
+                      const vluint32_t* slotsp) VL_MT_UNSAFE;
     // ACCESSORS
     const char* name() const { return m_namep; }
     const char* identifier() const { return m_identifierp; }
@@ -1019,21 +1027,37 @@ extern const char* vl_mc_scan_plusargs(const char* prefixp);  // PLIish
 // Shift appropriate word by bit. Does not account for wrapping between two words
 #define VL_BITRSHIFT_W(data, bit) ((data)[VL_BITWORD_E(bit)] >> VL_BITBIT_E(bit))
 
+// clang-format off
+#ifdef VL_EDATA64
+// Create one 64-bit word from quadword
+// Writes only the VL_WQ_WORDS_E word; does not clean upper words
+# define VL_SET_WQ(owp, data) \
+    do { \
+        (owp)[0] = static_cast<EData>(data); \
+    } while (false)
+# define VL_SET_WI(owp, data) \
+    do { \
+        (owp)[0] = static_cast<EData>(data); \
+    } while (false)
+# define VL_SET_QW(lwp) (static_cast<QData>((lwp)[0]))
+#else
 // Create two 32-bit words from quadword
 // WData is always at least 2 words; does not clean upper bits
-#define VL_SET_WQ(owp, data) \
+# define VL_SET_WQ(owp, data) \
     do { \
         (owp)[0] = static_cast<IData>(data); \
         (owp)[1] = static_cast<IData>((data) >> VL_EDATASIZE); \
     } while (false)
-#define VL_SET_WI(owp, data) \
+# define VL_SET_WI(owp, data) \
     do { \
         (owp)[0] = static_cast<IData>(data); \
         (owp)[1] = 0; \
     } while (false)
-#define VL_SET_QW(lwp) \
+# define VL_SET_QW(lwp) \
     ((static_cast<QData>((lwp)[0])) \
      | (static_cast<QData>((lwp)[1]) << (static_cast<QData>(VL_EDATASIZE))))
+#endif
+// clang-format on
 #define VL_SET_QII(ld, rd) ((static_cast<QData>(ld) << 32ULL) | static_cast<QData>(rd))
 
 // Return FILE* from IData
@@ -1306,12 +1330,31 @@ static inline void VL_ASSIGNBIT_WO(int, int bit, WDataOutP owp, IData) VL_MT_SAF
                 | (svar).read().get_word(0)) \
                & VL_MASK_Q(obits); \
     }
-#define VL_ASSIGN_WSW(obits, owp, svar) \
+// clang-format off
+#ifdef VL_EDATA64
+// SystemC words are always 32 bits, so each EData takes two
+# define VL_ASSIGN_WSW(obits, owp, svar) \
+    { \
+        int words = VL_WORDS_I(obits); \
+        int swords = VL_BITWORD_I((obits)-1) + 1; \
+        for (int i = 0; i < words; ++i) { \
+            (owp)[i] = (svar).read().get_word(2 * i); \
+            if (2 * i + 1 < swords) { \
+                (owp)[i] |= static_cast<EData>((svar).read().get_word(2 * i + 1)) \
+                            << VL_IDATASIZE; \
+            } \
+        } \
+        (owp)[words - 1] &= VL_MASK_E(obits); \
+    }
+#else
+# define VL_ASSIGN_WSW(obits, owp, svar) \
     { \
         int words = VL_WORDS_I(obits); \
         for (int i = 0; i < words; ++i) (owp)[i] = (svar).read().get_word(i); \
         (owp)[words - 1] &= VL_MASK_E(obits); \
     }
+#endif
+// clang-format on
 
 #define VL_ASSIGN_ISU(obits, vvar, svar) \
     { (vvar) = VL_CLEAN_II((obits), (obits), (svar).read().to_uint()); }
@@ -1322,9 +1365,9 @@ static inline void VL_ASSIGNBIT_WO(int, int bit, WDataOutP owp, IData) VL_MT_SAF
         int words = VL_WORDS_I(obits); \
         sc_biguint<(obits)> _butemp = (svar).read(); \
         for (int i = 0; i < words; ++i) { \
-            int msb = ((i + 1) * VL_IDATASIZE) - 1; \
+            int msb = ((i + 1) * VL_EDATASIZE) - 1; \
             msb = (msb >= (obits)) ? ((obits)-1) : msb; \
-            (owp)[i] = _butemp.range(msb, i * VL_IDATASIZE).to_uint(); \
+            (owp)[i] = static_cast<EData>(_butemp.range(msb, i * VL_EDATASIZE).to_uint64()); \
         } \
         (owp)[words - 1] &= VL_MASK_E(obits); \
     }
@@ -1350,12 +1393,25 @@ static inline void VL_ASSIGNBIT_WO(int, int bit, WDataOutP owp, IData) VL_MT_SAF
         _bvtemp.set_word(1, static_cast<IData>((rd) >> VL_IDATASIZE)); \
         (svar).write(_bvtemp); \
     }
-#define VL_ASSIGN_SWW(obits, svar, rwp) \
+// clang-format off
+#ifdef VL_EDATA64
+# define VL_ASSIGN_SWW(obits, svar, rwp) \
+    { \
+        sc_bv<(obits)> _bvtemp; \
+        for (int i = 0; i <= VL_BITWORD_I((obits)-1); ++i) { \
+            _bvtemp.set_word(i, static_cast<IData>((rwp)[i / 2] >> ((i & 1) * VL_IDATASIZE))); \
+        } \
+        (svar).write(_bvtemp); \
+    }
+#else
+# define VL_ASSIGN_SWW(obits, svar, rwp) \
     { \
         sc_bv<(obits)> _bvtemp; \
         for (int i = 0; i < VL_WORDS_I(obits); ++i) _bvtemp.set_word(i, (rwp)[i]); \
         (svar).write(_bvtemp); \
     }
+#endif
+// clang-format on
 
 #define VL_ASSIGN_SUI(obits, svar, rd) \
     { (svar).write(rd); }
@@ -1369,9 +1425,9 @@ static inline void VL_ASSIGNBIT_WO(int, int bit, WDataOutP owp, IData) VL_MT_SAF
     { \
         sc_biguint<(obits)> _butemp; \
         for (int i = 0; i < VL_WORDS_I(obits); ++i) { \
-            int msb = ((i + 1) * VL_IDATASIZE) - 1; \
+            int msb = ((i + 1) * VL_EDATASIZE) - 1; \
             msb = (msb >= (obits)) ? ((obits)-1) : msb; \
-            _butemp.range(msb, i* VL_IDATASIZE) = (rwp)[i]; \
+            _butemp.range(msb, i* VL_EDATASIZE) = (rwp)[i]; \
         } \
         (svar).write(_butemp); \
     }
@@ -1425,8 +1481,8 @@ static inline WDataOutP VL_EXTENDS_WI(int obits, int lbits, WDataOutP owp, IData
 }
 static inline WDataOutP VL_EXTENDS_WQ(int obits, int lbits, WDataOutP owp, QData ld) VL_MT_SAFE {
     VL_SET_WQ(owp, ld);
-    EData sign = VL_SIGNONES_E(lbits, owp[1]);
-    owp[1] |= sign & ~VL_MASK_E(lbits);
+    EData sign = VL_SIGNONES_E(lbits, owp[VL_WQ_WORDS_E - 1]);
+    owp[VL_WQ_WORDS_E - 1] |= sign & ~VL_MASK_E(lbits);
     for (int i = VL_WQ_WORDS_E; i < VL_WORDS_I(obits); ++i) owp[i] = sign;
     return owp;
 }
@@ -1440,6 +1496,193 @@ static inline WDataOutP VL_EXTENDS_WW(int obits, int lbits, WDataOutP owp,
     return owp;
 }
 
+//===================================================================
+// SIMD SUPPORT FOR WIDE OPERATIONS
+//
+// Wide logical operations use the widest vectors the compile flags allow
+// (e.g. -mavx2 or -march=native), then finish any remaining words one at a
+// time.  When VL_SIMD_DISPATCH is defined, and the flags do not already
+// give AVX2, operations on at least VL_SIMD_DISPATCH_WORDS words call
+// kernels chosen for the running CPU instead, for libraries that are built
+// once and run on various machines.
+
+// clang-format off
+#if defined(VL_SIMD_DISPATCH) && !defined(VL_HAVE_AVX2)
+# define VL_SIMD_DISPATCH_ 1
+# ifndef VL_SIMD_DISPATCH_WORDS
+#  define VL_SIMD_DISPATCH_WORDS 8  ///< Smallest vector dispatched, in words
+# endif
+#endif
+
+/// Wide kernels for one instruction set, selected at run time
+struct VlWideKernels final {
+    const char* m_name;  ///< Instruction set name
+    WDataOutP (*m_and)(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp);
+    WDataOutP (*m_or)(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp);
+    WDataOutP (*m_xor)(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp);
+    IData (*m_changexor)(int words, WDataInP lwp, WDataInP rwp);  ///< Nonzero if different
+    EData (*m_xorwords)(int words, WDataInP lwp);  ///< XOR of all words
+};
+/// Kernels for the best instruction set the running CPU supports
+extern const VlWideKernels* vl_wide_kernelsp;
+
+// Words in each vector width, and the per-word shift intrinsics
+#define VL_SIMD_WORDS_512_ (512 / VL_EDATASIZE)
+#define VL_SIMD_WORDS_256_ (256 / VL_EDATASIZE)
+#define VL_SIMD_WORDS_128_ (128 / VL_EDATASIZE)
+#ifdef VL_EDATA64
+# define VL_SIMD_SRL_512_ _mm512_srl_epi64
+# define VL_SIMD_SLL_512_ _mm512_sll_epi64
+# define VL_SIMD_SRL_256_ _mm256_srl_epi64
+# define VL_SIMD_SLL_256_ _mm256_sll_epi64
+# define VL_SIMD_SRL_128_ _mm_srl_epi64
+# define VL_SIMD_SLL_128_ _mm_sll_epi64
+#else
+# define VL_SIMD_SRL_512_ _mm512_srl_epi32
+# define VL_SIMD_SLL_512_ _mm512_sll_epi32
+# define VL_SIMD_SRL_256_ _mm256_srl_epi32
+# define VL_SIMD_SLL_256_ _mm256_sll_epi32
+# define VL_SIMD_SRL_128_ _mm_srl_epi32
+# define VL_SIMD_SLL_128_ _mm_sll_epi32
+#endif
+
+// Apply a bitwise operation over as many whole vectors as fit in words,
+// advancing i past them; caller finishes the remaining words.  op512,
+// op256 and op128 are the intrinsics for each vector width.
+#ifdef VL_HAVE_AVX512F
+# define VL_SIMD_BITWISE_512_(op, words, i, owp, lwp, rwp) \
+    for (; (i) + VL_SIMD_WORDS_512_ <= (words); (i) += VL_SIMD_WORDS_512_) { \
+        _mm512_storeu_si512(reinterpret_cast<void*>((owp) + (i)), \
+                            op(_mm512_loadu_si512((lwp) + (i)), \
+                               _mm512_loadu_si512((rwp) + (i)))); \
+    }
+#else
+# define VL_SIMD_BITWISE_512_(op, words, i, owp, lwp, rwp)
+#endif
+#ifdef VL_HAVE_AVX2
+# define VL_SIMD_BITWISE_256_(op, words, i, owp, lwp, rwp) \
+    for (; (i) + VL_SIMD_WORDS_256_ <= (words); (i) += VL_SIMD_WORDS_256_) { \
+        _mm256_storeu_si256( \
+            reinterpret_cast<__m256i*>((owp) + (i)), \
+            op(_mm256_loadu_si256(reinterpret_cast<const __m256i*>((lwp) + (i))), \
+               _mm256_loadu_si256(reinterpret_cast<const __m256i*>((rwp) + (i))))); \
+    }
+#else
+# define VL_SIMD_BITWISE_256_(op, words, i, owp, lwp, rwp)
+#endif
+#ifdef VL_HAVE_SSE2
+# define VL_SIMD_BITWISE_128_(op, words, i, owp, lwp, rwp) \
+    for (; (i) + VL_SIMD_WORDS_128_ <= (words); (i) += VL_SIMD_WORDS_128_) { \
+        _mm_storeu_si128(reinterpret_cast<__m128i*>((owp) + (i)), \
+                         op(_mm_loadu_si128(reinterpret_cast<const __m128i*>((lwp) + (i))), \
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>((rwp) + (i))))); \
+    }
+#else
+# define VL_SIMD_BITWISE_128_(op, words, i, owp, lwp, rwp)
+#endif
+#define VL_SIMD_BITWISE_W_(op512, op256, op128, words, i, owp, lwp, rwp) \
+    do { \
+        VL_SIMD_BITWISE_512_(op512, words, i, owp, lwp, rwp) \
+        VL_SIMD_BITWISE_256_(op256, words, i, owp, lwp, rwp) \
+        VL_SIMD_BITWISE_128_(op128, words, i, owp, lwp, rwp) \
+    } while (false)
+
+// Return OR (if !isXor) or XOR of all words, or of each word pair XORed
+// together if rwp, reading whole vectors
+static inline EData _vl_simd_fold_w(bool isXor, int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    int i = 0;
+    EData r = 0;
+#ifdef VL_HAVE_SSE2
+    __m128i acc128 = _mm_setzero_si128();
+# ifdef VL_HAVE_AVX2
+    __m256i acc256 = _mm256_setzero_si256();
+#  ifdef VL_HAVE_AVX512F
+    __m512i acc512 = _mm512_setzero_si512();
+    for (; i + VL_SIMD_WORDS_512_ <= words; i += VL_SIMD_WORDS_512_) {
+        __m512i d = _mm512_loadu_si512(lwp + i);
+        if (rwp) d = _mm512_xor_si512(d, _mm512_loadu_si512(rwp + i));
+        acc512 = isXor ? _mm512_xor_si512(acc512, d) : _mm512_or_si512(acc512, d);
+    }
+    const __m256i hi512 = _mm512_extracti64x4_epi64(acc512, 1);
+    const __m256i lo512 = _mm512_castsi512_si256(acc512);
+    acc256 = isXor ? _mm256_xor_si256(hi512, lo512) : _mm256_or_si256(hi512, lo512);
+#  endif
+    for (; i + VL_SIMD_WORDS_256_ <= words; i += VL_SIMD_WORDS_256_) {
+        __m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i));
+        if (rwp) {
+            d = _mm256_xor_si256(d, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rwp + i)));
+        }
+        acc256 = isXor ? _mm256_xor_si256(acc256, d) : _mm256_or_si256(acc256, d);
+    }
+    const __m128i hi256 = _mm256_extracti128_si256(acc256, 1);
+    const __m128i lo256 = _mm256_castsi256_si128(acc256);
+    acc128 = isXor ? _mm_xor_si128(hi256, lo256) : _mm_or_si128(hi256, lo256);
+# endif
+    for (; i + VL_SIMD_WORDS_128_ <= words; i += VL_SIMD_WORDS_128_) {
+        __m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i));
+        if (rwp) d = _mm_xor_si128(d, _mm_loadu_si128(reinterpret_cast<const __m128i*>(rwp + i)));
+        acc128 = isXor ? _mm_xor_si128(acc128, d) : _mm_or_si128(acc128, d);
+    }
+    // Fold the lanes: swap 64-bit halves, then 32-bit words within them
+    const __m128i swap64 = _mm_shuffle_epi32(acc128, 0x4e);
+    acc128 = isXor ? _mm_xor_si128(acc128, swap64) : _mm_or_si128(acc128, swap64);
+# ifdef VL_EDATA64
+    r = static_cast<EData>(_mm_cvtsi128_si64(acc128));
+# else
+    const __m128i swap32 = _mm_shuffle_epi32(acc128, 0xb1);
+    acc128 = isXor ? _mm_xor_si128(acc128, swap32) : _mm_or_si128(acc128, swap32);
+    r = static_cast<EData>(_mm_cvtsi128_si32(acc128));
+# endif
+#endif
+    for (; i < words; ++i) {
+        const EData d = rwp ? (lwp[i] ^ rwp[i]) : lwp[i];
+        r = isXor ? (r ^ d) : (r | d);
+    }
+    return r;
+}
+
+// Funnel shift owp[i] = (lwp[i + loff] >> rs) | (lwp[i + loff + 1] << (VL_EDATASIZE - rs))
+// for i from i to end, using vectors where they fit; returns the next i.
+// Caller must ensure 0 < rs < VL_EDATASIZE, and that both source words are in range.
+static inline int _vl_simd_shiftr_w(int i, int end, WDataOutP owp, WDataInP lwp, int loff,
+                                    int rs) VL_MT_SAFE {
+#ifdef VL_HAVE_SSE2
+    const __m128i rcount = _mm_cvtsi32_si128(rs);
+    const __m128i lcount = _mm_cvtsi32_si128(VL_EDATASIZE - rs);
+# ifdef VL_HAVE_AVX2
+#  ifdef VL_HAVE_AVX512F
+    for (; i + VL_SIMD_WORDS_512_ <= end; i += VL_SIMD_WORDS_512_) {
+        const __m512i lo = _mm512_loadu_si512(lwp + i + loff);
+        const __m512i hi = _mm512_loadu_si512(lwp + i + loff + 1);
+        _mm512_storeu_si512(reinterpret_cast<void*>(owp + i),
+                            _mm512_or_si512(VL_SIMD_SRL_512_(lo, rcount),
+                                            VL_SIMD_SLL_512_(hi, lcount)));
+    }
+#  endif
+    for (; i + VL_SIMD_WORDS_256_ <= end; i += VL_SIMD_WORDS_256_) {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i + loff));
+        const __m256i hi
+            = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lwp + i + loff + 1));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(owp + i),
+                            _mm256_or_si256(VL_SIMD_SRL_256_(lo, rcount),
+                                            VL_SIMD_SLL_256_(hi, lcount)));
+    }
+# endif
+    for (; i + VL_SIMD_WORDS_128_ <= end; i += VL_SIMD_WORDS_128_) {
+        const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i + loff));
+        const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lwp + i + loff + 1));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(owp + i),
+                         _mm_or_si128(VL_SIMD_SRL_128_(lo, rcount), VL_SIMD_SLL_128_(hi, lcount)));
+    }
+#endif
+    for (; i < end; ++i) {
+        owp[i] = (lwp[i + loff] >> rs) | (lwp[i + loff + 1] << (VL_EDATASIZE - rs));
+    }
+    return i;
+}
+
+// clang-format on
+
 //===================================================================
 // REDUCTION OPERATORS
 
@@ -1524,10 +1767,20 @@ static inline IData VL_REDXOR_64(QData r) VL_PURE {
     return static_cast<IData>(r);
 #endif
 }
+// clang-format off
+#ifdef VL_EDATA64
+# define VL_REDXOR_E_ VL_REDXOR_64  ///< Parity of an EData
+#else
+# define VL_REDXOR_E_ VL_REDXOR_32  ///< Parity of an EData
+#endif
+// clang-format on
 static inline IData VL_REDXOR_W(int words, WDataInP lwp) VL_MT_SAFE {
-    EData r = lwp[0];
-    for (int i = 1; i < words; ++i) r ^= lwp[i];
-    return VL_REDXOR_32(r);
+#ifdef VL_SIMD_DISPATCH_
+    if (words >= VL_SIMD_DISPATCH_WORDS) {
+        return VL_REDXOR_E_(vl_wide_kernelsp->m_xorwords(words, lwp));
+    }
+#endif
+    return VL_REDXOR_E_(_vl_simd_fold_w(true, words, lwp, nullptr));
 }
 
 // EMIT_RULE: VL_COUNTONES_II:  oclean = false; lhs clean
@@ -1542,7 +1795,13 @@ static inline IData VL_COUNTONES_I(IData lhs) VL_PURE {
 static inline IData VL_COUNTONES_Q(QData lhs) VL_PURE {
     return VL_COUNTONES_I(static_cast<IData>(lhs)) + VL_COUNTONES_I(static_cast<IData>(lhs >> 32));
 }
-#define VL_COUNTONES_E VL_COUNTONES_I
+// clang-format off
+#ifdef VL_EDATA64
+# define VL_COUNTONES_E VL_COUNTONES_Q
+#else
+# define VL_COUNTONES_E VL_COUNTONES_I
+#endif
+// clang-format on
 static inline IData VL_COUNTONES_W(int words, WDataInP lwp) VL_MT_SAFE {
     EData r = 0;
     for (int i = 0; i < words; ++i) r += VL_COUNTONES_E(lwp[i]);
@@ -1567,13 +1826,23 @@ static inline IData VL_COUNTBITS_Q(int lbits, QData lhs, IData ctrl0, IData ctrl
     return VL_COUNTBITS_I(32, static_cast<IData>(lhs), ctrl0, ctrl1, ctrl2)
            + VL_COUNTBITS_I(lbits - 32, static_cast<IData>(lhs >> 32), ctrl0, ctrl1, ctrl2);
 }
+#ifdef VL_EDATA64
+static inline IData VL_COUNTBITS_E(int lbits, EData lhs, IData ctrl0, IData ctrl1,
+                                   IData ctrl2) VL_PURE {
+    if (lbits <= VL_IDATASIZE) {
+        return VL_COUNTBITS_I(lbits, static_cast<IData>(lhs), ctrl0, ctrl1, ctrl2);
+    }
+    return VL_COUNTBITS_Q(lbits, lhs, ctrl0, ctrl1, ctrl2);
+}
+#else
 #define VL_COUNTBITS_E VL_COUNTBITS_I
+#endif
 static inline IData VL_COUNTBITS_W(int lbits, int words, WDataInP lwp, IData ctrl0, IData ctrl1,
                                    IData ctrl2) VL_MT_SAFE {
     EData r = 0;
-    IData wordLbits = 32;
+    IData wordLbits = VL_EDATASIZE;
     for (int i = 0; i < words; ++i) {
-        if (i == words - 1) wordLbits = lbits % 32;
+        if (i == words - 1) wordLbits = VL_BITBIT_E(lbits - 1) + 1;
         r += VL_COUNTBITS_E(wordLbits, lwp[i], ctrl0, ctrl1, ctrl2);
     }
     return r;
@@ -1659,23 +1928,42 @@ static inline IData VL_MOSTSETBITP1_W(int words, WDataInP lwp) VL_MT_SAFE {
 
 // EMIT_RULE: VL_AND:  oclean=lclean||rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_AND_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] & rwp[i]);
+#ifdef VL_SIMD_DISPATCH_
+    if (words >= VL_SIMD_DISPATCH_WORDS) return vl_wide_kernelsp->m_and(words, owp, lwp, rwp);
+#endif
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_and_si512, _mm256_and_si256, _mm_and_si128, words, i, owp, lwp,
+                       rwp);
+    for (; (i < words); ++i) owp[i] = (lwp[i] & rwp[i]);
     return owp;
 }
 // EMIT_RULE: VL_OR:   oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_OR_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] | rwp[i]);
+#ifdef VL_SIMD_DISPATCH_
+    if (words >= VL_SIMD_DISPATCH_WORDS) return vl_wide_kernelsp->m_or(words, owp, lwp, rwp);
+#endif
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_or_si512, _mm256_or_si256, _mm_or_si128, words, i, owp, lwp,
+                       rwp);
+    for (; (i < words); ++i) owp[i] = (lwp[i] | rwp[i]);
     return owp;
 }
 // EMIT_RULE: VL_CHANGEXOR:  oclean=1; obits=32; lbits==rbits;
 static inline IData VL_CHANGEXOR_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
-    IData od = 0;
-    for (int i = 0; (i < words); ++i) od |= (lwp[i] ^ rwp[i]);
-    return od;
+#ifdef VL_SIMD_DISPATCH_
+    if (words >= VL_SIMD_DISPATCH_WORDS) return vl_wide_kernelsp->m_changexor(words, lwp, rwp);
+#endif
+    return _vl_simd_fold_w(false, words, lwp, rwp);
 }
 // EMIT_RULE: VL_XOR:  oclean=lclean&&rclean; obits=lbits; lbits==rbits;
 static inline WDataOutP VL_XOR_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
-    for (int i = 0; (i < words); ++i) owp[i] = (lwp[i] ^ rwp[i]);
+#ifdef VL_SIMD_DISPATCH_
+    if (words >= VL_SIMD_DISPATCH_WORDS) return vl_wide_kernelsp->m_xor(words, owp, lwp, rwp);
+#endif
+    int i = 0;
+    VL_SIMD_BITWISE_W_(_mm512_xor_si512, _mm256_xor_si256, _mm_xor_si128, words, i, owp, lwp,
+                       rwp);
+    for (; (i < words); ++i) owp[i] = (lwp[i] ^ rwp[i]);
     return owp;
 }
 // EMIT_RULE: VL_NOT:  oclean=dirty; obits=lbits;
@@ -1701,9 +1989,7 @@ static inline WDataOutP VL_NOT_W(int words, WDataOutP owp, WDataInP lwp) VL_MT_S
 
 // Output clean, <lhs> AND <rhs> MUST BE CLEAN
 static inline IData VL_EQ_W(int words, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
-    EData nequal = 0;
-    for (int i = 0; (i < words); ++i) nequal |= (lwp[i] ^ rwp[i]);
-    return (nequal == 0);
+    return VL_CHANGEXOR_W(words, lwp, rwp) == 0;
 }
 
 // Internal usage
@@ -1812,6 +2098,71 @@ static void VL_NEGATE_INPLACE_W(int words, WDataOutP owp_lwp) VL_MT_SAFE {
 #define VL_MODDIV_QQQ(lbits, lhs, rhs) (((rhs) == 0) ? 0 : (lhs) % (rhs))
 #define VL_MODDIV_WWW(lbits, owp, lwp, rwp) (_vl_moddiv_w(lbits, owp, lwp, rwp, 1))
 
+#ifdef VL_EDATA64
+// With 64-bit words there is no wider type to hold the carry, so detect
+// it from the wrap around of each sum instead
+static inline WDataOutP VL_ADD_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    EData carry = 0;
+    for (int i = 0; i < words; ++i) {
+        const EData sum = lwp[i] + rwp[i];
+        const EData out = sum + carry;
+        carry = (sum < lwp[i]) | (out < sum);
+        owp[i] = out;
+    }
+    // Last output word is dirty
+    return owp;
+}
+
+static inline WDataOutP VL_SUB_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    EData borrow = 0;
+    for (int i = 0; i < words; ++i) {
+        const EData diff = lwp[i] - rwp[i];
+        const EData out = diff - borrow;
+        borrow = (lwp[i] < rwp[i]) | (diff < borrow);
+        owp[i] = out;
+    }
+    // Last output word is dirty
+    return owp;
+}
+
+// Return low word of lhs * rhs, setting hir to the high word
+static inline EData _vl_mul_e(EData lhs, EData rhs, EData& hir) VL_PURE {
+#ifdef __SIZEOF_INT128__
+    const unsigned __int128 mul = static_cast<unsigned __int128>(lhs) * rhs;
+    hir = static_cast<EData>(mul >> VL_EDATASIZE);
+    return static_cast<EData>(mul);
+#else
+    const QData llo = lhs & 0xffffffffULL;
+    const QData lhi = lhs >> 32ULL;
+    const QData rlo = rhs & 0xffffffffULL;
+    const QData rhi = rhs >> 32ULL;
+    const QData lolo = llo * rlo;
+    const QData hilo = lhi * rlo;
+    const QData lohi = llo * rhi;
+    const QData mid = (lolo >> 32ULL) + (hilo & 0xffffffffULL) + (lohi & 0xffffffffULL);
+    hir = lhi * rhi + (hilo >> 32ULL) + (lohi >> 32ULL) + (mid >> 32ULL);
+    return (mid << 32ULL) | (lolo & 0xffffffffULL);
+#endif
+}
+
+static inline WDataOutP VL_MUL_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
+    for (int i = 0; i < words; ++i) owp[i] = 0;
+    for (int lword = 0; lword < words; ++lword) {
+        EData carry = 0;
+        for (int rword = 0; lword + rword < words; ++rword) {
+            EData hi;
+            EData lo = _vl_mul_e(lwp[lword], rwp[rword], hi);
+            lo += carry;
+            hi += (lo < carry);
+            owp[lword + rword] += lo;
+            hi += (owp[lword + rword] < lo);
+            carry = hi;
+        }
+    }
+    // Last output word is dirty
+    return owp;
+}
+#else
 static inline WDataOutP VL_ADD_W(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) VL_MT_SAFE {
     QData carry = 0;
     for (int i = 0; i < words; ++i) {
@@ -1851,6 +2202,7 @@ static inline WDataOutP VL_MUL_W(int words, WDataOutP owp, WDataInP lwp, WDataIn
     // Last output word is dirty
     return owp;
 }
+#endif
 
 static inline IData VL_MULS_III(int, int lbits, int, IData lhs, IData rhs) VL_PURE {
     vlsint32_t lhs_signed = VL_EXTENDS_II(32, lbits, lhs);
@@ -1888,13 +2240,7 @@ static inline WDataOutP VL_MULS_WWW(int, int lbits, int, WDataOutP owp, WDataInP
     owp[words - 1] &= VL_MASK_E(
         lbits);  // Clean.  Note it's ok for the multiply to overflow into the sign bit
     if ((lneg ^ rneg) & 1) {  // Negate output (not using NEGATE, as owp==lwp)
-        QData carry = 0;
-        for (int i = 0; i < words; ++i) {
-            carry = carry + static_cast<QData>(static_cast<IData>(~owp[i]));
-            if (i == 0) ++carry;  // Negation of temp2
-            owp[i] = (carry & 0xffffffffULL);
-            carry = (carry >> 32ULL) & 0xffffffffULL;
-        }
+        VL_NEGATE_INPLACE_W(words, owp);
         // Not needed: owp[words-1] |= 1<<VL_BITBIT_E(lbits-1);  // Set sign bit
     }
     // Last output word is dirty
@@ -2449,7 +2795,7 @@ static inline void _vl_shiftl_inplace_w(int obits, WDataOutP iowp,
 // EMIT_RULE: VL_SHIFTL:  oclean=lclean; rclean==clean;
 // Important: Unlike most other funcs, the shift might well be a computed
 // expression.  Thus consider this when optimizing.  (And perhaps have 2 funcs?)
-static inline WDataOutP VL_SHIFTL_WWI(int obits, int, int, WDataOutP owp, WDataInP lwp,
+static inline WDataOutP VL_SHIFTL_WWI(int obits, int lbits, int, WDataOutP owp, WDataInP lwp,
                                       IData rd) VL_MT_SAFE {
     int word_shift = VL_BITWORD_E(rd);
     int bit_shift = VL_BITBIT_E(rd);
@@ -2459,8 +2805,21 @@ static inline WDataOutP VL_SHIFTL_WWI(int obits, int, int, WDataOutP owp, WDataI
         for (int i = 0; i < word_shift; ++i) owp[i] = 0;
         for (int i = word_shift; i < VL_WORDS_I(obits); ++i) owp[i] = lwp[i - word_shift];
     } else {
-        for (int i = 0; i < VL_WORDS_I(obits); ++i) owp[i] = 0;
-        _vl_insert_WW(obits, owp, lwp, obits - 1, rd);
+        const int owords = VL_WORDS_I(obits);
+        const int lwords = VL_WORDS_I(lbits);
+        const int nbitsonright = VL_EDATASIZE - bit_shift;  // bits that end up in lower word
+        for (int i = 0; i < word_shift; ++i) owp[i] = 0;
+        owp[word_shift] = lwp[0] << bit_shift;
+        // Each upper word takes bits from two source words; vectors only
+        // while both are within lwp
+        const int vend = (lwords + word_shift < owords) ? (lwords + word_shift) : owords;
+        int i = _vl_simd_shiftr_w(word_shift + 1, vend, owp, lwp, -word_shift - 1, nbitsonright);
+        for (; i < owords; ++i) {
+            const int lword = i - word_shift;
+            owp[i] = ((lword < lwords) ? (lwp[lword] << bit_shift) : 0)
+                     | ((lword - 1 < lwords) ? (lwp[lword - 1] >> nbitsonright) : 0);
+        }
+        owp[owords - 1] &= VL_MASK_E(obits);
     }
     return owp;
 }
@@ -2471,7 +2830,9 @@ static inline WDataOutP VL_SHIFTL_WWW(int obits, int lbits, int rbits, WDataOutP
             return VL_ZERO_W(obits, owp);
         }
     }
-    return VL_SHIFTL_WWI(obits, lbits, 32, owp, lwp, rwp[0]);
+    // Word may be wider than the IData shift amount
+    if (VL_UNLIKELY(rwp[0] >= static_cast<EData>(obits))) return VL_ZERO_W(obits, owp);
+    return VL_SHIFTL_WWI(obits, lbits, 32, owp, lwp, static_cast<IData>(rwp[0]));
 }
 static inline WDataOutP VL_SHIFTL_WWQ(int obits, int lbits, int rbits, WDataOutP owp, WDataInP lwp,
                                       QData rd) VL_MT_SAFE {
@@ -2523,9 +2884,11 @@ static inline WDataOutP VL_SHIFTR_WWI(int obits, int, int, WDataOutP owp, WDataI
     } else {
         int loffset = rd & VL_SIZEBITS_E;
         int nbitsonright = VL_EDATASIZE - loffset;  // bits that end up in lword (know loffset!=0)
-        // Middle words
+        // Middle words; vectors only while the upper source word is within obits
         int words = VL_WORDS_I(obits - rd);
-        for (int i = 0; i < words; ++i) {
+        const int vend = VL_WORDS_I(obits) - word_shift - 1;
+        int i = _vl_simd_shiftr_w(0, (vend < words) ? vend : words, owp, lwp, word_shift, loffset);
+        for (; i < words; ++i) {
             owp[i] = lwp[i + word_shift] >> loffset;
             int upperword = i + word_shift + 1;
             if (upperword < VL_WORDS_I(obits)) owp[i] |= lwp[upperword] << nbitsonright;
@@ -2541,7 +2904,9 @@ static inline WDataOutP VL_SHIFTR_WWW(int obits, int lbits, int rbits, WDataOutP
             return VL_ZERO_W(obits, owp);
         }
     }
-    return VL_SHIFTR_WWI(obits, lbits, 32, owp, lwp, rwp[0]);
+    // Word may be wider than the IData shift amount
+    if (VL_UNLIKELY(rwp[0] >= static_cast<EData>(obits))) return VL_ZERO_W(obits, owp);
+    return VL_SHIFTR_WWI(obits, lbits, 32, owp, lwp, static_cast<IData>(rwp[0]));
 }
 static inline WDataOutP VL_SHIFTR_WWQ(int obits, int lbits, int rbits, WDataOutP owp, WDataInP lwp,
                                       QData rd) VL_MT_SAFE {
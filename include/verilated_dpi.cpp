@@ -60,7 +60,10 @@ const char* svDpiVersion() { return "1800-2005"; }
 //======================================================================
 // Bit-select utility functions.
 
-svBit svGetBitselBit(const svBitVecVal* sp, int bit) { return VL_BITRSHIFT_W(sp, bit) & 1; }
+svBit svGetBitselBit(const svBitVecVal* sp, int bit) {
+    // Not VL_BITRSHIFT_W as sv vectors are always 32-bit words
+    return (sp[VL_BITWORD_I(bit)] >> VL_BITBIT_I(bit)) & 1;
+}
 svLogic svGetBitselLogic(const svLogicVecVal* sp, int bit) {
     // Not VL_BITRSHIFT_W as sp is a different structure type
     // Verilator doesn't support X/Z so only aval
@@ -68,7 +71,10 @@ svLogic svGetBitselLogic(const svLogicVecVal* sp, int bit) {
             | (((sp[VL_BITWORD_I(bit)].bval >> VL_BITBIT_I(bit)) & 1) << 1));
 }
 
-void svPutBitselBit(svBitVecVal* dp, int bit, svBit s) { VL_ASSIGNBIT_WI(32, bit, dp, s); }
+void svPutBitselBit(svBitVecVal* dp, int bit, svBit s) {
+    dp[VL_BITWORD_I(bit)] = ((dp[VL_BITWORD_I(bit)] & ~(VL_UL(1) << VL_BITBIT_I(bit)))
+                             | ((s & 1) << VL_BITBIT_I(bit)));
+}
 void svPutBitselLogic(svLogicVecVal* dp, int bit, svLogic s) {
     // Verilator doesn't support X/Z so only aval
     dp[VL_BITWORD_I(bit)].aval = ((dp[VL_BITWORD_I(bit)].aval & ~(VL_UL(1) << VL_BITBIT_I(bit)))
@@ -83,12 +89,12 @@ void svGetPartselBit(svBitVecVal* dp, const svBitVecVal* sp, int lsb, int width)
     int word_shift = VL_BITWORD_I(lsb);
     if (VL_BITBIT_I(lsb) == 0) {
         // Just a word extract
-        for (int i = 0; i < VL_WORDS_I(width); ++i) dp[i] = sp[i + word_shift];
+        for (int i = 0; i < SV_PACKED_DATA_NELEMS(width); ++i) dp[i] = sp[i + word_shift];
     } else {
         int loffset = lsb & VL_SIZEBITS_I;
         int nbitsfromlow = 32 - loffset;  // bits that end up in lword (know loffset!=0)
         // Middle words
-        int words = VL_WORDS_I(msb - lsb + 1);
+        int words = SV_PACKED_DATA_NELEMS(msb - lsb + 1);
         for (int i = 0; i < words; ++i) {
             dp[i] = sp[i + word_shift] >> loffset;
             int upperword = i + word_shift + 1;
@@ -98,19 +104,19 @@ void svGetPartselBit(svBitVecVal* dp, const svBitVecVal* sp, int lsb, int width)
         }
     }
     // Clean result
-    dp[VL_WORDS_I(width) - 1] &= VL_MASK_I(width);
+    dp[SV_PACKED_DATA_NELEMS(width) - 1] &= VL_MASK_I(width);
 }
 void svGetPartselLogic(svLogicVecVal* dp, const svLogicVecVal* sp, int lsb, int width) {
     int msb = lsb + width - 1;
     int word_shift = VL_BITWORD_I(lsb);
     if (VL_BITBIT_I(lsb) == 0) {
         // Just a word extract
-        for (int i = 0; i < VL_WORDS_I(width); ++i) dp[i] = sp[i + word_shift];
+        for (int i = 0; i < SV_PACKED_DATA_NELEMS(width); ++i) dp[i] = sp[i + word_shift];
     } else {
         int loffset = lsb & VL_SIZEBITS_I;
         int nbitsfromlow = 32 - loffset;  // bits that end up in lword (know loffset!=0)
         // Middle words
-        int words = VL_WORDS_I(msb - lsb + 1);
+        int words = SV_PACKED_DATA_NELEMS(msb - lsb + 1);
         for (int i = 0; i < words; ++i) {
             dp[i].aval = sp[i + word_shift].aval >> loffset;
             dp[i].bval = sp[i + word_shift].bval >> loffset;
@@ -122,8 +128,8 @@ void svGetPartselLogic(svLogicVecVal* dp, const svLogicVecVal* sp, int lsb, int
         }
     }
     // Clean result
-    dp[VL_WORDS_I(width) - 1].aval &= VL_MASK_I(width);
-    dp[VL_WORDS_I(width) - 1].bval &= VL_MASK_I(width);
+    dp[SV_PACKED_DATA_NELEMS(width) - 1].aval &= VL_MASK_I(width);
+    dp[SV_PACKED_DATA_NELEMS(width) - 1].bval &= VL_MASK_I(width);
 }
 void svPutPartselBit(svBitVecVal* dp, const svBitVecVal s, int lbit, int width) {
     // See also _vl_insert_WI
@@ -278,18 +284,10 @@ static void _vl_svGetBitArrElemVecVal(svBitVecVal* d, const svOpenArrayHandle s,
     case VLVT_UINT8: d[0] = *(reinterpret_cast<CData*>(datap)); return;
     case VLVT_UINT16: d[0] = *(reinterpret_cast<SData*>(datap)); return;
     case VLVT_UINT32: d[0] = *(reinterpret_cast<IData*>(datap)); return;
-    case VLVT_UINT64: {
-        WData lwp[2];
-        VL_SET_WQ(lwp, *(reinterpret_cast<QData*>(datap)));
-        d[0] = lwp[0];
-        d[1] = lwp[1];
-        break;
-    }
-    case VLVT_WDATA: {
-        WDataOutP wdatap = (reinterpret_cast<WDataOutP>(datap));
-        for (int i = 0; i < VL_WORDS_I(varp->packed().elements()); ++i) d[i] = wdatap[i];
+    case VLVT_UINT64: VL_SET_SVBV_Q(64, d, *(reinterpret_cast<QData*>(datap))); break;
+    case VLVT_WDATA:
+        VL_SET_SVBV_W(varp->packed().elements(), d, reinterpret_cast<WDataInP>(datap));
         return;
-    }
     default:  // LCOV_EXCL_START  // Errored earlier
         VL_SVDPI_WARN_("%%Warning: DPI svOpenArrayHandle function unsupported datatype (%d).\n",
                        varp->vltype());
@@ -315,23 +313,10 @@ static void _vl_svGetLogicArrElemVecVal(svLogicVecVal* d, const svOpenArrayHandl
         d[0].aval = *(reinterpret_cast<IData*>(datap));
         d[0].bval = 0;
         return;
-    case VLVT_UINT64: {
-        WData lwp[2];
-        VL_SET_WQ(lwp, *(reinterpret_cast<QData*>(datap)));
-        d[0].aval = lwp[0];
-        d[0].bval = 0;
-        d[1].aval = lwp[1];
-        d[1].bval = 0;
-        break;
-    }
-    case VLVT_WDATA: {
-        WDataOutP wdatap = (reinterpret_cast<WDataOutP>(datap));
-        for (int i = 0; i < VL_WORDS_I(varp->packed().elements()); ++i) {
-            d[i].aval = wdatap[i];
-            d[i].bval = 0;
-        }
+    case VLVT_UINT64: VL_SET_SVLV_Q(64, d, *(reinterpret_cast<QData*>(datap))); break;
+    case VLVT_WDATA:
+        VL_SET_SVLV_W(varp->packed().elements(), d, reinterpret_cast<WDataInP>(datap));
         return;
-    }
     default:  // LCOV_EXCL_START  // Errored earlier
         VL_SVDPI_WARN_("%%Warning: DPI svOpenArrayHandle function unsupported datatype (%d).\n",
                        varp->vltype());
@@ -350,11 +335,9 @@ static void _vl_svPutBitArrElemVecVal(const svOpenArrayHandle d, const svBitVecV
     case VLVT_UINT16: *(reinterpret_cast<SData*>(datap)) = s[0]; return;
     case VLVT_UINT32: *(reinterpret_cast<IData*>(datap)) = s[0]; return;
     case VLVT_UINT64: *(reinterpret_cast<QData*>(datap)) = VL_SET_QII(s[1], s[0]); break;
-    case VLVT_WDATA: {
-        WDataOutP wdatap = (reinterpret_cast<WDataOutP>(datap));
-        for (int i = 0; i < VL_WORDS_I(varp->packed().elements()); ++i) wdatap[i] = s[i];
+    case VLVT_WDATA:
+        VL_SET_W_SVBV(varp->packed().elements(), reinterpret_cast<WDataOutP>(datap), s);
         return;
-    }
     default:  // LCOV_EXCL_START  // Errored earlier
         VL_SVDPI_WARN_("%%Warning: DPI svOpenArrayHandle function unsupported datatype (%d).\n",
                        varp->vltype());
@@ -372,11 +355,9 @@ static void _vl_svPutLogicArrElemVecVal(const svOpenArrayHandle d, const svLogic
     case VLVT_UINT16: *(reinterpret_cast<SData*>(datap)) = s[0].aval; return;
     case VLVT_UINT32: *(reinterpret_cast<IData*>(datap)) = s[0].aval; return;
     case VLVT_UINT64: *(reinterpret_cast<QData*>(datap)) = VL_SET_QII(s[1].aval, s[0].aval); break;
-    case VLVT_WDATA: {
-        WDataOutP wdatap = (reinterpret_cast<WDataOutP>(datap));
-        for (int i = 0; i < VL_WORDS_I(varp->packed().elements()); ++i) wdatap[i] = s[i].aval;
+    case VLVT_WDATA:
+        VL_SET_W_SVLV(varp->packed().elements(), reinterpret_cast<WDataOutP>(datap), s);
         return;
-    }
     default:  // LCOV_EXCL_START  // Errored earlier
         VL_SVDPI_WARN_("%%Warning: DPI svOpenArrayHandle function unsupported datatype (%d).\n",
                        varp->vltype());
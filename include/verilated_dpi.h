@@ -35,11 +35,24 @@
 //===================================================================
 // SETTING OPERATORS
 
+// svBitVecVal and svLogicVecVal are always in 32-bit words, while
+// EData may be 64 bits (--wide-word-size 64), so wide conversions go
+// through these
+static inline IData _vl_svdpi_word(WDataInP lwp, int i) VL_MT_SAFE {
+    return static_cast<IData>(lwp[VL_BITWORD_E(i * VL_IDATASIZE)]
+                              >> VL_BITBIT_E(i * VL_IDATASIZE));
+}
+static inline void _vl_svdpi_setword(WDataOutP owp, int i, IData ld) VL_MT_SAFE {
+    owp[VL_BITWORD_E(i * VL_IDATASIZE)] |= static_cast<EData>(ld)
+                                           << VL_BITBIT_E(i * VL_IDATASIZE);
+}
+
 // Convert svBitVecVal to Verilator internal data
 static inline void VL_SET_W_SVBV(int obits, WDataOutP owp, const svBitVecVal* lwp) VL_MT_SAFE {
     int words = VL_WORDS_I(obits);
-    for (int i = 0; i < words - 1; ++i) owp[i] = lwp[i];
-    owp[words - 1] = lwp[words - 1] & VL_MASK_I(obits);
+    for (int i = 0; i < words; ++i) owp[i] = 0;
+    for (int i = 0; i < SV_PACKED_DATA_NELEMS(obits); ++i) _vl_svdpi_setword(owp, i, lwp[i]);
+    owp[words - 1] &= VL_MASK_E(obits);
 }
 static inline QData VL_SET_Q_SVBV(const svBitVecVal* lwp) VL_MT_SAFE {
     return VL_SET_QII(lwp[1], lwp[0]);
@@ -48,21 +61,25 @@ static inline IData VL_SET_I_SVBV(const svBitVecVal* lwp) VL_MT_SAFE { return lw
 
 // Convert Verilator internal data to svBitVecVal
 static inline void VL_SET_SVBV_W(int obits, svBitVecVal* owp, WDataInP lwp) VL_MT_SAFE {
-    int words = VL_WORDS_I(obits);
-    for (int i = 0; i < words - 1; ++i) owp[i] = lwp[i];
-    owp[words - 1] = lwp[words - 1] & VL_MASK_I(obits);
+    int words = SV_PACKED_DATA_NELEMS(obits);
+    for (int i = 0; i < words - 1; ++i) owp[i] = _vl_svdpi_word(lwp, i);
+    owp[words - 1] = _vl_svdpi_word(lwp, words - 1) & VL_MASK_I(obits);
 }
 static inline void VL_SET_SVBV_I(int, svBitVecVal* owp, IData ld) VL_MT_SAFE { owp[0] = ld; }
 static inline void VL_SET_SVBV_Q(int, svBitVecVal* owp, QData ld) VL_MT_SAFE {
-    VL_SET_WQ(owp, ld);
+    owp[0] = static_cast<IData>(ld);
+    owp[1] = static_cast<IData>(ld >> VL_IDATASIZE);
 }
 
 // Convert svLogicVecVal to Verilator internal data
 // Note these functions ignore X/Z in svLogicVecVal
 static inline void VL_SET_W_SVLV(int obits, WDataOutP owp, const svLogicVecVal* lwp) VL_MT_SAFE {
     int words = VL_WORDS_I(obits);
-    for (int i = 0; i < words - 1; ++i) owp[i] = lwp[i].aval;
-    owp[words - 1] = lwp[words - 1].aval & VL_MASK_I(obits);
+    for (int i = 0; i < words; ++i) owp[i] = 0;
+    for (int i = 0; i < SV_PACKED_DATA_NELEMS(obits); ++i) {
+        _vl_svdpi_setword(owp, i, lwp[i].aval);
+    }
+    owp[words - 1] &= VL_MASK_E(obits);
 }
 static inline QData VL_SET_Q_SVLV(const svLogicVecVal* lwp) VL_MT_SAFE {
     return VL_SET_QII(lwp[1].aval, lwp[0].aval);
@@ -72,21 +89,19 @@ static inline IData VL_SET_I_SVLV(const svLogicVecVal* lwp) VL_MT_SAFE { return
 // Convert Verilator internal data to svLogicVecVal
 // Note these functions never create X/Z in svLogicVecVal
 static inline void VL_SET_SVLV_W(int obits, svLogicVecVal* owp, WDataInP lwp) VL_MT_SAFE {
-    int words = VL_WORDS_I(obits);
+    int words = SV_PACKED_DATA_NELEMS(obits);
     for (int i = 0; i < words; ++i) owp[i].bval = 0;
-    for (int i = 0; i < words - 1; ++i) owp[i].aval = lwp[i];
-    owp[words - 1].aval = lwp[words - 1] & VL_MASK_I(obits);
+    for (int i = 0; i < words - 1; ++i) owp[i].aval = _vl_svdpi_word(lwp, i);
+    owp[words - 1].aval = _vl_svdpi_word(lwp, words - 1) & VL_MASK_I(obits);
 }
 static inline void VL_SET_SVLV_I(int, svLogicVecVal* owp, IData ld) VL_MT_SAFE {
     owp[0].aval = ld;
     owp[0].bval = 0;
 }
 static inline void VL_SET_SVLV_Q(int, svLogicVecVal* owp, QData ld) VL_MT_SAFE {
-    WData lwp[2];
-    VL_SET_WQ(lwp, ld);
-    owp[0].aval = lwp[0];
+    owp[0].aval = static_cast<IData>(ld);
     owp[0].bval = 0;
-    owp[1].aval = lwp[1];
+    owp[1].aval = static_cast<IData>(ld >> VL_IDATASIZE);
     owp[1].bval = 0;
 }
 
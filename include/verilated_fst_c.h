@@ -117,6 +117,8 @@ public:
 #ifndef DOXYGEN
 // Declare specialization here as it's used in VerilatedFstC just below
 template <> void VerilatedTrace<VerilatedFst>::dump(vluint64_t timeui);
+template <> void VerilatedTrace<VerilatedFst>::flightRecorder(vluint32_t dumps);
+template <> void VerilatedTrace<VerilatedFst>::flightRecorderWrite();
 template <> void VerilatedTrace<VerilatedFst>::set_time_unit(const char* unitp);
 template <> void VerilatedTrace<VerilatedFst>::set_time_unit(const std::string& unit);
 template <> void VerilatedTrace<VerilatedFst>::set_time_resolution(const char* unitp);
@@ -151,6 +153,12 @@ public:
     void close() VL_MT_SAFE { m_sptrace.close(); }
     /// Flush dump
     void flush() VL_MT_SAFE { m_sptrace.flush(); }
+    /// Keep only the last given number of dumps in memory, writing them
+    /// only on flightRecorderWrite(), or on a flush after an error such as
+    /// $stop, $fatal or a failed assertion.  Call before the first dump.
+    void flightRecorder(vluint32_t dumps) VL_MT_SAFE { m_sptrace.flightRecorder(dumps); }
+    /// Write the dumps kept by flightRecorder()
+    void flightRecorderWrite() VL_MT_SAFE { m_sptrace.flightRecorderWrite(); }
     /// Write one cycle of dump data
     void dump(vluint64_t timeui) { m_sptrace.dump(timeui); }
     /// Write one cycle of dump data - backward compatible and to reduce
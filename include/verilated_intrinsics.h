@@ -34,10 +34,25 @@
 #  define VL_HAVE_SSE2 1
 #  include <emmintrin.h>
 # endif
-# if defined(__AVX2__) && defined(VL_HAVE_SSE2) && !defined(VL_DISABLE_AVX2)
+# if defined(__SSE4_1__) && defined(VL_HAVE_SSE2) && !defined(VL_DISABLE_SSE4_1)
+#  define VL_HAVE_SSE4_1 1
+#  include <smmintrin.h>
+# endif
+# if defined(__AVX2__) && defined(VL_HAVE_SSE4_1) && !defined(VL_DISABLE_AVX2)
 #  define VL_HAVE_AVX2 1
 #  include <immintrin.h>
 # endif
+# if defined(__AVX512F__) && defined(VL_HAVE_AVX2) && !defined(VL_DISABLE_AVX512F)
+#  define VL_HAVE_AVX512F 1
+#  include <immintrin.h>
+# endif
+// Per-function target attributes, so kernels for instruction sets beyond
+// the compile flags can be selected at run time; users of this must
+// include <immintrin.h> themselves
+# if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) \
+     && !defined(VL_DISABLE_SIMD_DISPATCH)
+#  define VL_HAVE_SIMD_DISPATCH 1
+# endif
 #endif
 
 // clang-format on
@@ -27,9 +27,22 @@
 #include "verilated.h"
 #include "verilated_save.h"
 #include "verilated_imp.h"
+#ifdef VL_THREADED
+#include "verilated_trace.h"  // For VerilatedThreadQueue
+#endif
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <fcntl.h>
+#include <memory>
+
+#ifdef VL_THREADED
+#include <thread>
+#endif
+#ifdef VL_SAVE_ZLIB
+#include <zlib.h>
+#endif
 
 // clang-format off
 #if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
@@ -37,6 +50,11 @@
 #else
 # include <unistd.h>
 #endif
+#if defined(_WIN32) && !defined(__CYGWIN__)
+# define VL_SAVE_NO_FORK
+#else
+# include <sys/wait.h>
+#endif
 
 #ifndef O_LARGEFILE  // For example on WIN32
 # define O_LARGEFILE 0
@@ -54,6 +72,520 @@
 static const char* const VLTSAVE_HEADER_STR = "verilatorsave02\n";
 // Value of last bytes of each file (must be multiple of 8 bytes)
 static const char* const VLTSAVE_TRAILER_STR = "vltsaved";
+// Value of first bytes of each delta format file (same length as VLTSAVE_HEADER_STR)
+static const char* const VLTSAVE_DELTA_HEADER_STR = "verilatorsaveD1\n";
+// Value of last bytes of each delta format file
+static const char* const VLTSAVE_DELTA_TRAILER_STR = "vltdelta";
+// Size of the blocks a delta format file compares and stores
+static const size_t VLTSAVE_DELTA_BLOCK = 4096;
+// Record block index marking the end of delta records
+static const vluint64_t VLTSAVE_DELTA_END = ~0ULL;
+// Value of first bytes of each compressed or chunked file (same length as VLTSAVE_HEADER_STR)
+static const char* const VLTSAVE_FRAMED_HEADER_STR = "verilatorsaveC1\n";
+// Number of frames each chunk thread may have outstanding
+static const unsigned VLTSAVE_FRAMED_QUEUE = 2;
+
+#ifndef VL_SAVE_NO_FORK
+static pid_t s_saveForkPid = 0;  // Child process writing the last openFork
+static std::string s_saveForkFilename;  // Filename the last openFork child is writing
+#endif
+
+//=============================================================================
+// Delta format
+//
+// A delta format file holds the same stream as a full save file, cut into
+// VLTSAVE_DELTA_BLOCK sized blocks, storing only the blocks that differ
+// from a base checkpoint:
+//    VLTSAVE_DELTA_HEADER_STR, block size, base filename
+//    { block index, length, data } for each stored block
+//    VLTSAVE_DELTA_END
+//    stream length, block count, hash of each block      <- table offset
+//    table offset, VLTSAVE_DELTA_TRAILER_STR
+
+static vluint64_t vlSaveBlockHash(const vluint8_t* datap, size_t size) {
+    vluint64_t hash = 0x9e3779b97f4a7c15ULL ^ size;
+    size_t i = 0;
+    for (; i + sizeof(vluint64_t) <= size; i += sizeof(vluint64_t)) {
+        vluint64_t word;
+        std::memcpy(&word, datap + i, sizeof(word));
+        hash = (hash ^ word) * 0xff51afd7ed558ccdULL;
+        hash ^= hash >> 32;
+    }
+    for (; i < size; ++i) hash = (hash ^ datap[i]) * 0x100000001b3ULL;
+    return hash ^ (hash >> 29);
+}
+
+// Reads the stream held in a full or delta format file, one block at a time
+class VerilatedSaveDeltaReader final {
+    int m_fd = -1;  // File descriptor we're reading from
+    std::string m_filename;  // Filename, for error messages
+    bool m_delta = false;  // File is in delta format
+    vluint64_t m_size = 0;  // Stream length, in delta format
+    vluint64_t m_tableOffset = 0;  // File offset of block table, in delta format
+    vluint64_t m_block = 0;  // Index of next block to return
+    vluint64_t m_recIndex = VLTSAVE_DELTA_END;  // Block index of next record
+    vluint64_t m_recSize = 0;  // Length of next record
+    std::unique_ptr<VerilatedSaveDeltaReader> m_basep;  // Base checkpoint reader
+
+    void fatal(const std::string& why) {
+        const std::string msg = "Can't deserialize save-restore file: " + why + ": " + m_filename;
+        VL_FATAL_MT(m_filename.c_str(), 0, "", msg.c_str());
+    }
+    size_t readSome(void* datap, size_t size) {
+        vluint8_t* dp = static_cast<vluint8_t*>(datap);
+        size_t done = 0;
+        while (done < size) {
+            errno = 0;
+            const ssize_t got = ::read(m_fd, dp + done, size - done);
+            if (got > 0) {
+                done += got;
+            } else if (got == 0) {
+                break;
+            } else if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
+                fatal(std::strerror(errno));  // LCOV_EXCL_LINE
+                break;  // LCOV_EXCL_LINE
+            }
+        }
+        return done;
+    }
+    void readExact(void* datap, size_t size) {
+        if (VL_UNLIKELY(readSome(datap, size) != size)) fatal("file truncated");
+    }
+    void seek(vluint64_t offset) {
+        if (VL_UNLIKELY(::lseek(m_fd, offset, SEEK_SET) < 0)) fatal("file truncated");
+    }
+    void nextRecord() {
+        readExact(&m_recIndex, sizeof(m_recIndex));
+        if (m_recIndex != VLTSAVE_DELTA_END) readExact(&m_recSize, sizeof(m_recSize));
+    }
+
+public:
+    // Open the file; call isOpen() to see if errors
+    explicit VerilatedSaveDeltaReader(const std::string& filename)
+        : m_filename{filename} {
+        // cppcheck-suppress duplicateExpression
+        m_fd = ::open(filename.c_str(), O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+        if (VL_UNLIKELY(m_fd < 0)) return;
+        const size_t headerSize = std::strlen(VLTSAVE_HEADER_STR);
+        char header[16] = {};
+        assert(headerSize <= sizeof(header));
+        if (readSome(header, headerSize) == headerSize
+            && 0 == std::memcmp(header, VLTSAVE_HEADER_STR, headerSize)) {
+            seek(0);  // Full format, the file is the stream
+            return;
+        }
+        if (VL_UNLIKELY(std::memcmp(header, VLTSAVE_DELTA_HEADER_STR, headerSize))) {
+            fatal("file has wrong header signature");
+        }
+        m_delta = true;
+        vluint64_t blockSize = 0;
+        readExact(&blockSize, sizeof(blockSize));
+        if (VL_UNLIKELY(blockSize != VLTSAVE_DELTA_BLOCK)) fatal("unsupported delta block size");
+        vluint32_t len = 0;
+        readExact(&len, sizeof(len));
+        std::string base(len, '\0');
+        readExact(&base[0], len);
+        const off_t recordsOffset = ::lseek(m_fd, 0, SEEK_CUR);
+        // Trailer gives location of the block table, which gives the stream length
+        const off_t endOffset = ::lseek(m_fd, 0, SEEK_END);
+        const size_t trailerSize = std::strlen(VLTSAVE_DELTA_TRAILER_STR);
+        char trailer[8];
+        if (VL_UNLIKELY(endOffset < static_cast<off_t>(sizeof(m_tableOffset) + trailerSize))) {
+            fatal("file truncated");
+        }
+        seek(endOffset - sizeof(m_tableOffset) - trailerSize);
+        readExact(&m_tableOffset, sizeof(m_tableOffset));
+        readExact(trailer, trailerSize);
+        if (VL_UNLIKELY(std::memcmp(trailer, VLTSAVE_DELTA_TRAILER_STR, trailerSize))) {
+            fatal("file has wrong end-of-file signature");
+        }
+        seek(m_tableOffset);
+        readExact(&m_size, sizeof(m_size));
+        seek(recordsOffset);
+        nextRecord();
+        if (!base.empty()) {
+            m_basep.reset(new VerilatedSaveDeltaReader{base});
+            if (VL_UNLIKELY(!m_basep->isOpen())) fatal("can't open base checkpoint " + base);
+        }
+    }
+    ~VerilatedSaveDeltaReader() {
+        if (m_fd >= 0) ::close(m_fd);
+    }
+    bool isOpen() const { return m_fd >= 0; }
+    // Read the next block of the stream into bufp, which must hold
+    // VLTSAVE_DELTA_BLOCK bytes; return its length, or 0 at end of stream
+    size_t readBlock(vluint8_t* bufp) {
+        if (!m_delta) return readSome(bufp, VLTSAVE_DELTA_BLOCK);
+        const vluint64_t start = m_block * VLTSAVE_DELTA_BLOCK;
+        if (start >= m_size) return 0;
+        const size_t size = std::min<vluint64_t>(VLTSAVE_DELTA_BLOCK, m_size - start);
+        // Always read the base, so it stays at the same block
+        const size_t baseSize = m_basep ? m_basep->readBlock(bufp) : 0;
+        if (m_recIndex == m_block) {
+            if (VL_UNLIKELY(m_recSize != size)) fatal("corrupt delta record");
+            readExact(bufp, size);
+            nextRecord();
+        } else if (VL_UNLIKELY(baseSize != size)) {
+            fatal("base checkpoint does not match delta");
+        }
+        ++m_block;
+        return size;
+    }
+    // Return the hash of each block of the stream
+    void hashes(std::vector<vluint64_t>& hashes) {
+        hashes.clear();
+        if (m_delta) {
+            vluint64_t blocks = 0;
+            seek(m_tableOffset + sizeof(m_size));
+            readExact(&blocks, sizeof(blocks));
+            hashes.resize(blocks);
+            if (blocks) readExact(hashes.data(), blocks * sizeof(vluint64_t));
+        } else {
+            std::vector<vluint8_t> buf(VLTSAVE_DELTA_BLOCK);
+            while (const size_t size = readBlock(buf.data())) {
+                hashes.push_back(vlSaveBlockHash(buf.data(), size));
+            }
+        }
+    }
+};
+
+//=============================================================================
+// Compressed and chunked format
+//
+// Each buffer flushed becomes one frame, written to the chunk files in
+// turn.  Each chunk file holds:
+//    VLTSAVE_FRAMED_HEADER_STR, chunk count, chunk number
+//    { stream length, stored length, method, data } for each frame
+//    { 0, 0, 0 } ending the frames
+
+enum VerilatedSaveMethod : vluint32_t {
+    VLTSAVE_METHOD_STORED = 0,  // Data as is
+    VLTSAVE_METHOD_ZEROS = 1,  // Zero run encoded
+    VLTSAVE_METHOD_ZLIB = 2  // Zero run encoded, then deflated
+};
+
+static void vlSavePutVarint(std::vector<vluint8_t>& out, vluint64_t val) {
+    while (val >= 0x80) {
+        out.push_back(static_cast<vluint8_t>(val | 0x80));
+        val >>= 7;
+    }
+    out.push_back(static_cast<vluint8_t>(val));
+}
+
+static bool vlSaveGetVarint(const vluint8_t*& datap, const vluint8_t* endp, vluint64_t& val) {
+    val = 0;
+    for (int shift = 0; datap < endp && shift < 64; shift += 7) {
+        const vluint8_t byte = *datap++;
+        val |= static_cast<vluint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) return true;
+    }
+    return false;
+}
+
+// Encode as { literal length, literal bytes, zero run length } tokens
+static void vlSaveZerosEncode(const vluint8_t* datap, size_t size, std::vector<vluint8_t>& out) {
+    out.clear();
+    size_t pos = 0;
+    while (pos < size) {
+        // Find the next run of at least 8 zeros, or of zeros to the end
+        size_t runStart = pos;
+        size_t runEnd = pos;
+        while (true) {
+            while (runStart < size && datap[runStart]) ++runStart;
+            runEnd = runStart;
+            while (runEnd + sizeof(vluint64_t) <= size) {
+                vluint64_t word;
+                std::memcpy(&word, datap + runEnd, sizeof(word));
+                if (word) break;
+                runEnd += sizeof(word);
+            }
+            while (runEnd < size && !datap[runEnd]) ++runEnd;
+            if (runEnd == size || runEnd - runStart >= 8) break;
+            runStart = runEnd;
+        }
+        vlSavePutVarint(out, runStart - pos);
+        out.insert(out.end(), datap + pos, datap + runStart);
+        vlSavePutVarint(out, runEnd - runStart);
+        pos = runEnd;
+    }
+}
+
+static bool vlSaveZerosDecode(const vluint8_t* datap, size_t size, vluint8_t* outp,
+                              size_t outSize) {
+    const vluint8_t* const endp = datap + size;
+    vluint8_t* const outEndp = outp + outSize;
+    while (datap < endp) {
+        vluint64_t literal;
+        vluint64_t zeros;
+        if (!vlSaveGetVarint(datap, endp, literal)) return false;
+        if (literal > static_cast<vluint64_t>(endp - datap)) return false;
+        if (literal > static_cast<vluint64_t>(outEndp - outp)) return false;
+        std::memcpy(outp, datap, literal);
+        datap += literal;
+        outp += literal;
+        if (!vlSaveGetVarint(datap, endp, zeros)) return false;
+        if (zeros > static_cast<vluint64_t>(outEndp - outp)) return false;
+        std::memset(outp, 0, zeros);
+        outp += zeros;
+    }
+    return outp == outEndp;
+}
+
+static void vlSaveFramedHeader(std::vector<vluint8_t>& out, vluint32_t chunks,
+                               vluint32_t chunk) {
+    const size_t headerSize = std::strlen(VLTSAVE_FRAMED_HEADER_STR);
+    out.assign(VLTSAVE_FRAMED_HEADER_STR, VLTSAVE_FRAMED_HEADER_STR + headerSize);
+    out.insert(out.end(), reinterpret_cast<const vluint8_t*>(&chunks),
+               reinterpret_cast<const vluint8_t*>(&chunks) + sizeof(chunks));
+    out.insert(out.end(), reinterpret_cast<const vluint8_t*>(&chunk),
+               reinterpret_cast<const vluint8_t*>(&chunk) + sizeof(chunk));
+}
+
+static std::string vlSaveChunkFilename(const std::string& filename, vluint32_t chunk) {
+    return chunk ? filename + "." + std::to_string(chunk) : filename;
+}
+
+// Writes frames to one chunk file, in a thread of its own if VL_THREADED
+class VerilatedSaveChunkWriter final {
+    using Frame = std::vector<vluint8_t>;
+    int m_fd;  // File descriptor we're writing to
+    int m_level;  // zlib level, 0 for zero runs only, negative for no compression
+    Frame m_encoded;  // Zero run encoded frame
+    Frame m_out;  // Frame as written
+    std::atomic<int> m_errno{0};  // Error number of a failed write, or 0
+#ifdef VL_THREADED
+    VerilatedThreadQueue<Frame*> m_toWriter;  // Frames to write, nullptr to exit
+    VerilatedThreadQueue<Frame*> m_fromWriter;  // Frames written, for reuse
+    std::thread m_thread;  // Writer thread
+    Frame m_frames[VLTSAVE_FRAMED_QUEUE];  // Frame storage
+#endif
+
+    void writeFd(const vluint8_t* datap, size_t size) {
+        while (size && !m_errno) {
+            errno = 0;
+            const ssize_t got = ::write(m_fd, datap, size);
+            if (got > 0) {
+                datap += got;
+                size -= got;
+            } else if (VL_UNCOVERABLE(got < 0 && errno != EAGAIN && errno != EINTR)) {
+                m_errno = errno ? errno : EIO;  // LCOV_EXCL_LINE
+            }
+        }
+    }
+    void writeFrame(const vluint8_t* datap, size_t size) {
+        vluint32_t method = VLTSAVE_METHOD_STORED;
+        const vluint8_t* storedp = datap;
+        size_t storedSize = size;
+        if (m_level >= 0) {
+            vlSaveZerosEncode(datap, size, m_encoded);
+            method = VLTSAVE_METHOD_ZEROS;
+            storedp = m_encoded.data();
+            storedSize = m_encoded.size();
+        }
+#ifdef VL_SAVE_ZLIB
+        if (m_level > 0) {
+            uLongf outSize = compressBound(m_encoded.size());
+            m_out.resize(outSize);
+            if (compress2(m_out.data(), &outSize, m_encoded.data(), m_encoded.size(), m_level)
+                    == Z_OK
+                && outSize < storedSize) {
+                method = VLTSAVE_METHOD_ZLIB;
+                storedp = m_out.data();
+                storedSize = outSize;
+            }
+        }
+#endif
+        if (storedSize >= size) {
+            method = VLTSAVE_METHOD_STORED;
+            storedp = datap;
+            storedSize = size;
+        }
+        const vluint64_t header[3] = {size, storedSize, method};
+        writeFd(reinterpret_cast<const vluint8_t*>(header), sizeof(header));
+        writeFd(storedp, storedSize);
+    }
+#ifdef VL_THREADED
+    void writerMain() {
+        while (Frame* const framep = m_toWriter.get()) {
+            writeFrame(framep->data(), framep->size());
+            m_fromWriter.put(framep);
+        }
+    }
+#endif
+
+public:
+    VerilatedSaveChunkWriter(int fd, int level, vluint32_t chunks, vluint32_t chunk)
+        : m_fd{fd}
+        , m_level{level} {
+        vlSaveFramedHeader(m_out, chunks, chunk);
+        writeFd(m_out.data(), m_out.size());
+#ifdef VL_THREADED
+        for (Frame& frame : m_frames) m_fromWriter.put(&frame);
+        m_thread = std::thread{&VerilatedSaveChunkWriter::writerMain, this};
+#endif
+    }
+    ~VerilatedSaveChunkWriter() { finish(); }
+    // Write a frame holding the given data, which is copied
+    void put(const vluint8_t* datap, size_t size) {
+#ifdef VL_THREADED
+        Frame* const framep = m_fromWriter.get();  // Blocks if all frames are in flight
+        framep->assign(datap, datap + size);
+        m_toWriter.put(framep);
+#else
+        writeFrame(datap, size);
+#endif
+    }
+    // Write the end of frames and close; return errno of any failure, else 0
+    int finish() {
+        if (m_fd < 0) return m_errno;
+#ifdef VL_THREADED
+        m_toWriter.put(nullptr);
+        m_thread.join();
+#endif
+        const vluint64_t header[3] = {0, 0, 0};
+        writeFd(reinterpret_cast<const vluint8_t*>(header), sizeof(header));
+        ::close(m_fd);  // May get error, just ignore it
+        m_fd = -1;
+        return m_errno;
+    }
+};
+
+// Reads frames from one chunk file, in a thread of its own if VL_THREADED
+class VerilatedSaveChunkReader final {
+    using Frame = std::vector<vluint8_t>;
+    int m_fd;  // File descriptor we're reading from
+    std::string m_filename;  // Filename, for error messages
+    Frame m_stored;  // Frame as read
+    Frame m_encoded;  // Zero run encoded frame
+    bool m_eof = false;  // readFrame reached the end of frames
+    bool m_done = false;  // get returned the end of frames
+#ifdef VL_THREADED
+    VerilatedThreadQueue<Frame*> m_toReader;  // Frames to fill
+    VerilatedThreadQueue<Frame*> m_fromReader;  // Frames filled, empty at end
+    std::thread m_thread;  // Reader thread
+    std::atomic<bool> m_stop{false};  // Reader thread should exit
+    Frame m_frames[VLTSAVE_FRAMED_QUEUE];  // Frame storage
+#endif
+
+    void fatal(const std::string& why) {
+        const std::string msg = "Can't deserialize save-restore file: " + why + ": " + m_filename;
+        VL_FATAL_MT(m_filename.c_str(), 0, "", msg.c_str());
+    }
+    void readExact(void* datap, size_t size) {
+        vluint8_t* dp = static_cast<vluint8_t*>(datap);
+        while (size) {
+            errno = 0;
+            const ssize_t got = ::read(m_fd, dp, size);
+            if (got > 0) {
+                dp += got;
+                size -= got;
+            } else if (got == 0) {
+                fatal("file truncated");
+                return;
+            } else if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
+                fatal(std::strerror(errno));  // LCOV_EXCL_LINE
+                return;  // LCOV_EXCL_LINE
+            }
+        }
+    }
+    void readFrame(Frame& frame) {
+        frame.clear();
+        if (m_eof) return;
+        vluint64_t header[3];
+        readExact(header, sizeof(header));
+        const vluint64_t size = header[0];
+        const vluint64_t storedSize = header[1];
+        if (!size) {
+            m_eof = true;
+            return;
+        }
+        if (VL_UNLIKELY(size > (1ULL << 32) || storedSize > (1ULL << 32))) {
+            fatal("corrupt frame");
+        }
+        frame.resize(size);
+        switch (header[2]) {
+        case VLTSAVE_METHOD_STORED:
+            if (VL_UNLIKELY(storedSize != size)) fatal("corrupt frame");
+            readExact(frame.data(), size);
+            break;
+        case VLTSAVE_METHOD_ZEROS:
+            m_encoded.resize(storedSize);
+            readExact(m_encoded.data(), storedSize);
+            if (VL_UNLIKELY(!vlSaveZerosDecode(m_encoded.data(), storedSize, frame.data(), size))) {
+                fatal("corrupt frame");
+            }
+            break;
+#ifdef VL_SAVE_ZLIB
+        case VLTSAVE_METHOD_ZLIB: {
+            m_stored.resize(storedSize);
+            readExact(m_stored.data(), storedSize);
+            // Zero run encoding grows data by at most its length prefixes
+            uLongf encodedSize = size + size / 8 + 16;
+            m_encoded.resize(encodedSize);
+            if (VL_UNLIKELY(uncompress(m_encoded.data(), &encodedSize, m_stored.data(), storedSize)
+                                != Z_OK
+                            || !vlSaveZerosDecode(m_encoded.data(), encodedSize, frame.data(),
+                                                  size))) {
+                fatal("corrupt frame");
+            }
+            break;
+        }
+#else
+        case VLTSAVE_METHOD_ZLIB:
+            fatal("zlib compressed frame, but built without VL_SAVE_ZLIB");
+            break;
+#endif
+        default: fatal("unknown frame compression method");
+        }
+    }
+#ifdef VL_THREADED
+    void readerMain() {
+        while (true) {
+            Frame* const framep = m_toReader.get();
+            if (m_stop || !framep) break;
+            readFrame(*framep);
+            m_fromReader.put(framep);
+            if (framep->empty()) break;
+        }
+    }
+#endif
+
+public:
+    VerilatedSaveChunkReader(int fd, const std::string& filename)
+        : m_fd{fd}
+        , m_filename{filename} {
+#ifdef VL_THREADED
+        for (Frame& frame : m_frames) m_toReader.put(&frame);
+        m_thread = std::thread{&VerilatedSaveChunkReader::readerMain, this};
+#endif
+    }
+    ~VerilatedSaveChunkReader() {
+#ifdef VL_THREADED
+        m_stop = true;
+        m_toReader.put(nullptr);
+        m_thread.join();
+#endif
+        ::close(m_fd);
+    }
+    // Read the next frame, leaving it empty at the end of frames
+    void get(Frame& frame) {
+#ifdef VL_THREADED
+        if (m_done) {
+            frame.clear();
+            return;
+        }
+        Frame* const framep = m_fromReader.get();
+        frame.swap(*framep);
+        if (frame.empty()) {
+            m_done = true;  // Reader thread has exited
+        } else {
+            m_toReader.put(framep);
+        }
+#else
+        readFrame(frame);
+#endif
+    }
+};
 
 //=============================================================================
 //=============================================================================
@@ -122,6 +654,18 @@ void VerilatedDeserialize::trailer() VL_MT_UNSAFE_ONE {
 //=============================================================================
 // Opening/Closing
 
+void VerilatedSave::compress(int level) VL_MT_UNSAFE_ONE {
+#ifndef VL_SAVE_ZLIB
+    if (VL_UNLIKELY(level > 0)) {
+        const std::string msg = "VerilatedSave::compress level " + std::to_string(level)
+                                + " requires building with -DVL_SAVE_ZLIB and linking with -lz";
+        VL_FATAL_MT("", 0, "", msg.c_str());
+    }
+#endif
+    m_compress = true;
+    m_compressLevel = level;
+}
+
 void VerilatedSave::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_assertOne.check();
     if (isOpen()) return;
@@ -142,9 +686,53 @@ void VerilatedSave::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_isOpen = true;
     m_filename = filenamep;
     m_cp = m_bufp;
+    if (!m_deltaBase.empty()) {
+        deltaOpen();
+    } else if (framed()) {
+        framedOpen();
+    }
     header();
 }
 
+bool VerilatedSave::openFork(const char* filenamep) VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (isOpen()) return false;
+#ifndef VL_SAVE_NO_FORK
+    // Report a failed earlier save which the caller hasn't already waited on
+    if (s_saveForkPid && VL_UNLIKELY(!forkWait())) {
+        VL_PRINTF(  // Not VL_PRINTF_MT, already on main thread
+            "%%Warning: Forked save failed to write %s\n", s_saveForkFilename.c_str());
+    }
+    // Child exits without flushing stdio, but don't let an error message repeat pending output
+    std::fflush(stdout);
+    std::fflush(stderr);
+    const pid_t pid = ::fork();
+    if (pid > 0) {
+        s_saveForkPid = pid;
+        s_saveForkFilename = filenamep;
+        return false;
+    }
+    m_forkChild = (pid == 0);  // Else couldn't fork, so save in this process
+#endif
+    open(filenamep);
+    return true;
+}
+
+bool VerilatedSave::forkWait() VL_MT_UNSAFE_ONE {
+#ifndef VL_SAVE_NO_FORK
+    if (!s_saveForkPid) return true;
+    int status = 0;
+    pid_t got;
+    do {
+        got = ::waitpid(s_saveForkPid, &status, 0);
+    } while (got < 0 && errno == EINTR);
+    s_saveForkPid = 0;
+    return got > 0 && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+#else
+    return true;
+#endif
+}
+
 void VerilatedRestore::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_assertOne.check();
     if (isOpen()) return;
@@ -165,15 +753,71 @@ void VerilatedRestore::open(const char* filenamep) VL_MT_UNSAFE_ONE {
     m_filename = filenamep;
     m_cp = m_bufp;
     m_endp = m_bufp;
+    // Delta format files are read through the chain of their base checkpoints
+    const size_t headerSize = std::strlen(VLTSAVE_DELTA_HEADER_STR);
+    char magic[16] = {};
+    assert(headerSize <= sizeof(magic));
+    if (::read(m_fd, magic, headerSize) == static_cast<ssize_t>(headerSize)
+        && 0 == std::memcmp(magic, VLTSAVE_DELTA_HEADER_STR, headerSize)) {
+        ::close(m_fd);
+        m_fd = -1;
+        m_deltap = new VerilatedSaveDeltaReader{m_filename};
+    } else if (0 == std::memcmp(magic, VLTSAVE_FRAMED_HEADER_STR, headerSize)) {
+        vluint32_t chunkHeader[2] = {0, 0};  // Chunk count, chunk number
+        if (::read(m_fd, chunkHeader, sizeof(chunkHeader)) != sizeof(chunkHeader)
+            || chunkHeader[1] != 0 || chunkHeader[0] == 0) {
+            const std::string msg = "Can't deserialize; file has wrong chunk header: " + m_filename;
+            VL_FATAL_MT(m_filename.c_str(), 0, "", msg.c_str());
+        }
+        framedOpen(chunkHeader[0]);
+    } else {
+        ::lseek(m_fd, 0, SEEK_SET);
+    }
     header();
 }
 
+void VerilatedRestore::framedOpen(vluint32_t chunks) VL_MT_UNSAFE_ONE {
+    m_frame.clear();
+    m_framePos = 0;
+    m_frames = 0;
+    m_readers.push_back(new VerilatedSaveChunkReader{m_fd, m_filename});
+    m_fd = -1;  // Now owned by reader
+    for (vluint32_t chunk = 1; chunk < chunks; ++chunk) {
+        const std::string filename = vlSaveChunkFilename(m_filename, chunk);
+        // cppcheck-suppress duplicateExpression
+        const int fd = ::open(filename.c_str(), O_RDONLY | O_LARGEFILE | O_CLOEXEC);
+        std::vector<vluint8_t> expect;
+        vlSaveFramedHeader(expect, chunks, chunk);
+        std::vector<vluint8_t> got(expect.size());
+        if (VL_UNLIKELY(fd < 0
+                        || ::read(fd, got.data(), got.size())
+                               != static_cast<ssize_t>(got.size())
+                        || got != expect)) {
+            const std::string msg
+                = "Can't deserialize; missing or wrong chunk file: " + filename;
+            VL_FATAL_MT(filename.c_str(), 0, "", msg.c_str());
+            if (fd >= 0) ::close(fd);
+            return;
+        }
+        m_readers.push_back(new VerilatedSaveChunkReader{fd, filename});
+    }
+}
+
 void VerilatedSave::close() VL_MT_UNSAFE_ONE {
-    if (!isOpen()) return;
-    trailer();
-    flush();
-    m_isOpen = false;
-    ::close(m_fd);  // May get error, just ignore it
+    if (isOpen()) {
+        trailer();
+        if (m_delta) {
+            deltaClose();
+        } else {
+            flush();
+        }
+        if (!m_writers.empty()) framedClose();
+        m_isOpen = false;
+        if (m_fd >= 0) ::close(m_fd);  // May get error, just ignore it
+        m_fd = -1;
+        if (m_forkChild) ::_exit(0);
+    }
+    if (m_forkChild) ::_exit(1);  // Open or write failed
 }
 
 void VerilatedRestore::close() VL_MT_UNSAFE_ONE {
@@ -181,38 +825,170 @@ void VerilatedRestore::close() VL_MT_UNSAFE_ONE {
     trailer();
     flush();
     m_isOpen = false;
-    ::close(m_fd);  // May get error, just ignore it
+    if (m_fd >= 0) ::close(m_fd);  // May get error, just ignore it
+    m_fd = -1;
+    if (m_deltap) VL_DO_CLEAR(delete m_deltap, m_deltap = nullptr);
+    for (VerilatedSaveChunkReader* readerp : m_readers) delete readerp;
+    m_readers.clear();
 }
 
 //=============================================================================
 // Buffer management
 
-void VerilatedSave::flush() VL_MT_UNSAFE_ONE {
-    m_assertOne.check();
-    if (VL_UNLIKELY(!isOpen())) return;
-    vluint8_t* wp = m_bufp;
-    while (true) {
-        ssize_t remaining = (m_cp - wp);
-        if (remaining == 0) break;
+void VerilatedSave::writeFd(const void* datap, size_t size) VL_MT_UNSAFE_ONE {
+    const vluint8_t* wp = static_cast<const vluint8_t*>(datap);
+    const vluint8_t* const endp = wp + size;
+    while (wp < endp) {
         errno = 0;
-        ssize_t got = ::write(m_fd, wp, remaining);
+        ssize_t got = ::write(m_fd, wp, endp - wp);
         if (got > 0) {
             wp += got;
         } else if (VL_UNCOVERABLE(got < 0)) {
             if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
                 // LCOV_EXCL_START
                 // write failed, presume error (perhaps out of disk space)
-                std::string msg = std::string(__FUNCTION__) + ": " + std::strerror(errno);
-                VL_FATAL_MT("", 0, "", msg.c_str());
-                close();
+                writeFatal(std::string(__FUNCTION__) + ": " + std::strerror(errno));
+                m_isOpen = false;
                 break;
                 // LCOV_EXCL_STOP
             }
         }
     }
+    m_fileBytes += size;
+}
+
+void VerilatedSave::flush() VL_MT_UNSAFE_ONE {
+    m_assertOne.check();
+    if (VL_UNLIKELY(!isOpen())) return;
+    if (m_delta) {
+        deltaFlush(false);
+        return;
+    }
+    if (!m_writers.empty()) {
+        if (m_cp != m_bufp) m_writers[m_frames++ % m_writers.size()]->put(m_bufp, m_cp - m_bufp);
+    } else {
+        writeFd(m_bufp, m_cp - m_bufp);
+    }
     m_cp = m_bufp;  // Reset buffer
 }
 
+void VerilatedSave::framedOpen() VL_MT_UNSAFE_ONE {
+    m_frames = 0;
+    std::vector<int> fds{m_fd};
+    for (vluint32_t chunk = 1; chunk < m_chunks; ++chunk) {
+        const std::string filename = vlSaveChunkFilename(m_filename, chunk);
+        // cppcheck-suppress duplicateExpression
+        const int fd = ::open(filename.c_str(),
+                              O_CREAT | O_WRONLY | O_TRUNC | O_LARGEFILE | O_NONBLOCK | O_CLOEXEC,
+                              0666);
+        if (VL_UNLIKELY(fd < 0)) {
+            // User code can check isOpen()
+            for (const int openFd : fds) ::close(openFd);
+            m_fd = -1;
+            m_isOpen = false;
+            return;
+        }
+        fds.push_back(fd);
+    }
+    m_fd = -1;  // Now owned by writers
+    for (vluint32_t chunk = 0; chunk < m_chunks; ++chunk) {
+        m_writers.push_back(new VerilatedSaveChunkWriter{
+            fds[chunk], m_compress ? m_compressLevel : -1, m_chunks, chunk});
+    }
+}
+
+void VerilatedSave::framedClose() VL_MT_UNSAFE_ONE {
+    int err = 0;
+    for (VerilatedSaveChunkWriter* writerp : m_writers) {
+        if (const int writerErr = writerp->finish()) err = writerErr;
+        delete writerp;
+    }
+    m_writers.clear();
+    if (VL_UNCOVERABLE(err)) {
+        // LCOV_EXCL_START
+        // write failed, presume error (perhaps out of disk space)
+        writeFatal(std::string(__FUNCTION__) + ": " + std::strerror(err));
+        // LCOV_EXCL_STOP
+    }
+}
+
+void VerilatedSave::writeFatal(const std::string& msg) VL_MT_UNSAFE_ONE {
+    if (m_forkChild) {
+        // Exit without the flush and exit callbacks, as the trace files etc
+        // they would write belong to the parent
+        VL_PRINTF("%%Error: %s\n", msg.c_str());  // Not VL_PRINTF_MT, already on main thread
+        std::fflush(stdout);
+        ::_exit(1);
+    }
+    VL_FATAL_MT("", 0, "", msg.c_str());
+}
+
+void VerilatedSave::deltaOpen() VL_MT_UNSAFE_ONE {
+    m_delta = true;
+    m_fileBytes = 0;
+    m_hashes.clear();
+    m_baseHashes.clear();
+    std::string base = m_deltaBase;
+    {
+        VerilatedSaveDeltaReader reader{base};
+        if (reader.isOpen()) {
+            reader.hashes(m_baseHashes);
+        } else {
+            base = "";  // Unreadable, so store every block
+        }
+    }
+    const vluint64_t blockSize = VLTSAVE_DELTA_BLOCK;
+    const vluint32_t len = base.length();
+    m_deltaOut.assign(VLTSAVE_DELTA_HEADER_STR);
+    m_deltaOut.append(reinterpret_cast<const char*>(&blockSize), sizeof(blockSize));
+    m_deltaOut.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    m_deltaOut.append(base);
+}
+
+void VerilatedSave::deltaFlush(bool final) VL_MT_UNSAFE_ONE {
+    // Store each whole block (or the final partial block) that differs from the base
+    vluint8_t* rp = m_bufp;
+    while ((rp + VLTSAVE_DELTA_BLOCK) <= m_cp || (final && rp < m_cp)) {
+        const vluint64_t size = std::min<size_t>(VLTSAVE_DELTA_BLOCK, m_cp - rp);
+        const vluint64_t index = m_hashes.size();
+        const vluint64_t hash = vlSaveBlockHash(rp, size);
+        m_hashes.push_back(hash);
+        if (index >= m_baseHashes.size() || m_baseHashes[index] != hash) {
+            m_deltaOut.append(reinterpret_cast<const char*>(&index), sizeof(index));
+            m_deltaOut.append(reinterpret_cast<const char*>(&size), sizeof(size));
+            m_deltaOut.append(reinterpret_cast<const char*>(rp), size);
+        }
+        rp += size;
+    }
+    // Keep any partial block for next time
+    const size_t remaining = m_cp - rp;
+    std::memmove(m_bufp, rp, remaining);
+    m_cp = m_bufp + remaining;
+    if (final || m_deltaOut.size() >= bufferSize()) {
+        writeFd(m_deltaOut.data(), m_deltaOut.size());
+        m_deltaOut.clear();
+    }
+}
+
+void VerilatedSave::deltaClose() VL_MT_UNSAFE_ONE {
+    // The stream length is whole blocks, plus the partial block still buffered
+    const vluint64_t size = m_hashes.size() * VLTSAVE_DELTA_BLOCK + (m_cp - m_bufp);
+    deltaFlush(true);
+    const vluint64_t blocks = m_hashes.size();
+    const vluint64_t tableOffset = m_fileBytes + sizeof(VLTSAVE_DELTA_END);
+    m_deltaOut.append(reinterpret_cast<const char*>(&VLTSAVE_DELTA_END),
+                      sizeof(VLTSAVE_DELTA_END));
+    m_deltaOut.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    m_deltaOut.append(reinterpret_cast<const char*>(&blocks), sizeof(blocks));
+    m_deltaOut.append(reinterpret_cast<const char*>(m_hashes.data()),
+                      blocks * sizeof(vluint64_t));
+    m_deltaOut.append(reinterpret_cast<const char*>(&tableOffset), sizeof(tableOffset));
+    m_deltaOut.append(VLTSAVE_DELTA_TRAILER_STR);
+    writeFd(m_deltaOut.data(), m_deltaOut.size());
+    m_deltaOut.clear();
+    m_delta = false;
+}
+
 void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     m_assertOne.check();
     if (VL_UNLIKELY(!isOpen())) return;
@@ -221,6 +997,35 @@ void VerilatedRestore::fill() VL_MT_UNSAFE_ONE {
     for (vluint8_t* sp = m_cp; sp < m_endp; *rp++ = *sp++) {}  // Overlaps
     m_endp = m_bufp + (m_endp - m_cp);
     m_cp = m_bufp;  // Reset buffer
+    if (!m_readers.empty()) {
+        while (m_endp < m_bufp + bufferSize()) {
+            if (m_framePos == m_frame.size()) {
+                m_readers[m_frames++ % m_readers.size()]->get(m_frame);
+                m_framePos = 0;
+                if (m_frame.empty()) {  // EOF, NULL fill as below
+                    while (m_endp < m_bufp + bufferSize()) *m_endp++ = '\0';
+                    break;
+                }
+            }
+            const size_t size = std::min<size_t>(m_frame.size() - m_framePos,
+                                                 m_bufp + bufferSize() - m_endp);
+            std::memcpy(m_endp, m_frame.data() + m_framePos, size);
+            m_endp += size;
+            m_framePos += size;
+        }
+        return;
+    }
+    if (m_deltap) {
+        while (m_endp + VLTSAVE_DELTA_BLOCK <= m_bufp + bufferSize()) {
+            const size_t got = m_deltap->readBlock(m_endp);
+            if (!got) {  // EOF, NULL fill as below
+                while (m_endp < m_bufp + bufferSize()) *m_endp++ = '\0';
+                break;
+            }
+            m_endp += got;
+        }
+        return;
+    }
     // Read into buffer starting at m_endp
     while (true) {
         ssize_t remaining = (m_bufp + bufferSize() - m_endp);
@@ -26,6 +26,11 @@
 #include "verilated_heavy.h"
 
 #include <string>
+#include <vector>
+
+class VerilatedSaveChunkReader;
+class VerilatedSaveChunkWriter;
+class VerilatedSaveDeltaReader;
 
 //=============================================================================
 // VerilatedSerialize
@@ -188,6 +193,27 @@ private:
 class VerilatedSave final : public VerilatedSerialize {
 private:
     int m_fd = -1;  // File descriptor we're writing to
+    bool m_forkChild = false;  // This process was forked by openFork, exit on close
+    std::string m_deltaBase;  // Checkpoint to write differences against, empty for full
+    bool m_delta = false;  // Writing delta format
+    vluint64_t m_fileBytes = 0;  // Bytes written to file, in delta format
+    std::string m_deltaOut;  // Delta records pending write to file
+    std::vector<vluint64_t> m_hashes;  // Hash of each block written, in delta format
+    std::vector<vluint64_t> m_baseHashes;  // Hash of each block in m_deltaBase
+    bool m_compress = false;  // Compress the file
+    int m_compressLevel = 0;  // zlib level after zero run encoding, 0 for none
+    unsigned m_chunks = 1;  // Number of chunk files to split across
+    std::vector<VerilatedSaveChunkWriter*> m_writers;  // Writer for each chunk file
+    vluint64_t m_frames = 0;  // Number of frames handed to m_writers
+
+    void writeFd(const void* datap, size_t size) VL_MT_UNSAFE_ONE;
+    void writeFatal(const std::string& msg) VL_MT_UNSAFE_ONE;
+    bool framed() const { return m_compress || m_chunks > 1; }
+    void framedOpen() VL_MT_UNSAFE_ONE;
+    void framedClose() VL_MT_UNSAFE_ONE;
+    void deltaOpen() VL_MT_UNSAFE_ONE;
+    void deltaFlush(bool final) VL_MT_UNSAFE_ONE;
+    void deltaClose() VL_MT_UNSAFE_ONE;
 
 public:
     // CONSTRUCTORS
@@ -200,6 +226,37 @@ public:
     void open(const char* filenamep) VL_MT_UNSAFE_ONE;
     /// Open the file; call isOpen() to see if errors
     void open(const std::string& filename) VL_MT_UNSAFE_ONE { open(filename.c_str()); }
+    /// Fork a child process that writes the file from a copy-on-write image
+    /// of this process, so the caller may continue simulating.  Returns
+    /// true in the child, which must serialize and then close(), which
+    /// exits the child; returns false in the caller.  Waits for any
+    /// previous forked save to complete first, warning if it failed.
+    /// The child exits without running flush or exit callbacks.  Where
+    /// fork is not available, opens the file in this process and returns
+    /// true.
+    bool openFork(const char* filenamep) VL_MT_UNSAFE_ONE;
+    bool openFork(const std::string& filename) VL_MT_UNSAFE_ONE {
+        return openFork(filename.c_str());
+    }
+    /// Wait for the child created by the last openFork to complete.
+    /// Returns false if it failed to write the file.
+    static bool forkWait() VL_MT_UNSAFE_ONE;
+    /// Before open, request that only blocks of the save stream which
+    /// differ from the given earlier checkpoint be written.  Restoring
+    /// then also reads that checkpoint, so it must be kept.  If it can't
+    /// be read, all blocks are written.
+    void deltaBase(const std::string& filename) VL_MT_UNSAFE_ONE { m_deltaBase = filename; }
+    /// Before open, request the file be compressed.  Runs of zeros are
+    /// always encoded compactly; a level of 1-9 then further deflates each
+    /// buffer with zlib at that level, which is only available when built
+    /// with VL_SAVE_ZLIB defined, else is a fatal error.
+    void compress(int level) VL_MT_UNSAFE_ONE;
+    /// Before open, request the file be split into the given number of
+    /// chunk files, the first named as passed to open, the rest with a
+    /// ".<number>" suffix.  With VL_THREADED, each chunk is compressed and
+    /// written, and when restoring read, by its own thread.  Compression
+    /// and chunks do not apply to delta checkpoints.
+    void chunks(unsigned number) VL_MT_UNSAFE_ONE { m_chunks = number ? number : 1; }
     /// Flush and close the file
     virtual void close() override VL_MT_UNSAFE_ONE;
     /// Flush data to file
@@ -215,6 +272,13 @@ public:
 class VerilatedRestore final : public VerilatedDeserialize {
 private:
     int m_fd = -1;  // File descriptor we're writing to
+    VerilatedSaveDeltaReader* m_deltap = nullptr;  // Reader when file is in delta format
+    std::vector<VerilatedSaveChunkReader*> m_readers;  // Reader for each chunk file
+    std::vector<vluint8_t> m_frame;  // Last frame read from m_readers
+    size_t m_framePos = 0;  // Bytes of m_frame already consumed
+    vluint64_t m_frames = 0;  // Number of frames read from m_readers
+
+    void framedOpen(vluint32_t chunks) VL_MT_UNSAFE_ONE;
 
 public:
     // CONSTRUCTORS
@@ -228,6 +228,7 @@ class VerilatedVar final : public VerilatedVarProps {
     // MEMBERS
     void* m_datap;  // Location of data
     const char* m_namep;  // Name - slowpath
+    vluint8_t* m_dirtyp = nullptr;  // Set on each write by the model, if --vpi-dirty
 protected:
     bool m_isParam;
     friend class VerilatedScope;
@@ -247,6 +248,7 @@ public:
     const VerilatedRange& array() const { return unpacked(); }  // Deprecated
     const char* name() const { return m_namep; }
     bool isParam() const { return m_isParam; }
+    vluint8_t* dirtyp() const { return m_dirtyp; }
 };
 
 #endif  // Guard
@@ -33,8 +33,11 @@
 #include "verilated_heavy.h"
 #include "verilated_sym_props.h"
 
+#include <algorithm>
+#include <cstring>
 #include <map>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 //======================================================================
@@ -45,10 +48,77 @@ struct VerilatedCStrCmp {
     bool operator()(const char* a, const char* b) const { return std::strcmp(a, b) < 0; }
 };
 
+// Classes to hash maps keyed by const char*'s
+struct VerilatedCStrHash {
+    // FNV-1a.  V3EmitCSyms computes the same hash to generate variable tables.
+    static vluint64_t hash(const char* a) {
+        vluint64_t hash = 0xcbf29ce484222325ULL;
+        for (; *a; ++a) hash = (hash ^ static_cast<vluint8_t>(*a)) * 0x100000001b3ULL;
+        return hash;
+    }
+    size_t operator()(const char* a) const { return static_cast<size_t>(hash(a)); }
+};
+struct VerilatedCStrEqual {
+    bool operator()(const char* a, const char* b) const { return std::strcmp(a, b) == 0; }
+};
+
+// Map of sorted names, with a hashed index so find() takes constant time.
+// The sorted map is kept for iteration in name order.
+template <class T_Value> class VerilatedCStrMap VL_NOT_FINAL {
+    using Map = std::map<const char*, T_Value, VerilatedCStrCmp>;
+    // MEMBERS
+    Map m_map;  // Each element, sorted by name
+    std::unordered_map<const char*, typename Map::iterator, VerilatedCStrHash, VerilatedCStrEqual>
+        m_index;  // Each element of m_map, by name
+
+    VL_UNCOPYABLE(VerilatedCStrMap);
+
+public:
+    using iterator = typename Map::iterator;
+    using const_iterator = typename Map::const_iterator;
+    using value_type = typename Map::value_type;
+    // CONSTRUCTORS
+    VerilatedCStrMap() = default;
+    ~VerilatedCStrMap() = default;
+    // METHODS
+    iterator begin() { return m_map.begin(); }
+    const_iterator begin() const { return m_map.begin(); }
+    iterator end() { return m_map.end(); }
+    const_iterator end() const { return m_map.end(); }
+    size_t size() const { return m_map.size(); }
+    bool empty() const { return m_map.empty(); }
+    iterator find(const char* namep) {
+        const auto it = m_index.find(namep);
+        return VL_LIKELY(it != m_index.end()) ? it->second : m_map.end();
+    }
+    const_iterator find(const char* namep) const {
+        const auto it = m_index.find(namep);
+        return VL_LIKELY(it != m_index.end()) ? const_iterator{it->second} : m_map.end();
+    }
+    // Insert, keeping any existing element of the same name
+    template <typename... T_Args>
+    std::pair<iterator, bool> emplace(const char* namep, T_Args&&... args) {
+        const auto it = m_index.find(namep);
+        if (it != m_index.end()) return std::make_pair(it->second, false);
+        // Names are usually inserted in sorted order, so try the end first
+        const iterator newit
+            = m_map.emplace_hint(m_map.end(), namep, std::forward<T_Args>(args)...);
+        m_index.emplace(newit->first, newit);
+        return std::make_pair(newit, true);
+    }
+    iterator erase(iterator it) {
+        m_index.erase(it->first);
+        return m_map.erase(it);
+    }
+    void clear() {
+        m_index.clear();
+        m_map.clear();
+    }
+};
+
 // Map of sorted scope names to find associated scope class
 // This is a class instead of typedef/using to allow forward declaration in verilated.h
-class VerilatedScopeNameMap final
-    : public std::map<const char*, const VerilatedScope*, VerilatedCStrCmp> {
+class VerilatedScopeNameMap final : public VerilatedCStrMap<const VerilatedScope*> {
 public:
     VerilatedScopeNameMap() = default;
     ~VerilatedScopeNameMap() = default;
@@ -56,10 +126,91 @@ public:
 
 // Map of sorted variable names to find associated variable class
 // This is a class instead of typedef/using to allow forward declaration in verilated.h
-class VerilatedVarNameMap final : public std::map<const char*, VerilatedVar, VerilatedCStrCmp> {
+//
+// The variables are held sorted in a vector.  V3EmitCSyms inserts them in
+// name order, along with an open addressing hash table it generated of the
+// VerilatedCStrHash of each name, so neither sorting nor hashing is needed
+// when the model is constructed.
+class VerilatedVarNameMap final {
+public:
+    using value_type = std::pair<const char*, VerilatedVar>;
+    using iterator = std::vector<value_type>::iterator;
+    using const_iterator = std::vector<value_type>::const_iterator;
+
+private:
+    // MEMBERS
+    std::vector<value_type> m_vars;  // Each variable, sorted by name
+    const vluint32_t* m_slotsp = nullptr;  // Hash slot to m_vars index + 1, or 0 if empty
+    vluint32_t m_slotMask = 0;  // Number of hash slots - 1
+
+    VL_UNCOPYABLE(VerilatedVarNameMap);
+
+    iterator lowerBound(const char* namep) {
+        return std::lower_bound(
+            m_vars.begin(), m_vars.end(), namep,
+            [](const value_type& a, const char* b) { return std::strcmp(a.first, b) < 0; });
+    }
+
 public:
+    // CONSTRUCTORS
     VerilatedVarNameMap() = default;
     ~VerilatedVarNameMap() = default;
+    // METHODS
+    iterator begin() { return m_vars.begin(); }
+    const_iterator begin() const { return m_vars.begin(); }
+    iterator end() { return m_vars.end(); }
+    const_iterator end() const { return m_vars.end(); }
+    size_t size() const { return m_vars.size(); }
+    bool empty() const { return m_vars.empty(); }
+    // Use the generated hash table of the given number of variables, that
+    // will be inserted in name order.  The table must remain allocated.
+    void hashTable(vluint32_t count, vluint32_t slotMask, const vluint32_t* slotsp) {
+        m_vars.reserve(count);
+        m_slotMask = slotMask;
+        m_slotsp = slotsp;
+    }
+    iterator find(const char* namep) {
+        if (VL_LIKELY(m_slotsp)) {
+            for (vluint32_t slot = VerilatedCStrHash::hash(namep) & m_slotMask; m_slotsp[slot];
+                 slot = (slot + 1) & m_slotMask) {
+                const vluint32_t index = m_slotsp[slot] - 1;
+                // Indices past the end are yet to be inserted
+                if (index < m_vars.size() && std::strcmp(m_vars[index].first, namep) == 0) {
+                    return m_vars.begin() + index;
+                }
+            }
+            return m_vars.end();
+        }
+        const iterator it = lowerBound(namep);
+        return (it != m_vars.end() && std::strcmp(it->first, namep) == 0) ? it : m_vars.end();
+    }
+    const_iterator find(const char* namep) const {
+        return const_cast<VerilatedVarNameMap*>(this)->find(namep);
+    }
+    // Insert, keeping any existing variable of the same name
+    std::pair<iterator, bool> emplace(const char* namep, const VerilatedVar& var) {
+        if (VL_LIKELY(m_vars.empty() || std::strcmp(m_vars.back().first, namep) < 0)) {
+            m_vars.emplace_back(namep, var);
+            return std::make_pair(m_vars.end() - 1, true);
+        }
+        const iterator it = lowerBound(namep);
+        if (std::strcmp(it->first, namep) == 0) return std::make_pair(it, false);
+        // Out of order, so the generated table no longer matches the indices.
+        // VerilatedVar is not assignable, so copy into a new vector.
+        m_slotsp = nullptr;
+        const size_t index = it - m_vars.begin();
+        std::vector<value_type> vars;
+        vars.reserve(m_vars.size() + 1);
+        for (const_iterator copyit = m_vars.begin(); copyit != it; ++copyit) {
+            vars.push_back(*copyit);
+        }
+        vars.emplace_back(namep, var);
+        for (const_iterator copyit = it; copyit != m_vars.end(); ++copyit) {
+            vars.push_back(*copyit);
+        }
+        m_vars.swap(vars);
+        return std::make_pair(m_vars.begin() + index, true);
+    }
 };
 
 // Map of parent scope to vector of children scopes
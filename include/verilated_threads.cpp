@@ -26,29 +26,134 @@
 
 #include <cstdio>
 
+// clang-format off
+#if defined(__linux)
+# include <climits>
+# include <linux/futex.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#else
+# include <mutex>
+#endif
+// clang-format on
+
 //=============================================================================
 // Globals
 
 // Internal note: Globals may multi-construct, see verilated.cpp top.
 
 std::atomic<vluint64_t> VlMTaskVertex::s_yields;
+VL_THREAD_LOCAL VlWaitStats* VlMTaskVertex::t_waitStatsp = nullptr;
+
+#if !defined(__linux)
+// Without futexes, parked threads all share one condition variable
+static std::mutex s_parkMutex;
+static std::condition_variable s_parkCv;
+#endif
 
 VL_THREAD_LOCAL VlThreadPool::ProfileTrace* VlThreadPool::t_profilep = nullptr;
+VL_THREAD_LOCAL int VlThreadPool::t_dequeIndex = 0;
 
 //=============================================================================
 // VlMTaskVertex
 
 VlMTaskVertex::VlMTaskVertex(vluint32_t upstreamDepCount)
     : m_upstreamDepsDone{0}
-    , m_upstreamDepCount{upstreamDepCount} {
+    , m_upstreamDepCount{upstreamDepCount}
+    , m_parked{false} {
     assert(atomic_is_lock_free(&m_upstreamDepsDone));
 }
 
+void VlMTaskVertex::waitUntilUpstreamDoneSlow(bool evenCycle) {
+    VlWaitStats* const statsp = t_waitStatsp;
+    const unsigned spinLimit = statsp ? statsp->m_spinLimit : VlWaitStats::SPIN_MAX;
+    const vluint64_t startTicks = VL_RDTSC_Q();
+    for (unsigned ct = 0; ct < spinLimit; ++ct) {
+        VL_CPU_RELAX();
+        if (areUpstreamDepsDone(evenCycle)) {
+            if (statsp) {
+                statsp->m_spinTicks.fetch_add(VL_RDTSC_Q() - startTicks,
+                                              std::memory_order_relaxed);
+                // Spinning paid off, allow spinning longer next time
+                if (spinLimit < VlWaitStats::SPIN_MAX / 2) statsp->m_spinLimit = spinLimit * 2;
+            }
+            return;
+        }
+    }
+    const vluint64_t parkTicks = VL_RDTSC_Q();
+    park(evenCycle);
+    if (statsp) {
+        statsp->m_spinTicks.fetch_add(parkTicks - startTicks, std::memory_order_relaxed);
+        statsp->m_parkTicks.fetch_add(VL_RDTSC_Q() - parkTicks, std::memory_order_relaxed);
+        statsp->m_parks.fetch_add(1, std::memory_order_relaxed);
+        // Spinning was wasted, give up sooner next time
+        if (spinLimit > VlWaitStats::SPIN_MIN * 2) statsp->m_spinLimit = spinLimit / 2;
+    }
+}
+
+// The waiter publishes m_parked before its final check of the done count,
+// and signalUpstreamDone() updates the done count before checking
+// m_parked (all sequentially consistent), so either the waiter sees the
+// vertex is ready, or the last signaller sees the waiter and wakes it.
+#if defined(__linux)
+static_assert(sizeof(std::atomic<vluint32_t>) == sizeof(vluint32_t),
+              "futex requires plain 32-bit atomic");
+
+void VlMTaskVertex::park(bool evenCycle) {
+    vluint32_t* const addrp = reinterpret_cast<vluint32_t*>(&m_upstreamDepsDone);
+    const vluint32_t target = evenCycle ? m_upstreamDepCount : 0;
+    m_parked.store(true, std::memory_order_seq_cst);
+    while (true) {
+        const vluint32_t value = m_upstreamDepsDone.load(std::memory_order_seq_cst);
+        if (value == target) break;
+        // Returns at once if the done count is no longer 'value'
+        syscall(SYS_futex, addrp, FUTEX_WAIT_PRIVATE, value, nullptr, nullptr, 0);
+    }
+    m_parked.store(false, std::memory_order_relaxed);
+}
+
+void VlMTaskVertex::wakeParked() {
+    vluint32_t* const addrp = reinterpret_cast<vluint32_t*>(&m_upstreamDepsDone);
+    syscall(SYS_futex, addrp, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+#else
+void VlMTaskVertex::park(bool evenCycle) {
+    std::unique_lock<std::mutex> lk(s_parkMutex);
+    m_parked.store(true, std::memory_order_seq_cst);
+    while (!areUpstreamDepsDone(evenCycle)) s_parkCv.wait(lk);
+    m_parked.store(false, std::memory_order_relaxed);
+}
+
+void VlMTaskVertex::wakeParked() {
+    // Taking the mutex ensures the waiter is either not yet checking the
+    // done count, or is inside wait()
+    { const std::lock_guard<std::mutex> lk(s_parkMutex); }
+    s_parkCv.notify_all();
+}
+#endif
+
+//=============================================================================
+// VlWorkDeque
+
+static vlsint64_t workDequeMask(vluint32_t capacity) {
+    vlsint64_t size = 1;
+    while (size < capacity) size <<= 1;
+    return size - 1;
+}
+
+VlWorkDeque::VlWorkDeque(vluint32_t capacity)
+    : m_top{0}
+    , m_bottom{0}
+    , m_mask{workDequeMask(capacity)}
+    , m_itemsp{new std::atomic<VlExecFnp>[m_mask + 1]} {}
+
 //=============================================================================
 // VlWorkerThread
 
-VlWorkerThread::VlWorkerThread(VlThreadPool* poolp, VerilatedContext* contextp, bool profiling)
+VlWorkerThread::VlWorkerThread(VlThreadPool* poolp, int index, VerilatedContext* contextp,
+                               bool profiling)
     : m_poolp{poolp}
+    , m_index{index}
     , m_profiling{profiling}  // Must init this last -- after setting up fields that it might read:
     , m_exiting{false}
     , m_cthread{startWorker, this}
@@ -63,6 +168,8 @@ VlWorkerThread::~VlWorkerThread() {
 
 void VlWorkerThread::workerLoop() {
     if (VL_UNLIKELY(m_profiling)) m_poolp->setupProfilingClientThread();
+    VlThreadPool::t_dequeIndex = m_index;
+    VlMTaskVertex::waitStatsp(m_poolp->m_waitStats[m_index]);
 
     ExecRec work;
     work.m_fnp = nullptr;
@@ -91,7 +198,10 @@ void VlWorkerThread::startWorker(VlWorkerThread* workerp) {
 // VlThreadPool
 
 VlThreadPool::VlThreadPool(VerilatedContext* contextp, int nThreads, bool profiling)
-    : m_profiling{profiling} {
+    : m_profiling{profiling}
+    , m_dynRemaining{0}
+    , m_dynActive{0}
+    , m_steals{0} {
     // --threads N passes nThreads=N-1, as the "main" threads counts as 1
     unsigned cpus = std::thread::hardware_concurrency();
     if (cpus < nThreads + 1) {
@@ -102,9 +212,11 @@ VlThreadPool::VlThreadPool(VerilatedContext* contextp, int nThreads, bool profil
                          cpus, nThreads + 1);
         }
     }
+    // The eval thread's statistics are last
+    for (int i = 0; i < nThreads + 1; ++i) m_waitStats.push_back(new VlWaitStats);
     // Create'em
     for (int i = 0; i < nThreads; ++i) {
-        m_workers.push_back(new VlWorkerThread(this, contextp, profiling));
+        m_workers.push_back(new VlWorkerThread(this, i, contextp, profiling));
     }
     // Set up a profile buffer for the current thread too -- on the
     // assumption that it's the same thread that calls eval and may be
@@ -115,9 +227,69 @@ VlThreadPool::VlThreadPool(VerilatedContext* contextp, int nThreads, bool profil
 VlThreadPool::~VlThreadPool() {
     // Each ~WorkerThread will wait for its thread to exit.
     for (auto& i : m_workers) delete i;
+    for (auto& i : m_deques) delete i;
+    for (auto& i : m_waitStats) delete i;
     if (VL_UNLIKELY(m_profiling)) tearDownProfilingClientThread();
 }
 
+void VlThreadPool::setupDynamic(vluint32_t nMTasks) {
+    assert(m_deques.empty());
+    // The eval thread owns the last deque
+    for (int i = 0; i < numThreads() + 1; ++i) m_deques.push_back(new VlWorkDeque(nMTasks));
+}
+
+void VlThreadPool::executeDynamic(const VlExecFnp* rootsp, vluint32_t nRoots,
+                                  vluint32_t nMTasks, bool evenCycle, VlThrSymTab sym) {
+    assert(!m_deques.empty());
+    m_dynEvenCycle = evenCycle;
+    m_dynSym = sym;
+    m_dynRemaining.store(nMTasks, std::memory_order_relaxed);
+    // All workers left dynamicLoop() at the end of the previous eval, so
+    // it's safe to push onto their deques from here. Their addTask()
+    // below publishes these pushes.
+    const int nDeques = m_deques.size();
+    for (vluint32_t i = 0; i < nRoots; ++i) m_deques[i % nDeques]->push(rootsp[i]);
+    m_dynActive.store(numThreads(), std::memory_order_relaxed);
+    for (auto& workerp : m_workers) workerp->addTask(&dynamicEntry, evenCycle, this);
+    // The eval thread takes part as well
+    t_dequeIndex = numThreads();
+    dynamicLoop(numThreads());
+    // Don't return until the workers have stopped looking at this eval's state
+    while (VL_UNLIKELY(m_dynActive.load(std::memory_order_acquire))) VL_CPU_RELAX();
+}
+
+void VlThreadPool::dynamicEntry(bool, VlThrSymTab poolp) {
+    VlThreadPool* const selfp = static_cast<VlThreadPool*>(poolp);
+    selfp->dynamicLoop(t_dequeIndex);
+    selfp->m_dynActive.fetch_sub(1, std::memory_order_release);
+}
+
+void VlThreadPool::dynamicLoop(int index) {
+    const int nDeques = m_deques.size();
+    unsigned ct = 0;
+    while (m_dynRemaining.load(std::memory_order_acquire)) {
+        VlExecFnp fnp = m_deques[index]->take();
+        if (!fnp) {
+            // Own deque is empty, try to steal, starting with our neighbor
+            for (int i = 1; !fnp && i < nDeques; ++i) {
+                fnp = m_deques[(index + i) % nDeques]->steal();
+            }
+            if (fnp) ++m_steals;
+        }
+        if (VL_LIKELY(fnp)) {
+            fnp(m_dynEvenCycle, m_dynSym);
+            m_dynRemaining.fetch_sub(1, std::memory_order_acq_rel);
+            ct = 0;
+        } else {
+            VL_CPU_RELAX();
+            if (VL_UNLIKELY(++ct > VL_LOCK_SPINS)) {
+                ct = 0;
+                VlMTaskVertex::yieldThread();
+            }
+        }
+    }
+}
+
 void VlThreadPool::tearDownProfilingClientThread() {
     assert(t_profilep);
     delete t_profilep;
@@ -144,6 +316,12 @@ void VlThreadPool::profileAppendAll(const VlProfileRec& rec) VL_MT_SAFE_EXCLUDES
     }
 }
 
+void VlThreadPool::profileMTaskHash(vluint32_t mtaskId, const char* hashp)
+    VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lk(m_mutex);
+    m_mtaskHashes.emplace_back(mtaskId, hashp);
+}
+
 void VlThreadPool::profileDump(const char* filenamep, vluint64_t ticksElapsed)
     VL_MT_SAFE_EXCLUDES(m_mutex) {
     const VerilatedLockGuard lk(m_mutex);
@@ -165,6 +343,20 @@ void VlThreadPool::profileDump(const char* filenamep, vluint64_t ticksElapsed)
     fprintf(fp, "VLPROF arg +verilator+prof+threads+window+%u\n",
             Verilated::threadContextp()->profThreadsWindow());
     fprintf(fp, "VLPROF stat yields %" VL_PRI64 "u\n", VlMTaskVertex::yields());
+    if (!m_deques.empty()) fprintf(fp, "VLPROF stat steals %" VL_PRI64 "u\n", steals());
+    // Time waiting on upstream mtasks, the last thread is the eval thread
+    for (size_t i = 0; i < m_waitStats.size(); ++i) {
+        const VlWaitStats* const statsp = m_waitStats[i];
+        fprintf(fp,
+                "VLPROF wait thread %u spin %" VL_PRI64 "u park %" VL_PRI64 "u parks %" VL_PRI64
+                "u\n",
+                static_cast<unsigned>(i), statsp->m_spinTicks.load(std::memory_order_relaxed),
+                statsp->m_parkTicks.load(std::memory_order_relaxed),
+                statsp->m_parks.load(std::memory_order_relaxed));
+    }
+    for (const auto& it : m_mtaskHashes) {
+        fprintf(fp, "VLPROF mtask_hash %u %s\n", it.first, it.second);
+    }
 
     vluint32_t thread_id = 0;
     for (const auto& pi : m_allProfiles) {
@@ -55,10 +55,32 @@ using VlThrSymTab = void*;
 
 using VlExecFnp = void (*)(bool, VlThrSymTab);
 
+// clang-format off
+#ifndef VL_WAIT_SPINS
+# define VL_WAIT_SPINS VL_LOCK_SPINS  ///< Most spins waiting on an upstream mtask before parking
+#endif
+// clang-format on
+
+// Statistics of, and adaptive tuning for, one thread's waits on upstream
+// mtasks. Written only by the owning thread; relaxed atomics so the
+// profile dump may read them.
+class VlWaitStats final {
+public:
+    // Bounds of the adaptive spin limit
+    static constexpr unsigned SPIN_MIN = VL_WAIT_SPINS / 64;
+    static constexpr unsigned SPIN_MAX = VL_WAIT_SPINS;
+    // MEMBERS
+    std::atomic<vluint64_t> m_spinTicks{0};  // Ticks spent spinning
+    std::atomic<vluint64_t> m_parkTicks{0};  // Ticks spent parked
+    std::atomic<vluint64_t> m_parks{0};  // Number of times parked
+    unsigned m_spinLimit = SPIN_MAX;  // Spins before parking
+};
+
 // Track dependencies for a single MTask.
 class VlMTaskVertex final {
     // MEMBERS
     static std::atomic<vluint64_t> s_yields;  // Statistics
+    static VL_THREAD_LOCAL VlWaitStats* t_waitStatsp;  // Executing thread's statistics
 
     // On even cycles, _upstreamDepsDone increases as upstream
     // dependencies complete. When it reaches _upstreamDepCount,
@@ -78,6 +100,8 @@ class VlMTaskVertex final {
     // use 16-bit types here...)
     std::atomic<vluint32_t> m_upstreamDepsDone;
     const vluint32_t m_upstreamDepCount;
+    // The waiter has given up spinning, signallers must wake it
+    std::atomic<bool> m_parked;
 
 public:
     // CONSTRUCTORS
@@ -93,38 +117,46 @@ public:
         ++s_yields;  // Statistics
         std::this_thread::yield();
     }
+    // Set where the executing thread accumulates its wait statistics
+    static void waitStatsp(VlWaitStats* statsp) { t_waitStatsp = statsp; }
 
     // Upstream mtasks must call this when they complete.
     // Returns true when the current MTaskVertex becomes ready to execute,
     // false while it's still waiting on more dependencies.
+    // (Sequentially consistent, both as with dynamic scheduling the
+    // upstream mtask which readies this one goes on to hand it to another
+    // thread, and to order against the m_parked check.)
     inline bool signalUpstreamDone(bool evenCycle) {
+        bool ready;
         if (evenCycle) {
             vluint32_t upstreamDepsDone
-                = 1 + m_upstreamDepsDone.fetch_add(1, std::memory_order_release);
+                = 1 + m_upstreamDepsDone.fetch_add(1, std::memory_order_seq_cst);
             assert(upstreamDepsDone <= m_upstreamDepCount);
-            return (upstreamDepsDone == m_upstreamDepCount);
+            ready = (upstreamDepsDone == m_upstreamDepCount);
         } else {
             vluint32_t upstreamDepsDone_prev
-                = m_upstreamDepsDone.fetch_sub(1, std::memory_order_release);
+                = m_upstreamDepsDone.fetch_sub(1, std::memory_order_seq_cst);
             assert(upstreamDepsDone_prev > 0);
-            return (upstreamDepsDone_prev == 1);
+            ready = (upstreamDepsDone_prev == 1);
         }
+        if (ready && VL_UNLIKELY(m_parked.load(std::memory_order_seq_cst))) wakeParked();
+        return ready;
     }
     inline bool areUpstreamDepsDone(bool evenCycle) const {
         vluint32_t target = evenCycle ? m_upstreamDepCount : 0;
         return m_upstreamDepsDone.load(std::memory_order_acquire) == target;
     }
-    inline void waitUntilUpstreamDone(bool evenCycle) const {
-        unsigned ct = 0;
-        while (VL_UNLIKELY(!areUpstreamDepsDone(evenCycle))) {
-            VL_CPU_RELAX();
-            ++ct;
-            if (VL_UNLIKELY(ct > VL_LOCK_SPINS)) {
-                ct = 0;
-                yieldThread();
-            }
-        }
+    // Spin for a while, then park the thread until ready. Only the one
+    // thread about to run this mtask may wait on it.
+    inline void waitUntilUpstreamDone(bool evenCycle) {
+        if (VL_LIKELY(areUpstreamDepsDone(evenCycle))) return;
+        waitUntilUpstreamDoneSlow(evenCycle);
     }
+
+private:
+    void waitUntilUpstreamDoneSlow(bool evenCycle);
+    void park(bool evenCycle);
+    void wakeParked();
 };
 
 // Profiling support
@@ -170,6 +202,72 @@ public:
     }
 };
 
+// Work-stealing deque of ready mtasks, for --threads-schedule dynamic.
+// The owning thread pushes and takes at the bottom, other threads steal
+// from the top. This is the Chase-Lev deque, with the memory orderings of
+// Le et al., "Correct and Efficient Work-Stealing for Weak Memory Models".
+// The capacity is fixed; each mtask is pushed at most once per eval, so
+// sizing to the number of mtasks in the model is always sufficient.
+class VlWorkDeque final {
+    // MEMBERS
+    std::atomic<vlsint64_t> m_top;  // Next index to steal, written by thieves
+    char m_pad[VL_CACHE_LINE_BYTES];  // Keep owner and thieves off the same line
+    std::atomic<vlsint64_t> m_bottom;  // Next index to push, written by owner
+    const vlsint64_t m_mask;  // Capacity - 1, capacity is a power of two
+    std::atomic<VlExecFnp>* m_itemsp;  // Circular array of ready mtasks
+
+    VL_UNCOPYABLE(VlWorkDeque);
+
+public:
+    // CONSTRUCTORS
+    explicit VlWorkDeque(vluint32_t capacity);
+    ~VlWorkDeque() { delete[] m_itemsp; }
+
+    // METHODS
+    // Owner only: add a ready mtask
+    inline void push(VlExecFnp fnp) {
+        const vlsint64_t b = m_bottom.load(std::memory_order_relaxed);
+        m_itemsp[b & m_mask].store(fnp, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    // Owner only: remove the most recently pushed mtask, or nullptr if empty
+    inline VlExecFnp take() {
+        const vlsint64_t b = m_bottom.load(std::memory_order_relaxed) - 1;
+        m_bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        vlsint64_t t = m_top.load(std::memory_order_relaxed);
+        VlExecFnp fnp = nullptr;
+        if (t <= b) {
+            fnp = m_itemsp[b & m_mask].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Last item, race against thieves
+                if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed)) {
+                    fnp = nullptr;
+                }
+                m_bottom.store(b + 1, std::memory_order_relaxed);
+            }
+        } else {
+            m_bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return fnp;
+    }
+    // Any thread: remove the oldest mtask, or nullptr if empty or lost a race
+    inline VlExecFnp steal() {
+        vlsint64_t t = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const vlsint64_t b = m_bottom.load(std::memory_order_acquire);
+        if (t >= b) return nullptr;
+        VlExecFnp fnp = m_itemsp[t & m_mask].load(std::memory_order_relaxed);
+        if (!m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return fnp;
+    }
+};
+
 class VlThreadPool;
 
 class VlWorkerThread final {
@@ -203,6 +301,7 @@ private:
     std::atomic<size_t> m_ready_size;
 
     VlThreadPool* m_poolp;  // Our associated thread pool
+    int m_index;  // Our index in the thread pool
 
     bool m_profiling;  // Is profiling enabled?
     std::atomic<bool> m_exiting;  // Worker thread should exit
@@ -213,7 +312,7 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit VlWorkerThread(VlThreadPool* poolp, VerilatedContext* contextp, bool profiling);
+    VlWorkerThread(VlThreadPool* poolp, int index, VerilatedContext* contextp, bool profiling);
     ~VlWorkerThread();
 
     // METHODS
@@ -254,6 +353,7 @@ public:
 };
 
 class VlThreadPool final {
+    friend class VlWorkerThread;
     // TYPES
     using ProfileTrace = std::vector<VlProfileRec>;
 
@@ -271,6 +371,19 @@ class VlThreadPool final {
     static VL_THREAD_LOCAL ProfileTrace* t_profilep;
     std::set<ProfileTrace*> m_allProfiles VL_GUARDED_BY(m_mutex);
     VerilatedMutex m_mutex;
+    // Wait statistics, one per worker plus eval thread
+    std::vector<VlWaitStats*> m_waitStats;
+    // Mtask id and hash of its logic, for --prof-threads-data
+    std::vector<std::pair<vluint32_t, const char*>> m_mtaskHashes VL_GUARDED_BY(m_mutex);
+
+    // Dynamic scheduling (--threads-schedule dynamic) state, see executeDynamic()
+    std::vector<VlWorkDeque*> m_deques;  // Ready mtasks, one per worker plus eval thread
+    std::atomic<vluint32_t> m_dynRemaining;  // Mtasks not yet completed this eval
+    std::atomic<vluint32_t> m_dynActive;  // Workers not yet out of dynamicLoop()
+    bool m_dynEvenCycle = false;  // Even/odd for flag alternation, this eval
+    VlThrSymTab m_dynSym = nullptr;  // Symbol table to execute, this eval
+    std::atomic<vluint64_t> m_steals;  // Statistics
+    static VL_THREAD_LOCAL int t_dequeIndex;  // Deque owned by the executing thread
 
 public:
     // CONSTRUCTORS
@@ -291,7 +404,25 @@ public:
         t_profilep->emplace_back();
         return &(t_profilep->back());
     }
+    // The thread calling eval() must call this before running mtasks
+    inline void evalStart() { VlMTaskVertex::waitStatsp(m_waitStats.back()); }
+    // Dynamic scheduling: allocate the per-thread deques; 'nMTasks' is
+    // the total number of mtasks in the model.
+    void setupDynamic(vluint32_t nMTasks);
+    // Dynamic scheduling: run all 'nMTasks' mtasks of one eval, starting
+    // from the 'nRoots' mtasks in 'rootsp' which have no upstream
+    // dependencies. The calling thread participates, and this returns
+    // once every mtask has completed.
+    void executeDynamic(const VlExecFnp* rootsp, vluint32_t nRoots, vluint32_t nMTasks,
+                        bool evenCycle, VlThrSymTab sym);
+    // Dynamic scheduling: called by an mtask when it makes a downstream
+    // mtask ready to run
+    inline void pushReady(VlExecFnp fnp) { m_deques[t_dequeIndex]->push(fnp); }
+    vluint64_t steals() const { return m_steals; }
     void profileAppendAll(const VlProfileRec& rec) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Record the hash of an mtask's logic, for writing with the profile.
+    // 'hashp' must be a static string.
+    void profileMTaskHash(vluint32_t mtaskId, const char* hashp) VL_MT_SAFE_EXCLUDES(m_mutex);
     void profileDump(const char* filenamep, vluint64_t ticksElapsed) VL_MT_SAFE_EXCLUDES(m_mutex);
     // In profiling mode, each executing thread must call
     // this once to setup profiling state:
@@ -299,6 +430,9 @@ public:
     void tearDownProfilingClientThread();
 
 private:
+    static void dynamicEntry(bool, VlThrSymTab poolp);
+    void dynamicLoop(int index);
+
     VL_UNCOPYABLE(VlThreadPool);
 };
 
@@ -27,22 +27,53 @@
 #include "verilated.h"
 #include "verilated_trace_defs.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 
-#ifdef VL_TRACE_THREADED
+#ifdef VL_THREADED
+# include <atomic>
 # include <condition_variable>
-# include <deque>
+# include <memory>
 # include <thread>
 #endif
 
 // clang-format on
 
-#ifdef VL_TRACE_THREADED
+//=============================================================================
+// Trace commands
+
+// Commands used by thread tracing and the flight recorder. Anonymous enum in
+// class, as we want it scoped, but we also want the automatic conversion to
+// integer types.
+class VerilatedTraceCommand final {
+public:
+    // These must all fit in 4 bit at the moment, as the tracing routines
+    // pack parameters in the top bits.
+    enum : vluint8_t {
+        CHG_BIT_0 = 0x0,
+        CHG_BIT_1 = 0x1,
+        CHG_CDATA = 0x2,
+        CHG_SDATA = 0x3,
+        CHG_IDATA = 0x4,
+        CHG_QDATA = 0x5,
+        CHG_WDATA = 0x6,
+        CHG_DOUBLE = 0x8,
+        // TODO: full..
+        TIME_CHANGE = 0xd,
+        END = 0xe,  // End of buffer
+        SHUTDOWN = 0xf  // Shutdown worker thread, also marks end of buffer
+    };
+};
+
+#ifdef VL_THREADED
+class VlThreadPool;
+
 //=============================================================================
 // Threaded tracing
 
-// A simple synchronized first in first out queue
+// A simple synchronized first in first out queue, also used for
+// asynchronous file writes
 template <class T> class VerilatedThreadQueue final {  // LCOV_EXCL_LINE  // lcov bug
 private:
     VerilatedMutex m_mutex;  // Protects m_queue
@@ -83,28 +114,6 @@ public:
         return true;
     }
 };
-
-// Commands used by thread tracing. Anonymous enum in class, as we want
-// it scoped, but we also want the automatic conversion to integer types.
-class VerilatedTraceCommand final {
-public:
-    // These must all fit in 4 bit at the moment, as the tracing routines
-    // pack parameters in the top bits.
-    enum : vluint8_t {
-        CHG_BIT_0 = 0x0,
-        CHG_BIT_1 = 0x1,
-        CHG_CDATA = 0x2,
-        CHG_SDATA = 0x3,
-        CHG_IDATA = 0x4,
-        CHG_QDATA = 0x5,
-        CHG_WDATA = 0x6,
-        CHG_DOUBLE = 0x8,
-        // TODO: full..
-        TIME_CHANGE = 0xd,
-        END = 0xe,  // End of buffer
-        SHUTDOWN = 0xf  // Shutdown worker thread, also marks end of buffer
-    };
-};
 #endif
 
 //=============================================================================
@@ -146,6 +155,16 @@ private:
     std::vector<CallbackRecord> m_fullCbs;  // Routines to perform full dump
     std::vector<CallbackRecord> m_chgCbs;  // Routines to perform incremental dump
     std::vector<CallbackRecord> m_cleanupCbs;  // Routines to call at the end of dump
+    // Change checks of a block of signals, for --trace-activity-stats
+    struct ActivityStatsRecord {
+        std::string m_group;  // Activity flags of the block
+        vluint64_t* m_checksp;  // Number of times the block was checked
+        vluint32_t m_signals;  // Number of signals in the block
+        vluint32_t m_beginCode;  // First code of the block
+        vluint32_t m_endCode;  // One past the last code of the block
+    };
+    std::vector<ActivityStatsRecord> m_activityStats;  // Blocks registered
+    vluint64_t* m_changeCountsp;  // Changes found in each code, if m_activityStats
     bool m_fullDump;  // Whether a full dump is required on the next call to 'dump'
     vluint32_t m_nextCode;  // Next code number to assign
     vluint32_t m_numSignals;  // Number of distinct signals
@@ -167,6 +186,37 @@ private:
     // Close the file on termination
     static void onExit(void* selfp) VL_MT_UNSAFE_ONE;
 
+    // Print the --trace-activity-stats report
+    void activityStatsReport();
+
+    // Flight recorder, keeping only the most recent dumps in memory.  Dumps
+    // are recorded as VerilatedTraceCommand sequences, as in the buffers of
+    // threaded tracing, in segments each starting with a full dump, so the
+    // oldest segment may be discarded once the newer ones hold enough dumps.
+    struct RecordSegment {
+        std::vector<vluint32_t> m_cmds;  // Recorded commands
+        std::vector<size_t> m_dumps;  // Index in m_cmds of each dump's TIME_CHANGE
+    };
+    enum ReplayMode : vluint8_t {
+        REPLAY_APPLY,  // Copy values into the state
+        REPLAY_EMIT,  // Emit time changes and values
+        REPLAY_EMIT_STATE  // Emit values of the recorded signals from the state
+    };
+    vluint32_t m_recordDumps;  // Number of dumps to keep, 0 if not recording
+    vluint32_t m_recordSinceFull;  // Dumps since the last full dump
+    size_t m_recordedDumps;  // Number of dumps in m_recordSegments
+    std::deque<RecordSegment> m_recordSegments;  // Segments, oldest first
+    RecordSegment m_recordSpare;  // Discarded segment, to reuse its memory
+    std::vector<vluint32_t>* m_recordp;  // Commands of newest segment, or nullptr
+
+    // Emit the time change, or record it when recording
+    void timeChange(vluint64_t timeui, bool full);
+    void recordTimeChange(vluint64_t timeui, bool full);
+    void recordChange(vluint32_t cmd, const vluint32_t* oldp, int words);
+    void replayRecords(const vluint32_t* readp, const vluint32_t* endp, vluint32_t* statep,
+                       ReplayMode mode);
+    void clearRecording();
+
 #ifdef VL_TRACE_THREADED
     // Number of total trace buffers that have been allocated
     vluint32_t m_numTraceBuffers;
@@ -182,11 +232,31 @@ private:
     // Get a new trace buffer that can be populated. May block if none available
     vluint32_t* getTraceBuffer();
 
-    // Write pointer into current buffer
-    vluint32_t* m_traceBufferWritep;
+    // Write pointer into current buffer of the executing thread
+    static VL_THREAD_LOCAL vluint32_t* t_traceBufferWritep;
+
+    // End of trace buffer of the executing thread
+    static VL_THREAD_LOCAL vluint32_t* t_traceBufferEndp;
 
-    // End of trace buffer
-    vluint32_t* m_traceBufferEndp;
+    // Thread pool running the change callbacks in parallel, or nullptr
+    VlThreadPool* m_threadPoolp;
+
+    // A change callback run on the thread pool, filling its own buffer
+    struct ParallelChgTask {
+        VerilatedTrace* m_selfp;  // Trace file being dumped
+        const CallbackRecord* m_cbrp;  // Callback to run
+        vluint32_t* m_bufferp;  // Buffer to fill
+        std::atomic<bool> m_done;  // Callback has completed
+    };
+    std::unique_ptr<ParallelChgTask[]> m_parallelTasksp;  // One per m_chgCbs
+
+    // Buffers filled by parallel change callbacks, to pass to the worker after
+    // the current buffer, in callback, and hence signal code order
+    std::vector<vluint32_t*> m_parallelBuffers;
+
+    // Run the change callbacks on the thread pool
+    void runParallelChgCbs();
+    static void parallelChgTask(bool, void* taskp);
 
     // The worker thread itself
     std::unique_ptr<std::thread> m_workerThread;
@@ -261,6 +331,11 @@ public:
     // Call
     void dump(vluint64_t timeui) VL_MT_SAFE_EXCLUDES(m_mutex);
 
+    // Keep only the last 'dumps' dumps in memory, 0 to write all dumps
+    void flightRecorder(vluint32_t dumps) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Write the dumps kept by the flight recorder
+    void flightRecorderWrite() VL_MT_SAFE_EXCLUDES(m_mutex);
+
     //=========================================================================
     // Non-hot path internal interface to Verilator generated code
 
@@ -268,9 +343,16 @@ public:
     void addFullCb(dumpCb_t cb, void* userp) VL_MT_SAFE;
     void addChgCb(dumpCb_t cb, void* userp) VL_MT_SAFE;
     void addCleanupCb(dumpCb_t cb, void* userp) VL_MT_SAFE;
+    // Called from init callbacks, with --trace-activity-stats
+    void addActivityStats(const char* groupp, vluint64_t* checksp, vluint32_t signals,
+                          vluint32_t beginCode, vluint32_t endCode) VL_MT_UNSAFE;
 
     void module(const std::string& name) VL_MT_UNSAFE;
     void scopeEscape(char flag) { m_scopeEscape = flag; }
+#ifdef VL_TRACE_THREADED
+    // Run the change callbacks on the given thread pool, see runParallelChgCbs
+    void threadPool(VlThreadPool* poolp) VL_MT_UNSAFE { m_threadPoolp = poolp; }
+#endif
 
     //=========================================================================
     // Hot path internal interface to Verilator generated code
@@ -303,53 +385,55 @@ public:
 #ifdef VL_TRACE_THREADED
     // Threaded tracing. Just dump everything in the trace buffer
     inline void chgBit(vluint32_t code, CData newval) {
-        m_traceBufferWritep[0] = VerilatedTraceCommand::CHG_BIT_0 | newval;
-        m_traceBufferWritep[1] = code;
-        m_traceBufferWritep += 2;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = VerilatedTraceCommand::CHG_BIT_0 | newval;
+        t_traceBufferWritep[1] = code;
+        t_traceBufferWritep += 2;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgCData(vluint32_t code, CData newval, int bits) {
-        m_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_CDATA;
-        m_traceBufferWritep[1] = code;
-        m_traceBufferWritep[2] = newval;
-        m_traceBufferWritep += 3;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_CDATA;
+        t_traceBufferWritep[1] = code;
+        t_traceBufferWritep[2] = newval;
+        t_traceBufferWritep += 3;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgSData(vluint32_t code, SData newval, int bits) {
-        m_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_SDATA;
-        m_traceBufferWritep[1] = code;
-        m_traceBufferWritep[2] = newval;
-        m_traceBufferWritep += 3;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_SDATA;
+        t_traceBufferWritep[1] = code;
+        t_traceBufferWritep[2] = newval;
+        t_traceBufferWritep += 3;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgIData(vluint32_t code, IData newval, int bits) {
-        m_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_IDATA;
-        m_traceBufferWritep[1] = code;
-        m_traceBufferWritep[2] = newval;
-        m_traceBufferWritep += 3;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_IDATA;
+        t_traceBufferWritep[1] = code;
+        t_traceBufferWritep[2] = newval;
+        t_traceBufferWritep += 3;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgQData(vluint32_t code, QData newval, int bits) {
-        m_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_QDATA;
-        m_traceBufferWritep[1] = code;
-        *reinterpret_cast<QData*>(m_traceBufferWritep + 2) = newval;
-        m_traceBufferWritep += 4;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_QDATA;
+        t_traceBufferWritep[1] = code;
+        *reinterpret_cast<QData*>(t_traceBufferWritep + 2) = newval;
+        t_traceBufferWritep += 4;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgWData(vluint32_t code, const WData* newvalp, int bits) {
-        m_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_WDATA;
-        m_traceBufferWritep[1] = code;
-        m_traceBufferWritep += 2;
-        for (int i = 0; i < (bits + 31) / 32; ++i) { *m_traceBufferWritep++ = newvalp[i]; }
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        t_traceBufferWritep[0] = (bits << 4) | VerilatedTraceCommand::CHG_WDATA;
+        t_traceBufferWritep[1] = code;
+        t_traceBufferWritep += 2;
+        EData* const wp = reinterpret_cast<EData*>(t_traceBufferWritep);
+        for (int i = 0; i < VL_WORDS_I(bits); ++i) wp[i] = newvalp[i];
+        t_traceBufferWritep += VL_WORDS_I(bits) * (VL_EDATASIZE / 32);
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
     inline void chgDouble(vluint32_t code, double newval) {
-        m_traceBufferWritep[0] = VerilatedTraceCommand::CHG_DOUBLE;
-        m_traceBufferWritep[1] = code;
+        t_traceBufferWritep[0] = VerilatedTraceCommand::CHG_DOUBLE;
+        t_traceBufferWritep[1] = code;
         // cppcheck-suppress invalidPointerCast
-        *reinterpret_cast<double*>(m_traceBufferWritep + 2) = newval;
-        m_traceBufferWritep += 4;
-        VL_DEBUG_IF(assert(m_traceBufferWritep <= m_traceBufferEndp););
+        *reinterpret_cast<double*>(t_traceBufferWritep + 2) = newval;
+        t_traceBufferWritep += 4;
+        VL_DEBUG_IF(assert(t_traceBufferWritep <= t_traceBufferEndp););
     }
 
 #define CHG(name) chg##name##Impl
@@ -357,6 +441,11 @@ public:
 #define CHG(name) chg##name
 #endif
 
+    // Count a change found, for --trace-activity-stats
+    inline void countChange(const vluint32_t* oldp) {
+        if (VL_UNLIKELY(m_changeCountsp)) ++m_changeCountsp[oldp - m_sigs_oldvalp];
+    }
+
     // In non-threaded mode, these are called directly by the trace callbacks,
     // and are called chg*. In threaded mode, they are called by the worker
     // thread and are called chg*Impl
@@ -364,27 +453,45 @@ public:
     // Check previous dumped value of signal. If changed, then emit trace entry
     inline void CHG(Bit)(vluint32_t* oldp, CData newval) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullBit(oldp, newval);
+        if (VL_UNLIKELY(diff)) {
+            countChange(oldp);
+            fullBit(oldp, newval);
+        }
     }
     inline void CHG(CData)(vluint32_t* oldp, CData newval, int bits) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullCData(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            countChange(oldp);
+            fullCData(oldp, newval, bits);
+        }
     }
     inline void CHG(SData)(vluint32_t* oldp, SData newval, int bits) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullSData(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            countChange(oldp);
+            fullSData(oldp, newval, bits);
+        }
     }
     inline void CHG(IData)(vluint32_t* oldp, IData newval, int bits) {
         const vluint32_t diff = *oldp ^ newval;
-        if (VL_UNLIKELY(diff)) fullIData(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            countChange(oldp);
+            fullIData(oldp, newval, bits);
+        }
     }
     inline void CHG(QData)(vluint32_t* oldp, QData newval, int bits) {
         const vluint64_t diff = *reinterpret_cast<QData*>(oldp) ^ newval;
-        if (VL_UNLIKELY(diff)) fullQData(oldp, newval, bits);
+        if (VL_UNLIKELY(diff)) {
+            countChange(oldp);
+            fullQData(oldp, newval, bits);
+        }
     }
     inline void CHG(WData)(vluint32_t* oldp, const WData* newvalp, int bits) {
-        for (int i = 0; i < (bits + 31) / 32; ++i) {
-            if (VL_UNLIKELY(oldp[i] ^ newvalp[i])) {
+        // Old value takes VL_EDATASIZE / 32 codes per word
+        const EData* const oldwp = reinterpret_cast<const EData*>(oldp);
+        for (int i = 0; i < VL_WORDS_I(bits); ++i) {
+            if (VL_UNLIKELY(oldwp[i] ^ newvalp[i])) {
+                countChange(oldp);
                 fullWData(oldp, newvalp, bits);
                 return;
             }
@@ -392,9 +499,20 @@ public:
     }
     inline void CHG(Double)(vluint32_t* oldp, double newval) {
         // cppcheck-suppress invalidPointerCast
-        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) fullDouble(oldp, newval);
+        if (VL_UNLIKELY(*reinterpret_cast<double*>(oldp) != newval)) {
+            countChange(oldp);
+            fullDouble(oldp, newval);
+        }
     }
 
 #undef CHG
 };
+
+#ifdef VL_TRACE_THREADED
+template <class T_Derived>
+VL_THREAD_LOCAL vluint32_t* VerilatedTrace<T_Derived>::t_traceBufferWritep = nullptr;
+template <class T_Derived>
+VL_THREAD_LOCAL vluint32_t* VerilatedTrace<T_Derived>::t_traceBufferEndp = nullptr;
+#endif
+
 #endif  // guard
@@ -30,6 +30,12 @@
 
 #include "verilated_intrinsics.h"
 #include "verilated_trace.h"
+#ifdef VL_TRACE_THREADED
+# include "verilated_threads.h"
+#endif
+
+#include <algorithm>
+#include <map>
 
 #if 0
 # include <iostream>
@@ -78,6 +84,122 @@ static std::string doubleToTimescale(double value) {
     return valuestr;  // Gets converted to string, so no ref to stack
 }
 
+//=============================================================================
+// Flight recorder
+
+template <> void VerilatedTrace<VL_DERIVED_T>::recordTimeChange(vluint64_t timeui, bool full) {
+    if (full || !m_recordp) {
+        // Start a new segment, reusing the memory of a discarded one
+        m_recordSegments.push_back(std::move(m_recordSpare));
+        m_recordSpare = RecordSegment{};
+        m_recordSegments.back().m_cmds.clear();
+        m_recordSegments.back().m_dumps.clear();
+        m_recordp = &m_recordSegments.back().m_cmds;
+    }
+    m_recordSegments.back().m_dumps.push_back(m_recordp->size());
+    m_recordp->push_back(VerilatedTraceCommand::TIME_CHANGE);
+    m_recordp->push_back(static_cast<vluint32_t>(timeui));
+    m_recordp->push_back(static_cast<vluint32_t>(timeui >> 32ULL));
+    ++m_recordedDumps;
+    // Discard the oldest segment once the newer ones hold enough dumps
+    while (m_recordSegments.size() > 1
+           && m_recordedDumps - m_recordSegments.front().m_dumps.size() >= m_recordDumps) {
+        m_recordedDumps -= m_recordSegments.front().m_dumps.size();
+        m_recordSpare = std::move(m_recordSegments.front());
+        m_recordSegments.pop_front();
+    }
+}
+
+template <> void VerilatedTrace<VL_DERIVED_T>::timeChange(vluint64_t timeui, bool full) {
+    if (VL_UNLIKELY(m_recordDumps)) {
+        recordTimeChange(timeui, full);
+    } else {
+        emitTimeChange(timeui);
+    }
+}
+
+template <>
+void VerilatedTrace<VL_DERIVED_T>::recordChange(vluint32_t cmd, const vluint32_t* oldp,
+                                                int words) {
+    // Same layout as the threaded tracing buffers, the value follows the code
+    m_recordp->push_back(cmd);
+    m_recordp->push_back(static_cast<vluint32_t>(oldp - m_sigs_oldvalp));
+    m_recordp->insert(m_recordp->end(), oldp, oldp + words);
+}
+
+template <>
+void VerilatedTrace<VL_DERIVED_T>::replayRecords(const vluint32_t* readp, const vluint32_t* endp,
+                                                 vluint32_t* statep, ReplayMode mode) {
+    while (readp < endp) {
+        vluint32_t cmd = readp[0];
+        if ((cmd & 0xF) == VerilatedTraceCommand::TIME_CHANGE) {
+            if (mode == REPLAY_EMIT) {
+                emitTimeChange((static_cast<vluint64_t>(readp[2]) << 32ULL) | readp[1]);
+            }
+            readp += 3;
+            continue;
+        }
+        const vluint32_t code = readp[1];
+        const int bits = cmd >> 4;
+        const vluint32_t* valp = readp + 2;
+        int words = 0;
+        switch (cmd & 0xF) {
+        case VerilatedTraceCommand::CHG_BIT_0:  // FALLTHRU
+        case VerilatedTraceCommand::CHG_BIT_1: words = 0; break;
+        case VerilatedTraceCommand::CHG_CDATA:  // FALLTHRU
+        case VerilatedTraceCommand::CHG_SDATA:  // FALLTHRU
+        case VerilatedTraceCommand::CHG_IDATA: words = 1; break;
+        case VerilatedTraceCommand::CHG_QDATA:  // FALLTHRU
+        case VerilatedTraceCommand::CHG_DOUBLE: words = 2; break;
+        case VerilatedTraceCommand::CHG_WDATA:
+            words = VL_WORDS_I(bits) * (VL_EDATASIZE / 32);
+            break;
+        default:  // LCOV_EXCL_START
+            VL_FATAL_MT(__FILE__, __LINE__, "", "Internal: Unknown recorded trace command");
+            return;
+        }  // LCOV_EXCL_STOP
+        readp = valp + words;
+        if (mode == REPLAY_APPLY) {
+            // Bit values are held in the command
+            if (!words) {
+                statep[code] = cmd & 1;
+            } else {
+                std::copy(valp, readp, statep + code);
+            }
+            continue;
+        }
+        if (mode == REPLAY_EMIT_STATE) {
+            valp = statep + code;
+            if (!words) cmd = VerilatedTraceCommand::CHG_BIT_0 | (*valp & 1);
+        }
+        switch (cmd & 0xF) {
+        case VerilatedTraceCommand::CHG_BIT_0: self()->emitBit(code, 0); break;
+        case VerilatedTraceCommand::CHG_BIT_1: self()->emitBit(code, 1); break;
+        case VerilatedTraceCommand::CHG_CDATA: self()->emitCData(code, *valp, bits); break;
+        case VerilatedTraceCommand::CHG_SDATA: self()->emitSData(code, *valp, bits); break;
+        case VerilatedTraceCommand::CHG_IDATA: self()->emitIData(code, *valp, bits); break;
+        case VerilatedTraceCommand::CHG_QDATA:
+            self()->emitQData(code, *reinterpret_cast<const QData*>(valp), bits);
+            break;
+        case VerilatedTraceCommand::CHG_WDATA:
+            self()->emitWData(code, reinterpret_cast<const WData*>(valp), bits);
+            break;
+        case VerilatedTraceCommand::CHG_DOUBLE:
+            // cppcheck-suppress invalidPointerCast
+            self()->emitDouble(code, *reinterpret_cast<const double*>(valp));
+            break;
+        }
+    }
+}
+
+template <> void VerilatedTrace<VL_DERIVED_T>::clearRecording() {
+    // Keep the newest segment's memory for reuse
+    if (!m_recordSegments.empty()) m_recordSpare = std::move(m_recordSegments.back());
+    m_recordSegments.clear();
+    m_recordedDumps = 0;
+    m_recordp = nullptr;
+}
+
 #ifdef VL_TRACE_THREADED
 //=========================================================================
 // Buffer management
@@ -85,8 +207,10 @@ static std::string doubleToTimescale(double value) {
 template <> vluint32_t* VerilatedTrace<VL_DERIVED_T>::getTraceBuffer() {
     vluint32_t* bufferp;
     // Some jitter is expected, so some number of alternative trace buffers are
-    // required, but don't allocate more than 8 buffers.
-    if (m_numTraceBuffers < 8) {
+    // required, but don't allocate more than 8 buffers, or when the change
+    // callbacks run in parallel, enough for two dumps with a buffer each.
+    const size_t maxTraceBuffers = m_parallelTasksp ? std::max<size_t>(8, 2 * m_chgCbs.size()) : 8;
+    if (m_numTraceBuffers < maxTraceBuffers) {
         // Allocate a new buffer if none is available
         if (!m_buffersFromWorker.tryGet(bufferp)) {
             ++m_numTraceBuffers;
@@ -173,8 +297,8 @@ template <> void VerilatedTrace<VL_DERIVED_T>::workerThreadMain() {
                 continue;
             case VerilatedTraceCommand::CHG_WDATA:
                 VL_TRACE_THREAD_DEBUG("Command CHG_WDATA " << top);
-                chgWDataImpl(oldp, readp, top);
-                readp += VL_WORDS_I(top);
+                chgWDataImpl(oldp, reinterpret_cast<const WData*>(readp), top);
+                readp += VL_WORDS_I(top) * (VL_EDATASIZE / 32);
                 continue;
             case VerilatedTraceCommand::CHG_DOUBLE:
                 VL_TRACE_THREAD_DEBUG("Command CHG_DOUBLE " << top);
@@ -187,7 +311,7 @@ template <> void VerilatedTrace<VL_DERIVED_T>::workerThreadMain() {
             case VerilatedTraceCommand::TIME_CHANGE:
                 VL_TRACE_THREAD_DEBUG("Command TIME_CHANGE " << top);
                 readp -= 1;  // No code in this command, undo increment
-                emitTimeChange(*reinterpret_cast<const vluint64_t*>(readp));
+                timeChange(*reinterpret_cast<const vluint64_t*>(readp), false);
                 readp += 2;
                 continue;
 
@@ -221,6 +345,62 @@ template <> void VerilatedTrace<VL_DERIVED_T>::workerThreadMain() {
     } while (VL_LIKELY(!shutdown));
 }
 
+//=========================================================================
+// Parallel change callbacks
+
+template <> void VerilatedTrace<VL_DERIVED_T>::parallelChgTask(bool, void* taskp) {
+    ParallelChgTask* const tp = static_cast<ParallelChgTask*>(taskp);
+    VerilatedTrace<VL_DERIVED_T>* const selfp = tp->m_selfp;
+    t_traceBufferWritep = tp->m_bufferp;
+    t_traceBufferEndp = tp->m_bufferp + selfp->m_traceBufferSize;
+    tp->m_cbrp->m_dumpCb(tp->m_cbrp->m_userp, selfp->self());
+    // Mark end of the trace buffer we just filled
+    *t_traceBufferWritep++ = VerilatedTraceCommand::END;
+    assert(static_cast<size_t>(t_traceBufferWritep - tp->m_bufferp)
+           <= selfp->m_traceBufferSize);
+    tp->m_done.store(true, std::memory_order_release);
+}
+
+template <> void VerilatedTrace<VL_DERIVED_T>::runParallelChgCbs() {
+    // Verilator splits the change callbacks so each dumps a similar number
+    // of signal codes, in ascending code order.  Each callback fills its own
+    // buffer, and as the first continues the current buffer, passing the
+    // rest to the worker thread in callback order keeps the trace in signal
+    // code order.  The eval thread runs the callbacks the pool's workers don't.
+    const unsigned threads = m_threadPoolp->numThreads() + 1;
+    for (vluint32_t i = 1; i < m_chgCbs.size(); ++i) {
+        ParallelChgTask& task = m_parallelTasksp[i];
+        task.m_bufferp = getTraceBuffer();
+        task.m_done.store(false, std::memory_order_relaxed);
+        if (const unsigned rem = i % threads) {
+            m_threadPoolp->workerp(rem - 1)->addTask(&parallelChgTask, false, &task);
+        }
+    }
+    // The first callback continues the current buffer
+    m_chgCbs[0].m_dumpCb(m_chgCbs[0].m_userp, self());
+    // The tasks run here redirect this thread's buffer pointers, so restore
+    // them after, for dump() to end the current buffer
+    vluint32_t* const writep = t_traceBufferWritep;
+    vluint32_t* const endp = t_traceBufferEndp;
+    for (vluint32_t i = threads; i < m_chgCbs.size(); i += threads) {
+        parallelChgTask(false, &m_parallelTasksp[i]);
+    }
+    t_traceBufferWritep = writep;
+    t_traceBufferEndp = endp;
+    // Wait for the workers
+    for (vluint32_t i = 1; i < m_chgCbs.size(); ++i) {
+        ParallelChgTask& task = m_parallelTasksp[i];
+        for (unsigned ct = 0; VL_UNLIKELY(!task.m_done.load(std::memory_order_acquire)); ++ct) {
+            if (VL_UNLIKELY(ct > VL_LOCK_SPINS)) {
+                ct = 0;
+                std::this_thread::yield();
+            }
+            VL_CPU_RELAX();
+        }
+        m_parallelBuffers.push_back(task.m_bufferp);
+    }
+}
+
 template <> void VerilatedTrace<VL_DERIVED_T>::shutdownWorker() {
     // If the worker thread is not running, done..
     if (!m_workerThread) return;
@@ -241,6 +421,36 @@ template <> void VerilatedTrace<VL_DERIVED_T>::shutdownWorker() {
 //=============================================================================
 // Life cycle
 
+template <> void VerilatedTrace<VL_DERIVED_T>::activityStatsReport() {
+    // Sum the blocks of each group, in order of first registration
+    struct GroupStats {
+        vluint64_t m_signals = 0;
+        vluint64_t m_checked = 0;
+        vluint64_t m_changed = 0;
+    };
+    std::vector<std::string> order;
+    std::map<std::string, GroupStats> groups;
+    for (const ActivityStatsRecord& rec : m_activityStats) {
+        if (groups.find(rec.m_group) == groups.end()) order.push_back(rec.m_group);
+        GroupStats& stats = groups[rec.m_group];
+        stats.m_signals += rec.m_signals;
+        stats.m_checked += *rec.m_checksp * rec.m_signals;
+        for (vluint32_t code = rec.m_beginCode; code < rec.m_endCode; ++code) {
+            stats.m_changed += m_changeCountsp[code];
+        }
+    }
+    VL_PRINTF_MT("Trace activity statistics, signals checked for changes per activity group:\n");
+    VL_PRINTF_MT("  %-20s %10s %16s %16s %9s\n", "Group", "Signals", "Checked", "Changed",
+                 "Changed%");
+    for (const std::string& group : order) {
+        const GroupStats& stats = groups[group];
+        const double pct = stats.m_checked ? 100.0 * stats.m_changed / stats.m_checked : 0.0;
+        VL_PRINTF_MT("  %-20s %10" VL_PRI64 "u %16" VL_PRI64 "u %16" VL_PRI64 "u %8.2f%%\n",
+                     group.c_str(), stats.m_signals, stats.m_checked, stats.m_changed, pct);
+    }
+    m_activityStats.clear();
+}
+
 template <> void VerilatedTrace<VL_DERIVED_T>::closeBase() {
 #ifdef VL_TRACE_THREADED
     shutdownWorker();
@@ -249,6 +459,10 @@ template <> void VerilatedTrace<VL_DERIVED_T>::closeBase() {
         m_numTraceBuffers--;
     }
 #endif
+    // All changes have been found, so report
+    if (VL_UNLIKELY(!m_activityStats.empty())) activityStatsReport();
+    // Dumps not written by now are discarded
+    clearRecording();
 }
 
 template <> void VerilatedTrace<VL_DERIVED_T>::flushBase() {
@@ -267,8 +481,14 @@ template <> void VerilatedTrace<VL_DERIVED_T>::flushBase() {
 // Callbacks to run on global events
 
 template <> void VerilatedTrace<VL_DERIVED_T>::onFlush(void* selfp) {
+    VL_DERIVED_T* const tracep = reinterpret_cast<VL_DERIVED_T*>(selfp);
+    // Flushes due to $stop, $fatal or a failed assertion write the flight recording
+    if (VL_UNLIKELY(tracep->m_recordDumps)) {
+        const VerilatedContext* const contextp = Verilated::threadContextp();
+        if (contextp->gotError() || contextp->errorCount()) tracep->flightRecorderWrite();
+    }
     // This calls 'flush' on the derived classo (which must then get any mutex)
-    reinterpret_cast<VL_DERIVED_T*>(selfp)->flush();
+    tracep->flush();
 }
 
 template <> void VerilatedTrace<VL_DERIVED_T>::onExit(void* selfp) {
@@ -283,17 +503,23 @@ template <>
 VerilatedTrace<VL_DERIVED_T>::VerilatedTrace()
     : m_sigs_oldvalp{nullptr}
     , m_timeLastDump{0}
+    , m_changeCountsp{nullptr}
     , m_fullDump{true}
     , m_nextCode{0}
     , m_numSignals{0}
     , m_maxBits{0}
     , m_scopeEscape{'.'}
     , m_timeRes{1e-9}
-    , m_timeUnit {
-    1e-9
+    , m_timeUnit{1e-9}
+    , m_recordDumps{0}
+    , m_recordSinceFull{0}
+    , m_recordedDumps{0}
+    , m_recordp {
+    nullptr
 }
 #ifdef VL_TRACE_THREADED
-, m_numTraceBuffers { 0 }
+, m_numTraceBuffers{0}
+, m_threadPoolp { nullptr }
 #endif
 {
     set_time_unit(Verilated::threadContextp()->timeunitString());
@@ -302,6 +528,7 @@ VerilatedTrace<VL_DERIVED_T>::VerilatedTrace()
 
 template <> VerilatedTrace<VL_DERIVED_T>::~VerilatedTrace() {
     if (m_sigs_oldvalp) VL_DO_CLEAR(delete[] m_sigs_oldvalp, m_sigs_oldvalp = nullptr);
+    if (m_changeCountsp) VL_DO_CLEAR(delete[] m_changeCountsp, m_changeCountsp = nullptr);
     Verilated::removeFlushCb(VerilatedTrace<VL_DERIVED_T>::onFlush, this);
     Verilated::removeExitCb(VerilatedTrace<VL_DERIVED_T>::onExit, this);
 #ifdef VL_TRACE_THREADED
@@ -320,6 +547,7 @@ template <> void VerilatedTrace<VL_DERIVED_T>::traceInit() VL_MT_UNSAFE {
     m_nextCode = 1;
     m_numSignals = 0;
     m_maxBits = 0;
+    m_activityStats.clear();
 
     // Call all initialize callbacks, which will:
     // - Call decl* for each signal
@@ -338,6 +566,12 @@ template <> void VerilatedTrace<VL_DERIVED_T>::traceInit() VL_MT_UNSAFE {
     // holding previous signal values.
     if (!m_sigs_oldvalp) m_sigs_oldvalp = new vluint32_t[nextCode()];
 
+    // The init callbacks registered any --trace-activity-stats blocks
+    if (!m_activityStats.empty()) {
+        if (!m_changeCountsp) m_changeCountsp = new vluint64_t[nextCode()];
+        std::fill(m_changeCountsp, m_changeCountsp + nextCode(), 0);
+    }
+
     // Set callback so flush/abort will flush this file
     Verilated::addFlushCb(VerilatedTrace<VL_DERIVED_T>::onFlush, this);
     Verilated::addExitCb(VerilatedTrace<VL_DERIVED_T>::onExit, this);
@@ -350,6 +584,16 @@ template <> void VerilatedTrace<VL_DERIVED_T>::traceInit() VL_MT_UNSAFE {
     // update.
     m_traceBufferSize = nextCode() + numSignals() * 2 + 4;
 
+    // Set up the change callbacks to run in parallel, if possible
+    if (m_threadPoolp && m_threadPoolp->numThreads() && m_chgCbs.size() > 1
+        && !m_parallelTasksp) {
+        m_parallelTasksp.reset(new ParallelChgTask[m_chgCbs.size()]);
+        for (vluint32_t i = 0; i < m_chgCbs.size(); ++i) {
+            m_parallelTasksp[i].m_selfp = this;
+            m_parallelTasksp[i].m_cbrp = &m_chgCbs[i];
+        }
+    }
+
     // Start the worker thread
     m_workerThread.reset(new std::thread(&VerilatedTrace<VL_DERIVED_T>::workerThreadMain, this));
 #endif
@@ -362,7 +606,8 @@ void VerilatedTrace<VL_DERIVED_T>::declCode(vluint32_t code, vluint32_t bits, bo
     }
     // Note: The tri-state flag is not used by Verilator, but is here for
     // compatibility with some foreign code.
-    int codesNeeded = VL_WORDS_I(bits);
+    // Wide values take VL_EDATASIZE / 32 codes per word
+    int codesNeeded = VL_WORDS_I(bits) * (VL_EDATASIZE / 32);
     if (tri) codesNeeded *= 2;
     m_nextCode = std::max(m_nextCode, code + codesNeeded);
     ++m_numSignals;
@@ -409,6 +654,12 @@ void VerilatedTrace<VL_DERIVED_T>::dump(vluint64_t timeui) VL_MT_SAFE_EXCLUDES(m
 
     Verilated::quiesce();
 
+    // The flight recorder starts a segment with a full dump every m_recordDumps dumps
+    if (VL_UNLIKELY(m_recordDumps)) {
+        if (m_recordSinceFull >= m_recordDumps) m_fullDump = true;
+        m_recordSinceFull = m_fullDump ? 1 : m_recordSinceFull + 1;
+    }
+
     // Call hook for format specific behaviour
     if (VL_UNLIKELY(m_fullDump)) {
         if (!preFullDump()) return;
@@ -422,21 +673,21 @@ void VerilatedTrace<VL_DERIVED_T>::dump(vluint64_t timeui) VL_MT_SAFE_EXCLUDES(m
     if (VL_LIKELY(!m_fullDump)) {
         // Get the trace buffer we are about to fill
         bufferp = getTraceBuffer();
-        m_traceBufferWritep = bufferp;
-        m_traceBufferEndp = bufferp + m_traceBufferSize;
+        t_traceBufferWritep = bufferp;
+        t_traceBufferEndp = bufferp + m_traceBufferSize;
 
         // Tell worker to update time point
-        m_traceBufferWritep[0] = VerilatedTraceCommand::TIME_CHANGE;
-        *reinterpret_cast<vluint64_t*>(m_traceBufferWritep + 1) = timeui;
-        m_traceBufferWritep += 3;
+        t_traceBufferWritep[0] = VerilatedTraceCommand::TIME_CHANGE;
+        *reinterpret_cast<vluint64_t*>(t_traceBufferWritep + 1) = timeui;
+        t_traceBufferWritep += 3;
     } else {
         // Update time point
         flushBase();
-        emitTimeChange(timeui);
+        timeChange(timeui, true);
     }
 #else
     // Update time point
-    emitTimeChange(timeui);
+    timeChange(timeui, m_fullDump);
 #endif
 
     // Run the callbacks
@@ -446,6 +697,10 @@ void VerilatedTrace<VL_DERIVED_T>::dump(vluint64_t timeui) VL_MT_SAFE_EXCLUDES(m
             const CallbackRecord& cbr = m_fullCbs[i];
             cbr.m_dumpCb(cbr.m_userp, self());
         }
+#ifdef VL_TRACE_THREADED
+    } else if (m_parallelTasksp) {
+        runParallelChgCbs();
+#endif
     } else {
         for (vluint32_t i = 0; i < m_chgCbs.size(); ++i) {
             const CallbackRecord& cbr = m_chgCbs[i];
@@ -461,17 +716,70 @@ void VerilatedTrace<VL_DERIVED_T>::dump(vluint64_t timeui) VL_MT_SAFE_EXCLUDES(m
 #ifdef VL_TRACE_THREADED
     if (VL_LIKELY(bufferp)) {
         // Mark end of the trace buffer we just filled
-        *m_traceBufferWritep++ = VerilatedTraceCommand::END;
+        *t_traceBufferWritep++ = VerilatedTraceCommand::END;
 
         // Assert no buffer overflow
-        assert(m_traceBufferWritep - bufferp <= m_traceBufferSize);
+        assert(t_traceBufferWritep - bufferp <= m_traceBufferSize);
 
         // Pass it to the worker thread
         m_buffersToWorker.put(bufferp);
+
+        // Then any filled by parallel change callbacks, in order
+        for (vluint32_t* const parallelBufferp : m_parallelBuffers) {
+            m_buffersToWorker.put(parallelBufferp);
+        }
+        m_parallelBuffers.clear();
     }
 #endif
 }
 
+template <>
+void VerilatedTrace<VL_DERIVED_T>::flightRecorder(vluint32_t dumps) VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock(m_mutex);
+    if (VL_UNLIKELY(timeLastDump() != 0)) {
+        VL_FATAL_MT(__FILE__, __LINE__, "",
+                    "Trace flightRecorder() must be called before the first dump");
+    }
+    m_recordDumps = dumps;
+    m_recordSinceFull = 0;
+    clearRecording();
+}
+
+template <> void VerilatedTrace<VL_DERIVED_T>::flightRecorderWrite() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock(m_mutex);
+    if (m_recordSegments.empty()) return;
+    // Wait for the worker thread to record all dumps
+    flushBase();
+
+    // The first segment may hold more than the last m_recordDumps dumps.
+    // The earlier dumps are only applied to a copy of the signal state,
+    // which is written in full at the first dump to keep, using the signal
+    // types from the segment's initial full dump.
+    const RecordSegment& first = m_recordSegments.front();
+    const vluint32_t* const cmdsp = first.m_cmds.data();
+    const auto dumpEnd = [&](size_t i) {
+        return cmdsp + (i + 1 < first.m_dumps.size() ? first.m_dumps[i + 1] : first.m_cmds.size());
+    };
+    const size_t skip = m_recordedDumps > m_recordDumps ? m_recordedDumps - m_recordDumps : 0;
+    const vluint32_t* readp = cmdsp;
+    if (skip) {
+        std::vector<vluint32_t> state(nextCode());
+        readp = dumpEnd(skip);
+        replayRecords(cmdsp, readp, state.data(), REPLAY_APPLY);
+        const vluint32_t* const timep = cmdsp + first.m_dumps[skip];
+        emitTimeChange((static_cast<vluint64_t>(timep[2]) << 32ULL) | timep[1]);
+        replayRecords(cmdsp, dumpEnd(0), state.data(), REPLAY_EMIT_STATE);
+    }
+    for (const RecordSegment& seg : m_recordSegments) {
+        if (&seg != &first) readp = seg.m_cmds.data();
+        replayRecords(readp, seg.m_cmds.data() + seg.m_cmds.size(), nullptr, REPLAY_EMIT);
+    }
+
+    // Record again from a full dump
+    clearRecording();
+    m_fullDump = true;
+}
+
 //=============================================================================
 // Non-hot path internal interface to Verilator generated code
 
@@ -504,6 +812,14 @@ template <> void VerilatedTrace<VL_DERIVED_T>::addCleanupCb(dumpCb_t cb, void* u
     CallbackRecord cbr(cb, userp);
     addCallbackRecord(m_cleanupCbs, cbr);
 }
+template <>
+void VerilatedTrace<VL_DERIVED_T>::addActivityStats(const char* groupp, vluint64_t* checksp,
+                                                    vluint32_t signals, vluint32_t beginCode,
+                                                    vluint32_t endCode) VL_MT_UNSAFE {
+    // Called via callbacks way above in call stack, which already hold m_mutex
+    *checksp = 0;
+    m_activityStats.push_back({groupp, checksp, signals, beginCode, endCode});
+}
 template <> void VerilatedTrace<VL_DERIVED_T>::module(const std::string& name) VL_MT_UNSAFE {
     // Called via callbacks way above in call stack, which already hold m_mutex
     m_moduleName = name;
@@ -515,46 +831,68 @@ template <> void VerilatedTrace<VL_DERIVED_T>::module(const std::string& name) V
 // These functions must write the new value back into the old value store,
 // and subsequently call the format specific emit* implementations. Note
 // that this file must be included in the format specific implementation, so
-// the emit* functions can be inlined for performance.
+// the emit* functions can be inlined for performance.  When the flight
+// recorder is on, the new value is recorded from the old value store instead.
 
 template <> void VerilatedTrace<VL_DERIVED_T>::fullBit(vluint32_t* oldp, CData newval) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange(VerilatedTraceCommand::CHG_BIT_0 | newval, oldp, 0);
+    }
     self()->emitBit(oldp - m_sigs_oldvalp, newval);
 }
 
 template <>
 void VerilatedTrace<VL_DERIVED_T>::fullCData(vluint32_t* oldp, CData newval, int bits) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange((bits << 4) | VerilatedTraceCommand::CHG_CDATA, oldp, 1);
+    }
     self()->emitCData(oldp - m_sigs_oldvalp, newval, bits);
 }
 
 template <>
 void VerilatedTrace<VL_DERIVED_T>::fullSData(vluint32_t* oldp, SData newval, int bits) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange((bits << 4) | VerilatedTraceCommand::CHG_SDATA, oldp, 1);
+    }
     self()->emitSData(oldp - m_sigs_oldvalp, newval, bits);
 }
 
 template <>
 void VerilatedTrace<VL_DERIVED_T>::fullIData(vluint32_t* oldp, IData newval, int bits) {
     *oldp = newval;
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange((bits << 4) | VerilatedTraceCommand::CHG_IDATA, oldp, 1);
+    }
     self()->emitIData(oldp - m_sigs_oldvalp, newval, bits);
 }
 
 template <>
 void VerilatedTrace<VL_DERIVED_T>::fullQData(vluint32_t* oldp, QData newval, int bits) {
     *reinterpret_cast<QData*>(oldp) = newval;
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange((bits << 4) | VerilatedTraceCommand::CHG_QDATA, oldp, 2);
+    }
     self()->emitQData(oldp - m_sigs_oldvalp, newval, bits);
 }
 
 template <>
 void VerilatedTrace<VL_DERIVED_T>::fullWData(vluint32_t* oldp, const WData* newvalp, int bits) {
-    for (int i = 0; i < VL_WORDS_I(bits); ++i) oldp[i] = newvalp[i];
+    EData* const oldwp = reinterpret_cast<EData*>(oldp);
+    for (int i = 0; i < VL_WORDS_I(bits); ++i) oldwp[i] = newvalp[i];
+    if (VL_UNLIKELY(m_recordp)) {
+        return recordChange((bits << 4) | VerilatedTraceCommand::CHG_WDATA, oldp,
+                            VL_WORDS_I(bits) * (VL_EDATASIZE / 32));
+    }
     self()->emitWData(oldp - m_sigs_oldvalp, newvalp, bits);
 }
 
 template <> void VerilatedTrace<VL_DERIVED_T>::fullDouble(vluint32_t* oldp, double newval) {
     // cppcheck-suppress invalidPointerCast
     *reinterpret_cast<double*>(oldp) = newval;
+    if (VL_UNLIKELY(m_recordp)) return recordChange(VerilatedTraceCommand::CHG_DOUBLE, oldp, 2);
     self()->emitDouble(oldp - m_sigs_oldvalp, newval);
 }
 
@@ -646,7 +984,13 @@ static inline void cvtQDataToStr(char* dstp, QData value) {
     cvtIDataToStr(dstp + 32, value);
 }
 
-#define cvtEDataToStr cvtIDataToStr
+// clang-format off
+#ifdef VL_EDATA64
+# define cvtEDataToStr cvtQDataToStr
+#else
+# define cvtEDataToStr cvtIDataToStr
+#endif
+// clang-format on
 
 //=============================================================================
 
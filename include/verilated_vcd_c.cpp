@@ -29,6 +29,7 @@
 
 #include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <ctime>
 #include <fcntl.h>
 
@@ -169,6 +170,9 @@ void VerilatedVcd::openNextImp(bool incFilename) {
     m_isOpen = true;
     fullDump(true);  // First dump must be full
     m_wroteBytes = 0;
+#ifdef VL_THREADED
+    if (m_asyncBuffers && !m_asyncThreadp) asyncStart();
+#endif
 }
 
 bool VerilatedVcd::preChangeDump() {
@@ -220,6 +224,9 @@ void VerilatedVcd::deleteNameMap() {
 VerilatedVcd::~VerilatedVcd() {
     close();
     if (m_wrBufp) VL_DO_CLEAR(delete[] m_wrBufp, m_wrBufp = nullptr);
+#ifdef VL_THREADED
+    for (char* const bufp : m_asyncFree) delete[] bufp;
+#endif
     deleteNameMap();
     if (m_filep && m_fileNewed) VL_DO_CLEAR(delete m_filep, m_filep = nullptr);
 }
@@ -230,6 +237,9 @@ void VerilatedVcd::closePrev() {
 
     VerilatedTrace<VerilatedVcd>::flushBase();
     bufferFlush();
+#ifdef VL_THREADED
+    asyncWait();
+#endif
     m_isOpen = false;
     m_filep->close();
 }
@@ -256,14 +266,20 @@ void VerilatedVcd::close() VL_MT_SAFE_EXCLUDES(m_mutex) {
     }
     closePrev();
     // closePrev() called VerilatedTrace<VerilatedVcd>::flush(), so we just
-    // need to shut down the tracing thread here.
+    // need to shut down the tracing and writer threads here.
     VerilatedTrace<VerilatedVcd>::closeBase();
+#ifdef VL_THREADED
+    asyncStop();
+#endif
 }
 
 void VerilatedVcd::flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
     const VerilatedLockGuard lock(m_mutex);
     VerilatedTrace<VerilatedVcd>::flushBase();
     bufferFlush();
+#ifdef VL_THREADED
+    asyncWait();
+#endif
 }
 
 void VerilatedVcd::printStr(const char* str) {
@@ -284,6 +300,12 @@ void VerilatedVcd::bufferResize(vluint64_t minsize) {
     // minsize is size of largest write.  We buffer at least 8 times as much data,
     // writing when we are 3/4 full (with thus 2*minsize remaining free)
     if (VL_UNLIKELY(minsize > m_wrChunkSize)) {
+#ifdef VL_THREADED
+        // Buffers being written are too small to reuse
+        asyncWait();
+        for (char* const bufp : m_asyncFree) delete[] bufp;
+        m_asyncFree.clear();
+#endif
         char* oldbufp = m_wrBufp;
         m_wrChunkSize = minsize * 2;
         m_wrBufp = new char[m_wrChunkSize * 8];
@@ -301,33 +323,120 @@ void VerilatedVcd::bufferFlush() VL_MT_UNSAFE_ONE {
     // When it gets nearly full we dump it using this routine which calls write()
     // This is much faster than using buffered I/O
     if (VL_UNLIKELY(!isOpen())) return;
-    char* wp = m_wrBufp;
-    while (true) {
-        ssize_t remaining = (m_writep - wp);
-        if (remaining == 0) break;
+    const size_t len = m_writep - m_wrBufp;
+    if (!len) return;
+    m_wroteBytes += len;
+    m_statBytes += len;
+#ifdef VL_THREADED
+    if (m_asyncThreadp) {
+        // Hand the buffer to the writer thread, and continue in a free one
+        m_asyncToWriter.put(AsyncBuffer{m_wrBufp, len});
+        ++m_asyncInFlight;
+        char* bufp = nullptr;
+        while (m_asyncFromWriter.tryGet(bufp)) {
+            m_asyncFree.push_back(bufp);
+            --m_asyncInFlight;
+        }
+        if (!m_asyncFree.empty()) {
+            m_wrBufp = m_asyncFree.back();
+            m_asyncFree.pop_back();
+        } else if (m_asyncInFlight < m_asyncBuffers) {
+            m_wrBufp = new char[m_wrChunkSize * 8];
+        } else {
+            // All buffers are being written, so wait for one
+            const auto start = std::chrono::steady_clock::now();
+            m_wrBufp = m_asyncFromWriter.get();
+            --m_asyncInFlight;
+            m_statBlockedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                   std::chrono::steady_clock::now() - start)
+                                   .count();
+        }
+        m_wrFlushp = m_wrBufp + m_wrChunkSize * 6;
+        m_writep = m_wrBufp;
+        if (VL_UNCOVERABLE(m_asyncErrno)) bufferError(m_asyncErrno);
+        return;
+    }
+#endif
+    const auto start = std::chrono::steady_clock::now();
+    const int err = bufferWrite(m_wrBufp, len);
+    m_statBlockedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    if (VL_UNCOVERABLE(err)) bufferError(err);
+
+    // Reset buffer
+    m_writep = m_wrBufp;
+}
+
+int VerilatedVcd::bufferWrite(const char* bufp, size_t len) VL_MT_UNSAFE_ONE {
+    // This function can be called from the writer thread
+    // Returns errno of a failed write, or 0
+    const char* wp = bufp;
+    const char* const endp = bufp + len;
+    while (wp < endp) {
         errno = 0;
-        ssize_t got = m_filep->write(wp, remaining);
+        const ssize_t got = m_filep->write(wp, endp - wp);
         if (got > 0) {
             wp += got;
-            m_wroteBytes += got;
         } else if (VL_UNCOVERABLE(got < 0)) {
-            if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
-                // LCOV_EXCL_START
-                // write failed, presume error (perhaps out of disk space)
-                std::string msg
-                    = std::string("VerilatedVcd::bufferFlush: ") + std::strerror(errno);
-                VL_FATAL_MT("", 0, "", msg.c_str());
-                closeErr();
-                break;
-                // LCOV_EXCL_STOP
-            }
+            if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) return errno;  // LCOV_EXCL_LINE
         }
     }
+    return 0;
+}
 
-    // Reset buffer
-    m_writep = m_wrBufp;
+void VerilatedVcd::bufferError(int err) {  // LCOV_EXCL_START
+    // write failed, presume error (perhaps out of disk space)
+    const std::string msg = std::string("VerilatedVcd::bufferFlush: ") + std::strerror(err);
+    VL_FATAL_MT("", 0, "", msg.c_str());
+    closeErr();
+}  // LCOV_EXCL_STOP
+
+#ifdef VL_THREADED
+//=============================================================================
+// Asynchronous writing
+
+void VerilatedVcd::asyncStart() {
+    m_asyncErrno = 0;
+    m_asyncThreadp.reset(new std::thread{&VerilatedVcd::asyncWriterMain, this});
+}
+
+void VerilatedVcd::asyncStop() {
+    if (!m_asyncThreadp) return;
+    asyncWait();
+    m_asyncToWriter.put(AsyncBuffer{nullptr, 0});
+    m_asyncThreadp->join();
+    m_asyncThreadp.reset(nullptr);
 }
 
+void VerilatedVcd::asyncWait() {
+    // Wait until the writer thread has written all buffers handed to it
+    if (!m_asyncInFlight) return;
+    const auto start = std::chrono::steady_clock::now();
+    while (m_asyncInFlight) {
+        m_asyncFree.push_back(m_asyncFromWriter.get());
+        --m_asyncInFlight;
+    }
+    m_statBlockedNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    if (VL_UNCOVERABLE(m_asyncErrno)) bufferError(m_asyncErrno);
+}
+
+void VerilatedVcd::asyncWriterMain() {
+    while (true) {
+        const AsyncBuffer buffer = m_asyncToWriter.get();
+        if (!buffer.first) break;
+        // After an error, just return the buffers until the file is closed
+        if (!m_asyncErrno) {
+            const int err = bufferWrite(buffer.first, buffer.second);
+            if (VL_UNCOVERABLE(err)) m_asyncErrno = err;
+        }
+        m_asyncFromWriter.put(buffer.first);
+    }
+}
+#endif
+
 //=============================================================================
 // VCD string code
 
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
 class VerilatedVcd;
@@ -48,7 +49,8 @@ public:
     virtual bool open(const std::string& name) VL_MT_UNSAFE;
     /// Close object's file
     virtual void close() VL_MT_UNSAFE;
-    /// Write data to file (if it is open)
+    /// Write data to file (if it is open).  With VerilatedVcdC::asyncBuffers
+    /// this is called from a background writer thread.
     virtual ssize_t write(const char* bufp, ssize_t len) VL_MT_UNSAFE;
 };
 
@@ -78,6 +80,21 @@ private:
     char* m_writep;  // Write pointer into output buffer
     vluint64_t m_wrChunkSize;  // Output buffer size
     vluint64_t m_wroteBytes = 0;  // Number of bytes written to this file
+    vluint64_t m_statBytes = 0;  // Number of bytes written to all files
+    vluint64_t m_statBlockedNs = 0;  // Time spent blocked writing, in nanoseconds
+
+    unsigned m_asyncBuffers = 0;  // Maximum buffers handed to the writer thread, 0 for none
+#ifdef VL_THREADED
+    // Asynchronous writing.  Full buffers are handed to the writer thread,
+    // and returned for reuse once written.
+    using AsyncBuffer = std::pair<char*, size_t>;  // Buffer, and length to write
+    VerilatedThreadQueue<AsyncBuffer> m_asyncToWriter;  // Buffers to write, nullptr to exit
+    VerilatedThreadQueue<char*> m_asyncFromWriter;  // Buffers written
+    std::vector<char*> m_asyncFree;  // Buffers returned, and not yet reused
+    unsigned m_asyncInFlight = 0;  // Buffers handed to the writer, and not yet returned
+    std::atomic<int> m_asyncErrno{0};  // Error number of a failed write, or 0
+    std::unique_ptr<std::thread> m_asyncThreadp;  // Writer thread, if running
+#endif
 
     std::vector<char> m_suffixes;  // VCD line end string codes + metadata
     const char* m_suffixesp;  // Pointer to first element of above
@@ -87,6 +104,14 @@ private:
 
     void bufferResize(vluint64_t minsize);
     void bufferFlush() VL_MT_UNSAFE_ONE;
+    int bufferWrite(const char* bufp, size_t len) VL_MT_UNSAFE_ONE;
+    void bufferError(int err);
+#ifdef VL_THREADED
+    void asyncStart();
+    void asyncStop();
+    void asyncWait();
+    void asyncWriterMain();
+#endif
     inline void bufferCheck() {
         // Flush the write buffer if there's not enough space left for new information
         // We only call this once per vector, so we need enough slop for a very wide "b###" line
@@ -144,6 +169,12 @@ public:
     // ACCESSORS
     // Set size in megabytes after which new file should be created
     void rolloverMB(vluint64_t rolloverMB) { m_rolloverMB = rolloverMB; }
+    // Set number of buffers that may be written in the background
+    void asyncBuffers(unsigned buffers) { m_asyncBuffers = buffers; }
+    // Number of bytes written to all files
+    vluint64_t statBytesWritten() const { return m_statBytes; }
+    // Seconds spent blocked writing, or waiting for background writes
+    double statBlockedSeconds() const { return m_statBlockedNs * 1e-9; }
 
     // METHODS
     // Open the file; call isOpen() to see if errors
@@ -325,6 +356,8 @@ public:
 #ifndef DOXYGEN
 // Declare specializations here they are used in VerilatedVcdC just below
 template <> void VerilatedTrace<VerilatedVcd>::dump(vluint64_t timeui);
+template <> void VerilatedTrace<VerilatedVcd>::flightRecorder(vluint32_t dumps);
+template <> void VerilatedTrace<VerilatedVcd>::flightRecorderWrite();
 template <> void VerilatedTrace<VerilatedVcd>::set_time_unit(const char* unitp);
 template <> void VerilatedTrace<VerilatedVcd>::set_time_unit(const std::string& unit);
 template <> void VerilatedTrace<VerilatedVcd>::set_time_resolution(const char* unitp);
@@ -364,10 +397,26 @@ public:
     void openNext(bool incFilename = true) VL_MT_SAFE { m_sptrace.openNext(incFilename); }
     /// Set size in megabytes after which new file should be created
     void rolloverMB(size_t rolloverMB) VL_MT_SAFE { m_sptrace.rolloverMB(rolloverMB); }
+    /// Set number of full output buffers that may be queued for writing by a
+    /// background thread, so dumping need not wait for the file system.
+    /// Default 0 writes from the dumping thread.  Call before open().
+    /// Requires VL_THREADED, otherwise writes remain synchronous.
+    void asyncBuffers(unsigned buffers) VL_MT_SAFE { m_sptrace.asyncBuffers(buffers); }
+    /// Return number of bytes written to all files
+    vluint64_t statBytesWritten() const VL_MT_SAFE { return m_sptrace.statBytesWritten(); }
+    /// Return seconds dumping was blocked writing, or waiting for a free
+    /// buffer or for background writes to complete
+    double statBlockedSeconds() const VL_MT_SAFE { return m_sptrace.statBlockedSeconds(); }
     /// Close dump
     void close() VL_MT_SAFE { m_sptrace.close(); }
     /// Flush dump
     void flush() VL_MT_SAFE { m_sptrace.flush(); }
+    /// Keep only the last given number of dumps in memory, writing them
+    /// only on flightRecorderWrite(), or on a flush after an error such as
+    /// $stop, $fatal or a failed assertion.  Call before the first dump.
+    void flightRecorder(vluint32_t dumps) VL_MT_SAFE { m_sptrace.flightRecorder(dumps); }
+    /// Write the dumps kept by flightRecorder()
+    void flightRecorderWrite() VL_MT_SAFE { m_sptrace.flightRecorderWrite(); }
     /// Write one cycle of dump data
     void dump(vluint64_t timeui) VL_MT_SAFE { m_sptrace.dump(timeui); }
     /// Write one cycle of dump data - backward compatible and to reduce
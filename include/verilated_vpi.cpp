@@ -30,9 +30,11 @@
 #include "verilated_vpi.h"
 #include "verilated_imp.h"
 
+#include <algorithm>
 #include <list>
 #include <map>
 #include <set>
+#include <vector>
 
 //======================================================================
 // Internal constants
@@ -514,6 +516,8 @@ class VerilatedVpiImp final {
     VerilatedVpiError* m_errorInfop = nullptr;  // Container for vpi error info
     VerilatedAssertOneThread m_assertOne;  // Assert only called from single thread
     vluint64_t m_nextCallbackId = 1;  // Id to identify callback
+    std::vector<VerilatedVpioVar*> m_valueUpdates;  // Objects to update after value callbacks
+    std::vector<vluint8_t*> m_valueDirtys;  // Dirty flags to clear after value callbacks
 
     static VerilatedVpiImp& s() {  // Singleton
         static VerilatedVpiImp s_s;
@@ -610,8 +614,11 @@ public:
         assertOneCheck();
         VpioCbList& cbObjList = s().m_cbObjLists[cbValueChange];
         bool called = false;
-        std::unordered_set<VerilatedVpioVar*> update;  // set of objects to update after callbacks
         if (cbObjList.empty()) return called;
+        std::vector<VerilatedVpioVar*>& updates = s().m_valueUpdates;
+        std::vector<vluint8_t*>& dirtys = s().m_valueDirtys;
+        updates.clear();
+        dirtys.clear();
         const auto last = std::prev(cbObjList.end());  // prevent looping over newly added elements
         for (auto it = cbObjList.begin(); true;) {
             // cbReasonRemove sets to nullptr, so we know on removal the old end() will still exist
@@ -623,6 +630,14 @@ public:
             }
             VerilatedVpiCbHolder& ho = *it++;
             if (VerilatedVpioVar* varop = VerilatedVpioVar::castp(ho.cb_datap()->obj)) {
+                // With --vpi-dirty, only variables written since the last call may have changed
+                if (vluint8_t* const dirtyp = varop->varp()->dirtyp()) {
+                    if (!*dirtyp) {
+                        if (was_last) break;
+                        continue;
+                    }
+                    dirtys.push_back(dirtyp);
+                }
                 void* newDatap = varop->varDatap();
                 void* prevDatap = varop->prevDatap();  // Was malloced when we added the callback
                 VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_test %s v[0]=%d/%d %p %p\n",
@@ -632,7 +647,7 @@ public:
                     VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: value_callback %" VL_PRI64
                                                 "d %s v[0]=%d\n",
                                                 ho.id(), varop->fullname(), *((CData*)newDatap)););
-                    update.insert(varop);
+                    updates.push_back(varop);
                     vpi_get_value(ho.cb_datap()->obj, ho.cb_datap()->value);
                     (ho.cb_rtnp())(ho.cb_datap());
                     called = true;
@@ -640,9 +655,10 @@ public:
             }
             if (was_last) break;
         }
-        for (const auto& ip : update) {
-            std::memcpy(ip->prevDatap(), ip->varDatap(), ip->entSize());
+        for (VerilatedVpioVar* const varop : updates) {
+            std::memcpy(varop->prevDatap(), varop->varDatap(), varop->entSize());
         }
+        for (vluint8_t* const dirtyp : dirtys) *dirtyp = 0;
         return called;
     }
 
@@ -1221,7 +1237,7 @@ vpiHandle vpi_handle_by_name(PLI_BYTE8* namep, vpiHandle scope) {
     const VerilatedVar* varp = nullptr;
     const VerilatedScope* scopep;
     VerilatedVpioScope* voScopep = VerilatedVpioScope::castp(scope);
-    std::string scopeAndName = namep;
+    std::string scopeAndName;
     if (voScopep) {
         scopeAndName = std::string(voScopep->fullname()) + "." + namep;
         namep = const_cast<PLI_BYTE8*>(scopeAndName.c_str());
@@ -1236,7 +1252,7 @@ vpiHandle vpi_handle_by_name(PLI_BYTE8* namep, vpiHandle scope) {
                 return (new VerilatedVpioScope(scopep))->castVpiHandle();
             }
         }
-        const char* baseNamep = scopeAndName.c_str();
+        const char* baseNamep = namep;
         std::string scopename;
         const char* dotp = std::strrchr(namep, '.');
         if (VL_LIKELY(dotp)) {
@@ -1591,8 +1607,11 @@ void vl_get_value(const VerilatedVar* varp, void* varDatap, p_vpi_value valuep,
                     "vpi_get_value with more than VL_MULS_MAX_WORDS; increase and recompile");
             }
             WDataInP datap = (reinterpret_cast<EData*>(varDatap));
-            for (int i = 0; i < words; ++i) {
-                t_out[i].aval = datap[i];
+            // Vectors are in 32-bit pieces, EData may be wider
+            const int vecs = VL_BITWORD_I(varp->packed().elements() - 1) + 1;
+            for (int i = 0; i < vecs; ++i) {
+                t_out[i].aval
+                    = static_cast<IData>(datap[VL_BITWORD_E(i * 32)] >> VL_BITBIT_E(i * 32));
                 t_out[i].bval = 0;
             }
             return;
@@ -1799,6 +1818,7 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value valuep, p_vpi_time /*time_
             return nullptr;
         }
         if (!vl_check_format(vop->varp(), valuep, vop->fullname(), false)) return nullptr;
+        if (vluint8_t* const dirtyp = vop->varp()->dirtyp()) *dirtyp = 1;
         if (valuep->format == vpiVectorVal) {
             if (VL_UNLIKELY(!valuep->value.vector)) return nullptr;
             if (vop->varp()->vltype() == VLVT_UINT8) {
@@ -1818,11 +1838,15 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value valuep, p_vpi_time /*time_
                     valuep->value.vector[1].aval & vop->mask(), valuep->value.vector[0].aval);
                 return object;
             } else if (vop->varp()->vltype() == VLVT_WDATA) {
-                int words = VL_WORDS_I(vop->varp()->packed().elements());
+                int bits = vop->varp()->packed().elements();
                 WDataOutP datap = (reinterpret_cast<EData*>(vop->varDatap()));
-                for (int i = 0; i < words; ++i) {
-                    datap[i] = valuep->value.vector[i].aval;
-                    if (i == (words - 1)) datap[i] &= vop->mask();
+                for (int i = 0; i < VL_WORDS_I(bits); ++i) datap[i] = 0;
+                // Vectors are in 32-bit pieces, EData may be wider
+                const int vecs = VL_BITWORD_I(bits - 1) + 1;
+                for (int i = 0; i < vecs; ++i) {
+                    IData aval = valuep->value.vector[i].aval;
+                    if (i == (vecs - 1)) aval &= vop->mask();
+                    datap[VL_BITWORD_E(i * 32)] |= static_cast<EData>(aval) << VL_BITBIT_E(i * 32);
                 }
                 return object;
             }
@@ -1998,13 +2022,265 @@ vpiHandle vpi_put_value(vpiHandle object, p_vpi_value valuep, p_vpi_time /*time_
     return nullptr;
 }
 
-void vpi_get_value_array(vpiHandle /*object*/, p_vpi_arrayvalue /*arrayvalue_p*/,
-                         PLI_INT32* /*index_p*/, PLI_UINT32 /*num*/) {
-    VL_VPI_UNIMP_();
+// Array values are transferred element by element, starting at index_p[0]
+// and going to increasing indexes, wrapping around to the lowest index.
+// Raw formats hold each element in 32-bit words, least significant first,
+// with four-state formats having the aval words followed by the bval words.
+// Where the model stores elements the same way, runs are copied with memcpy.
+
+static size_t vl_array_format_words(PLI_INT32 format, int bits) {
+    // Return 32-bit words per element in given format, or 0 if unsupported
+    const size_t words = (bits + 31) / 32;
+    switch (format) {
+    case vpiIntVal: return 1;
+    case vpiShortIntVal: return 1;
+    case vpiLongIntVal: return 2;
+    case vpiVectorVal: return words * 2;
+    case vpiRawTwoStateVal: return words;
+    case vpiRawFourStateVal: return words * 2;
+    default: return 0;
+    }
 }
-void vpi_put_value_array(vpiHandle /*object*/, p_vpi_arrayvalue /*arrayvalue_p*/,
-                         PLI_INT32* /*index_p*/, PLI_UINT32 /*num*/) {
-    VL_VPI_UNIMP_();
+
+static size_t vl_array_format_bytes(PLI_INT32 format, int bits) {
+    // Return bytes per element in given format
+    switch (format) {
+    case vpiIntVal: return sizeof(PLI_INT32);
+    case vpiShortIntVal: return sizeof(PLI_INT16);
+    default: return vl_array_format_words(format, bits) * sizeof(PLI_UINT32);
+    }
+}
+
+static bool vl_array_format_direct(const VerilatedVar* varp, PLI_INT32 format, bool put) {
+    // Return true if elements in the format are stored as in the model
+    const int bits = varp->packed().elements();
+    switch (varp->vltype()) {
+    case VLVT_UINT16: return format == vpiShortIntVal && (!put || bits == 16);
+    case VLVT_UINT32:
+        return (format == vpiIntVal || format == vpiRawTwoStateVal) && (!put || bits == 32);
+    case VLVT_UINT64: return format == vpiLongIntVal && (!put || bits == 64);
+    case VLVT_WDATA:
+        return format == vpiRawTwoStateVal && VL_EDATASIZE == 32 && (!put || (bits % 32) == 0);
+    default: return false;
+    }
+}
+
+static IData vl_array_get_chunk(const VerilatedVar* varp, const void* datap, int chunk) {
+    // Return given 32-bit chunk of an element's value
+    switch (varp->vltype()) {
+    case VLVT_UINT8: return chunk ? 0 : *(reinterpret_cast<const CData*>(datap));
+    case VLVT_UINT16: return chunk ? 0 : *(reinterpret_cast<const SData*>(datap));
+    case VLVT_UINT32: return chunk ? 0 : *(reinterpret_cast<const IData*>(datap));
+    case VLVT_UINT64:
+        return chunk > 1 ? 0
+                         : static_cast<IData>(*(reinterpret_cast<const QData*>(datap))
+                                              >> (chunk * 32));
+    case VLVT_WDATA: {
+        if (chunk >= (VL_BITWORD_I(varp->packed().elements() - 1) + 1)) return 0;
+        const EData* const wp = reinterpret_cast<const EData*>(datap);
+        return static_cast<IData>(wp[VL_BITWORD_E(chunk * 32)] >> VL_BITBIT_E(chunk * 32));
+    }
+    default: return 0;  // LCOV_EXCL_LINE
+    }
+}
+
+static void vl_array_put_chunks(const VerilatedVar* varp, void* datap, const IData* chunksp,
+                                IData mask) {
+    // Set an element's value from 32-bit chunks, masking the most significant
+    const int vecs = VL_BITWORD_I(varp->packed().elements() - 1) + 1;
+    switch (varp->vltype()) {
+    case VLVT_UINT8: *(reinterpret_cast<CData*>(datap)) = chunksp[0] & mask; break;
+    case VLVT_UINT16: *(reinterpret_cast<SData*>(datap)) = chunksp[0] & mask; break;
+    case VLVT_UINT32: *(reinterpret_cast<IData*>(datap)) = chunksp[0] & mask; break;
+    case VLVT_UINT64:
+        *(reinterpret_cast<QData*>(datap)) = VL_SET_QII(chunksp[1] & mask, chunksp[0]);
+        break;
+    case VLVT_WDATA: {
+        EData* const wp = reinterpret_cast<EData*>(datap);
+        for (int i = 0; i < VL_WORDS_I(varp->packed().elements()); ++i) wp[i] = 0;
+        for (int i = 0; i < vecs; ++i) {
+            const IData aval = (i == vecs - 1) ? (chunksp[i] & mask) : chunksp[i];
+            wp[VL_BITWORD_E(i * 32)] |= static_cast<EData>(aval) << VL_BITBIT_E(i * 32);
+        }
+        break;
+    }
+    default: break;  // LCOV_EXCL_LINE
+    }
+}
+
+static VerilatedVpioVar* vl_array_check(vpiHandle object, p_vpi_arrayvalue arrayvalue_p,
+                                        PLI_INT32* index_p, const char* func,
+                                        vluint32_t& offsetr) {
+    // Check arguments, returning array and offset of first element, or nullptr
+    if (VL_UNLIKELY(!arrayvalue_p || !index_p)) {
+        VL_VPI_WARNING_(__FILE__, __LINE__, "Ignoring %s with nullptr value or index pointer",
+                        func);
+        return nullptr;
+    }
+    VerilatedVpioVar* const vop = VerilatedVpioVar::castp(object);
+    if (VL_UNLIKELY(!vop || VerilatedVpioMemoryWord::castp(object)
+                    || vop->varp()->dims() != 2)) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported vpiHandle (%p), not a %s", func,
+                      object, "one dimensional unpacked array");
+        return nullptr;
+    }
+    const VerilatedVar* const varp = vop->varp();
+    if (VL_UNLIKELY(!vl_array_format_words(arrayvalue_p->format, varp->packed().elements())
+                    || varp->vltype() == VLVT_PTR)) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Unsupported format (%s) for %s", func,
+                      VerilatedVpiError::strFromVpiVal(arrayvalue_p->format), vop->fullname());
+        return nullptr;
+    }
+    const VerilatedRange& range = varp->unpacked();
+    if (VL_UNLIKELY(index_p[0] < range.low() || index_p[0] > range.high())) {
+        VL_VPI_ERROR_(__FILE__, __LINE__, "%s: Index %d out of range for %s", func, index_p[0],
+                      vop->fullname());
+        return nullptr;
+    }
+    offsetr = index_p[0] - range.low();
+    return vop;
+}
+
+void vpi_get_value_array(vpiHandle object, p_vpi_arrayvalue arrayvalue_p, PLI_INT32* index_p,
+                         PLI_UINT32 num) {
+    VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_get_value_array %p %p %u\n", object, arrayvalue_p,
+                                num););
+    VerilatedVpiImp::assertOneCheck();
+    VL_VPI_ERROR_RESET_();
+    vluint32_t offset = 0;
+    const VerilatedVpioVar* const vop
+        = vl_array_check(object, arrayvalue_p, index_p, __func__, offset);
+    if (!vop) return;
+    const VerilatedVar* const varp = vop->varp();
+    const PLI_INT32 format = arrayvalue_p->format;
+    const int bits = varp->packed().elements();
+    const size_t outBytes = vl_array_format_bytes(format, bits);
+    const size_t outWords = vl_array_format_words(format, bits);
+    const size_t words = (bits + 31) / 32;
+    if (!(arrayvalue_p->flags & vpiUserAllocFlag)) {
+        // Values only need to persist until the next vpi_get_value_array
+        static VL_THREAD_LOCAL std::vector<vluint64_t> t_out;  // 64-bit aligned for longints
+        t_out.resize((outWords * num + 1) / 2 + 1);
+        arrayvalue_p->value.rawvals = reinterpret_cast<PLI_BYTE8*>(t_out.data());
+    }
+    PLI_BYTE8* const outp = arrayvalue_p->value.rawvals;
+    const vluint8_t* const datap = static_cast<const vluint8_t*>(varp->datap());
+    const vluint32_t entSize = vop->entSize();
+    const vluint32_t elements = varp->unpacked().elements();
+    const bool direct = vl_array_format_direct(varp, format, false) && entSize == outBytes;
+    for (PLI_UINT32 i = 0; i < num;) {
+        // Each run ends at the end of the array
+        const PLI_UINT32 run = std::min<PLI_UINT32>(num - i, elements - offset);
+        if (direct) {
+            std::memcpy(outp + i * outBytes, datap + offset * entSize, run * entSize);
+        } else {
+            for (PLI_UINT32 n = 0; n < run; ++n) {
+                const void* const elemp = datap + (offset + n) * entSize;
+                PLI_UINT32* const wordsp
+                    = reinterpret_cast<PLI_UINT32*>(outp + (i + n) * outBytes);
+                switch (format) {
+                case vpiIntVal:
+                    arrayvalue_p->value.integers[i + n] = vl_array_get_chunk(varp, elemp, 0);
+                    break;
+                case vpiShortIntVal:
+                    arrayvalue_p->value.shortints[i + n]
+                        = static_cast<PLI_INT16>(vl_array_get_chunk(varp, elemp, 0));
+                    break;
+                case vpiLongIntVal:
+                    arrayvalue_p->value.longints[i + n] = static_cast<PLI_INT64>(VL_SET_QII(
+                        vl_array_get_chunk(varp, elemp, 1), vl_array_get_chunk(varp, elemp, 0)));
+                    break;
+                case vpiVectorVal:
+                    for (size_t c = 0; c < words; ++c) {
+                        arrayvalue_p->value.vectors[(i + n) * words + c].aval
+                            = vl_array_get_chunk(varp, elemp, c);
+                        arrayvalue_p->value.vectors[(i + n) * words + c].bval = 0;
+                    }
+                    break;
+                default:  // vpiRawTwoStateVal, vpiRawFourStateVal
+                    for (size_t c = 0; c < words; ++c) {
+                        wordsp[c] = vl_array_get_chunk(varp, elemp, c);
+                    }
+                    for (size_t c = words; c < outWords; ++c) wordsp[c] = 0;
+                    break;
+                }
+            }
+        }
+        i += run;
+        offset = 0;
+    }
+}
+
+void vpi_put_value_array(vpiHandle object, p_vpi_arrayvalue arrayvalue_p, PLI_INT32* index_p,
+                         PLI_UINT32 num) {
+    VL_DEBUG_IF_PLI(VL_DBG_MSGF("- vpi: vpi_put_value_array %p %p %u\n", object, arrayvalue_p,
+                                num););
+    VerilatedVpiImp::assertOneCheck();
+    VL_VPI_ERROR_RESET_();
+    vluint32_t offset = 0;
+    VerilatedVpioVar* const vop = vl_array_check(object, arrayvalue_p, index_p, __func__, offset);
+    if (!vop) return;
+    const VerilatedVar* const varp = vop->varp();
+    if (VL_UNLIKELY(!varp->isPublicRW())) {
+        VL_VPI_WARNING_(__FILE__, __LINE__,
+                        "Ignoring vpi_put_value_array to signal marked read-only,"
+                        " use public_flat_rw instead: %s",
+                        vop->fullname());
+        return;
+    }
+    if (vluint8_t* const dirtyp = varp->dirtyp()) *dirtyp = 1;
+    const PLI_INT32 format = arrayvalue_p->format;
+    const int bits = varp->packed().elements();
+    const size_t inBytes = vl_array_format_bytes(format, bits);
+    const size_t words = (bits + 31) / 32;
+    // With vpiOneValue, the first value is written to every element
+    const bool oneValue = arrayvalue_p->flags & vpiOneValue;
+    const PLI_BYTE8* const inp = arrayvalue_p->value.rawvals;
+    vluint8_t* const datap = static_cast<vluint8_t*>(varp->datap());
+    const vluint32_t entSize = vop->entSize();
+    const vluint32_t elements = varp->unpacked().elements();
+    const bool direct
+        = vl_array_format_direct(varp, format, true) && entSize == inBytes && !oneValue;
+    static VL_THREAD_LOCAL std::vector<IData> t_chunks;
+    t_chunks.resize(words + 1);
+    for (PLI_UINT32 i = 0; i < num;) {
+        // Each run ends at the end of the array
+        const PLI_UINT32 run = std::min<PLI_UINT32>(num - i, elements - offset);
+        if (direct) {
+            std::memcpy(datap + offset * entSize, inp + i * inBytes, run * entSize);
+        } else {
+            for (PLI_UINT32 n = 0; n < run; ++n) {
+                const PLI_UINT32 in = oneValue ? 0 : i + n;
+                const PLI_UINT32* const wordsp
+                    = reinterpret_cast<const PLI_UINT32*>(inp + in * inBytes);
+                std::fill(t_chunks.begin(), t_chunks.end(), 0);
+                switch (format) {
+                case vpiIntVal: t_chunks[0] = arrayvalue_p->value.integers[in]; break;
+                case vpiShortIntVal:
+                    t_chunks[0] = static_cast<vluint16_t>(arrayvalue_p->value.shortints[in]);
+                    break;
+                case vpiLongIntVal: {
+                    const QData value = arrayvalue_p->value.longints[in];
+                    t_chunks[0] = static_cast<IData>(value);
+                    if (words > 1) t_chunks[1] = static_cast<IData>(value >> 32ULL);
+                    break;
+                }
+                case vpiVectorVal:
+                    for (size_t c = 0; c < words; ++c) {
+                        t_chunks[c] = arrayvalue_p->value.vectors[in * words + c].aval;
+                    }
+                    break;
+                default:  // vpiRawTwoStateVal, vpiRawFourStateVal
+                    for (size_t c = 0; c < words; ++c) t_chunks[c] = wordsp[c];
+                    break;
+                }
+                vl_array_put_chunks(varp, datap + (offset + n) * entSize, t_chunks.data(),
+                                    vop->mask());
+            }
+        }
+        i += run;
+        offset = 0;
+    }
 }
 
 // time processing
@@ -2019,10 +2295,8 @@ void vpi_get_time(vpiHandle object, p_vpi_time time_p) {
     }
     if (time_p->type == vpiSimTime) {
         QData qtime = VL_TIME_Q();
-        WData itime[2];
-        VL_SET_WQ(itime, qtime);
-        time_p->low = itime[0];
-        time_p->high = itime[1];
+        time_p->low = static_cast<IData>(qtime);
+        time_p->high = static_cast<IData>(qtime >> 32ULL);
         return;
     } else if (time_p->type == vpiScaledRealTime) {
         double dtime = VL_TIME_D();
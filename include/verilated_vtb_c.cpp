@@ -0,0 +1,405 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// Code available from: https://verilator.org
+//
+// Copyright 2001-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//=============================================================================
+///
+/// \file
+/// \brief Verilated C++ tracing in VTB format implementation code
+///
+/// This file must be compiled and linked against all Verilated objects
+/// that use --trace-vtb.
+///
+/// Use "verilator --trace-vtb" to add this to the Makefile for the linker.
+///
+/// File layout, all fixed size fields little endian:
+///
+///   Header:  "VTBTRACE", u32 version, u32 length of the rest of the header,
+///            then varint-length timescale string, varint declaration count,
+///            and per declaration: varint code, varint bits, u8 flags
+///            (1 = real, 2 = bussed), zigzag varint msb and lsb, and
+///            varint-length name in VCD hierarchy form ("a b\tsig").
+///   Chunks:  "VTBC", u32 payload length, u64 first time, u64 last time,
+///            then the payload records.
+///   Index:   "VTBI", u32 0, then per chunk: u64 first time, u64 last
+///            time, u64 file offset of the chunk.
+///   Trailer: u64 index offset, u64 chunk count, "VTBINDEX".
+///
+/// Each chunk decodes on its own: the reader starts with every signal 0,
+/// the time at the chunk's first time, and the code at 0.  A record is a
+/// varint tag.  An odd tag advances the time by tag >> 1.  An even tag is
+/// a value change; tag >> 1 is the zigzag encoded difference from the
+/// previous record's code, and it is followed by the XOR of the new and
+/// previous value, as one varint for up to 64 bits, otherwise as a varint
+/// per 32-bit word, least significant first.  Each chunk starts with a
+/// change to every signal that is not 0, so no earlier chunk is needed.
+///
+//=============================================================================
+
+// clang-format off
+
+#include "verilatedos.h"
+#include "verilated.h"
+#include "verilated_vtb_c.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+
+#if defined(_WIN32) && !defined(__MINGW32__) && !defined(__CYGWIN__)
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+#ifndef O_LARGEFILE  // For example on WIN32
+# define O_LARGEFILE 0
+#endif
+#ifndef O_CLOEXEC
+# define O_CLOEXEC 0
+#endif
+
+// clang-format on
+
+constexpr vluint32_t VL_TRACE_VTB_VERSION = 1;  // Format version written
+constexpr size_t VL_TRACE_VTB_CHUNK_HEADER = 24;  // Bytes in chunk header
+constexpr size_t VL_TRACE_VTB_MAX_VARINT = 10;  // Maximum bytes of a 64-bit varint
+constexpr size_t VL_TRACE_VTB_MAX_WORD = 5;  // Maximum bytes of a 32-bit varint
+
+//=============================================================================
+// Specialization of the generics for this trace format
+
+#define VL_DERIVED_T VerilatedVtb
+#include "verilated_trace_imp.cpp"
+#undef VL_DERIVED_T
+
+//=============================================================================
+// VerilatedVtb
+
+VerilatedVtb::VerilatedVtb(void* /*filep*/) {}
+
+VerilatedVtb::~VerilatedVtb() {
+    close();
+    if (m_chunkBufp) VL_DO_CLEAR(delete[] m_chunkBufp, m_chunkBufp = nullptr);
+}
+
+void VerilatedVtb::open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock(m_mutex);
+    if (isOpen()) return;
+    m_filename = filename;
+    m_fd = ::open(m_filename.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_LARGEFILE | O_CLOEXEC,
+                  0666);
+    if (!isOpen()) return;  // User code can check isOpen()
+    m_wroteBytes = 0;
+    m_index.clear();
+    m_inChunk = false;
+
+    // Declarations append to m_decls
+    m_signals.clear();
+    m_declared.clear();
+    m_decls.clear();
+    m_declCount = 0;
+    VerilatedTrace<VerilatedVtb>::traceInit();
+    m_values.assign(nextCode(), 0);
+    m_declared.clear();
+
+    std::string header;
+    const std::string timeRes = timeResStr();  // lintok-begin-on-ref
+    appendVarint(header, timeRes.size());
+    header += timeRes;
+    appendVarint(header, m_declCount);
+    header += m_decls;
+    m_decls.clear();
+    std::string prefix = "VTBTRACE";
+    appendFixed(prefix, VL_TRACE_VTB_VERSION, 4);
+    appendFixed(prefix, header.size(), 4);
+    writeBytes(prefix.data(), prefix.size());
+    writeBytes(header.data(), header.size());
+
+    if (!m_chunkBufp) bufferGrow(0);
+    fullDump(true);  // First dump must be full
+}
+
+void VerilatedVtb::close() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock(m_mutex);
+    if (!isOpen()) return;
+    VerilatedTrace<VerilatedVtb>::flushBase();
+    endChunk();
+    // Index then trailer, so readers can find the index from the end of file
+    const vluint64_t indexOffset = m_wroteBytes;
+    std::string index = "VTBI";
+    appendFixed(index, 0, 4);
+    for (const IndexEntry& entry : m_index) {
+        appendFixed(index, entry.m_startTime, 8);
+        appendFixed(index, entry.m_endTime, 8);
+        appendFixed(index, entry.m_offset, 8);
+    }
+    appendFixed(index, indexOffset, 8);
+    appendFixed(index, m_index.size(), 8);
+    index += "VTBINDEX";
+    writeBytes(index.data(), index.size());
+    ::close(m_fd);
+    m_fd = -1;
+    VerilatedTrace<VerilatedVtb>::closeBase();
+}
+
+void VerilatedVtb::flush() VL_MT_SAFE_EXCLUDES(m_mutex) {
+    const VerilatedLockGuard lock(m_mutex);
+    if (!isOpen()) return;
+    VerilatedTrace<VerilatedVtb>::flushBase();
+    // The next change starts a new chunk with a snapshot, so everything
+    // so far can be read back even if the index is never written
+    endChunk();
+}
+
+void VerilatedVtb::appendVarint(std::string& str, vluint64_t val) {
+    while (val >= 0x80) {
+        str += static_cast<char>((val & 0x7f) | 0x80);
+        val >>= 7;
+    }
+    str += static_cast<char>(val);
+}
+
+void VerilatedVtb::appendFixed(std::string& str, vluint64_t val, int bytes) {
+    for (int i = 0; i < bytes; ++i) str += static_cast<char>((val >> (8 * i)) & 0xff);
+}
+
+void VerilatedVtb::writeBytes(const char* bufp, size_t len) {
+    // This function can be called from the trace thread
+    while (len) {
+        errno = 0;
+        const ssize_t got = ::write(m_fd, bufp, len);
+        if (got > 0) {
+            bufp += got;
+            len -= got;
+            m_wroteBytes += got;
+        } else if (VL_UNCOVERABLE(got < 0)) {
+            if (VL_UNCOVERABLE(errno != EAGAIN && errno != EINTR)) {
+                // LCOV_EXCL_START
+                // write failed, presume error (perhaps out of disk space)
+                const std::string msg
+                    = std::string("VerilatedVtb::writeBytes: ") + std::strerror(errno);
+                VL_FATAL_MT("", 0, "", msg.c_str());
+                break;
+                // LCOV_EXCL_STOP
+            }
+        }
+    }
+}
+
+void VerilatedVtb::bufferGrow(size_t minFree) {
+    // The chunk header is filled in when the chunk ends, so reserve room for it
+    const size_t used = m_chunkBufp ? m_writep - m_chunkBufp : VL_TRACE_VTB_CHUNK_HEADER;
+    const size_t size
+        = std::max(2 * (used + minFree), m_chunkBytes + VL_TRACE_VTB_CHUNK_HEADER + 4096);
+    vluint8_t* const newp = new vluint8_t[size];
+    if (m_chunkBufp) {
+        std::memcpy(newp, m_chunkBufp, used);
+        delete[] m_chunkBufp;
+    }
+    m_chunkBufp = newp;
+    m_writep = m_chunkBufp + used;
+    m_chunkEndp = m_chunkBufp + size;
+}
+
+void VerilatedVtb::startChunk(vluint64_t timeui) {
+    m_inChunk = true;
+    m_chunkStartTime = timeui;
+    m_lastTime = timeui;
+    m_lastCode = 0;
+    m_writep = m_chunkBufp + VL_TRACE_VTB_CHUNK_HEADER;
+    // Snapshot of current values, relative to the reader's reset state of 0
+    for (const Signal& sig : m_signals) {
+        const int words = (sig.m_bits + 31) / 32;
+        const vluint32_t* const valp = &m_values[sig.m_code];
+        bool nonZero = false;
+        for (int i = 0; i < words; ++i) nonZero |= valp[i] != 0;
+        if (!nonZero) continue;
+        bufferCheck(VL_TRACE_VTB_MAX_VARINT + words * VL_TRACE_VTB_MAX_WORD);
+        writeCode(sig.m_code);
+        if (sig.m_bits <= 32) {
+            writeVarint(valp[0]);
+        } else if (sig.m_bits <= 64) {
+            writeVarint(static_cast<vluint64_t>(valp[1]) << 32 | valp[0]);
+        } else {
+            for (int i = 0; i < words; ++i) writeVarint(valp[i]);
+        }
+    }
+}
+
+void VerilatedVtb::endChunk() {
+    // This function can be called from the trace thread
+    if (!m_inChunk) return;
+    m_inChunk = false;
+    const size_t payload = m_writep - m_chunkBufp - VL_TRACE_VTB_CHUNK_HEADER;
+    vluint8_t* hp = m_chunkBufp;
+    const auto putFixed = [&hp](vluint64_t val, int bytes) {
+        for (int i = 0; i < bytes; ++i) *hp++ = static_cast<vluint8_t>(val >> (8 * i));
+    };
+    std::memcpy(hp, "VTBC", 4);
+    hp += 4;
+    putFixed(payload, 4);
+    putFixed(m_chunkStartTime, 8);
+    putFixed(m_lastTime, 8);
+    m_index.push_back({m_chunkStartTime, m_lastTime, m_wroteBytes});
+    writeBytes(reinterpret_cast<const char*>(m_chunkBufp), payload + VL_TRACE_VTB_CHUNK_HEADER);
+    m_writep = m_chunkBufp + VL_TRACE_VTB_CHUNK_HEADER;
+}
+
+void VerilatedVtb::emitTimeChange(vluint64_t timeui) {
+    if (m_inChunk) {
+        const size_t payload = m_writep - m_chunkBufp - VL_TRACE_VTB_CHUNK_HEADER;
+        if (payload >= m_chunkBytes
+            || (m_chunkTime && timeui / m_chunkTime != m_chunkStartTime / m_chunkTime)) {
+            endChunk();
+        }
+    }
+    if (!m_inChunk) {
+        // The snapshot takes the place of the time record
+        startChunk(timeui);
+        return;
+    }
+    bufferCheck(VL_TRACE_VTB_MAX_VARINT);
+    writeVarint(((timeui - m_lastTime) << 1) | 1);
+    m_lastTime = timeui;
+}
+
+//=============================================================================
+// Decl
+
+void VerilatedVtb::declare(vluint32_t code, const char* name, bool real, bool array,
+                           int arraynum, bool bussed, int msb, int lsb) {
+    const int bits = ((msb > lsb) ? (msb - lsb) : (lsb - msb)) + 1;
+
+    VerilatedTrace<VerilatedVtb>::declCode(code, bits, false);
+
+    if (m_declared.size() <= code) m_declared.resize(code + 1);
+    if (!m_declared[code]) {  // Else an alias of an earlier signal
+        m_declared[code] = true;
+        m_signals.push_back({code, static_cast<vluint32_t>(bits)});
+    }
+
+    // Split name into scopes and basename, as VerilatedVcd does
+    std::string nameasstr = name;
+    if (!moduleName().empty()) nameasstr = moduleName() + scopeEscape() + nameasstr;
+    std::string hiername;
+    std::string basename;
+    for (const char* cp = nameasstr.c_str(); *cp; ++cp) {
+        if (isScopeEscape(*cp)) {
+            if (!hiername.empty()) hiername += " ";
+            hiername += basename;
+            basename = "";
+        } else {
+            basename += *cp;
+        }
+    }
+    hiername += "\t" + basename;
+    if (array) hiername += "(" + std::to_string(arraynum) + ")";
+
+    const auto zigzag = [](int val) {
+        return (static_cast<vluint64_t>(static_cast<vlsint64_t>(val)) << 1)
+               ^ static_cast<vluint64_t>(static_cast<vlsint64_t>(val) >> 63);
+    };
+    ++m_declCount;
+    appendVarint(m_decls, code);
+    appendVarint(m_decls, bits);
+    m_decls += static_cast<char>((real ? 1 : 0) | (bussed ? 2 : 0));
+    appendVarint(m_decls, zigzag(msb));
+    appendVarint(m_decls, zigzag(lsb));
+    appendVarint(m_decls, hiername.size());
+    m_decls += hiername;
+}
+
+void VerilatedVtb::declBit(vluint32_t code, const char* name, bool array, int arraynum) {
+    declare(code, name, false, array, arraynum, false, 0, 0);
+}
+void VerilatedVtb::declBus(vluint32_t code, const char* name, bool array, int arraynum, int msb,
+                           int lsb) {
+    declare(code, name, false, array, arraynum, true, msb, lsb);
+}
+void VerilatedVtb::declQuad(vluint32_t code, const char* name, bool array, int arraynum, int msb,
+                            int lsb) {
+    declare(code, name, false, array, arraynum, true, msb, lsb);
+}
+void VerilatedVtb::declArray(vluint32_t code, const char* name, bool array, int arraynum,
+                             int msb, int lsb) {
+    declare(code, name, false, array, arraynum, true, msb, lsb);
+}
+void VerilatedVtb::declDouble(vluint32_t code, const char* name, bool array, int arraynum) {
+    declare(code, name, true, array, arraynum, false, 63, 0);
+}
+
+//=============================================================================
+// emit* trace routines
+
+// Note: emit* are only ever called from one place (full* in
+// verilated_trace_imp.cpp, which is included in this file at the top),
+// so always inline them.
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitBit(vluint32_t code, CData newval) {
+    bufferCheck(2 * VL_TRACE_VTB_MAX_VARINT);
+    writeCode(code);
+    vluint32_t& oldval = m_values[code];
+    writeVarint(oldval ^ newval);
+    oldval = newval;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitCData(vluint32_t code, CData newval, int bits) {
+    emitIData(code, newval, bits);
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitSData(vluint32_t code, SData newval, int bits) {
+    emitIData(code, newval, bits);
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitIData(vluint32_t code, IData newval, int /*bits*/) {
+    bufferCheck(2 * VL_TRACE_VTB_MAX_VARINT);
+    writeCode(code);
+    vluint32_t& oldval = m_values[code];
+    writeVarint(oldval ^ newval);
+    oldval = newval;
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitQData(vluint32_t code, QData newval, int /*bits*/) {
+    bufferCheck(2 * VL_TRACE_VTB_MAX_VARINT);
+    writeCode(code);
+    vluint32_t* const oldp = &m_values[code];
+    const vluint64_t oldval = static_cast<vluint64_t>(oldp[1]) << 32 | oldp[0];
+    writeVarint(oldval ^ newval);
+    oldp[0] = static_cast<vluint32_t>(newval);
+    oldp[1] = static_cast<vluint32_t>(newval >> 32);
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitWData(vluint32_t code, const WData* newvalp, int bits) {
+    const int words = (bits + 31) / 32;
+    bufferCheck(VL_TRACE_VTB_MAX_VARINT + words * VL_TRACE_VTB_MAX_WORD);
+    writeCode(code);
+    vluint32_t* const oldp = &m_values[code];
+    for (int i = 0; i < words; ++i) {
+        // 32-bit words regardless of VL_EDATASIZE, so files do not depend on it
+        const vluint32_t newval = static_cast<vluint32_t>(newvalp[i * 32 / VL_EDATASIZE]
+                                                          >> ((i * 32) % VL_EDATASIZE));
+        writeVarint(oldp[i] ^ newval);
+        oldp[i] = newval;
+    }
+}
+
+VL_ATTR_ALWINLINE
+void VerilatedVtb::emitDouble(vluint32_t code, double newval) {
+    vluint64_t bitsval;
+    std::memcpy(&bitsval, &newval, sizeof(bitsval));
+    emitQData(code, bitsval, 64);
+}
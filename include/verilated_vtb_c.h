@@ -0,0 +1,244 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//=============================================================================
+//
+// Code available from: https://verilator.org
+//
+// Copyright 2001-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//=============================================================================
+///
+/// \file
+/// \brief Verilated tracing in VTB (Verilator trace binary) format header
+///
+/// User wrapper code should use this header when creating VTB traces.
+///
+/// VTB is a compact binary format written in independently decodable
+/// chunks, with an index at the end of the file so a reader may seek
+/// directly to the chunk holding a given time.  Use verilator_vtb2vcd to
+/// convert a VTB file, or a time window from it, to VCD or FST.
+///
+//=============================================================================
+
+#ifndef VERILATOR_VERILATED_VTB_C_H_
+#define VERILATOR_VERILATED_VTB_C_H_
+
+#include "verilated.h"
+#include "verilated_trace.h"
+
+#include <string>
+#include <vector>
+
+//=============================================================================
+// VerilatedVtb
+// Base class to create a Verilator VTB dump
+// This is an internally used class - see VerilatedVtbC for what to call from applications
+
+class VerilatedVtb final : public VerilatedTrace<VerilatedVtb> {
+private:
+    // Give the superclass access to private bits (to avoid virtual functions)
+    friend class VerilatedTrace<VerilatedVtb>;
+
+    //=========================================================================
+    // VTB specific internals
+
+    struct Signal {
+        vluint32_t m_code;  // Trace code
+        vluint32_t m_bits;  // Width, 64 for doubles
+    };
+    struct IndexEntry {
+        vluint64_t m_startTime;  // Time of chunk's first record
+        vluint64_t m_endTime;  // Time of chunk's last record
+        vluint64_t m_offset;  // File offset of chunk header
+    };
+
+    int m_fd = -1;  // File descriptor we're writing to
+    std::string m_filename;  // Filename we're writing to (if open)
+    vluint64_t m_wroteBytes = 0;  // Number of bytes written to this file
+    vluint64_t m_chunkBytes = 1024 * 1024;  // Chunk payload size to end chunks at
+    vluint64_t m_chunkTime = 0;  // Time span of each chunk, 0 for none
+
+    // Current chunk, filled by the emit* routines
+    vluint8_t* m_chunkBufp = nullptr;  // Chunk buffer
+    vluint8_t* m_writep = nullptr;  // Write pointer into chunk buffer
+    vluint8_t* m_chunkEndp = nullptr;  // End of chunk buffer
+    bool m_inChunk = false;  // A chunk has been started
+    vluint64_t m_chunkStartTime = 0;  // Time of chunk's first record
+    vluint64_t m_lastTime = 0;  // Time of last time record
+    vluint32_t m_lastCode = 0;  // Code of last value record
+
+    std::vector<vluint32_t> m_values;  // Last value emitted for each code, in 32-bit words
+    std::vector<Signal> m_signals;  // Each unique code declared
+    std::vector<bool> m_declared;  // Code has been added to m_signals
+    std::vector<IndexEntry> m_index;  // Chunks written so far
+    std::string m_decls;  // Declarations, while tracing is initialized
+    vluint32_t m_declCount = 0;  // Number of declarations in m_decls
+
+    // METHODS
+    void bufferGrow(size_t minFree);
+    inline void bufferCheck(size_t maxBytes) {
+        // Record sizes are bounded, so only check once per record
+        if (VL_UNLIKELY(m_writep + maxBytes > m_chunkEndp)) bufferGrow(maxBytes);
+    }
+    inline void writeVarint(vluint64_t val) {
+        while (val >= 0x80) {
+            *m_writep++ = static_cast<vluint8_t>(val | 0x80);
+            val >>= 7;
+        }
+        *m_writep++ = static_cast<vluint8_t>(val);
+    }
+    inline void writeCode(vluint32_t code) {
+        // Zigzag encoded code delta, with a clear low bit marking a value record
+        const vluint64_t delta = static_cast<vluint64_t>(code) - m_lastCode;
+        const vluint64_t zigzag = (delta << 1) ^ (0 - (delta >> 63));
+        writeVarint(zigzag << 1);
+        m_lastCode = code;
+    }
+    static void appendVarint(std::string& str, vluint64_t val);
+    static void appendFixed(std::string& str, vluint64_t val, int bytes);
+    void writeBytes(const char* bufp, size_t len);
+    void startChunk(vluint64_t timeui);
+    void endChunk();
+    void declare(vluint32_t code, const char* name, bool real, bool array, int arraynum,
+                 bool bussed, int msb, int lsb);
+
+    // CONSTRUCTORS
+    VL_UNCOPYABLE(VerilatedVtb);
+
+protected:
+    //=========================================================================
+    // Implementation of VerilatedTrace interface
+
+    // Implementations of protected virtual methods for VerilatedTrace
+    virtual void emitTimeChange(vluint64_t timeui) override;
+
+    // Hooks called from VerilatedTrace
+    virtual bool preFullDump() override { return isOpen(); }
+    virtual bool preChangeDump() override { return isOpen(); }
+
+    // Implementations of duck-typed methods for VerilatedTrace. These are
+    // called from only one place (namely full*) so always inline them.
+    inline void emitBit(vluint32_t code, CData newval);
+    inline void emitCData(vluint32_t code, CData newval, int bits);
+    inline void emitSData(vluint32_t code, SData newval, int bits);
+    inline void emitIData(vluint32_t code, IData newval, int bits);
+    inline void emitQData(vluint32_t code, QData newval, int bits);
+    inline void emitWData(vluint32_t code, const WData* newvalp, int bits);
+    inline void emitDouble(vluint32_t code, double newval);
+
+public:
+    //=========================================================================
+    // External interface to client code
+
+    explicit VerilatedVtb(void* filep = nullptr);
+    ~VerilatedVtb();
+
+    // ACCESSORS
+    // Set payload size in bytes after which a new chunk is started
+    void chunkBytes(vluint64_t bytes) { m_chunkBytes = bytes ? bytes : 1; }
+    // Set time span of each chunk, so chunks start at multiples of it; 0 for no limit
+    void chunkTime(vluint64_t timeui) { m_chunkTime = timeui; }
+
+    // METHODS
+    // Open the file; call isOpen() to see if errors
+    void open(const char* filename) VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Close the file, writing the index
+    void close() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Flush any remaining data to this file, ending the current chunk
+    void flush() VL_MT_SAFE_EXCLUDES(m_mutex);
+    // Return if file is open
+    bool isOpen() const VL_MT_SAFE { return m_fd >= 0; }
+
+    //=========================================================================
+    // Internal interface to Verilator generated code
+
+    void declBit(vluint32_t code, const char* name, bool array, int arraynum);
+    void declBus(vluint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declQuad(vluint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declArray(vluint32_t code, const char* name, bool array, int arraynum, int msb, int lsb);
+    void declDouble(vluint32_t code, const char* name, bool array, int arraynum);
+};
+
+#ifndef DOXYGEN
+// Declare specialization here as it's used in VerilatedVtbC just below
+template <> void VerilatedTrace<VerilatedVtb>::dump(vluint64_t timeui);
+template <> void VerilatedTrace<VerilatedVtb>::flightRecorder(vluint32_t dumps);
+template <> void VerilatedTrace<VerilatedVtb>::flightRecorderWrite();
+template <> void VerilatedTrace<VerilatedVtb>::set_time_unit(const char* unitp);
+template <> void VerilatedTrace<VerilatedVtb>::set_time_unit(const std::string& unit);
+template <> void VerilatedTrace<VerilatedVtb>::set_time_resolution(const char* unitp);
+template <> void VerilatedTrace<VerilatedVtb>::set_time_resolution(const std::string& unit);
+#endif
+
+//=============================================================================
+// VerilatedVtbC
+/// Create a VTB dump file in C standalone (no SystemC) simulations.
+
+class VerilatedVtbC VL_NOT_FINAL {
+    VerilatedVtb m_sptrace;  // Trace file being created
+
+    // CONSTRUCTORS
+    VL_UNCOPYABLE(VerilatedVtbC);
+
+public:
+    /// Construct the dump. Optional argument is ignored.
+    explicit VerilatedVtbC(void* filep = nullptr)
+        : m_sptrace{filep} {}
+    /// Destruct, flush, and close the dump
+    ~VerilatedVtbC() { close(); }
+
+    // METHODS - User called
+
+    /// Return if file is open
+    bool isOpen() const VL_MT_SAFE { return m_sptrace.isOpen(); }
+    /// Open a new VTB file
+    void open(const char* filename) VL_MT_SAFE { m_sptrace.open(filename); }
+    /// Close dump, writing the index
+    void close() VL_MT_SAFE { m_sptrace.close(); }
+    /// Flush dump
+    void flush() VL_MT_SAFE { m_sptrace.flush(); }
+    /// Keep only the last given number of dumps in memory, writing them
+    /// only on flightRecorderWrite(), or on a flush after an error such as
+    /// $stop, $fatal or a failed assertion.  Call before the first dump.
+    void flightRecorder(vluint32_t dumps) VL_MT_SAFE { m_sptrace.flightRecorder(dumps); }
+    /// Write the dumps kept by flightRecorder()
+    void flightRecorderWrite() VL_MT_SAFE { m_sptrace.flightRecorderWrite(); }
+    /// Set payload size in bytes after which a new chunk is started, default 1 MiB
+    void chunkBytes(vluint64_t bytes) VL_MT_UNSAFE { m_sptrace.chunkBytes(bytes); }
+    /// Set time span of each chunk, so chunks start at multiples of it,
+    /// default 0 for no limit
+    void chunkTime(vluint64_t timeui) VL_MT_UNSAFE { m_sptrace.chunkTime(timeui); }
+    /// Write one cycle of dump data
+    void dump(vluint64_t timeui) { m_sptrace.dump(timeui); }
+    /// Write one cycle of dump data - backward compatible and to reduce
+    /// conversion warnings.  It's better to use a vluint64_t time instead.
+    void dump(double timestamp) { dump(static_cast<vluint64_t>(timestamp)); }
+    void dump(vluint32_t timestamp) { dump(static_cast<vluint64_t>(timestamp)); }
+    void dump(int timestamp) { dump(static_cast<vluint64_t>(timestamp)); }
+
+    // METHODS - Internal/backward compatible
+    // \protectedsection
+
+    // Set time units (s/ms, defaults to ns)
+    // Users should not need to call this, as for Verilated models, these
+    // propage from the Verilated default timeunit
+    void set_time_unit(const char* unitp) VL_MT_SAFE { m_sptrace.set_time_unit(unitp); }
+    void set_time_unit(const std::string& unit) VL_MT_SAFE { m_sptrace.set_time_unit(unit); }
+    // Set time resolution (s/ms, defaults to ns)
+    // Users should not need to call this, as for Verilated models, these
+    // propage from the Verilated default timeprecision
+    void set_time_resolution(const char* unitp) VL_MT_SAFE {
+        m_sptrace.set_time_resolution(unitp);
+    }
+    void set_time_resolution(const std::string& unit) VL_MT_SAFE {
+        m_sptrace.set_time_resolution(unit);
+    }
+
+    // Internal class access
+    inline VerilatedVtb* spTrace() { return &m_sptrace; };
+};
+
+#endif  // guard
@@ -382,8 +382,13 @@ typedef unsigned long long vluint64_t;  ///< 64-bit unsigned type
 #define VL_SHORTSIZE 16  ///< Bits in a SData / short
 #define VL_IDATASIZE 32  ///< Bits in a IData / word
 #define VL_QUADSIZE 64  ///< Bits in a QData / quadword
-#define VL_EDATASIZE 32  ///< Bits in a EData (WData entry)
-#define VL_EDATASIZE_LOG2 5  ///< log2(VL_EDATASIZE)
+#ifdef VL_EDATA64  // Verilated with --wide-word-size 64
+# define VL_EDATASIZE 64  ///< Bits in a EData (WData entry)
+# define VL_EDATASIZE_LOG2 6  ///< log2(VL_EDATASIZE)
+#else
+# define VL_EDATASIZE 32  ///< Bits in a EData (WData entry)
+# define VL_EDATASIZE_LOG2 5  ///< log2(VL_EDATASIZE)
+#endif
 #define VL_CACHE_LINE_BYTES 64  ///< Bytes in a cache line (for alignment)
 
 #ifndef VL_NO_LEGACY
@@ -419,7 +424,7 @@ typedef unsigned long long vluint64_t;  ///< 64-bit unsigned type
 
 #define VL_SIZEBITS_I (VL_IDATASIZE - 1)  ///< Bit mask for bits in a word
 #define VL_SIZEBITS_Q (VL_QUADSIZE - 1)  ///< Bit mask for bits in a quad
-#define VL_SIZEBITS_E (VL_EDATASIZE - 1)  ///< Bit mask for bits in a quad
+#define VL_SIZEBITS_E (VL_EDATASIZE - 1)  ///< Bit mask for bits in a EData
 
 /// Return mask for words with 1's where relevant bits are (0=all bits)
 #define VL_MASK_I(nbits) (((nbits) & VL_SIZEBITS_I) ? ((1U << ((nbits) & VL_SIZEBITS_I)) - 1) : ~0)
@@ -427,8 +432,13 @@ typedef unsigned long long vluint64_t;  ///< 64-bit unsigned type
 #define VL_MASK_Q(nbits) \
     (((nbits) & VL_SIZEBITS_Q) ? ((1ULL << ((nbits) & VL_SIZEBITS_Q)) - 1ULL) : ~0ULL)
 /// Return mask for EData with 1's where relevant bits are (0=all bits)
-#define VL_MASK_E(nbits) VL_MASK_I(nbits)
-#define VL_EUL(n) VL_UL(n)  // Make constant number EData sized
+#ifdef VL_EDATA64
+# define VL_MASK_E(nbits) VL_MASK_Q(nbits)
+# define VL_EUL(n) (static_cast<QData>(n##ULL))  // Make constant number EData sized
+#else
+# define VL_MASK_E(nbits) VL_MASK_I(nbits)
+# define VL_EUL(n) VL_UL(n)  // Make constant number EData sized
+#endif
 
 #define VL_BITWORD_I(bit) ((bit) / VL_IDATASIZE)  ///< Word number for sv DPI vectors
 #define VL_BITWORD_E(bit) ((bit) >> VL_EDATASIZE_LOG2)  ///< Word number for a wide quantity
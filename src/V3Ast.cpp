@@ -30,23 +30,13 @@
 // Statics
 
 vluint64_t AstNode::s_editCntLast = 0;
-vluint64_t AstNode::s_editCntGbl = 0;  // Hot cache line
+std::atomic<vluint64_t> AstNode::s_editCntGbl{0};  // Hot cache line
 
 // To allow for fast clearing of all user pointers, we keep a "timestamp"
 // along with each userp, and thus by bumping this count we can make it look
 // as if we iterated across the entire tree to set all the userp's to null.
-int AstNode::s_cloneCntGbl = 0;
-uint32_t AstUser1InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
-uint32_t AstUser2InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
-uint32_t AstUser3InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
-uint32_t AstUser4InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
-uint32_t AstUser5InUse::s_userCntGbl = 0;  // Hot cache line, leave adjacent
-
-bool AstUser1InUse::s_userBusy = false;
-bool AstUser2InUse::s_userBusy = false;
-bool AstUser3InUse::s_userBusy = false;
-bool AstUser4InUse::s_userBusy = false;
-bool AstUser5InUse::s_userBusy = false;
+std::atomic<int> AstNode::s_cloneGenGbl{0};
+std::atomic<uint32_t> AstUserInUseBase::s_userGenGbl{0};
 
 int AstNodeDType::s_uniqueNum = 0;
 
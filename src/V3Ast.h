@@ -25,6 +25,7 @@
 #include "V3Number.h"
 #include "V3Global.h"
 
+#include <atomic>
 #include <cmath>
 #include <unordered_set>
 
@@ -1157,6 +1158,14 @@ public:
 
 class AstUserInUseBase VL_NOT_FINAL {
 protected:
+    // The in-use state is per thread so module-local passes may run
+    // concurrently (see V3ThreadPool); generation numbers are allocated
+    // globally so a node's stale count can never match another thread's.
+    // The per thread state is in function-local statics, as being constant
+    // initialized these compile to a plain thread pointer relative load,
+    // where a thread_local class member needs a call to its TLS wrapper
+    // function in every other translation unit.
+    static std::atomic<uint32_t> s_userGenGbl;  // Last generation number handed out
     static void allocate(int id, uint32_t& cntGblRef, bool& userBusyRef) {
         // Perhaps there's still a AstUserInUse in scope for this?
         UASSERT_STATIC(!userBusyRef, "Conflicting user use; AstUser" + cvtToStr(id)
@@ -1173,7 +1182,7 @@ protected:
         UASSERT_STATIC(userBusyRef, "Clear of User" + cvtToStr(id) + "() not under AstUserInUse");
         // If this really fires and is real (after 2^32 edits???)
         // we could just walk the tree and clear manually
-        ++cntGblRef;
+        cntGblRef = ++s_userGenGbl;
         UASSERT_STATIC(cntGblRef, "User*() overflowed!");
     }
     static void checkcnt(int id, uint32_t&, const bool& userBusyRef) {
@@ -1189,57 +1198,67 @@ protected:
 class AstUser1InUse final : AstUserInUseBase {
 protected:
     friend class AstNode;
-    static uint32_t     s_userCntGbl;   // Count of which usage of userp() this is
-    static bool         s_userBusy;     // Count is in use
+    // Count of which usage of userp() this is
+    static uint32_t& userCntGbl() { static thread_local uint32_t s_cnt = 0; return s_cnt; }
+    // Count is in use
+    static bool& userBusy() { static thread_local bool s_busy = false; return s_busy; }
 public:
-    AstUser1InUse()     { allocate(1, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    ~AstUser1InUse()    { free    (1, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void clear() { clearcnt(1, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void check() { checkcnt(1, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
+    AstUser1InUse()     { allocate(1, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    ~AstUser1InUse()    { free    (1, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void clear() { clearcnt(1, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void check() { checkcnt(1, userCntGbl()/*ref*/, userBusy()/*ref*/); }
 };
 class AstUser2InUse final : AstUserInUseBase {
 protected:
     friend class AstNode;
-    static uint32_t     s_userCntGbl;   // Count of which usage of userp() this is
-    static bool         s_userBusy;     // Count is in use
+    // Count of which usage of userp() this is
+    static uint32_t& userCntGbl() { static thread_local uint32_t s_cnt = 0; return s_cnt; }
+    // Count is in use
+    static bool& userBusy() { static thread_local bool s_busy = false; return s_busy; }
 public:
-    AstUser2InUse()     { allocate(2, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    ~AstUser2InUse()    { free    (2, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void clear() { clearcnt(2, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void check() { checkcnt(2, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
+    AstUser2InUse()     { allocate(2, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    ~AstUser2InUse()    { free    (2, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void clear() { clearcnt(2, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void check() { checkcnt(2, userCntGbl()/*ref*/, userBusy()/*ref*/); }
 };
 class AstUser3InUse final : AstUserInUseBase {
 protected:
     friend class AstNode;
-    static uint32_t     s_userCntGbl;   // Count of which usage of userp() this is
-    static bool         s_userBusy;     // Count is in use
+    // Count of which usage of userp() this is
+    static uint32_t& userCntGbl() { static thread_local uint32_t s_cnt = 0; return s_cnt; }
+    // Count is in use
+    static bool& userBusy() { static thread_local bool s_busy = false; return s_busy; }
 public:
-    AstUser3InUse()     { allocate(3, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    ~AstUser3InUse()    { free    (3, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void clear() { clearcnt(3, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void check() { checkcnt(3, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
+    AstUser3InUse()     { allocate(3, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    ~AstUser3InUse()    { free    (3, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void clear() { clearcnt(3, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void check() { checkcnt(3, userCntGbl()/*ref*/, userBusy()/*ref*/); }
 };
 class AstUser4InUse final : AstUserInUseBase {
 protected:
     friend class AstNode;
-    static uint32_t     s_userCntGbl;   // Count of which usage of userp() this is
-    static bool         s_userBusy;     // Count is in use
+    // Count of which usage of userp() this is
+    static uint32_t& userCntGbl() { static thread_local uint32_t s_cnt = 0; return s_cnt; }
+    // Count is in use
+    static bool& userBusy() { static thread_local bool s_busy = false; return s_busy; }
 public:
-    AstUser4InUse()     { allocate(4, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    ~AstUser4InUse()    { free    (4, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void clear() { clearcnt(4, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void check() { checkcnt(4, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
+    AstUser4InUse()     { allocate(4, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    ~AstUser4InUse()    { free    (4, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void clear() { clearcnt(4, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void check() { checkcnt(4, userCntGbl()/*ref*/, userBusy()/*ref*/); }
 };
 class AstUser5InUse final : AstUserInUseBase {
 protected:
     friend class AstNode;
-    static uint32_t     s_userCntGbl;   // Count of which usage of userp() this is
-    static bool         s_userBusy;     // Count is in use
+    // Count of which usage of userp() this is
+    static uint32_t& userCntGbl() { static thread_local uint32_t s_cnt = 0; return s_cnt; }
+    // Count is in use
+    static bool& userBusy() { static thread_local bool s_busy = false; return s_busy; }
 public:
-    AstUser5InUse()     { allocate(5, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    ~AstUser5InUse()    { free    (5, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void clear() { clearcnt(5, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
-    static void check() { checkcnt(5, s_userCntGbl/*ref*/, s_userBusy/*ref*/); }
+    AstUser5InUse()     { allocate(5, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    ~AstUser5InUse()    { free    (5, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void clear() { clearcnt(5, userCntGbl()/*ref*/, userBusy()/*ref*/); }
+    static void check() { checkcnt(5, userCntGbl()/*ref*/, userBusy()/*ref*/); }
 };
 // clang-format on
 
@@ -1414,12 +1433,17 @@ class AstNode VL_NOT_FINAL {
     AstNode* m_headtailp;  // When at begin/end of list, the opposite end of the list
     FileLine* m_fileline;  // Where it was declared
     vluint64_t m_editCount;  // When it was last edited
-    static vluint64_t s_editCntGbl;  // Global edit counter
+    static std::atomic<vluint64_t> s_editCntGbl;  // Global edit counter
     // Global edit counter, last value for printing * near node #s
     static vluint64_t s_editCntLast;
 
     AstNode* m_clonep;  // Pointer to clone of/ source of this module (for *LAST* cloneTree() ONLY)
-    static int s_cloneCntGbl;  // Count of which userp is set
+    // Count of which userp is set, per thread as for AstUserInUseBase
+    static int& cloneCntGbl() {
+        static thread_local int s_cnt = 0;
+        return s_cnt;
+    }
+    static std::atomic<int> s_cloneGenGbl;  // Last cloneCntGbl() handed out, over all threads
 
     // Attributes
     bool m_didWidth : 1;  // Did V3Width computation
@@ -1506,11 +1530,11 @@ protected:
 
     void clonep(AstNode* nodep) {
         m_clonep = nodep;
-        m_cloneCnt = s_cloneCntGbl;
+        m_cloneCnt = cloneCntGbl();
     }
     static void cloneClearTree() {
-        s_cloneCntGbl++;
-        UASSERT_STATIC(s_cloneCntGbl, "Rollover");
+        cloneCntGbl() = ++s_cloneGenGbl;
+        UASSERT_STATIC(cloneCntGbl(), "Rollover");
     }
 
 public:
@@ -1525,7 +1549,7 @@ public:
     AstNode* op3p() const { return m_op3p; }
     AstNode* op4p() const { return m_op4p; }
     AstNodeDType* dtypep() const { return m_dtypep; }
-    AstNode* clonep() const { return ((m_cloneCnt == s_cloneCntGbl) ? m_clonep : nullptr); }
+    AstNode* clonep() const { return ((m_cloneCnt == cloneCntGbl()) ? m_clonep : nullptr); }
     AstNode* firstAbovep() const {  // Returns nullptr when second or later in list
         return ((backp() && backp()->nextp() != this) ? backp() : nullptr);
     }
@@ -1603,7 +1627,7 @@ public:
     int widthMinV() const {
         return v3Global.widthMinUsage() == VWidthMinUsage::VERILOG_WIDTH ? widthMin() : width();
     }
-    int widthWords() const { return VL_WORDS_I(width()); }
+    int widthWords() const { return v3Global.opt.wideWords(width()); }
     bool isQuad() const { return (width() > VL_IDATASIZE && width() <= VL_QUADSIZE); }
     bool isWide() const { return (width() > VL_QUADSIZE); }
     bool isDouble() const;
@@ -1613,11 +1637,11 @@ public:
     // clang-format off
     VNUser      user1u() const {
         // Slows things down measurably, so disabled by default
-        //UASSERT_STATIC(AstUser1InUse::s_userBusy, "userp set w/o busy");
-        return ((m_user1Cnt==AstUser1InUse::s_userCntGbl) ? m_user1u : VNUser(0));
+        //UASSERT_STATIC(AstUser1InUse::userBusy(), "userp set w/o busy");
+        return ((m_user1Cnt==AstUser1InUse::userCntGbl()) ? m_user1u : VNUser(0));
     }
     AstNode*    user1p() const { return user1u().toNodep(); }
-    void        user1u(const VNUser& user) { m_user1u=user; m_user1Cnt=AstUser1InUse::s_userCntGbl; }
+    void        user1u(const VNUser& user) { m_user1u=user; m_user1Cnt=AstUser1InUse::userCntGbl(); }
     void        user1p(void* userp) { user1u(VNUser(userp)); }
     int         user1() const { return user1u().toInt(); }
     void        user1(int val) { user1u(VNUser(val)); }
@@ -1627,11 +1651,11 @@ public:
 
     VNUser      user2u() const {
         // Slows things down measurably, so disabled by default
-        //UASSERT_STATIC(AstUser2InUse::s_userBusy, "userp set w/o busy");
-        return ((m_user2Cnt==AstUser2InUse::s_userCntGbl) ? m_user2u : VNUser(0));
+        //UASSERT_STATIC(AstUser2InUse::userBusy(), "userp set w/o busy");
+        return ((m_user2Cnt==AstUser2InUse::userCntGbl()) ? m_user2u : VNUser(0));
     }
     AstNode*    user2p() const { return user2u().toNodep(); }
-    void        user2u(const VNUser& user) { m_user2u=user; m_user2Cnt=AstUser2InUse::s_userCntGbl; }
+    void        user2u(const VNUser& user) { m_user2u=user; m_user2Cnt=AstUser2InUse::userCntGbl(); }
     void        user2p(void* userp) { user2u(VNUser(userp)); }
     int         user2() const { return user2u().toInt(); }
     void        user2(int val) { user2u(VNUser(val)); }
@@ -1641,11 +1665,11 @@ public:
 
     VNUser      user3u() const {
         // Slows things down measurably, so disabled by default
-        //UASSERT_STATIC(AstUser3InUse::s_userBusy, "userp set w/o busy");
-        return ((m_user3Cnt==AstUser3InUse::s_userCntGbl) ? m_user3u : VNUser(0));
+        //UASSERT_STATIC(AstUser3InUse::userBusy(), "userp set w/o busy");
+        return ((m_user3Cnt==AstUser3InUse::userCntGbl()) ? m_user3u : VNUser(0));
     }
     AstNode*    user3p() const { return user3u().toNodep(); }
-    void        user3u(const VNUser& user) { m_user3u=user; m_user3Cnt=AstUser3InUse::s_userCntGbl; }
+    void        user3u(const VNUser& user) { m_user3u=user; m_user3Cnt=AstUser3InUse::userCntGbl(); }
     void        user3p(void* userp) { user3u(VNUser(userp)); }
     int         user3() const { return user3u().toInt(); }
     void        user3(int val) { user3u(VNUser(val)); }
@@ -1655,11 +1679,11 @@ public:
 
     VNUser      user4u() const {
         // Slows things down measurably, so disabled by default
-        //UASSERT_STATIC(AstUser4InUse::s_userBusy, "userp set w/o busy");
-        return ((m_user4Cnt==AstUser4InUse::s_userCntGbl) ? m_user4u : VNUser(0));
+        //UASSERT_STATIC(AstUser4InUse::userBusy(), "userp set w/o busy");
+        return ((m_user4Cnt==AstUser4InUse::userCntGbl()) ? m_user4u : VNUser(0));
     }
     AstNode*    user4p() const { return user4u().toNodep(); }
-    void        user4u(const VNUser& user) { m_user4u=user; m_user4Cnt=AstUser4InUse::s_userCntGbl; }
+    void        user4u(const VNUser& user) { m_user4u=user; m_user4Cnt=AstUser4InUse::userCntGbl(); }
     void        user4p(void* userp) { user4u(VNUser(userp)); }
     int         user4() const { return user4u().toInt(); }
     void        user4(int val) { user4u(VNUser(val)); }
@@ -1669,11 +1693,11 @@ public:
 
     VNUser      user5u() const {
         // Slows things down measurably, so disabled by default
-        //UASSERT_STATIC(AstUser5InUse::s_userBusy, "userp set w/o busy");
-        return ((m_user5Cnt==AstUser5InUse::s_userCntGbl) ? m_user5u : VNUser(0));
+        //UASSERT_STATIC(AstUser5InUse::userBusy(), "userp set w/o busy");
+        return ((m_user5Cnt==AstUser5InUse::userCntGbl()) ? m_user5u : VNUser(0));
     }
     AstNode*    user5p() const { return user5u().toNodep(); }
-    void        user5u(const VNUser& user) { m_user5u=user; m_user5Cnt=AstUser5InUse::s_userCntGbl; }
+    void        user5u(const VNUser& user) { m_user5u=user; m_user5Cnt=AstUser5InUse::userCntGbl(); }
     void        user5p(void* userp) { user5u(VNUser(userp)); }
     int         user5() const { return user5u().toInt(); }
     void        user5(int val) { user5u(VNUser(val)); }
@@ -1729,6 +1753,10 @@ public:
     void dtypeSetSigned32() { dtypep(findSigned32DType()); }
     void dtypeSetUInt32() { dtypep(findUInt32DType()); }  // Twostate
     void dtypeSetUInt64() { dtypep(findUInt64DType()); }  // Twostate
+    void dtypeSetEData() {  // Twostate, one word of wide data
+        dtypep(v3Global.opt.wideWordSize() == VL_QUADSIZE ? findUInt64DType()
+                                                          : findUInt32DType());
+    }
     void dtypeSetVoid() { dtypep(findVoidDType()); }
 
     // Data type locators
@@ -2441,7 +2469,9 @@ public:
     bool isSigned() const { return m_numeric.isSigned(); }
     bool isNosign() const { return m_numeric.isNosign(); }
     VSigning numeric() const { return m_numeric; }
-    int widthWords() const { return VL_WORDS_I(width()); }
+    int widthWords() const { return v3Global.opt.wideWords(width()); }
+    // Words in svBitVecVal/svLogicVecVal, which are always 32 bits
+    int widthWordsDpi() const { return (width() + VL_IDATASIZE - 1) / VL_IDATASIZE; }
     int widthMin() const {  // If sized, the size, if unsized the min digits to represent it
         return m_widthMin ? m_widthMin : m_width;
     }
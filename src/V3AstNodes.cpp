@@ -26,6 +26,7 @@
 #include "V3EmitCBase.h"
 
 #include <iomanip>
+#include <mutex>
 #include <vector>
 
 //======================================================================
@@ -139,7 +140,7 @@ int AstBasicDType::widthTotalBytes() const {
     } else if (isQuad()) {
         return 8;
     } else {
-        return widthWords() * (VL_EDATASIZE / 8);
+        return widthWords() * (v3Global.opt.wideWordSize() / 8);
     }
 }
 
@@ -151,7 +152,7 @@ int AstNodeUOrStructDType::widthTotalBytes() const {
     } else if (isQuad()) {
         return 8;
     } else {
-        return widthWords() * (VL_EDATASIZE / 8);
+        return widthWords() * (v3Global.opt.wideWordSize() / 8);
     }
 }
 
@@ -862,6 +863,10 @@ bool AstSenTree::hasCombo() const {
     return false;
 }
 
+// Module-local passes may run in parallel (V3ThreadPool) and create
+// constants, so lookups that may insert into the table are serialized
+static std::recursive_mutex s_typeTableMutex;
+
 void AstTypeTable::clearCache() {
     // When we mass-change widthMin in V3WidthCommit, we need to correct the table.
     // Just clear out the maps; the search functions will be used to rebuild the map
@@ -884,6 +889,7 @@ void AstTypeTable::repairCache() {
 }
 
 AstVoidDType* AstTypeTable::findVoidDType(FileLine* fl) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     if (VL_UNLIKELY(!m_voidp)) {
         AstVoidDType* newp = new AstVoidDType(fl);
         addTypesp(newp);
@@ -893,6 +899,7 @@ AstVoidDType* AstTypeTable::findVoidDType(FileLine* fl) {
 }
 
 AstQueueDType* AstTypeTable::findQueueIndexDType(FileLine* fl) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     if (VL_UNLIKELY(!m_queueIndexp)) {
         AstQueueDType* newp = new AstQueueDType(fl, AstNode::findUInt32DType(), nullptr);
         addTypesp(newp);
@@ -902,6 +909,7 @@ AstQueueDType* AstTypeTable::findQueueIndexDType(FileLine* fl) {
 }
 
 AstBasicDType* AstTypeTable::findBasicDType(FileLine* fl, AstBasicDTypeKwd kwd) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     if (m_basicps[kwd]) return m_basicps[kwd];
     //
     AstBasicDType* new1p = new AstBasicDType(fl, kwd);
@@ -921,6 +929,7 @@ AstBasicDType* AstTypeTable::findBasicDType(FileLine* fl, AstBasicDTypeKwd kwd)
 
 AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, AstBasicDTypeKwd kwd, int width,
                                                int widthMin, VSigning numeric) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     AstBasicDType* new1p = new AstBasicDType(fl, kwd, numeric, width, widthMin);
     AstBasicDType* newp = findInsertSameDType(new1p);
     if (newp != new1p) {
@@ -934,6 +943,7 @@ AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, AstBasicDTypeKwd kw
 AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, AstBasicDTypeKwd kwd,
                                                const VNumRange& range, int widthMin,
                                                VSigning numeric) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     AstBasicDType* new1p = new AstBasicDType(fl, kwd, numeric, range, widthMin);
     AstBasicDType* newp = findInsertSameDType(new1p);
     if (newp != new1p) {
@@ -945,6 +955,7 @@ AstBasicDType* AstTypeTable::findLogicBitDType(FileLine* fl, AstBasicDTypeKwd kw
 }
 
 AstBasicDType* AstTypeTable::findInsertSameDType(AstBasicDType* nodep) {
+    const std::lock_guard<std::recursive_mutex> lock(s_typeTableMutex);
     VBasicTypeKey key(nodep->width(), nodep->widthMin(), nodep->numeric(), nodep->keyword(),
                       nodep->nrange());
     DetailedMap& mapr = m_detailedMap;
@@ -1534,6 +1545,7 @@ void AstVar::dump(std::ostream& str) const {
     if (isUsedClock()) str << " [CLK]";
     if (isSigPublic()) str << " [P]";
     if (isLatched()) str << " [LATCHED]";
+    if (isVpiDirty()) str << " [VPIDIRTY]";
     if (isUsedLoopIdx()) str << " [LOOP]";
     if (attrClockEn()) str << " [aCLKEN]";
     if (attrIsolateAssign()) str << " [aISO]";
@@ -123,9 +123,9 @@ public:
     class SizedEData {};  // for creator type-overload selection
     AstConst(FileLine* fl, SizedEData, vluint64_t num)
         : ASTGEN_SUPER(fl)
-        , m_num(this, VL_EDATASIZE, 0) {
+        , m_num(this, v3Global.opt.wideWordSize(), 0) {
         m_num.setQuad(num);
-        dtypeSetLogicSized(VL_EDATASIZE, VSigning::UNSIGNED);
+        dtypeSetLogicSized(v3Global.opt.wideWordSize(), VSigning::UNSIGNED);
     }
     class RealDouble {};  // for creator type-overload selection
     AstConst(FileLine* fl, RealDouble, double num)
@@ -1645,7 +1645,7 @@ class AstWordSel final : public AstNodeSel {
 public:
     AstWordSel(FileLine* fl, AstNode* fromp, AstNode* bitp)
         : ASTGEN_SUPER(fl, fromp, bitp) {
-        dtypeSetUInt32();  // Always used on WData arrays so returns edata size
+        dtypeSetEData();  // Always used on WData arrays so returns edata size
     }
     ASTNODE_NODE_FUNCS(WordSel)
     virtual AstNode* cloneType(AstNode* lhsp, AstNode* rhsp) override {
@@ -1952,6 +1952,7 @@ private:
     bool m_overridenParam : 1;  // Overridden parameter by #(...) or defparam
     bool m_trace : 1;  // Trace this variable
     bool m_isLatched : 1;  // Not assigned in all control paths of combo always
+    bool m_vpiDirty : 1;  // Has a VPI dirty flag variable, see vpiDirtyName()
     VLifetime m_lifetime;  // Lifetime
     VVarAttrClocker m_attrClocker;
     MTaskIdSet m_mtaskIds;  // MTaskID's that read or write this var
@@ -1993,6 +1994,7 @@ private:
         m_overridenParam = false;
         m_trace = false;
         m_isLatched = false;
+        m_vpiDirty = false;
         m_attrClocker = VVarAttrClocker::CLOCKER_UNKNOWN;
     }
 
@@ -2205,6 +2207,9 @@ public:
     bool isConst() const { return m_isConst; }
     bool isStatic() const { return m_isStatic; }
     bool isLatched() const { return m_isLatched; }
+    bool isVpiDirty() const { return m_vpiDirty; }
+    void vpiDirty(bool flag) { m_vpiDirty = flag; }
+    string vpiDirtyName() const { return "__Vvpidirty__" + name(); }
     bool isFuncLocal() const { return m_funcLocal; }
     bool isFuncReturn() const { return m_funcReturn; }
     bool isPullup() const { return m_isPullup; }
@@ -5284,7 +5289,7 @@ public:
         , m_arrayRange{arrayRange}
         , m_codeInc(
               ((arrayRange.ranged() ? arrayRange.elements() : 1) * valuep->dtypep()->widthWords()
-               * (VL_EDATASIZE / 32)))  // A code is always 32-bits
+               * (v3Global.opt.wideWordSize() / 32)))  // A code is always 32-bits
         , m_varType{varp->varType()}
         , m_declKwd{varp->declKwd()}
         , m_declDirection{varp->declDirection()}
@@ -32,6 +32,7 @@
 #include "V3AstConstOnly.h"
 
 #include <algorithm>
+#include <mutex>
 #include <unordered_map>
 
 //######################################################################
@@ -326,8 +327,17 @@ void V3Broken::brokenAll(AstNetlist* nodep) {
     }
 }
 
-void V3Broken::addNewed(AstNode* nodep) { BrokenTable::addNewed(nodep); }
-void V3Broken::deleted(AstNode* nodep) { BrokenTable::deleted(nodep); }
+// Nodes may be created and deleted by module-local passes running in parallel
+static std::mutex s_newedMutex;
+
+void V3Broken::addNewed(AstNode* nodep) {
+    const std::lock_guard<std::mutex> lock(s_newedMutex);
+    BrokenTable::addNewed(nodep);
+}
+void V3Broken::deleted(AstNode* nodep) {
+    const std::lock_guard<std::mutex> lock(s_newedMutex);
+    BrokenTable::deleted(nodep);
+}
 bool V3Broken::isAllocated(AstNode* nodep) { return BrokenTable::isAllocated(nodep); }
 void V3Broken::selfTest() {
     // Warmup addNewed and deleted for coverage, as otherwise only with VL_LEAK_CHECKS
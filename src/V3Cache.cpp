@@ -0,0 +1,184 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Persistent cache of Verilated output
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// V3Cache's Transformations:
+//
+//  Each preprocessed input file is hashed as it is read.  Once all
+//  input is read, the key is the hash of these, the Verilator version
+//  and the command line.  If a previous run with the same key saved
+//  its output files, they are copied into the --Mdir and the rest of
+//  Verilation is skipped.  Otherwise after Verilation, the files
+//  written into the --Mdir are saved under the key.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Global.h"
+#include "V3Cache.h"
+#include "V3File.h"
+#include "V3Os.h"
+#include "V3String.h"
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+//######################################################################
+// Cache state
+
+class V3CacheImp final {
+public:
+    // MEMBERS
+    static string s_inputs;  // Digest of each input file, in read order
+    static string s_key;  // Final key, once computed
+    static bool s_restored;  // Output was restored from cache
+
+    // METHODS
+    static string entryDir() { return v3Global.opt.cacheDir() + "/" + s_key; }
+    static string manifestName() { return "V3Cache.files"; }
+    static bool readFile(const string& filename, string& contents) {
+        const std::unique_ptr<std::ifstream> ifp(V3File::new_ifstream_nodepend(filename));
+        if (ifp->fail()) return false;
+        contents.assign(std::istreambuf_iterator<char>(*ifp), std::istreambuf_iterator<char>());
+        return !ifp->bad();
+    }
+    static bool writeFile(const string& filename, const string& contents) {
+        const std::unique_ptr<std::ofstream> ofp(V3File::new_ofstream_nodepend(filename));
+        if (ofp->fail()) return false;
+        ofp->write(contents.data(), contents.size());
+        ofp->close();
+        return !ofp->fail();
+    }
+    static void removeDir(const string& dirname) {
+        V3Os::unlinkRegexp(dirname, "*");
+        std::remove(dirname.c_str());
+    }
+    static bool endsWith(const string& str, const string& suffix) {
+        return str.length() >= suffix.length()
+               && str.compare(str.length() - suffix.length(), suffix.length(), suffix) == 0;
+    }
+    static bool cached(const string& filename) {
+        // Written by every run after Verilation, or debug dumps, so not part of the output
+        return !endsWith(filename, "__verFiles.dat") && !endsWith(filename, "__ver.d")
+               && !endsWith(filename, ".tree") && !endsWith(filename, ".dot");
+    }
+};
+
+string V3CacheImp::s_inputs;
+string V3CacheImp::s_key;
+bool V3CacheImp::s_restored = false;
+
+//######################################################################
+// V3Cache
+
+bool V3Cache::enabled() {
+    return !v3Global.opt.cacheDir().empty() && !v3Global.opt.preprocOnly()
+           && !v3Global.opt.lintOnly() && !v3Global.opt.xmlOnly()
+           && !v3Global.opt.dpiHdrOnly() && !v3Global.opt.cdc()
+           // The hierarchical top run writes and runs child Verilations
+           && !v3Global.opt.hierarchical();
+}
+
+void V3Cache::addInput(const string& filename, const string& text) {
+    if (!enabled()) return;
+    UINFO(4, "  Cache input " << filename << endl);
+    V3CacheImp::s_inputs += VHashSha256{text}.digestHex() + " " + filename + "\n";
+}
+
+bool V3Cache::restore(const string& argString) {
+    if (!enabled()) return false;
+    V3CacheImp::s_key
+        = VHashSha256{V3Options::version() + "\n" + argString + "\n" + V3CacheImp::s_inputs}
+              .digestHex();
+    const string entryDir = V3CacheImp::entryDir();
+    string manifest;
+    if (!V3CacheImp::readFile(entryDir + "/" + V3CacheImp::manifestName(), manifest)) {
+        UINFO(1, "--cache-dir: Miss " << V3CacheImp::s_key << endl);
+        return false;
+    }
+    // Read everything first, so a damaged entry leaves the --Mdir untouched
+    std::vector<std::pair<string, string>> files;
+    std::istringstream is{manifest};
+    for (string name; std::getline(is, name);) {
+        string contents;
+        if (!V3CacheImp::readFile(entryDir + "/" + name, contents)) {
+            UINFO(1, "--cache-dir: Incomplete entry " << entryDir << endl);
+            return false;
+        }
+        files.emplace_back(name, contents);
+    }
+    for (const auto& itr : files) {
+        const string filename = v3Global.opt.makeDir() + "/" + itr.first;
+        V3File::addTgtDepend(filename);
+        // Leave identical files alone, so make need not rebuild them
+        string oldContents;
+        if (V3CacheImp::readFile(filename, oldContents) && oldContents == itr.second) continue;
+        if (!V3CacheImp::writeFile(filename, itr.second)) v3fatal("Can't write " << filename);
+    }
+    UINFO(1, "--cache-dir: Hit " << V3CacheImp::s_key << ", restored " << files.size()
+                                 << " files" << endl);
+    V3CacheImp::s_restored = true;
+    return true;
+}
+
+void V3Cache::store() {
+    if (!enabled() || V3CacheImp::s_restored || V3CacheImp::s_key.empty()) return;
+    if (V3Error::warnCount()) {
+        // A restored run could not repeat the warnings
+        UINFO(1, "--cache-dir: Not saving, had warnings" << endl);
+        return;
+    }
+    const string prefix = v3Global.opt.makeDir() + "/";
+    std::vector<string> names;
+    for (const string& filename : V3File::getTgtDeps()) {
+        if (!V3CacheImp::cached(filename)) continue;
+        if (filename.compare(0, prefix.length(), prefix) != 0
+            || filename.find('/', prefix.length()) != string::npos) {
+            UINFO(1, "--cache-dir: Not saving, output outside --Mdir: " << filename << endl);
+            return;
+        }
+        const string name = filename.substr(prefix.length());
+        names.push_back(name);
+    }
+    // Write into a temporary then rename, so concurrent runs never see a
+    // partial entry
+    V3Os::createDir(v3Global.opt.cacheDir());
+    const string entryDir = V3CacheImp::entryDir();
+    const string tmpDir
+        = entryDir + ".tmp" + VHashSha256{V3Os::trueRandom(16)}.digestHex().substr(0, 16);
+    V3Os::createDir(tmpDir);
+    string manifest;
+    for (const string& name : names) {
+        string contents;
+        if (!V3CacheImp::readFile(prefix + name, contents)
+            || !V3CacheImp::writeFile(tmpDir + "/" + name, contents)) {
+            UINFO(1, "--cache-dir: Not saving, can't copy " << name << endl);
+            V3CacheImp::removeDir(tmpDir);
+            return;
+        }
+        manifest += name + "\n";
+    }
+    if (!V3CacheImp::writeFile(tmpDir + "/" + V3CacheImp::manifestName(), manifest)
+        || std::rename(tmpDir.c_str(), entryDir.c_str()) != 0) {
+        // Perhaps another run saved the same entry first
+        V3CacheImp::removeDir(tmpDir);
+        return;
+    }
+    UINFO(1, "--cache-dir: Saved " << names.size() << " files to " << entryDir << endl);
+}
@@ -0,0 +1,44 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Persistent cache of Verilated output
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#ifndef VERILATOR_V3CACHE_H_
+#define VERILATOR_V3CACHE_H_
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Error.h"
+#include "V3Global.h"
+
+//============================================================================
+
+class V3Cache final {
+public:
+    // True if --cache-dir is in effect for this run
+    static bool enabled();
+    // Add preprocessed text of one input file to the cache key
+    static void addInput(const string& filename, const string& text);
+    // Once all input is read, copy previous output for the same key into
+    // the --Mdir; returns true if found, so Verilation may be skipped
+    static bool restore(const string& argString);
+    // Save the output files of a successful Verilation under the key
+    static void store();
+
+private:
+    VL_DEBUG_FUNC;  // Declare debug()
+};
+
+#endif  // Guard
@@ -24,6 +24,12 @@
 //          module *below*, and it isn't a input to this module,
 //          we need to indicate a new clock has been created.
 //
+// With --settle-worklist:
+//      Count changes detected on each variable in __Vsettlechg__{var}
+//      Each top level call in _eval
+//          Skip unless a variable it reads has been written this settle
+//          loop iteration, or is circular and written by the last iteration
+//
 //*************************************************************************
 
 #include "config_build.h"
@@ -33,8 +39,10 @@
 #include "V3Ast.h"
 #include "V3Changed.h"
 #include "V3EmitCBase.h"
+#include "V3Stats.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 //######################################################################
 
@@ -103,6 +111,7 @@ private:
     AstNode* m_varEqnp;  // Original var's equation to get var value
     AstNode* m_newLvEqnp;  // New var's equation to read value
     AstNode* m_newRvEqnp;  // New var's equation to set value
+    AstVarScope* m_countVscp = nullptr;  // Settle change counter, if counting
     uint32_t m_detects;  // # detects created
 
     // CONSTANTS
@@ -127,6 +136,25 @@ private:
         AstChangeDet* changep = new AstChangeDet(m_vscp->fileline(), m_varEqnp->cloneTree(true),
                                                  m_newRvEqnp->cloneTree(true), false);
         m_statep->m_chgFuncp->addStmtsp(changep);
+        if (m_countVscp) {
+            // IF(var != last) count = count + 1
+            FileLine* const fl = m_vscp->fileline();
+            AstNode* const varp = m_varEqnp->cloneTree(true);
+            AstNode* const lastp = m_newRvEqnp->cloneTree(true);
+            AstNode* condp;
+            if (varp->isDouble()) {
+                condp = new AstNeqD{fl, varp, lastp};
+            } else if (varp->isString()) {
+                condp = new AstNeqN{fl, varp, lastp};
+            } else {
+                condp = new AstNeq{fl, varp, lastp};
+            }
+            AstNode* const incp = new AstAssign{
+                fl, new AstVarRef{fl, m_countVscp, VAccess::WRITE},
+                new AstAdd{fl, new AstVarRef{fl, m_countVscp, VAccess::READ},
+                           new AstConst{fl, AstConst::WidthedValue(), 32, 1}}};
+            m_statep->m_chgFuncp->addStmtsp(new AstIf{fl, condp, incp, nullptr});
+        }
         AstAssign* initp = new AstAssign(m_vscp->fileline(), m_newLvEqnp->cloneTree(true),
                                          m_varEqnp->cloneTree(true));
         m_statep->m_chgFuncp->addFinalsp(initp);
@@ -202,6 +230,17 @@ public:
             m_newLvEqnp = new AstVarRef(m_vscp->fileline(), m_newvscp, VAccess::WRITE);
             m_newRvEqnp = new AstVarRef(m_vscp->fileline(), m_newvscp, VAccess::READ);
         }
+        if (v3Global.opt.settleWorklist()) {
+            // Number of changes detected, for finding what keeps the model settling
+            AstVar* const varp = m_vscp->varp();
+            const string countName
+                = ("__Vsettlechg__" + m_vscp->scopep()->nameDotless() + "__" + varp->shortName());
+            AstVar* const countVarp = new AstVar{varp->fileline(), AstVarType::MODULETEMP,
+                                                 countName, VFlagBitPacked(), 32};
+            m_statep->m_topModp->addStmtp(countVarp);
+            m_countVscp = new AstVarScope{m_vscp->fileline(), m_statep->m_scopetopp, countVarp};
+            m_statep->m_scopetopp->addVarp(m_countVscp);
+        }
         iterate(vscp->dtypep()->skipRefp());
         m_varEqnp->deleteTree();
         m_newLvEqnp->deleteTree();
@@ -282,6 +321,220 @@ public:
     virtual ~ChangedVisitor() override = default;
 };
 
+//######################################################################
+// Worklist settle, gating each _eval call on what it reads
+
+class ChangedSettleVisitor final : public AstNVisitor {
+private:
+    // NODE STATE
+    // Entire netlist:
+    //  AstVarScope::user1()            -> int.  Mask bit number + 1, if written
+    //  AstCFunc::user1()               -> int.  1 computing, 2 computed effects
+    AstUser1InUse m_inuser1;
+
+    // TYPES
+    struct Effects {
+        vluint64_t m_reads = 0;  // Mask of variables read
+        vluint64_t m_writes = 0;  // Mask of variables written
+        bool m_impure = false;  // Has effects not seen by masks
+    };
+    // CONSTANTS
+    enum : int { FIRST_BIT = 63 };  // Mask bit set only on first iteration, no variables
+
+    // STATE
+    AstScope* m_scopetopp = nullptr;  // Scope under TOPSCOPE
+    AstVarScope* m_cleanVscp = nullptr;  // Mask of variables not to be re-evaluated
+    AstVarScope* m_writtenVscp = nullptr;  // Mask of variables written this iteration
+    int m_bits = 0;  // Number of written variables seen
+    bool m_numbering = false;  // Numbering written variables, not collecting effects
+    Effects* m_effectsp = nullptr;  // Effects being collected
+    std::vector<const AstVarScope*> m_circulars;  // Variables V3Order found circular
+    std::unordered_map<const AstCFunc*, Effects> m_funcEffects;  // Effects of each function
+    VDouble0 m_statGated;  // Statistic tracking
+    VDouble0 m_statAlways;  // Statistic tracking
+
+    // METHODS
+    VL_DEBUG_FUNC;  // Declare debug()
+
+    static vluint64_t varBit(const AstVarScope* vscp) {
+        return vscp->user1() ? (1ULL << ((vscp->user1() - 1) % FIRST_BIT)) : 0;
+    }
+    const Effects& funcEffects(AstCFunc* funcp) {
+        Effects& effects = m_funcEffects[funcp];
+        if (funcp->user1() == 1) {  // Recursive
+            effects.m_impure = true;
+        } else if (!funcp->user1()) {
+            funcp->user1(1);
+            VL_RESTORER(m_effectsp);
+            Effects collected;
+            m_effectsp = &collected;
+            if (funcp->dpiImport()) collected.m_impure = true;
+            iterateChildren(funcp);
+            m_funcEffects[funcp] = collected;
+            funcp->user1(2);
+        }
+        return m_funcEffects[funcp];
+    }
+    Effects stmtEffects(AstNode* nodep) {
+        VL_RESTORER(m_effectsp);
+        Effects effects;
+        m_effectsp = &effects;
+        iterate(nodep);
+        return effects;
+    }
+    AstVarScope* newMaskVar(const string& name) {
+        AstVar* const varp = new AstVar{m_scopetopp->fileline(), AstVarType::MODULETEMP, name,
+                                        VFlagBitPacked(), 64};
+        m_scopetopp->modp()->addStmtp(varp);
+        AstVarScope* const vscp = new AstVarScope{m_scopetopp->fileline(), m_scopetopp, varp};
+        m_scopetopp->addVarp(vscp);
+        return vscp;
+    }
+    AstNode* newMaskConst(FileLine* fl, vluint64_t mask) {
+        return new AstConst{fl, AstConst::Unsized64(), mask};
+    }
+    // Statement recording writes: clean &= ~writes; written |= writes
+    AstNode* newMarkWrites(FileLine* fl, vluint64_t writes) {
+        AstNode* const newp = new AstAssign{
+            fl, new AstVarRef{fl, m_cleanVscp, VAccess::WRITE},
+            new AstAnd{fl, new AstVarRef{fl, m_cleanVscp, VAccess::READ},
+                       newMaskConst(fl, ~writes)}};
+        newp->addNext(new AstAssign{
+            fl, new AstVarRef{fl, m_writtenVscp, VAccess::WRITE},
+            new AstOr{fl, new AstVarRef{fl, m_writtenVscp, VAccess::READ},
+                      newMaskConst(fl, writes)}});
+        return newp;
+    }
+    // Statement that always runs; record what it writes when it does
+    void instrument(AstNode* stmtp) {
+        if (AstIf* const ifp = VN_CAST(stmtp, If)) {
+            instrumentList(ifp->ifsp());
+            instrumentList(ifp->elsesp());
+        } else {
+            const Effects effects = stmtEffects(stmtp);
+            if (effects.m_writes) {
+                stmtp->addNextHere(newMarkWrites(stmtp->fileline(), effects.m_writes));
+            }
+            ++m_statAlways;
+        }
+    }
+    void instrumentList(AstNode* stmtsp) {
+        for (AstNode* nextp; stmtsp; stmtsp = nextp) {
+            nextp = stmtsp->nextp();
+            instrument(stmtsp);
+        }
+    }
+    // Call to pure function; skip unless something it reads is dirty
+    void gate(AstCCall* callp, const Effects& effects) {
+        FileLine* const fl = callp->fileline();
+        const vluint64_t reads = effects.m_reads | (1ULL << FIRST_BIT);
+        AstNode* const condp = new AstNeq{
+            fl, newMaskConst(fl, 0),
+            new AstAnd{fl, new AstNot{fl, new AstVarRef{fl, m_cleanVscp, VAccess::READ}},
+                       newMaskConst(fl, reads)}};
+        AstIf* const ifp = new AstIf{fl, condp, nullptr, nullptr};
+        callp->replaceWith(ifp);
+        ifp->addIfsp(callp);
+        if (effects.m_writes) ifp->addIfsp(newMarkWrites(fl, effects.m_writes));
+        ++m_statGated;
+    }
+
+    // VISITORS
+    virtual void visit(AstVarRef* nodep) override {
+        AstVarScope* const vscp = nodep->varScopep();
+        if (!vscp) return;
+        if (m_numbering) {
+            if (nodep->access().isWriteOrRW() && !vscp->user1()) vscp->user1(++m_bits);
+            return;
+        }
+        if (!m_effectsp) return;
+        if (nodep->access().isReadOrRW()) m_effectsp->m_reads |= varBit(vscp);
+        if (nodep->access().isWriteOrRW()) m_effectsp->m_writes |= varBit(vscp);
+    }
+    virtual void visit(AstVarScope* nodep) override {
+        if (m_numbering && nodep->isCircular()) m_circulars.push_back(nodep);
+        iterateChildren(nodep);
+    }
+    virtual void visit(AstNodeCCall* nodep) override {
+        iterateChildren(nodep);
+        if (m_numbering || !m_effectsp) return;
+        if (!nodep->funcp()) {
+            m_effectsp->m_impure = true;
+            return;
+        }
+        const Effects& effects = funcEffects(nodep->funcp());
+        m_effectsp->m_reads |= effects.m_reads;
+        m_effectsp->m_writes |= effects.m_writes;
+        m_effectsp->m_impure |= effects.m_impure;
+    }
+    // User C code may read or write anything
+    virtual void visit(AstCStmt* nodep) override { markImpure(nodep); }
+    virtual void visit(AstCMath* nodep) override { markImpure(nodep); }
+    virtual void visit(AstUCStmt* nodep) override { markImpure(nodep); }
+    virtual void visit(AstUCFunc* nodep) override { markImpure(nodep); }
+    void markImpure(AstNode* nodep) {
+        iterateChildren(nodep);
+        if (m_effectsp) m_effectsp->m_impure = true;
+    }
+    virtual void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    ChangedSettleVisitor(AstNetlist* nodep, AstScope* scopetopp)
+        : m_scopetopp{scopetopp} {
+        AstCFunc* const evalp = nodep->evalp();
+        if (!evalp) return;
+        // Number every variable written anywhere, so each has a mask bit
+        m_numbering = true;
+        iterate(nodep);
+        m_numbering = false;
+
+        m_cleanVscp = newMaskVar("__Vsettle_clean");
+        m_writtenVscp = newMaskVar("__Vsettle_written");
+        FileLine* const fl = evalp->fileline();
+
+        vluint64_t circular = 0;
+        for (const AstVarScope* vscp : m_circulars) circular |= varBit(vscp);
+
+        // Gate or instrument each top level statement
+        for (AstNode *stmtp = evalp->stmtsp(), *nextp; stmtp; stmtp = nextp) {
+            nextp = stmtp->nextp();
+            if (AstCCall* const callp = VN_CAST(stmtp, CCall)) {
+                const Effects effects = stmtEffects(callp);
+                if (!effects.m_impure) {
+                    gate(callp, effects);
+                    continue;
+                }
+            }
+            instrument(stmtp);
+        }
+
+        // Next iteration re-evaluates only circular variables written this iteration
+        // clean = ~(written & circular); written = 0
+        evalp->addFinalsp(new AstAssign{
+            fl, new AstVarRef{fl, m_cleanVscp, VAccess::WRITE},
+            new AstNot{fl, new AstAnd{fl, new AstVarRef{fl, m_writtenVscp, VAccess::READ},
+                                      newMaskConst(fl, circular)}}});
+        evalp->addFinalsp(new AstAssign{fl, new AstVarRef{fl, m_writtenVscp, VAccess::WRITE},
+                                        newMaskConst(fl, 0)});
+
+        // Each eval() starts by re-evaluating everything
+        AstCFunc* const resetp = new AstCFunc{fl, "_settle_reset", m_scopetopp};
+        resetp->argTypes(EmitCBaseVisitor::symClassVar());
+        resetp->symProlog(true);
+        resetp->declPrivate(true);
+        resetp->dontCombine(true);
+        resetp->addStmtsp(new AstAssign{fl, new AstVarRef{fl, m_cleanVscp, VAccess::WRITE},
+                                        newMaskConst(fl, 0)});
+        m_scopetopp->addActivep(resetp);
+        v3Global.settleWorklist(true);
+    }
+    virtual ~ChangedSettleVisitor() override {
+        V3Stats::addStat("Optimizations, Settle worklist gated calls", m_statGated);
+        V3Stats::addStat("Optimizations, Settle worklist ungated statements", m_statAlways);
+    }
+};
+
 //######################################################################
 // Changed class functions
 
@@ -289,7 +542,11 @@ void V3Changed::changedAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
     {
         ChangedState state;
-        ChangedVisitor visitor(nodep, &state);
+        { ChangedVisitor visitor(nodep, &state); }
+        // Threads evaluate mtasks, not top level calls, so can't gate them
+        if (v3Global.opt.settleWorklist() && !v3Global.opt.mtasks()) {
+            ChangedSettleVisitor visitor(nodep, state.m_scopetopp);
+        }
     }  // Destruct before checking
     V3Global::dumpCheckGlobalTree("changed", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
 }
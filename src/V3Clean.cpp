@@ -62,7 +62,7 @@ private:
         } else if (nodep->width() <= VL_QUADSIZE) {
             return VL_QUADSIZE;
         } else {
-            return nodep->widthWords() * VL_EDATASIZE;
+            return nodep->widthWords() * v3Global.opt.wideWordSize();
         }
     }
     void setCppWidth(AstNode* nodep) {
@@ -112,7 +112,7 @@ private:
     void setClean(AstNode* nodep, bool isClean) {
         computeCppWidth(nodep);  // Just to be sure it's in widthMin
         bool wholeUint = (nodep->widthMin() == VL_IDATASIZE || nodep->widthMin() == VL_QUADSIZE
-                          || (nodep->widthMin() % VL_EDATASIZE) == 0);
+                          || (nodep->widthMin() % v3Global.opt.wideWordSize()) == 0);
         setCleanState(nodep, ((isClean || wholeUint) ? CS_CLEAN : CS_DIRTY));
     }
 
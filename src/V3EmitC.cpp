@@ -25,10 +25,14 @@
 #include "V3PartitionGraph.h"
 #include "V3Task.h"
 #include "V3TSP.h"
+#include "V3ThreadPool.h"
 
 #include <algorithm>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <vector>
+#include <unordered_map>
 #include <unordered_set>
 
 constexpr int VL_VALUE_STRING_MAX_WIDTH = 8192;  // We use a static char array in VL_VALUE_STRING
@@ -36,6 +40,8 @@ constexpr int VL_VALUE_STRING_MAX_WIDTH = 8192;  // We use a static char array i
 constexpr int EMITC_NUM_CONSTW
     = 8;  // Number of VL_CONST_W_*X's in verilated.h (IE VL_CONST_W_8X is last)
 
+constexpr size_t EMIT_VAR_TSP_MAX_STATES = 1000;  // Max footprints to TSP sort in layout
+
 //######################################################################
 // Emit statements and math operators
 
@@ -47,6 +53,8 @@ private:
     bool m_suppressSemi;
     AstVarRef* m_wideTempRefp;  // Variable that _WW macros should be setting
     VarVec m_ctorVarsVec;  // All variables in constructor order
+    std::unordered_set<const AstVar*> m_padVars;  // Variables to start a new cache line
+    int m_padNum = 0;  // Next cache line padding member number
     int m_labelNum;  // Next label number
     int m_splitSize;  // # of cfunc nodes placed into output file
     int m_splitFilenum;  // File number being created, 0 = primary
@@ -86,7 +94,7 @@ public:
         EVL_FUNC_ALL
     };
     void emitVarList(AstNode* firstp, EisWhich which, const string& prefixIfImp, string& sectionr);
-    static void emitVarSort(const VarSortMap& vmap, VarVec* sortedp);
+    void emitVarSort(const VarSortMap& vmap, VarVec* sortedp, bool affinity);
     void emitSortedVarList(const VarVec& anons, const VarVec& nonanons, const string& prefixIfImp);
     void emitVarCtors(bool* firstp);
     void emitCtorSep(bool* firstp);
@@ -120,6 +128,13 @@ public:
             puts("[" + cvtToStr(arrayp->elementsConst()) + "]");
         }
     }
+    void emitVarPad(const AstVar* varp) {
+        // Pad by a whole line rather than use alignas, as models are
+        // heap allocated, and before C++17 new ignores the alignment
+        if (m_padVars.count(varp)) {
+            puts("char __VlayoutPad" + cvtToStr(m_padNum++) + "[VL_CACHE_LINE_BYTES];\n");
+        }
+    }
     void emitVarCmtChg(const AstVar* varp, string* curVarCmtp) {
         string newVarCmt = varp->mtasksString();
         if (*curVarCmtp != newVarCmt) {
@@ -265,7 +280,7 @@ public:
             for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp;
                  vxp = vxp->verticesNextp()) {
                 const ExecMTask* mtp = dynamic_cast<const ExecMTask*>(vxp);
-                if (mtp->threadRoot()) {
+                if (mtp->threadRoot() || v3Global.opt.threadsDynamic()) {
                     // Emit function declaration for this mtask
                     ofp()->putsPrivate(true);
                     puts("static void ");
@@ -274,7 +289,9 @@ public:
                 }
             }
             // No AstCFunc for this one, as it's synthetic. Just write it:
-            puts("static void __Vmtask__final(bool even_cycle, void* symtab);\n");
+            if (!v3Global.opt.threadsDynamic()) {
+                puts("static void __Vmtask__final(bool even_cycle, void* symtab);\n");
+            }
         }
     }
     void ccallIterateArgs(AstNodeCCall* nodep) {
@@ -1138,25 +1155,26 @@ public:
             putsQuoted(nodep->num().toString());
             puts(")");
         } else if (nodep->isWide()) {
+            const int wordSize = v3Global.opt.wideWordSize();
             int upWidth = nodep->num().widthMin();
             int chunks = 0;
-            if (upWidth > EMITC_NUM_CONSTW * VL_EDATASIZE) {
+            if (upWidth > EMITC_NUM_CONSTW * wordSize) {
                 // Output e.g. 8 words in groups of e.g. 8
-                chunks = (upWidth - 1) / (EMITC_NUM_CONSTW * VL_EDATASIZE);
-                upWidth %= (EMITC_NUM_CONSTW * VL_EDATASIZE);
-                if (upWidth == 0) upWidth = (EMITC_NUM_CONSTW * VL_EDATASIZE);
+                chunks = (upWidth - 1) / (EMITC_NUM_CONSTW * wordSize);
+                upWidth %= (EMITC_NUM_CONSTW * wordSize);
+                if (upWidth == 0) upWidth = (EMITC_NUM_CONSTW * wordSize);
             }
             {  // Upper e.g. 8 words
                 if (chunks) {
                     putbs("VL_CONSTHI_W_");
-                    puts(cvtToStr(VL_WORDS_I(upWidth)));
+                    puts(cvtToStr(v3Global.opt.wideWords(upWidth)));
                     puts("X(");
                     puts(cvtToStr(nodep->widthMin()));
                     puts(",");
-                    puts(cvtToStr(chunks * EMITC_NUM_CONSTW * VL_EDATASIZE));
+                    puts(cvtToStr(chunks * EMITC_NUM_CONSTW * wordSize));
                 } else {
                     putbs("VL_CONST_W_");
-                    puts(cvtToStr(VL_WORDS_I(upWidth)));
+                    puts(cvtToStr(v3Global.opt.wideWords(upWidth)));
                     puts("X(");
                     puts(cvtToStr(nodep->widthMin()));
                 }
@@ -1169,9 +1187,8 @@ public:
                 } else {
                     iterateAndNextNull(assigntop);
                 }
-                for (int word = VL_WORDS_I(upWidth) - 1; word >= 0; word--) {
-                    // Only 32 bits - llx + long long here just to appease CPP format warning
-                    ofp()->printf(",0x%08" VL_PRI64 "x",
+                for (int word = v3Global.opt.wideWords(upWidth) - 1; word >= 0; word--) {
+                    ofp()->printf(",0x%0*" VL_PRI64 "x", wordSize / 4,
                                   static_cast<vluint64_t>(
                                       nodep->num().edataWord(word + chunks * EMITC_NUM_CONSTW)));
                 }
@@ -1182,7 +1199,7 @@ public:
                 putbs("VL_CONSTLO_W_");
                 puts(cvtToStr(EMITC_NUM_CONSTW));
                 puts("X(");
-                puts(cvtToStr(chunks * EMITC_NUM_CONSTW * VL_EDATASIZE));
+                puts(cvtToStr(chunks * EMITC_NUM_CONSTW * wordSize));
                 puts(",");
                 if (!assigntop) {
                     puts(assignString);
@@ -1193,8 +1210,7 @@ public:
                     iterateAndNextNull(assigntop);
                 }
                 for (int word = EMITC_NUM_CONSTW - 1; word >= 0; word--) {
-                    // Only 32 bits - llx + long long here just to appease CPP format warning
-                    ofp()->printf(",0x%08" VL_PRI64 "x",
+                    ofp()->printf(",0x%0*" VL_PRI64 "x", wordSize / 4,
                                   static_cast<vluint64_t>(
                                       nodep->num().edataWord(word + chunks * EMITC_NUM_CONSTW)));
                 }
@@ -1285,6 +1301,47 @@ public:
     virtual ~EmitCStmts() override = default;
 };
 
+//######################################################################
+// Collect the functions accessing each variable, for --layout-affinity
+// without mtasks
+
+class EmitVarAffinityVisitor final : public AstNVisitor {
+    // STATE
+    static std::unordered_map<const AstVar*, MTaskIdSet> s_funcIds;  // Funcs accessing each var
+    int m_funcs = 0;  // Number of functions seen
+    int m_funcNum = -1;  // Number of current function, -1 = none
+
+    // VISITORS
+    virtual void visit(AstCFunc* nodep) override {
+        VL_RESTORER(m_funcNum);
+        {
+            m_funcNum = m_funcs++;
+            iterateChildren(nodep);
+        }
+    }
+    virtual void visit(AstNodeVarRef* nodep) override {
+        if (m_funcNum >= 0) s_funcIds[nodep->varp()].insert(m_funcNum);
+    }
+    virtual void visit(AstVar*) override {}  // Accelerate
+    virtual void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit EmitVarAffinityVisitor(AstNetlist* nodep) {
+        s_funcIds.clear();
+        iterate(nodep);
+    }
+    virtual ~EmitVarAffinityVisitor() override = default;
+    // METHODS
+    static const MTaskIdSet& funcIds(const AstVar* varp) {
+        static const MTaskIdSet s_empty;
+        const auto it = s_funcIds.find(varp);
+        return it == s_funcIds.end() ? s_empty : it->second;
+    }
+};
+
+std::unordered_map<const AstVar*, MTaskIdSet> EmitVarAffinityVisitor::s_funcIds;
+
 //######################################################################
 // Establish mtask variable sort order in mtasks mode
 
@@ -1292,7 +1349,7 @@ class EmitVarTspSorter final : public V3TSP::TspStateBase {
 private:
     // MEMBERS
     const MTaskIdSet& m_mtaskIds;  // Mtask we're ordering
-    static unsigned s_serialNext;  // Unique ID to establish serial order
+    static std::atomic<unsigned> s_serialNext;  // Unique ID to establish serial order
     unsigned m_serial;  // Serial ordering
 public:
     // CONSTRUCTORS
@@ -1325,7 +1382,7 @@ public:
     }
 };
 
-unsigned EmitVarTspSorter::s_serialNext = 0;
+std::atomic<unsigned> EmitVarTspSorter::s_serialNext{0};
 
 //######################################################################
 // Internal EmitC implementation
@@ -1336,13 +1393,16 @@ class EmitCImp final : EmitCStmts {
     std::vector<AstChangeDet*> m_blkChangeDetVec;  // All encountered changes in block
     bool m_slow = false;  // Creating __Slow file
     bool m_fast = false;  // Creating non __Slow file (or both)
+    bool m_split = false;  // Split into multiple files
+    int m_addDoubleOr = 10;  // Terms until next || in change detect, 10 determined as best
+    // Files created, in order.  Added to the netlist by V3EmitC::emitc so
+    // the list is the same no matter how emission was scheduled.
+    std::vector<AstCFile*> m_cfilesp;
 
     //---------------------------------------
     // METHODS
 
     void doubleOrDetect(AstChangeDet* changep, bool& gotOne) {
-        // cppcheck-suppress variableScope
-        static int s_addDoubleOr = 10;  // Determined experimentally as best
         if (!changep->rhsp()) {
             if (!gotOne) {
                 gotOne = true;
@@ -1359,11 +1419,11 @@ class EmitCImp final : EmitCStmts {
                  word < (changep->lhsp()->isWide() ? changep->lhsp()->widthWords() : 1); ++word) {
                 if (!gotOne) {
                     gotOne = true;
-                    s_addDoubleOr = 10;
+                    m_addDoubleOr = 10;
                     puts("(");
-                } else if (--s_addDoubleOr == 0) {
+                } else if (--m_addDoubleOr == 0) {
                     puts("|| (");
-                    s_addDoubleOr = 10;
+                    m_addDoubleOr = 10;
                 } else {
                     puts(" | (");
                 }
@@ -1390,15 +1450,15 @@ class EmitCImp final : EmitCStmts {
             // Unfortunately we have some lint checks here, so we can't just skip processing.
             // We should move them to a different stage.
             string filename = VL_DEV_NULL;
-            newCFile(filename, slow, source);
+            m_cfilesp.push_back(createCFile(filename, slow, source));
             ofp = new V3OutCFile(filename);
         } else if (optSystemC()) {
             string filename = filenameNoExt + (source ? ".cpp" : ".h");
-            newCFile(filename, slow, source);
+            m_cfilesp.push_back(createCFile(filename, slow, source));
             ofp = new V3OutScFile(filename);
         } else {
             string filename = filenameNoExt + (source ? ".cpp" : ".h");
-            newCFile(filename, slow, source);
+            m_cfilesp.push_back(createCFile(filename, slow, source));
             ofp = new V3OutCFile(filename);
         }
 
@@ -1427,18 +1487,20 @@ class EmitCImp final : EmitCStmts {
     // Returns the number of cross-thread dependencies into mtaskp.
     // If >0, mtaskp must test whether its prereqs are done before starting,
     // and may need to block.
+    // With dynamic scheduling, any dependency may be on another thread.
     static uint32_t packedMTaskMayBlock(const ExecMTask* mtaskp) {
         uint32_t result = 0;
         for (V3GraphEdge* edgep = mtaskp->inBeginp(); edgep; edgep = edgep->inNextp()) {
             const ExecMTask* prevp = dynamic_cast<ExecMTask*>(edgep->fromp());
-            if (prevp->thread() != mtaskp->thread()) ++result;
+            if (v3Global.opt.threadsDynamic() || prevp->thread() != mtaskp->thread()) ++result;
         }
         return result;
     }
 
     void emitMTaskBody(AstMTaskBody* nodep) {
         ExecMTask* curExecMTaskp = nodep->execMTaskp();
-        if (packedMTaskMayBlock(curExecMTaskp)) {
+        // With dynamic scheduling the thread pool only runs us once ready
+        if (packedMTaskMayBlock(curExecMTaskp) && !v3Global.opt.threadsDynamic()) {
             puts("vlTOPp->__Vm_mt_" + cvtToStr(curExecMTaskp->id())
                  + ".waitUntilUpstreamDone(even_cycle);\n");
         }
@@ -1470,6 +1532,21 @@ class EmitCImp final : EmitCStmts {
         // Flush message queue
         puts("Verilated::endOfThreadMTask(vlSymsp->__Vm_evalMsgQp);\n");
 
+        if (v3Global.opt.threadsDynamic()) {
+            // Hand each downstream mtask we make ready to the thread pool,
+            // it'll run on this thread unless another idle thread steals it.
+            for (V3GraphEdge* edgep = curExecMTaskp->outBeginp(); edgep;
+                 edgep = edgep->outNextp()) {
+                const ExecMTask* nextp = dynamic_cast<ExecMTask*>(edgep->top());
+                puts("if (vlTOPp->__Vm_mt_" + cvtToStr(nextp->id())
+                     + ".signalUpstreamDone(even_cycle)) {\n");
+                puts("vlTOPp->__Vm_threadPoolp->pushReady(&" + protect(nextp->cFuncName())
+                     + ");\n");
+                puts("}\n");
+            }
+            return;
+        }
+
         // For any downstream mtask that's on another thread, bump its
         // counter and maybe notify it.
         for (V3GraphEdge* edgep = curExecMTaskp->outBeginp(); edgep; edgep = edgep->outNextp()) {
@@ -1680,6 +1757,12 @@ class EmitCImp final : EmitCStmts {
         // function definitions for the nested CFuncs. We'll do that at the
         // end.
         puts("vlTOPp->__Vm_even_cycle = !vlTOPp->__Vm_even_cycle;\n");
+        puts("vlTOPp->__Vm_threadPoolp->evalStart();\n");
+
+        if (v3Global.opt.threadsDynamic()) {
+            emitExecGraphDynamic(nodep);
+            return;
+        }
 
         // Build the list of initial mtasks to start
         std::vector<const ExecMTask*> execMTasks;
@@ -1713,6 +1796,30 @@ class EmitCImp final : EmitCStmts {
         }
     }
 
+    void emitExecGraphDynamic(AstExecGraph* nodep) {
+        // Start from the mtasks with no upstream dependencies, the thread
+        // pool runs the rest as they become ready.
+        std::vector<const ExecMTask*> rootMTasks;
+        uint32_t nMTasks = 0;
+        for (const V3GraphVertex* vxp = nodep->depGraphp()->verticesBeginp(); vxp;
+             vxp = vxp->verticesNextp()) {
+            const ExecMTask* etp = dynamic_cast<const ExecMTask*>(vxp);
+            if (!etp->inBeginp()) rootMTasks.push_back(etp);
+            ++nMTasks;
+        }
+        if (rootMTasks.empty()) return;
+        puts("static const VlExecFnp __Vm_roots[] = {");
+        for (uint32_t i = 0; i < rootMTasks.size(); ++i) {
+            if (i) puts(", ");
+            puts("&" + protect(rootMTasks[i]->cFuncName()));
+        }
+        puts("};\n");
+        puts("vlTOPp->__Vm_threadPoolp->executeDynamic(__Vm_roots, "
+             + cvtToStr(rootMTasks.size()) + ", " + cvtToStr(nMTasks)
+             + ", vlTOPp->__Vm_even_cycle, vlSymsp);\n");
+        puts("Verilated::mtaskId(0);\n");
+    }
+
     //---------------------------------------
     // ACCESSORS
 
@@ -1870,6 +1977,12 @@ public:
     void mainImp(AstNodeModule* modp, bool slow);
     void mainInt(AstNodeModule* modp);
     void mainDoFunc(AstCFunc* nodep) { iterate(nodep); }
+    // Record files written in the netlist; called from the main thread
+    void addFiles() {
+        for (AstCFile* cfilep : m_cfilesp) v3Global.rootp()->addFilesp(cfilep);
+        m_cfilesp.clear();
+        if (m_split) v3Global.useParallelBuild(true);
+    }
 };
 
 //######################################################################
@@ -2114,7 +2227,7 @@ void EmitCStmts::emitOpName(AstNode* nodep, const string& format, AstNode* lhsp,
 //----------------------------------------------------------------------
 // Mid level - VISITS
 
-// We only do one display at once, so can just use static state
+// Each thread only does one display at once, so can just use static state
 
 struct EmitDispState {
     string m_format;  // "%s" and text from user
@@ -2135,7 +2248,8 @@ struct EmitDispState {
         m_argsp.push_back(nodep);
         m_argsFunc.push_back(func);
     }
-} emitDispState;
+};
+static thread_local EmitDispState emitDispState;
 
 void EmitCStmts::displayEmit(AstNode* nodep, bool isScan) {
     if (emitDispState.m_format == ""
@@ -2400,8 +2514,10 @@ void EmitCImp::emitMTaskVertexCtors(bool* firstp) {
         if (!mtp->packNextp()) ++finalEdgesInCt;
     }
 
-    emitCtorSep(firstp);
-    puts("__Vm_mt_final(" + cvtToStr(finalEdgesInCt) + ")");
+    if (!v3Global.opt.threadsDynamic()) {
+        emitCtorSep(firstp);
+        puts("__Vm_mt_final(" + cvtToStr(finalEdgesInCt) + ")");
+    }
 
     // This will flip to 'true' before the start of the 0th cycle.
     emitCtorSep(firstp);
@@ -2474,11 +2590,29 @@ void EmitCImp::emitCtorImp(AstNodeModule* modp) {
              // duration of the eval call.
              + string("vlSymsp->_vm_contextp__, ") + cvtToStr(v3Global.opt.threads() - 1) + ", "
              + cvtToStr(v3Global.opt.profThreads()) + ");\n");
+        if (v3Global.opt.threadsDynamic()) {
+            uint32_t nMTasks = 0;
+            for (const V3GraphVertex* vxp
+                 = v3Global.rootp()->execGraphp()->depGraphp()->verticesBeginp();
+                 vxp; vxp = vxp->verticesNextp()) {
+                ++nMTasks;
+            }
+            puts("__Vm_threadPoolp->setupDynamic(" + cvtToStr(nMTasks) + ");\n");
+        }
 
         if (v3Global.opt.profThreads()) {
             puts("__Vm_profile_cycle_start = 0;\n");
             puts("__Vm_profile_time_finished = 0;\n");
-            puts("__Vm_profile_window_ct = 0;");
+            puts("__Vm_profile_window_ct = 0;\n");
+            // So a later Verilation with --prof-threads-data can match
+            // the profiled mtasks against its own
+            for (const V3GraphVertex* vxp
+                 = v3Global.rootp()->execGraphp()->depGraphp()->verticesBeginp();
+                 vxp; vxp = vxp->verticesNextp()) {
+                const ExecMTask* mtp = dynamic_cast<const ExecMTask*>(vxp);
+                puts("__Vm_threadPoolp->profileMTaskHash(" + cvtToStr(mtp->id()) + ", \""
+                     + mtp->hashName() + "\");\n");
+            }
         }
     }
     puts("}\n");
@@ -2716,6 +2850,7 @@ void EmitCImp::emitSensitives() {
 
 void EmitCImp::emitSettleLoop(const std::string& eval_call, bool initial) {
     putsDecoration("// Evaluate till stable\n");
+    if (v3Global.settleWorklist()) puts(protect("_settle_reset") + "(vlSymsp);\n");
     puts("int __VclockLoop = 0;\n");
     puts("QData __Vchange = 1;\n");
     puts("do {\n");
@@ -2930,17 +3065,23 @@ void EmitCStmts::emitVarList(AstNode* firstp, EisWhich which, const string& pref
             puts(sectionr);
             sectionr = "";
         }
+        // Function locals and static definitions are not part of the model layout
+        const bool affinity
+            = v3Global.opt.layoutAffinity() && which != EVL_FUNC_ALL && prefixIfImp.empty();
         VarVec anons;
         VarVec nonanons;
-        emitVarSort(varAnonMap, &anons);
-        emitVarSort(varNonanonMap, &nonanons);
+        emitVarSort(varAnonMap, &anons, affinity);
+        emitVarSort(varNonanonMap, &nonanons, affinity);
         emitSortedVarList(anons, nonanons, prefixIfImp);
+        m_padVars.clear();
     }
 }
 
-void EmitCStmts::emitVarSort(const VarSortMap& vmap, VarVec* sortedp) {
+void EmitCStmts::emitVarSort(const VarSortMap& vmap, VarVec* sortedp, bool affinity) {
     UASSERT(sortedp->empty(), "Sorted should be initially empty");
-    if (!v3Global.opt.mtasks()) {
+    // With --layout-affinity and no mtasks, cluster by accessing functions
+    const bool byFuncs = affinity && !v3Global.opt.mtasks();
+    if (!v3Global.opt.mtasks() && !byFuncs) {
         // Plain old serial mode. Sort by size, from small to large,
         // to optimize for both packing and small offsets in code.
         for (const auto& itr : vmap) {
@@ -2952,12 +3093,17 @@ void EmitCStmts::emitVarSort(const VarSortMap& vmap, VarVec* sortedp) {
     }
 
     // MacroTask mode.  Sort by MTask-affinity group first, size second.
+    // Or likewise by function-affinity group with byFuncs.
     using MTaskVarSortMap = std::map<const MTaskIdSet, VarSortMap>;
     MTaskVarSortMap m2v;
     for (VarSortMap::const_iterator it = vmap.begin(); it != vmap.end(); ++it) {
         int size_class = it->first;
         const VarVec& vec = it->second;
-        for (const AstVar* varp : vec) { m2v[varp->mtaskIds()][size_class].push_back(varp); }
+        for (const AstVar* varp : vec) {
+            const MTaskIdSet& ids
+                = byFuncs ? EmitVarAffinityVisitor::funcIds(varp) : varp->mtaskIds();
+            m2v[ids][size_class].push_back(varp);
+        }
     }
 
     // Create a TSP sort state for each MTaskIdSet footprint
@@ -2966,18 +3112,29 @@ void EmitCStmts::emitVarSort(const VarSortMap& vmap, VarVec* sortedp) {
         states.push_back(new EmitVarTspSorter(it->first));
     }
 
-    // Do the TSP sort
+    // Do the TSP sort, unless too many function footprints to do so quickly,
+    // in which case the set order of the map keeps similar footprints close
     V3TSP::StateVec sorted_states;
-    V3TSP::tspSort(states, &sorted_states);
+    if (byFuncs && states.size() > EMIT_VAR_TSP_MAX_STATES) {
+        sorted_states = states;
+    } else {
+        V3TSP::tspSort(states, &sorted_states);
+    }
 
     for (V3TSP::StateVec::iterator it = sorted_states.begin(); it != sorted_states.end(); ++it) {
         const EmitVarTspSorter* statep = dynamic_cast<const EmitVarTspSorter*>(*it);
         const VarSortMap& localVmap = m2v[statep->mtaskIds()];
+        // Start each mtask footprint on a new cache line to avoid false sharing
+        bool padNext = affinity && !byFuncs;
         // use rbegin/rend to sort size large->small
         for (VarSortMap::const_reverse_iterator jt = localVmap.rbegin(); jt != localVmap.rend();
              ++jt) {
             const VarVec& vec = jt->second;
             for (VarVec::const_iterator kt = vec.begin(); kt != vec.end(); ++kt) {
+                if (padNext && !(*kt)->isStatic()) {
+                    m_padVars.insert(*kt);
+                    padNext = false;
+                }
                 sortedp->push_back(*kt);
             }
         }
@@ -3017,6 +3174,7 @@ void EmitCStmts::emitSortedVarList(const VarVec& anons, const VarVec& nonanons,
                     for (int l0 = 0; l0 < lim && it != anons.cend(); ++l0) {
                         const AstVar* varp = *it;
                         emitVarCmtChg(varp, &curVarCmt);
+                        emitVarPad(varp);
                         emitVarDecl(varp, prefixIfImp);
                         ++it;
                     }
@@ -3030,12 +3188,14 @@ void EmitCStmts::emitSortedVarList(const VarVec& anons, const VarVec& nonanons,
         for (; it != anons.end(); ++it) {
             const AstVar* varp = *it;
             emitVarCmtChg(varp, &curVarCmt);
+            emitVarPad(varp);
             emitVarDecl(varp, prefixIfImp);
         }
     }
     // Output nonanons
     for (const AstVar* varp : nonanons) {
         emitVarCmtChg(varp, &curVarCmt);
+        emitVarPad(varp);
         emitVarDecl(varp, prefixIfImp);
     }
 }
@@ -3058,7 +3218,8 @@ void EmitCImp::emitMTaskState() {
     // In the future we might allow _eval() to return before the graph is
     // fully done executing, for "half wave" scheduling. For now we wait
     // for all mtasks though.
-    puts("VlMTaskVertex __Vm_mt_final;\n");
+    // (With dynamic scheduling the thread pool tracks completion instead.)
+    if (!v3Global.opt.threadsDynamic()) puts("VlMTaskVertex __Vm_mt_final;\n");
     puts("VlThreadPool* __Vm_threadPoolp;\n");
 
     if (v3Global.opt.profThreads()) {
@@ -3386,7 +3547,7 @@ void EmitCImp::emitImp(AstNodeModule* fileModp, AstNodeModule* modp) {
 void EmitCImp::maybeSplit(AstNodeModule* fileModp) {
     if (splitNeeded()) {
         // Splitting file, so using parallel build.
-        v3Global.useParallelBuild(true);
+        m_split = true;
         // Close old file
         VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
         // Open a new file
@@ -3447,12 +3608,13 @@ void EmitCImp::mainImp(AstNodeModule* modp, bool slow) {
         for (const V3GraphVertex* vxp = depGraphp->verticesBeginp(); vxp;
              vxp = vxp->verticesNextp()) {
             const ExecMTask* mtaskp = dynamic_cast<const ExecMTask*>(vxp);
-            if (mtaskp->threadRoot()) {
+            if (mtaskp->threadRoot() || v3Global.opt.threadsDynamic()) {
                 maybeSplit(fileModp);
                 // Only define one function for all the mtasks packed on
                 // a given thread. We'll name this function after the
                 // root mtask though it contains multiple mtasks' worth
-                // of logic.
+                // of logic. With dynamic scheduling each mtask is its
+                // own function.
                 iterate(mtaskp->bodyp());
             }
         }
@@ -3914,21 +4076,539 @@ public:
     }
 };
 
+//######################################################################
+// Lane batch routines, for --batch-lanes
+
+class EmitCBatchCheckVisitor final : public AstNVisitor {
+    // NODE STATE (AstUser1InUse and AstUser2InUse held by EmitCBatch)
+    //  AstVar::user1()         -> int.  1 = used as lane array, 2 = unsupported
+    //  AstCFunc::user1()       -> bool.  Evaluated per lane
+    //  AstVar::user2()         -> bool.  Declared in top module
+    //  AstCFunc::user2()       -> bool.  Declared in top module
+
+    // STATE
+    AstCFunc* m_cfuncp = nullptr;  // Function being checked
+    std::vector<AstCFunc*> m_todo;  // Functions reached but not yet checked
+
+    // METHODS
+    static void unsupported(AstNode* nodep, const string& what) {
+        nodep->v3warn(E_UNSUPPORTED, "Unsupported: --batch-lanes with " << what);
+    }
+    static bool laneDTypeOk(const AstNode* nodep) {
+        const AstNodeDType* dtypep = nodep->dtypep()->skipRefp();
+        return !VN_IS(dtypep, UnpackArrayDType) && dtypep->basicp()
+               && !dtypep->basicp()->isOpaque() && dtypep->width() <= VL_QUADSIZE;
+    }
+    void checkVar(AstVar* varp) {
+        if (varp->user1()) return;
+        varp->user1(laneDTypeOk(varp) ? 1 : 2);
+        if (varp->user1() == 2) {
+            unsupported(varp,
+                        "wide, unpacked array, real or string signal: " + varp->prettyNameQ());
+        }
+    }
+    void checkChangeCalls(AstNode* nodep) {
+        // Top change request returns the OR of each change function's request
+        if (AstLogOr* orp = VN_CAST(nodep, LogOr)) {
+            checkChangeCalls(orp->lhsp());
+            checkChangeCalls(orp->rhsp());
+        } else if (VN_IS(nodep, NodeCCall)) {
+            iterate(nodep);
+        } else {
+            unsupported(nodep, nodep->prettyTypeName());
+        }
+    }
+    void reach(AstCFunc* funcp) {
+        if (funcp && !funcp->user1()) {
+            funcp->user1(true);
+            m_todo.push_back(funcp);
+        }
+    }
+
+    // VISITORS
+    virtual void visit(AstVar* nodep) override {
+        // Function local, becomes a lane array local to the function
+        checkVar(nodep);
+    }
+    virtual void visit(AstVarRef* nodep) override {
+        AstVar* varp = nodep->varp();
+        if (!varp->user1() && !varp->user2()) {
+            varp->user1(2);
+            unsupported(nodep, "signal outside the top module: " + varp->prettyNameQ()
+                                   + "; suggest --flatten");
+        }
+        checkVar(varp);
+    }
+    virtual void visit(AstNodeAssign* nodep) override {
+        AstNode* lhsp = nodep->lhsp();
+        if (AstSel* selp = VN_CAST(lhsp, Sel)) lhsp = selp->fromp();
+        if (!VN_IS(lhsp, VarRef)) unsupported(nodep, "assignment to " + lhsp->prettyTypeName());
+        iterateChildren(nodep);
+    }
+    virtual void visit(AstNodeIf* nodep) override { iterateChildren(nodep); }
+    virtual void visit(AstNodeCCall* nodep) override {
+        AstCFunc* funcp = nodep->funcp();
+        if (funcp->dpiImport() || funcp->dpiImportWrapper()) {
+            unsupported(nodep, "DPI import call: " + funcp->prettyNameQ());
+        } else if (!funcp->user2()) {
+            unsupported(nodep, "call into non-inlined module; suggest --flatten");
+        } else if (funcp->argsp() || nodep->argsp()
+                   || (funcp->rtnTypeVoid() != "void" && !isChangeFunc(funcp))) {
+            unsupported(nodep, "non-inlined task or function call: " + funcp->prettyNameQ());
+        } else {
+            reach(funcp);
+        }
+    }
+    virtual void visit(AstCReturn* nodep) override {
+        if (!isChangeFunc(m_cfuncp)) {
+            unsupported(nodep, "function return value");
+        } else {
+            checkChangeCalls(nodep->lhsp());
+        }
+    }
+    virtual void visit(AstChangeDet* nodep) override {
+        if (nodep->lhsp() && !nodep->rhsp()) {
+            unsupported(nodep, nodep->prettyTypeName());
+        } else {
+            iterateChildren(nodep);
+        }
+    }
+    virtual void visit(AstFinish*) override {}
+    virtual void visit(AstComment*) override {}
+    virtual void visit(AstNodeMath* nodep) override {
+        if (!VN_IS(nodep, Const) && !VN_IS(nodep, NodeUniop) && !VN_IS(nodep, NodeBiop)
+            && !VN_IS(nodep, NodeTriop)) {
+            unsupported(nodep, nodep->prettyTypeName());
+        } else if (!nodep->isPure() || !nodep->isPredictOptimizable()) {
+            unsupported(nodep, nodep->prettyTypeName());
+        } else if (nodep->isWide() || nodep->isDouble() || nodep->isString()) {
+            unsupported(nodep, "expression wider than 64 bits, or of real or string type");
+        } else {
+            iterateChildren(nodep);
+        }
+    }
+    virtual void visit(AstWhile* nodep) override { unsupported(nodep, "loops"); }
+    virtual void visit(AstNode* nodep) override { unsupported(nodep, nodep->prettyTypeName()); }
+
+public:
+    static bool isChangeFunc(const AstCFunc* funcp) {
+        return funcp->name().compare(0, 15, "_change_request") == 0;
+    }
+
+    // CONSTRUCTORS
+    EmitCBatchCheckVisitor(AstNodeModule* modp, const std::vector<AstCFunc*>& rootps) {
+        for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (VN_IS(nodep, Var) || VN_IS(nodep, CFunc)) nodep->user2(true);
+        }
+        for (AstNode* nodep = modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (AstVar* varp = VN_CAST(nodep, Var)) {
+                if (varp->isIO()) checkVar(varp);
+            }
+        }
+        for (AstCFunc* funcp : rootps) reach(funcp);
+        while (!m_todo.empty()) {
+            m_cfuncp = m_todo.back();
+            m_todo.pop_back();
+            iterateAndNextNull(m_cfuncp->initsp());
+            iterateAndNextNull(m_cfuncp->stmtsp());
+            iterateAndNextNull(m_cfuncp->finalsp());
+        }
+    }
+    virtual ~EmitCBatchCheckVisitor() override = default;
+};
+
+class EmitCBatch final : EmitCStmts {
+    // NODE STATE
+    // Cleared on netlist
+    //  See EmitCBatchCheckVisitor
+    AstUser1InUse m_inuser1;
+    AstUser2InUse m_inuser2;
+
+    // MEMBERS
+    AstNodeModule* m_modp;  // Top module
+    AstCFunc* m_evalInitialp;  // _eval_initial, or nullptr
+    AstCFunc* m_evalSettlep;  // _eval_settle, or nullptr
+    AstCFunc* m_evalp;  // _eval
+    AstCFunc* m_changep;  // _change_request
+    AstCFunc* m_finalp;  // _final, or nullptr
+    std::vector<AstCFunc*> m_funcps;  // Functions evaluated per lane, in module order
+    string m_maskName;  // Lane mask of the statements being emitted
+    int m_maskNum = 0;  // Next lane mask number in function
+
+    // METHODS
+    string batchClassName() const { return topClassName() + "__Batch"; }
+    static string laneLoop() { return "for (int __Vl = 0; __Vl < LANES; ++__Vl) {\n"; }
+    AstCFunc* findFunc(const string& name) const {
+        for (AstNode* nodep = m_modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (AstCFunc* funcp = VN_CAST(nodep, CFunc)) {
+                if (funcp->name() == name) return funcp;
+            }
+        }
+        return nullptr;
+    }
+    string funcDecl(const AstCFunc* funcp, bool imp) const {
+        const bool change = EmitCBatchCheckVisitor::isChangeFunc(funcp);
+        return string(change ? "bool " : "void ") + (imp ? batchClassName() + "::" : "")
+               + funcp->nameProtect()
+               + (change ? "(const bool* __Vmaskp, bool* __Vchgp)" : "(const bool* __Vmaskp)");
+    }
+    string laneDecl(const AstVar* varp) const {
+        return varp->dtypep()->cType(varp->nameProtect(), false, false) + "[LANES]";
+    }
+    void emitMasked(const string& maskName, AstNode* stmtsp) {
+        // Skip the branch entirely when no lane takes it
+        puts("if (" + maskName + "__any) {\n");
+        VL_RESTORER(m_maskName);
+        m_maskName = maskName;
+        iterateAndNextNull(stmtsp);
+        puts("}\n");
+    }
+    void emitChangeCalls(AstNode* nodep) {
+        // Call every change function, rather than short circuit, so each
+        // lane's change request is complete
+        if (AstLogOr* orp = VN_CAST(nodep, LogOr)) {
+            emitChangeCalls(orp->lhsp());
+            emitChangeCalls(orp->rhsp());
+        } else {
+            iterate(nodep);
+        }
+    }
+
+    // VISITORS
+    using EmitCStmts::visit;  // Suppress hidden overloaded virtual function warning
+    virtual void visit(AstVarRef* nodep) override {
+        puts(nodep->varp()->nameProtect());
+        puts("[__Vl]");
+    }
+    virtual void visit(AstNodeAssign* nodep) override {
+        puts(laneLoop());
+        if (VN_IS(nodep->lhsp(), VarRef)) {
+            // Select rather than branch, so the loop vectorizes
+            iterateAndNextNull(nodep->lhsp());
+            puts(" = " + m_maskName + "[__Vl] ? ");
+            iterateAndNextNull(nodep->rhsp());
+            puts(" : ");
+            iterateAndNextNull(nodep->lhsp());
+            puts(";\n");
+        } else {
+            puts("if (" + m_maskName + "[__Vl]) {\n");
+            EmitCStmts::visit(nodep);
+            puts("}\n");
+        }
+        puts("}\n");
+    }
+    virtual void visit(AstNodeIf* nodep) override {
+        // Lanes may diverge, so split the mask into lanes taking each branch
+        const string thenMask = "__Vm" + cvtToStr(++m_maskNum);
+        const string elseMask = "__Vm" + cvtToStr(++m_maskNum);
+        puts("{\n");
+        puts("bool " + thenMask + "[LANES];\n");
+        puts("bool " + thenMask + "__any = false;\n");
+        if (nodep->elsesp()) {
+            puts("bool " + elseMask + "[LANES];\n");
+            puts("bool " + elseMask + "__any = false;\n");
+        }
+        puts(laneLoop());
+        puts("const bool __Vcond = ");
+        iterateAndNextNull(nodep->condp());
+        puts(";\n");
+        puts(thenMask + "[__Vl] = " + m_maskName + "[__Vl] && __Vcond;\n");
+        puts(thenMask + "__any |= " + thenMask + "[__Vl];\n");
+        if (nodep->elsesp()) {
+            puts(elseMask + "[__Vl] = " + m_maskName + "[__Vl] && !__Vcond;\n");
+            puts(elseMask + "__any |= " + elseMask + "[__Vl];\n");
+        }
+        puts("}\n");
+        emitMasked(thenMask, nodep->ifsp());
+        if (nodep->elsesp()) emitMasked(elseMask, nodep->elsesp());
+        puts("}\n");
+    }
+    virtual void visit(AstNodeCCall* nodep) override {
+        if (EmitCBatchCheckVisitor::isChangeFunc(nodep->funcp())) {
+            puts("__Vreq |= " + nodep->funcp()->nameProtect() + "(" + m_maskName
+                 + ", __Vchgp);\n");
+        } else {
+            puts(nodep->funcp()->nameProtect() + "(" + m_maskName + ");\n");
+        }
+    }
+    virtual void visit(AstCReturn* nodep) override { emitChangeCalls(nodep->lhsp()); }
+    virtual void visit(AstChangeDet* nodep) override {
+        if (!nodep->lhsp()) return;
+        puts(laneLoop());
+        puts("const bool __Vchange = " + m_maskName + "[__Vl] && (");
+        iterateAndNextNull(nodep->lhsp());
+        puts(" != ");
+        iterateAndNextNull(nodep->rhsp());
+        puts(");\n");
+        puts("__Vchgp[__Vl] |= __Vchange;\n");
+        puts("__Vreq |= __Vchange;\n");
+        puts("}\n");
+    }
+    virtual void visit(AstFinish*) override {
+        puts(laneLoop());
+        puts("__Vm_finished[__Vl] |= " + m_maskName + "[__Vl];\n");
+        puts("}\n");
+    }
+
+    void emitFunc(AstCFunc* funcp) {
+        m_maskName = "__Vmaskp";
+        m_maskNum = 0;
+        puts("\n" + funcDecl(funcp, true) + " {\n");
+        const bool change = EmitCBatchCheckVisitor::isChangeFunc(funcp);
+        if (change) puts("bool __Vreq = false;\n");
+        for (AstNode* listp : {funcp->initsp(), funcp->stmtsp()}) {
+            for (AstNode* nodep = listp; nodep; nodep = nodep->nextp()) {
+                if (const AstVar* varp = VN_CAST(nodep, Var)) puts(laneDecl(varp) + " = {};\n");
+            }
+        }
+        iterateAndNextNull(funcp->initsp());
+        iterateAndNextNull(funcp->stmtsp());
+        iterateAndNextNull(funcp->finalsp());
+        if (change) puts("return __Vreq;\n");
+        puts("}\n");
+    }
+    void emitSettleLoop(bool initial) {
+        putsDecoration("// Evaluate till stable, each lane until its own changes settle\n");
+        puts("int __VclockLoop = 0;\n");
+        puts("bool __Vchange;\n");
+        puts("do {\n");
+        puts(laneLoop());
+        puts("__Vmask[__Vl] = __Vchg[__Vl];\n");
+        puts("__Vchg[__Vl] = false;\n");
+        puts("}\n");
+        if (initial && m_evalSettlep) puts(m_evalSettlep->nameProtect() + "(__Vmask);\n");
+        puts(m_evalp->nameProtect() + "(__Vmask);\n");
+        puts("if (VL_UNLIKELY(++__VclockLoop > " + cvtToStr(v3Global.opt.convergeLimit())
+             + ")) {\n");
+        puts("VL_FATAL_MT(");
+        putsQuoted(protect(m_modp->fileline()->filename()));
+        puts(", ");
+        puts(cvtToStr(m_modp->fileline()->lineno()));
+        puts(", \"\",\n");
+        puts("\"Verilated model didn't ");
+        if (initial) puts("DC ");
+        puts("converge\\n\"\n");
+        puts("\"- See https://verilator.org/warn/DIDNOTCONVERGE\");\n");
+        puts("}\n");
+        puts("__Vchange = " + m_changep->nameProtect() + "(__Vmask, __Vchg);\n");
+        puts("} while (VL_UNLIKELY(__Vchange));\n");
+    }
+
+    void emitHeader() {
+        const string filename = v3Global.opt.makeDir() + "/" + batchClassName() + ".h";
+        newCFile(filename, false /*slow*/, false /*source*/);
+        V3OutCFile hf(filename);
+        m_ofp = &hf;
+
+        ofp()->putsHeader();
+        puts("// DESCRIPTION: Verilator output: Lanes of the design evaluated together,"
+             " created with --batch-lanes\n");
+        puts("//\n");
+        puts("// Each signal is an array with one element per lane.  Each lane is an\n");
+        puts("// independent copy of the design, and eval() evaluates all active lanes\n");
+        puts("// together, one statement at a time.\n");
+        ofp()->putsGuard();
+        puts("\n");
+        puts("#include \"verilated.h\"\n");
+        puts("\n");
+
+        puts("class " + batchClassName() + " final {\n");
+        ofp()->resetPrivate();
+        ofp()->putsPrivate(false);  // public:
+        puts("/// Number of lanes, independent copies of the design\n");
+        puts("static constexpr int LANES = " + cvtToStr(v3Global.opt.batchLanes()) + ";\n");
+        puts("\n");
+        puts("// PORTS\n");
+        puts("// The application code writes and reads these signals, one element per lane\n");
+        for (AstNode* nodep = m_modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (const AstVar* varp = VN_CAST(nodep, Var)) {
+                if (varp->isIO() && varp->user1()) puts(laneDecl(varp) + ";\n");
+            }
+        }
+        puts("\n");
+        puts("// LOCAL SIGNALS\n");
+        puts("// Internals; generally not touched by application code\n");
+        for (AstNode* nodep = m_modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (const AstVar* varp = VN_CAST(nodep, Var)) {
+                if (!varp->isIO() && varp->user1()) puts(laneDecl(varp) + ";\n");
+            }
+        }
+        puts("\n");
+
+        ofp()->putsPrivate(true);  // private:
+        puts("// LANE STATE\n");
+        puts("bool __Vm_didInit;  // Initial blocks evaluated\n");
+        puts("bool __Vm_enabled[LANES];  // Lane is evaluated by eval()\n");
+        puts("bool __Vm_finished[LANES];  // Lane executed $finish\n");
+        puts("VL_UNCOPYABLE(" + batchClassName() + ");  ///< Copying not allowed\n");
+        puts("\n");
+
+        ofp()->putsPrivate(false);  // public:
+        puts("// CONSTRUCTORS\n");
+        puts("/// Construct the lanes, all enabled, with signals zero\n");
+        puts(batchClassName() + "();\n");
+        puts("~" + batchClassName() + "() = default;\n");
+        puts("\n");
+        puts("// API METHODS\n");
+        puts("/// Evaluate the active lanes.  Application must call when inputs change.\n");
+        puts("void eval();\n");
+        puts("/// Simulation complete, run final blocks of all lanes\n");
+        puts("void final();\n");
+        puts("/// Enable or disable (mask) evaluation of a lane; all lanes start enabled\n");
+        puts("void laneEnable(int lane, bool flag) { __Vm_enabled[lane] = flag; }\n");
+        puts("/// Return if a lane has executed $finish\n");
+        puts("bool laneFinished(int lane) const { return __Vm_finished[lane]; }\n");
+        puts("/// Return if every enabled lane has executed $finish\n");
+        puts("bool gotFinish() const;\n");
+        puts("\n");
+
+        ofp()->putsPrivate(true);  // private:
+        puts("// INTERNAL METHODS\n");
+        puts("void _eval_initial_loop();\n");
+        for (const AstCFunc* funcp : m_funcps) puts(funcDecl(funcp, false) + ";\n");
+        puts("};\n");
+
+        ofp()->putsEndGuard();
+        m_ofp = nullptr;
+    }
+
+    void emitImp() {
+        const string filename = v3Global.opt.makeDir() + "/" + batchClassName() + ".cpp";
+        newCFile(filename, false /*slow*/, true /*source*/);
+        V3OutCFile cf(filename);
+        m_ofp = &cf;
+
+        ofp()->putsHeader();
+        puts("// DESCRIPTION: Verilator output: Lanes of the design evaluated together\n");
+        puts("\n");
+        puts("#include \"" + batchClassName() + ".h\"\n");
+        puts("\n");
+
+        puts(batchClassName() + "::" + batchClassName() + "() {\n");
+        puts("__Vm_didInit = false;\n");
+        puts(laneLoop());
+        puts("__Vm_enabled[__Vl] = true;\n");
+        puts("__Vm_finished[__Vl] = false;\n");
+        for (AstNode* nodep = m_modp->stmtsp(); nodep; nodep = nodep->nextp()) {
+            if (const AstVar* varp = VN_CAST(nodep, Var)) {
+                if (!varp->user1()) continue;
+                puts(varp->nameProtect() + "[__Vl] = ");
+                if (varp->isParam() && VN_IS(varp->valuep(), Const)) {
+                    iterate(varp->valuep());
+                } else {
+                    puts("0");
+                }
+                puts(";\n");
+            }
+        }
+        puts("}\n");
+        puts("}\n");
+
+        puts("\nvoid " + batchClassName() + "::eval() {\n");
+        puts("if (VL_UNLIKELY(!__Vm_didInit)) _eval_initial_loop();\n");
+        puts("bool __Vmask[LANES];  // Lanes evaluated by this pass\n");
+        puts("bool __Vchg[LANES];  // Lanes needing another pass\n");
+        puts(laneLoop());
+        puts("__Vchg[__Vl] = __Vm_enabled[__Vl] && !__Vm_finished[__Vl];\n");
+        puts("}\n");
+        emitSettleLoop(false);
+        puts("}\n");
+
+        puts("\nvoid " + batchClassName() + "::_eval_initial_loop() {\n");
+        puts("__Vm_didInit = true;\n");
+        puts("bool __Vmask[LANES];  // Lanes evaluated by this pass\n");
+        puts("bool __Vchg[LANES];  // Lanes needing another pass\n");
+        puts(laneLoop());
+        puts("__Vchg[__Vl] = true;\n");
+        puts("}\n");
+        if (m_evalInitialp) puts(m_evalInitialp->nameProtect() + "(__Vchg);\n");
+        emitSettleLoop(true);
+        puts("}\n");
+
+        puts("\nvoid " + batchClassName() + "::final() {\n");
+        if (m_finalp) {
+            puts("bool __Vmask[LANES];\n");
+            puts(laneLoop());
+            puts("__Vmask[__Vl] = true;\n");
+            puts("}\n");
+            puts(m_finalp->nameProtect() + "(__Vmask);\n");
+        }
+        puts("}\n");
+
+        puts("\nbool " + batchClassName() + "::gotFinish() const {\n");
+        puts(laneLoop());
+        puts("if (__Vm_enabled[__Vl] && !__Vm_finished[__Vl]) return false;\n");
+        puts("}\n");
+        puts("return true;\n");
+        puts("}\n");
+
+        for (AstCFunc* funcp : m_funcps) emitFunc(funcp);
+        m_ofp = nullptr;
+    }
+
+public:
+    explicit EmitCBatch(AstNetlist* nodep)
+        : m_modp{nodep->topModulep()} {
+        m_evalInitialp = findFunc("_eval_initial");
+        m_evalSettlep = findFunc("_eval_settle");
+        m_evalp = findFunc("_eval");
+        m_changep = findFunc("_change_request");
+        m_finalp = findFunc("_final");
+        UASSERT_OBJ(m_evalp && m_changep, m_modp, "Top module missing _eval or _change_request");
+        {
+            EmitCBatchCheckVisitor{
+                m_modp, {m_evalInitialp, m_evalSettlep, m_evalp, m_changep, m_finalp}};
+        }
+        V3Error::abortIfErrors();
+        for (AstNode* stmtp = m_modp->stmtsp(); stmtp; stmtp = stmtp->nextp()) {
+            if (AstCFunc* funcp = VN_CAST(stmtp, CFunc)) {
+                if (funcp->user1()) m_funcps.push_back(funcp);
+            }
+        }
+        emitHeader();
+        emitImp();
+    }
+    virtual ~EmitCBatch() override = default;
+};
+
 //######################################################################
 // EmitC class functions
 
 void V3EmitC::emitc() {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    // Process each module in turn
+    std::vector<AstNodeModule*> modps;
     for (AstNodeModule* nodep = v3Global.rootp()->modulesp(); nodep;
          nodep = VN_CAST(nodep->nextp(), NodeModule)) {
         if (VN_IS(nodep, Class)) continue;  // Imped with ClassPackage
-        // clang-format off
-        EmitCImp cint; cint.mainInt(nodep);
-        cint.mainImp(nodep, true);
-        { EmitCImp fast; fast.mainImp(nodep, false); }
-        // clang-format on
+        modps.push_back(nodep);
+    }
+    // Each module's header and __Slow files, and each module's fast files,
+    // are independent once the symbol table is emitted, so may be written
+    // concurrently.  Job 2*n is the header and slow files of module n, job
+    // 2*n+1 the fast files.
+    std::vector<std::unique_ptr<EmitCImp>> imps(modps.size() * 2);
+    // Emitters only read the variable affinity, so collect it up front
+    if (v3Global.opt.layoutAffinity() && !v3Global.opt.mtasks()) {
+        EmitVarAffinityVisitor{v3Global.rootp()};
+    }
+    const auto emitJob = [&](size_t i) {
+        AstNodeModule* const modp = modps[i / 2];
+        imps[i].reset(new EmitCImp);
+        if (i % 2 == 0) {
+            imps[i]->mainInt(modp);
+            imps[i]->mainImp(modp, true);
+        } else {
+            imps[i]->mainImp(modp, false);
+        }
+    };
+    if (v3Global.opt.protectIds()) {
+        // Shortened protected names depend on the order names are first seen
+        for (size_t i = 0; i < imps.size(); ++i) emitJob(i);
+    } else {
+        V3ThreadPool::s().parallelFor(imps.size(), emitJob);
     }
+    // Add files in module order, as if emitted serially
+    for (const auto& impp : imps) impp->addFiles();
 }
 
 void V3EmitC::emitcTrace() {
@@ -3941,6 +4621,11 @@ void V3EmitC::emitcTrace() {
     }
 }
 
+void V3EmitC::emitcBatch() {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    EmitCBatch{v3Global.rootp()};
+}
+
 void V3EmitC::emitcFiles() {
     UINFO(2, __FUNCTION__ << ": " << endl);
     for (AstNodeFile* filep = v3Global.rootp()->filesp(); filep;
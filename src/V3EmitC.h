@@ -31,6 +31,7 @@ public:
     static void emitcInlines();
     static void emitcSyms(bool dpiHdrOnly = false);
     static void emitcTrace();
+    static void emitcBatch();
     static void emitcFiles();
 };
 
@@ -77,10 +77,15 @@ public:
     static string topClassName() {  // Return name of top wrapper module
         return v3Global.opt.prefix();
     }
-    static AstCFile* newCFile(const string& filename, bool slow, bool source) {
+    static AstCFile* createCFile(const string& filename, bool slow, bool source) {
+        // Caller must add to the netlist
         AstCFile* cfilep = new AstCFile(v3Global.rootp()->fileline(), filename);
         cfilep->slow(slow);
         cfilep->source(source);
+        return cfilep;
+    }
+    static AstCFile* newCFile(const string& filename, bool slow, bool source) {
+        AstCFile* cfilep = createCFile(filename, slow, source);
         v3Global.rootp()->addFilesp(cfilep);
         return cfilep;
     }
@@ -120,9 +120,16 @@ class CMakeEmitter final {
                           : "0");
         *of << "# FST Tracing output mode? 0/1 (from --fst-trace)\n";
         cmake_set_raw(*of, name + "_TRACE_FST",
-                      (v3Global.opt.trace() && (v3Global.opt.traceFormat() != TraceFormat::VCD))
+                      (v3Global.opt.trace() && (v3Global.opt.traceFormat() == TraceFormat::FST))
                           ? "1"
                           : "0");
+        *of << "# VTB Tracing output mode? 0/1 (from --trace-vtb)\n";
+        cmake_set_raw(*of, name + "_TRACE_VTB",
+                      (v3Global.opt.trace() && (v3Global.opt.traceFormat() == TraceFormat::VTB))
+                          ? "1"
+                          : "0");
+        *of << "# Wide data in 64-bit words?  0/1 (from --wide-word-size)\n";
+        cmake_set_raw(*of, name + "_EDATA64", v3Global.opt.wideWordSize() == 64 ? "1" : "0");
 
         *of << "\n### Sources...\n";
         std::vector<string> classes_fast;
@@ -165,6 +165,50 @@ class EmitCSyms final : EmitCBaseVisitor {
         return out;
     }
 
+    static string varBounds(AstVar* varp, int& pdim, int& udim) {
+        // Return varInsert's dimension arguments, counting the dimensions
+        string bounds;
+        if (AstBasicDType* basicp = varp->basicp()) {
+            // Range is always first, it's not in "C" order
+            if (basicp->isRanged()) {
+                bounds += " ,";
+                bounds += cvtToStr(basicp->hi());
+                bounds += ",";
+                bounds += cvtToStr(basicp->lo());
+                pdim++;
+            }
+            for (AstNodeDType* dtypep = varp->dtypep(); dtypep;) {
+                dtypep = dtypep->skipRefp();  // Skip AstRefDType/AstTypedef, or return same node
+                if (const AstNodeArrayDType* adtypep = VN_CAST(dtypep, NodeArrayDType)) {
+                    bounds += " ,";
+                    bounds += cvtToStr(adtypep->left());
+                    bounds += ",";
+                    bounds += cvtToStr(adtypep->right());
+                    if (VN_IS(dtypep, PackArrayDType)) {
+                        pdim++;
+                    } else {
+                        udim++;
+                    }
+                    dtypep = adtypep->subDTypep();
+                } else {
+                    break;  // AstBasicDType - nothing below, 1
+                }
+            }
+        }
+        return bounds;
+    }
+    static bool varSupported(int pdim, int udim) { return pdim <= 1 && udim <= 1; }
+
+    static vluint64_t varNameHash(const string& name) {
+        // FNV-1a, must match VerilatedCStrHash::hash
+        vluint64_t hash = 0xcbf29ce484222325ULL;
+        for (const char c : name) hash = (hash ^ static_cast<vluint8_t>(c)) * 0x100000001b3ULL;
+        return hash;
+    }
+
+    void emitVarHashTable(std::vector<const ScopeVarData*>::const_iterator beginIt,
+                          std::vector<const ScopeVarData*>::const_iterator endIt);
+
     void varHierarchyScopes(string scp) {
         while (!scp.empty()) {
             const auto scpit = m_vpiScopeCandidates.find(scp);
@@ -388,6 +432,13 @@ void EmitCSyms::emitSymHdr() {
     } else {
         puts("#include \"verilated.h\"\n");
     }
+    // Model and runtime must agree on the size of wide data words
+    puts("\n#if VL_EDATASIZE != " + cvtToStr(v3Global.opt.wideWordSize()) + "\n");
+    puts("# error \"Verilated with --wide-word-size " + cvtToStr(v3Global.opt.wideWordSize())
+         + (v3Global.opt.wideWordSize() == 64 ? ", must compile with -DVL_EDATA64"
+                                              : ", must compile without -DVL_EDATA64")
+         + "\"\n");
+    puts("#endif\n");
 
     puts("\n// INCLUDE MODULE CLASSES\n");
     for (AstNodeModule* nodep = v3Global.rootp()->modulesp(); nodep;
@@ -751,57 +802,43 @@ void EmitCSyms::emitSymImp() {
         }
         // It would be less code if each module inserted its own variables.
         // Someday.  For now public isn't common.
-        for (auto it = m_scopeVars.begin(); it != m_scopeVars.end(); ++it) {
+        // Insert each scope's variables in name order, after its hash table
+        std::vector<const ScopeVarData*> scopeVars;
+        for (const auto& itr : m_scopeVars) scopeVars.push_back(&itr.second);
+        std::stable_sort(scopeVars.begin(), scopeVars.end(),
+                         [](const ScopeVarData* ap, const ScopeVarData* bp) {
+                             if (ap->m_scopeName != bp->m_scopeName) {
+                                 return ap->m_scopeName < bp->m_scopeName;
+                             }
+                             return protect(ap->m_varBasePretty) < protect(bp->m_varBasePretty);
+                         });
+        for (auto it = scopeVars.begin(); it != scopeVars.end(); ++it) {
+            const ScopeVarData& data = **it;
+            if (it == scopeVars.begin() || (*(it - 1))->m_scopeName != data.m_scopeName) {
+                emitVarHashTable(it, scopeVars.end());
+            }
             checkSplit(true);
-            AstNodeModule* modp = it->second.m_modp;
-            AstScope* scopep = it->second.m_scopep;
-            AstVar* varp = it->second.m_varp;
+            AstNodeModule* modp = data.m_modp;
+            AstScope* scopep = data.m_scopep;
+            AstVar* varp = data.m_varp;
             //
             int pdim = 0;
             int udim = 0;
-            string bounds;
-            if (AstBasicDType* basicp = varp->basicp()) {
-                // Range is always first, it's not in "C" order
-                if (basicp->isRanged()) {
-                    bounds += " ,";
-                    bounds += cvtToStr(basicp->hi());
-                    bounds += ",";
-                    bounds += cvtToStr(basicp->lo());
-                    pdim++;
-                }
-                for (AstNodeDType* dtypep = varp->dtypep(); dtypep;) {
-                    dtypep
-                        = dtypep->skipRefp();  // Skip AstRefDType/AstTypedef, or return same node
-                    if (const AstNodeArrayDType* adtypep = VN_CAST(dtypep, NodeArrayDType)) {
-                        bounds += " ,";
-                        bounds += cvtToStr(adtypep->left());
-                        bounds += ",";
-                        bounds += cvtToStr(adtypep->right());
-                        if (VN_IS(dtypep, PackArrayDType)) {
-                            pdim++;
-                        } else {
-                            udim++;
-                        }
-                        dtypep = adtypep->subDTypep();
-                    } else {
-                        break;  // AstBasicDType - nothing below, 1
-                    }
-                }
-            }
-            //
-            if (pdim > 1 || udim > 1) {
+            const string bounds = varBounds(varp, pdim, udim);
+            if (!varSupported(pdim, udim)) {
                 puts("//UNSUP ");  // VerilatedImp can't deal with >2d or packed arrays
             }
-            puts(protect("__Vscope_" + it->second.m_scopeName) + ".varInsert(__Vfinal,");
-            putsQuoted(protect(it->second.m_varBasePretty));
+            puts(protect("__Vscope_" + data.m_scopeName) + ".varInsert(__Vfinal,");
+            putsQuoted(protect(data.m_varBasePretty));
 
-            std::string varName;
+            std::string varScopeName;
             if (modp->isTop()) {
-                varName += (protectIf(scopep->nameDotless() + "p", scopep->protect()) + "->");
+                varScopeName = protectIf(scopep->nameDotless() + "p", scopep->protect()) + "->";
             } else {
-                varName += (protectIf(scopep->nameDotless(), scopep->protect()) + ".");
+                varScopeName = protectIf(scopep->nameDotless(), scopep->protect()) + ".";
             }
 
+            std::string varName = varScopeName;
             if (varp->isParam()) {
                 varName += protect("var_" + varp->name());
             } else {
@@ -834,6 +871,13 @@ void EmitCSyms::emitSymImp() {
             puts(bounds);
             puts(");\n");
             ++m_numStmts;
+
+            if (varp->isVpiDirty()) {
+                puts(protect("__Vscope_" + data.m_scopeName) + ".varDirtyInsert(__Vfinal,");
+                putsQuoted(protect(data.m_varBasePretty));
+                puts(", &(" + varScopeName + protect(varp->vpiDirtyName()) + "));\n");
+                ++m_numStmts;
+            }
         }
         m_ofpBase->puts("}\n");
     }
@@ -843,6 +887,48 @@ void EmitCSyms::emitSymImp() {
     VL_DO_CLEAR(delete m_ofp, m_ofp = nullptr);
 }
 
+void EmitCSyms::emitVarHashTable(std::vector<const ScopeVarData*>::const_iterator beginIt,
+                                 std::vector<const ScopeVarData*>::const_iterator endIt) {
+    // Emit the open addressing hash table of a scope's variables, starting
+    // at beginIt, which VerilatedVarNameMap uses to find them by name.
+    // Index the variables the runtime will insert, skipping unsupported
+    // ones and duplicate names as VerilatedVarNameMap::emplace does.
+    const string& scopeName = (*beginIt)->m_scopeName;
+    std::vector<string> names;
+    for (auto it = beginIt; it != endIt && (*it)->m_scopeName == scopeName; ++it) {
+        int pdim = 0;
+        int udim = 0;
+        varBounds((*it)->m_varp, pdim, udim);
+        if (!varSupported(pdim, udim)) continue;
+        const string name = protect((*it)->m_varBasePretty);
+        if (names.empty() || names.back() != name) names.push_back(name);
+    }
+    if (names.empty()) return;
+    // Use at least twice as many slots as names, so probe sequences are short
+    vluint32_t slots = 1;
+    while (slots < 2 * names.size()) slots *= 2;
+    const vluint32_t mask = slots - 1;
+    std::vector<vluint32_t> table(slots, 0);
+    for (size_t i = 0; i < names.size(); ++i) {
+        vluint32_t slot = varNameHash(names[i]) & mask;
+        while (table[slot]) slot = (slot + 1) & mask;
+        table[slot] = i + 1;  // 0 marks an empty slot
+    }
+
+    checkSplit(true);
+    puts("{\n");
+    puts("static const vluint32_t __Vslots[] = {");
+    for (vluint32_t slot = 0; slot < slots; ++slot) {
+        if (slot % 16 == 0) puts("\n");
+        puts(cvtToStr(table[slot]) + ",");
+    }
+    puts("};\n");
+    puts(protect("__Vscope_" + scopeName) + ".varHashTable(__Vfinal, "
+         + cvtToStr(names.size()) + ", " + cvtToStr(mask) + ", __Vslots);\n");
+    puts("}\n");
+    m_numStmts += 1 + slots / 16;
+}
+
 //######################################################################
 
 void EmitCSyms::emitDpiHdr() {
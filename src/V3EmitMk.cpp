@@ -69,6 +69,10 @@ public:
         of.puts("VM_TRACE_FST = ");
         of.puts(v3Global.opt.trace() && v3Global.opt.traceFormat().fst() ? "1" : "0");
         of.puts("\n");
+        of.puts("# Tracing output mode in VTB format?  0/1 (from --trace-vtb)\n");
+        of.puts("VM_TRACE_VTB = ");
+        of.puts(v3Global.opt.trace() && v3Global.opt.traceFormat().vtb() ? "1" : "0");
+        of.puts("\n");
         of.puts("# Tracing threaded output mode?  0/1/N threads (from --trace-thread)\n");
         of.puts("VM_TRACE_THREADS = ");
         of.puts(cvtToStr(v3Global.opt.trueTraceThreads()));
@@ -77,6 +81,10 @@ public:
         of.puts("VM_TRACE_FST_WRITER_THREAD = ");
         of.puts(v3Global.opt.traceThreads() && v3Global.opt.traceFormat().fst() ? "1" : "0");
         of.puts("\n");
+        of.puts("# Wide data in 64-bit words?  0/1 (from --wide-word-size)\n");
+        of.puts("VM_EDATA64 = ");
+        of.puts(v3Global.opt.wideWordSize() == 64 ? "1" : "0");
+        of.puts("\n");
 
         of.puts("\n### Object file lists...\n");
         for (int support = 0; support < 3; ++support) {
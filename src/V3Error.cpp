@@ -23,6 +23,8 @@
 #endif
 // clang-format on
 
+#include <mutex>
+
 //======================================================================
 // Statics
 
@@ -32,10 +34,10 @@ int V3Error::s_debugDefault = 0;
 int V3Error::s_errorLimit = V3Error::MAX_ERRORS;
 bool V3Error::s_warnFatal = true;
 int V3Error::s_tellManual = 0;
-std::ostringstream V3Error::s_errorStr;  // Error string being formed
-V3ErrorCode V3Error::s_errorCode = V3ErrorCode::EC_FATAL;
-bool V3Error::s_errorContexted = false;
-bool V3Error::s_errorSuppressed = false;
+thread_local std::ostringstream V3Error::s_errorStr;  // Error string being formed
+thread_local V3ErrorCode V3Error::s_errorCode = V3ErrorCode::EC_FATAL;
+thread_local bool V3Error::s_errorContexted = false;
+thread_local bool V3Error::s_errorSuppressed = false;
 std::array<bool, V3ErrorCode::_ENUM_MAX> V3Error::s_describedEachWarn;
 std::array<bool, V3ErrorCode::_ENUM_MAX> V3Error::s_pretendError;
 bool V3Error::s_describedWarnings = false;
@@ -187,6 +189,10 @@ void V3Error::v3errorEnd(std::ostringstream& sstr, const string& locationStr) {
 #if defined(__COVERITY__) || defined(__cppcheck__)
     if (s_errorCode == V3ErrorCode::EC_FATAL) __coverity_panic__(x);
 #endif
+    // Output and counts are shared between threads; recursive as the exit
+    // callback may report further errors
+    static std::recursive_mutex s_mutex;
+    const std::lock_guard<std::recursive_mutex> lock(s_mutex);
     // Skip suppressed messages
     if (s_errorSuppressed
         // On debug, show only non default-off warning to prevent pages of warnings
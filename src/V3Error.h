@@ -247,10 +247,11 @@ private:
     static int s_errCount;  // Error count
     static int s_warnCount;  // Warning count
     static int s_tellManual;  // Tell user to see manual, 0=not yet, 1=doit, 2=disable
-    static std::ostringstream s_errorStr;  // Error string being formed
-    static V3ErrorCode s_errorCode;  // Error string being formed will abort
-    static bool s_errorContexted;  // Error being formed got context
-    static bool s_errorSuppressed;  // Error being formed should be suppressed
+    // Message being formed is per thread, as some passes run in parallel
+    static thread_local std::ostringstream s_errorStr;  // Error string being formed
+    static thread_local V3ErrorCode s_errorCode;  // Error string being formed will abort
+    static thread_local bool s_errorContexted;  // Error being formed got context
+    static thread_local bool s_errorSuppressed;  // Error being formed should be suppressed
     static MessagesSet s_messages;  // What errors we've outputted
     static ErrorExitCb s_errorExitCb;  // Callback when error occurs for dumping
 
@@ -31,6 +31,7 @@
 #include "V3Global.h"
 #include "V3Expand.h"
 #include "V3Ast.h"
+#include "V3ThreadPool.h"
 
 #include <algorithm>
 
@@ -49,15 +50,29 @@ private:
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
 
+    // Words of wide data are --wide-word-size bits
+    static int wordBits() { return v3Global.opt.wideWordSize(); }
+    static int wordBitsLog2() { return wordBits() == VL_QUADSIZE ? 6 : 5; }
+    static int bitWord(int bit) { return bit >> wordBitsLog2(); }  // VL_BITWORD_E
+    static int bitBit(int bit) { return bit & (wordBits() - 1); }  // VL_BITBIT_E
+    static vluint64_t wordMaskBits(int nbits) {  // VL_MASK_E
+        return wordBits() == VL_QUADSIZE ? VL_MASK_Q(nbits) : VL_MASK_I(nbits);
+    }
+    static V3Number wordNum(AstNode* nodep, vluint64_t value) {
+        V3Number num(nodep, wordBits());
+        num.setQuad(value);
+        return num;
+    }
+
     int longOrQuadWidth(AstNode* nodep) {
-        return (nodep->width() + (VL_EDATASIZE - 1)) & ~(VL_EDATASIZE - 1);
+        return (nodep->width() + (VL_IDATASIZE - 1)) & ~(VL_IDATASIZE - 1);
     }
     V3Number notWideMask(AstNode* nodep) {
-        return V3Number(nodep, VL_EDATASIZE, ~VL_MASK_E(nodep->widthMin()));
+        return wordNum(nodep, ~wordMaskBits(nodep->widthMin()));
     }
     V3Number wordMask(AstNode* nodep) {
         if (nodep->isWide()) {
-            return V3Number(nodep, VL_EDATASIZE, VL_MASK_E(nodep->widthMin()));
+            return wordNum(nodep, wordMaskBits(nodep->widthMin()));
         } else {
             V3Number mask(nodep, longOrQuadWidth(nodep));
             mask.setMask(nodep->widthMin());
@@ -112,19 +127,23 @@ private:
         } else if (nodep->isQuad() && word == 0) {
             AstNode* quadfromp = nodep->cloneTree(true);
             quadfromp->dtypeSetBitUnsized(VL_QUADSIZE, quadfromp->widthMin(), VSigning::UNSIGNED);
-            return new AstCCast(nodep->fileline(), quadfromp, VL_EDATASIZE);
-        } else if (nodep->isQuad() && word == 1) {
+            return new AstCCast(nodep->fileline(), quadfromp, wordBits());
+        } else if (nodep->isQuad() && word == 1 && wordBits() < VL_QUADSIZE) {
             AstNode* quadfromp = nodep->cloneTree(true);
             quadfromp->dtypeSetBitUnsized(VL_QUADSIZE, quadfromp->widthMin(), VSigning::UNSIGNED);
             return new AstCCast(nodep->fileline(),
                                 new AstShiftR(nodep->fileline(), quadfromp,
-                                              new AstConst(nodep->fileline(), VL_EDATASIZE),
-                                              VL_EDATASIZE),
-                                VL_EDATASIZE);
+                                              new AstConst(nodep->fileline(), wordBits()),
+                                              wordBits()),
+                                wordBits());
         } else if (!nodep->isWide() && !nodep->isQuad() && word == 0) {
+            if (wordBits() == VL_QUADSIZE) {
+                // Widen, so shifting within the word can't overflow
+                return new AstCCast(nodep->fileline(), nodep->cloneTree(true), wordBits());
+            }
             return nodep->cloneTree(true);
         } else {  // Out of bounds
-            return new AstConst(nodep->fileline(), 0);
+            return new AstConst(nodep->fileline(), AstConst::SizedEData(), 0);
         }
     }
 
@@ -134,17 +153,17 @@ private:
         AstNode* newp;
         // Negative word numbers requested for lhs when it's "before" what we want.
         // We get a 0 then.
-        int othword = word - shift / VL_EDATASIZE;
+        int othword = word - shift / wordBits();
         AstNode* llowp = newAstWordSelClone(lhsp, othword);
-        if (int loffset = VL_BITBIT_E(shift)) {
+        if (int loffset = bitBit(shift)) {
             AstNode* lhip = newAstWordSelClone(lhsp, othword - 1);
-            int nbitsonright = VL_EDATASIZE - loffset;  // bits that end up in lword
+            int nbitsonright = wordBits() - loffset;  // bits that end up in lword
             newp = new AstOr(
                 fl,
-                new AstAnd(fl, new AstConst(fl, AstConst::SizedEData(), VL_MASK_E(loffset)),
-                           new AstShiftR(fl, lhip, new AstConst(fl, nbitsonright), VL_EDATASIZE)),
-                new AstAnd(fl, new AstConst(fl, AstConst::SizedEData(), ~VL_MASK_E(loffset)),
-                           new AstShiftL(fl, llowp, new AstConst(fl, loffset), VL_EDATASIZE)));
+                new AstAnd(fl, new AstConst(fl, AstConst::SizedEData(), wordMaskBits(loffset)),
+                           new AstShiftR(fl, lhip, new AstConst(fl, nbitsonright), wordBits())),
+                new AstAnd(fl, new AstConst(fl, AstConst::SizedEData(), ~wordMaskBits(loffset)),
+                           new AstShiftL(fl, llowp, new AstConst(fl, loffset), wordBits())));
         } else {
             newp = llowp;
         }
@@ -164,11 +183,11 @@ private:
             AstNode* wordp;
             if (VN_IS(lsbp, Const)) {
                 wordp = new AstConst(lsbp->fileline(),
-                                     wordAdder + VL_BITWORD_E(VN_CAST(lsbp, Const)->toUInt()));
+                                     wordAdder + bitWord(VN_CAST(lsbp, Const)->toUInt()));
             } else {
                 wordp = new AstShiftR(lsbp->fileline(), lsbp->cloneTree(true),
-                                      new AstConst(lsbp->fileline(), VL_EDATASIZE_LOG2),
-                                      VL_EDATASIZE);
+                                      new AstConst(lsbp->fileline(), wordBitsLog2()),
+                                      VL_IDATASIZE);
                 if (wordAdder != 0) {
                     wordp = new AstAdd(lsbp->fileline(),
                                        // This is indexing a arraysel, so a 32 bit constant is fine
@@ -193,9 +212,9 @@ private:
     AstNode* newSelBitBit(AstNode* lsbp) {
         // Return equation to get the VL_BITBIT of a constant or non-constant
         if (VN_IS(lsbp, Const)) {
-            return new AstConst(lsbp->fileline(), VL_BITBIT_E(VN_CAST(lsbp, Const)->toUInt()));
+            return new AstConst(lsbp->fileline(), bitBit(VN_CAST(lsbp, Const)->toUInt()));
         } else {
-            return new AstAnd(lsbp->fileline(), new AstConst(lsbp->fileline(), VL_EDATASIZE - 1),
+            return new AstAnd(lsbp->fileline(), new AstConst(lsbp->fileline(), wordBits() - 1),
                               dropCondBound(lsbp)->cloneTree(true));
         }
     }
@@ -321,6 +340,11 @@ private:
             // See under ASSIGN(WIDE)
         } else if (nodep->fromp()->isWide()) {
             UINFO(8, "    SEL(wide) " << nodep << endl);
+            // With 64-bit words, form a narrower result as a quad, then cast
+            const bool castDown = !nodep->isQuad() && wordBits() == VL_QUADSIZE;
+            // With 32-bit words a quad result always spans two words
+            const bool quadTwoWords = nodep->isQuad() && wordBits() < VL_QUADSIZE;
+            const int selWidth = castDown ? VL_QUADSIZE : nodep->width();
             // Selection amounts
             // Check for constant shifts & save some constification work later.
             // Grab lowest bit(s)
@@ -330,10 +354,10 @@ private:
                 lowwordp = new AstCCast(nodep->fileline(), lowwordp, nodep);
             }
             AstNode* lowp = new AstShiftR(nodep->fileline(), lowwordp, newSelBitBit(nodep->lsbp()),
-                                          nodep->width());
+                                          selWidth);
             // If > 1 bit, we might be crossing the word boundary
             AstNode* midp = nullptr;
-            V3Number zero(nodep, longOrQuadWidth(nodep));
+            V3Number zero(nodep, castDown ? VL_QUADSIZE : longOrQuadWidth(nodep));
             if (nodep->widthConst() > 1) {
                 AstNode* midwordp =  // SEL(from,[1+wordnum])
                     newWordSel(nodep->fromp()->fileline(), nodep->fromp()->cloneTree(true),
@@ -347,18 +371,18 @@ private:
                 // nbitsfromlow <= (lsb==0) ? 64-bitbit(lsb) : 32-bitbit(lsb)
                 AstNode* midshiftp
                     = new AstSub(nodep->lsbp()->fileline(),
-                                 new AstConst(nodep->lsbp()->fileline(), VL_EDATASIZE),
+                                 new AstConst(nodep->lsbp()->fileline(), wordBits()),
                                  newSelBitBit(nodep->lsbp()));
-                if (nodep->isQuad()) {
+                if (quadTwoWords) {
                     midshiftp = new AstCond(
                         nodep->fileline(),
                         new AstEq(nodep->fileline(), new AstConst(nodep->fileline(), 0),
                                   newSelBitBit(nodep->lsbp())),
-                        new AstConst(nodep->lsbp()->fileline(), VL_EDATASIZE), midshiftp);
+                        new AstConst(nodep->lsbp()->fileline(), wordBits()), midshiftp);
                 }
                 AstNode* midmayp
-                    = new AstShiftL(nodep->fileline(), midwordp, midshiftp, nodep->width());
-                if (nodep->isQuad()) {
+                    = new AstShiftL(nodep->fileline(), midwordp, midshiftp, selWidth);
+                if (quadTwoWords) {
                     midp = midmayp;  // Always grab from two words
                 } else {
                     midp = new AstCond(nodep->fileline(),
@@ -370,7 +394,7 @@ private:
             }
             // If > 32 bits, we might be crossing the second word boundary
             AstNode* hip = nullptr;
-            if (nodep->widthConst() > VL_EDATASIZE) {
+            if (nodep->widthConst() > wordBits()) {
                 AstNode* hiwordp =  // SEL(from,[2+wordnum])
                     newWordSel(nodep->fromp()->fileline(), nodep->fromp()->cloneTree(true),
                                nodep->lsbp(), 2);
@@ -394,6 +418,10 @@ private:
             AstNode* newp = lowp;
             if (midp) newp = new AstOr(nodep->fileline(), midp, newp);
             if (hip) newp = new AstOr(nodep->fileline(), hip, newp);
+            if (castDown) {
+                newp->dtypeSetLogicSized(VL_QUADSIZE, VSigning::UNSIGNED);
+                newp = new AstCCast(nodep->fileline(), newp, nodep);
+            }
             newp->dtypeFrom(nodep);
             VL_DO_DANGLING(replaceWithDelete(nodep, newp), nodep);
         } else {  // Long/Quad from Long/Quad
@@ -417,11 +445,11 @@ private:
 
     bool expandWide(AstNodeAssign* nodep, AstSel* rhsp) {
         UASSERT_OBJ(nodep->widthMin() == rhsp->widthConst(), nodep, "Width mismatch");
-        if (VN_IS(rhsp->lsbp(), Const) && VL_BITBIT_E(rhsp->lsbConst()) == 0) {
+        if (VN_IS(rhsp->lsbp(), Const) && bitBit(rhsp->lsbConst()) == 0) {
             int lsb = rhsp->lsbConst();
             UINFO(8, "    Wordize ASSIGN(SEL,align) " << nodep << endl);
             for (int w = 0; w < nodep->widthWords(); w++) {
-                addWordAssign(nodep, w, newAstWordSelClone(rhsp->fromp(), w + VL_BITWORD_E(lsb)));
+                addWordAssign(nodep, w, newAstWordSelClone(rhsp->fromp(), w + bitWord(lsb)));
             }
             return true;
         } else {
@@ -431,17 +459,17 @@ private:
                 AstNode* lowwordp = newWordSel(rhsp->fileline(), rhsp->fromp()->cloneTree(true),
                                                rhsp->lsbp(), w);
                 AstNode* lowp = new AstShiftR(rhsp->fileline(), lowwordp,
-                                              newSelBitBit(rhsp->lsbp()), VL_EDATASIZE);
+                                              newSelBitBit(rhsp->lsbp()), wordBits());
                 // Upper bits
-                V3Number zero(nodep, VL_EDATASIZE, 0);
+                V3Number zero = wordNum(nodep, 0);
                 AstNode* midwordp =  // SEL(from,[1+wordnum])
                     newWordSel(rhsp->fromp()->fileline(), rhsp->fromp()->cloneTree(true),
                                rhsp->lsbp(), w + 1);
                 AstNode* midshiftp = new AstSub(
-                    rhsp->lsbp()->fileline(), new AstConst(rhsp->lsbp()->fileline(), VL_EDATASIZE),
+                    rhsp->lsbp()->fileline(), new AstConst(rhsp->lsbp()->fileline(), wordBits()),
                     newSelBitBit(rhsp->lsbp()));
                 AstNode* midmayp
-                    = new AstShiftL(rhsp->fileline(), midwordp, midshiftp, VL_EDATASIZE);
+                    = new AstShiftL(rhsp->fileline(), midwordp, midshiftp, wordBits());
                 AstNode* midp
                     = new AstCond(rhsp->fileline(),
                                   new AstEq(rhsp->fileline(), new AstConst(rhsp->fileline(), 0),
@@ -477,7 +505,7 @@ private:
             if (destwide) {
                 UINFO(8, "    ASSIGNSEL(const,wide) " << nodep << endl);
                 for (int w = 0; w < destp->widthWords(); w++) {
-                    if (w >= VL_BITWORD_E(lsb) && w <= VL_BITWORD_E(msb)) {
+                    if (w >= bitWord(lsb) && w <= bitWord(msb)) {
                         // else we would just be setting it to the same exact value
                         AstNode* oldvalp = newAstWordSelClone(destp, w);
                         fixCloneLvalue(oldvalp);
@@ -495,9 +523,9 @@ private:
                         // Apply cleaning at the top word of the destination
                         // (no cleaning to do if dst's width is a whole number
                         // of words).
-                        if (w == destp->widthWords() - 1 && VL_BITBIT_E(destp->widthMin()) != 0) {
-                            V3Number cleanmask(nodep, VL_EDATASIZE);
-                            cleanmask.setMask(VL_BITBIT_E(destp->widthMin()));
+                        if (w == destp->widthWords() - 1 && bitBit(destp->widthMin()) != 0) {
+                            V3Number cleanmask(nodep, wordBits());
+                            cleanmask.setMask(bitBit(destp->widthMin()));
                             newp = new AstAnd(lhsp->fileline(), newp,
                                               new AstConst(lhsp->fileline(), cleanmask));
                         }
@@ -546,19 +574,24 @@ private:
                         lhsp->fileline(),
                         new AstNot(
                             lhsp->fileline(),
-                            new AstShiftL(lhsp->fileline(), new AstConst(nodep->fileline(), 1),
+                            new AstShiftL(lhsp->fileline(),
+                                          new AstConst(nodep->fileline(), AstConst::SizedEData(),
+                                                       1),
                                           // newSelBitBit may exceed the MSB of this variable.
                                           // That's ok as we'd just AND with a larger value,
                                           // but oldval would clip the upper bits to sanity
-                                          newSelBitBit(lhsp->lsbp()), VL_EDATASIZE)),
+                                          newSelBitBit(lhsp->lsbp()), wordBits())),
                         oldvalp);
                 }
                 // Restrict the shift amount to 0-31, see bug804.
                 AstNode* shiftp = new AstAnd(nodep->fileline(), lhsp->lsbp()->cloneTree(true),
-                                             new AstConst(nodep->fileline(), VL_EDATASIZE - 1));
+                                             new AstConst(nodep->fileline(), wordBits() - 1));
+                if (wordBits() == VL_QUADSIZE && !rhsp->isQuad()) {
+                    rhsp = new AstCCast(nodep->fileline(), rhsp, wordBits());
+                }
                 AstNode* newp
                     = new AstOr(lhsp->fileline(), oldvalp,
-                                new AstShiftL(lhsp->fileline(), rhsp, shiftp, VL_EDATASIZE));
+                                new AstShiftL(lhsp->fileline(), rhsp, shiftp, wordBits()));
                 newp = new AstAssign(nodep->fileline(),
                                      newWordSel(nodep->fileline(), destp, lhsp->lsbp(), 0), newp);
                 insertBefore(nodep, newp);
@@ -710,7 +743,7 @@ private:
             AstNode* newp;
             if (lhswidth == 1) {
                 newp = new AstNegate(nodep->fileline(), lhsp->cloneTree(true));
-                newp->dtypeSetLogicSized(VL_EDATASIZE,
+                newp->dtypeSetLogicSized(wordBits(),
                                          VSigning::UNSIGNED);  // Replicate always unsigned
             } else {
                 newp = newAstWordSelClone(lhsp, w);
@@ -811,7 +844,7 @@ private:
             }
             newp = new AstEq(
                 nodep->fileline(),
-                new AstConst(nodep->fileline(), AstConst::SizedEData(), VL_MASK_E(VL_EDATASIZE)),
+                new AstConst(nodep->fileline(), AstConst::SizedEData(), wordMaskBits(wordBits())),
                 newp);
             VL_DO_DANGLING(replaceWithDelete(nodep, newp), nodep);
         } else {
@@ -896,7 +929,7 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit ExpandVisitor(AstNetlist* nodep) { iterate(nodep); }
+    explicit ExpandVisitor(AstNodeModule* nodep) { iterate(nodep); }
     virtual ~ExpandVisitor() override = default;
 };
 
@@ -908,6 +941,7 @@ public:
 
 void V3Expand::expandAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    { ExpandVisitor visitor(nodep); }  // Destruct before checking
+    // Module-local; each module gets its own visitor
+    V3ThreadPool::forEachModule(nodep, [](AstNodeModule* modp) { ExpandVisitor visitor(modp); });
     V3Global::dumpCheckGlobalTree("expand", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
 }
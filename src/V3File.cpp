@@ -29,6 +29,7 @@
 #include <iomanip>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -135,11 +136,14 @@ public:
     }
     void writeDepend(const string& filename);
     std::vector<string> getAllDeps() const;
+    std::vector<string> getTgtDeps() const;
     void writeTimes(const string& filename, const string& cmdlineIn);
     bool checkTimes(const string& filename, const string& cmdlineIn);
 };
 
 V3FileDependImp dependImp;  // Depend implementation class
+static std::mutex s_dependMutex;  // Protects dependImp and directory creation, as
+                                  // V3EmitC may write files in parallel
 
 //######################################################################
 // V3FileDependImp
@@ -177,6 +181,14 @@ inline std::vector<string> V3FileDependImp::getAllDeps() const {
     return r;
 }
 
+inline std::vector<string> V3FileDependImp::getTgtDeps() const {
+    std::vector<string> r;
+    for (const auto& itr : m_filenameList) {
+        if (itr.target()) r.push_back(itr.filename());
+    }
+    return r;
+}
+
 inline void V3FileDependImp::writeTimes(const string& filename, const string& cmdlineIn) {
     const std::unique_ptr<std::ofstream> ofp(V3File::new_ofstream(filename));
     if (ofp->fail()) v3fatal("Can't write " << filename);
@@ -297,10 +309,17 @@ inline bool V3FileDependImp::checkTimes(const string& filename, const string& cm
 //######################################################################
 // V3File
 
-void V3File::addSrcDepend(const string& filename) { dependImp.addSrcDepend(filename); }
-void V3File::addTgtDepend(const string& filename) { dependImp.addTgtDepend(filename); }
+void V3File::addSrcDepend(const string& filename) {
+    const std::lock_guard<std::mutex> lock(s_dependMutex);
+    dependImp.addSrcDepend(filename);
+}
+void V3File::addTgtDepend(const string& filename) {
+    const std::lock_guard<std::mutex> lock(s_dependMutex);
+    dependImp.addTgtDepend(filename);
+}
 void V3File::writeDepend(const string& filename) { dependImp.writeDepend(filename); }
 std::vector<string> V3File::getAllDeps() { return dependImp.getAllDeps(); }
+std::vector<string> V3File::getTgtDeps() { return dependImp.getTgtDeps(); }
 void V3File::writeTimes(const string& filename, const string& cmdlineIn) {
     dependImp.writeTimes(filename, cmdlineIn);
 }
@@ -316,6 +335,7 @@ void V3File::createMakeDirFor(const string& filename) {
     }
 }
 void V3File::createMakeDir() {
+    const std::lock_guard<std::mutex> lock(s_dependMutex);
     static bool created = false;
     if (!created) {
         created = true;
@@ -626,16 +646,9 @@ V3OutFormatter::V3OutFormatter(const string& filename, V3OutFormatter::Language
 
 string V3OutFormatter::indentSpaces(int num) {
     // Indent the specified number of spaces.  Use spaces.
-    static char str[MAXSPACE + 20];
-    char* cp = str;
     if (num > MAXSPACE) num = MAXSPACE;
-    while (num > 0) {
-        *cp++ = ' ';
-        --num;
-    }
-    *cp++ = '\0';
-    string st(str);
-    return st;
+    if (num < 0) num = 0;
+    return string(num, ' ');
 }
 
 bool V3OutFormatter::tokenStart(const char* cp, const char* cmp) {
@@ -63,6 +63,7 @@ public:
     static void addTgtDepend(const string& filename);
     static void writeDepend(const string& filename);
     static std::vector<string> getAllDeps();
+    static std::vector<string> getTgtDeps();
     static void writeTimes(const string& filename, const string& cmdlineIn);
     static bool checkTimes(const string& filename, const string& cmdlineIn);
 
@@ -100,6 +100,7 @@ class V3Global final {
     // Experimenting with always requiring heavy, see (#2701)
     bool m_needHeavy = true;  // Need verilated_heavy.h include
     bool m_needTraceDumper = false;  // Need __Vm_dumperp in symbols
+    bool m_settleWorklist = false;  // Created _settle_reset for worklist settle loops
     bool m_dpi = false;  // Need __Dpi include files
     bool m_useParallelBuild = false;  // Use parallel build for model
     bool m_useRandomizeMethods = false;  // Need to define randomize() class methods
@@ -146,6 +147,8 @@ public:
     void needHeavy(bool flag) { m_needHeavy = flag; }
     bool needTraceDumper() const { return m_needTraceDumper; }
     void needTraceDumper(bool flag) { m_needTraceDumper = flag; }
+    bool settleWorklist() const { return m_settleWorklist; }
+    void settleWorklist(bool flag) { m_settleWorklist = flag; }
     bool dpi() const { return m_dpi; }
     void dpi(bool flag) { m_dpi = flag; }
     V3HierBlockPlan* hierPlanp() const { return m_hierPlanp; }
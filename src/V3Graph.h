@@ -82,6 +82,7 @@ private:
     // MEMBERS
     V3List<V3GraphVertex*> m_vertices;  // All vertices
     static int s_debug;
+    static uint32_t s_parallelMinVertices;  // Vertices needed to use GraphCsr algorithms
 
 protected:
     friend class V3GraphVertex;
@@ -102,6 +103,11 @@ public:
     V3Graph();
     virtual ~V3Graph();
     static void debug(int level) { s_debug = level; }
+    /// Graphs with at least this many vertices use the compact, parallel
+    /// implementations of rank, stronglyConnected and removeTransitiveEdges
+    static void parallelMinVertices(uint32_t count) { s_parallelMinVertices = count; }
+    static uint32_t parallelMinVertices() { return s_parallelMinVertices; }
+    bool useParallel() const;  // Has at least parallelMinVertices()
     virtual string dotRankDir() const { return "TB"; }  // rankdir for dot plotting
 
     // METHODS
@@ -20,12 +20,173 @@
 #include "V3Global.h"
 #include "V3GraphAlg.h"
 #include "V3GraphPathChecker.h"
+#include "V3Os.h"
+#include "V3Stats.h"
+#include "V3ThreadPool.h"
 
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <map>
+#include <memory>
 #include <list>
 
+//######################################################################
+//######################################################################
+// Compressed sparse row graphs
+
+uint32_t V3Graph::s_parallelMinVertices = 1024;
+
+bool V3Graph::useParallel() const {
+    uint32_t count = 0;
+    for (V3GraphVertex* vertexp = verticesBeginp(); vertexp; vertexp = vertexp->verticesNextp()) {
+        if (++count >= s_parallelMinVertices) return true;
+    }
+    return false;
+}
+
+GraphCsr::GraphCsr(const V3Graph* graphp, GraphWay way, V3EdgeFuncP edgeFuncp,
+                   bool withZeroWeight, bool withEdges) {
+    for (V3GraphVertex* vertexp = graphp->verticesBeginp(); vertexp;
+         vertexp = vertexp->verticesNextp()) {
+        vertexp->user(size());
+        m_vertices.push_back(vertexp);
+    }
+    const auto follow = [=](const V3GraphEdge* edgep) {
+        return (withZeroWeight || edgep->weight()) && edgeFuncp(edgep);
+    };
+    // Gather each range of vertices' neighbors with a single walk of the
+    // edge lists, then concatenate them
+    const size_t ranges = (size() + RANGE_SIZE - 1) / RANGE_SIZE;
+    std::vector<std::vector<uint32_t>> rangeNeighbors(ranges);
+    std::vector<std::vector<V3GraphEdge*>> rangeEdges(withEdges ? ranges : 0);
+    m_begin.resize(size() + 1, 0);
+    parallelRanges(size(), [&](size_t b, size_t e) {
+        std::vector<uint32_t>& neighbors = rangeNeighbors[b / RANGE_SIZE];
+        for (size_t v = b; v < e; ++v) {
+            for (V3GraphEdge* edgep = m_vertices[v]->beginp(way); edgep;
+                 edgep = edgep->nextp(way)) {
+                if (!follow(edgep)) continue;
+                neighbors.push_back(edgep->furtherp(way)->user());
+                if (withEdges) rangeEdges[b / RANGE_SIZE].push_back(edgep);
+            }
+            m_begin[v + 1] = neighbors.size();  // Relative to range, for now
+        }
+    });
+    uint32_t total = 0;
+    for (size_t range = 0; range < ranges; ++range) {
+        const size_t e = std::min<size_t>(size(), (range + 1) * RANGE_SIZE);
+        for (size_t v = range * RANGE_SIZE; v < e; ++v) m_begin[v + 1] += total;
+        total += rangeNeighbors[range].size();
+    }
+    m_neighbors.resize(total);
+    if (withEdges) m_edges.resize(total);
+    parallelRanges(size(), [&](size_t b, size_t) {
+        const size_t range = b / RANGE_SIZE;
+        std::copy(rangeNeighbors[range].begin(), rangeNeighbors[range].end(),
+                  m_neighbors.begin() + m_begin[b]);
+        std::vector<uint32_t>().swap(rangeNeighbors[range]);
+        if (withEdges) {
+            std::copy(rangeEdges[range].begin(), rangeEdges[range].end(),
+                      m_edges.begin() + m_begin[b]);
+            std::vector<V3GraphEdge*>().swap(rangeEdges[range]);
+        }
+    });
+}
+
+GraphCsr GraphCsr::reversed() const {
+    GraphCsr rev;
+    rev.m_vertices = m_vertices;
+    rev.m_begin.resize(size() + 1, 0);
+    for (const uint32_t to : m_neighbors) ++rev.m_begin[to + 1];
+    for (uint32_t v = 0; v < size(); ++v) rev.m_begin[v + 1] += rev.m_begin[v];
+    rev.m_neighbors.resize(m_neighbors.size());
+    std::vector<uint32_t> fillIndex{rev.m_begin.begin(), rev.m_begin.end() - 1};
+    for (uint32_t v = 0; v < size(); ++v) {
+        for (uint32_t i = m_begin[v]; i < m_begin[v + 1]; ++i) {
+            rev.m_neighbors[fillIndex[m_neighbors[i]]++] = v;
+        }
+    }
+    return rev;
+}
+
+void GraphCsr::parallelRanges(size_t n, const std::function<void(size_t, size_t)>& fn) {
+    V3ThreadPool::s().parallelFor((n + RANGE_SIZE - 1) / RANGE_SIZE, [&](size_t i) {
+        fn(i * RANGE_SIZE, std::min(n, (i + 1) * RANGE_SIZE));
+    });
+}
+
+bool GraphCsr::peel(std::vector<uint32_t>& order, std::vector<uint32_t>& levels,
+                    const std::function<void(uint32_t, uint32_t)>& pushFn) const {
+    // Count each vertex's predecessors
+    std::unique_ptr<std::atomic<uint32_t>[]> preds{new std::atomic<uint32_t>[size()]};
+    parallelRanges(size(), [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v) preds[v].store(0, std::memory_order_relaxed);
+    });
+    parallelRanges(size(), [&](size_t b, size_t e) {
+        for (size_t v = b; v < e; ++v) {
+            for (uint32_t i = m_begin[v]; i < m_begin[v + 1]; ++i) {
+                preds[m_neighbors[i]].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    });
+    order.resize(size());
+    levels.clear();
+    uint32_t inputs = 0;
+    for (uint32_t v = 0; v < size(); ++v) {
+        if (!preds[v].load(std::memory_order_relaxed)) order[inputs++] = v;
+    }
+    // Each level is the vertices whose last predecessor was in the level before
+    std::atomic<uint32_t> tail{inputs};
+    uint32_t head = 0;
+    while (head < tail) {
+        levels.push_back(head);
+        const uint32_t levelBegin = head;
+        head = tail;
+        parallelRanges(head - levelBegin, [&](size_t b, size_t e) {
+            for (size_t o = levelBegin + b; o < levelBegin + e; ++o) {
+                const uint32_t v = order[o];
+                for (uint32_t i = m_begin[v]; i < m_begin[v + 1]; ++i) {
+                    const uint32_t to = m_neighbors[i];
+                    pushFn(v, to);
+                    if (preds[to].fetch_sub(1, std::memory_order_acq_rel) == 1) order[tail++] = to;
+                }
+            }
+        });
+    }
+    levels.push_back(head);
+    order.resize(head);
+    return head == size();
+}
+
+//######################################################################
+// Statistics of the GraphCsr algorithms, reported with --stats
+
+class GraphAlgStats final {
+    const string m_name;  // Algorithm name
+    const vluint64_t m_startUsecs;  // Time algorithm started
+    vluint64_t m_peakBytes = 0;  // Largest process memory sampled
+
+public:
+    explicit GraphAlgStats(const string& name)
+        : m_name{name}
+        , m_startUsecs{V3Os::timeUsecs()} {}
+    ~GraphAlgStats() {
+        // Statistics may only be added from the main thread
+        if (!v3Global.opt.stats() || V3ThreadPool::inParallel()) return;
+        static int s_count = 0;
+        const string suffix = V3Global::digitsFilename(++s_count) + "_" + m_name;
+        V3Stats::addStatPerf("Graph, Elapsed time (sec), " + suffix,
+                             (V3Os::timeUsecs() - m_startUsecs) / 1.0e6);
+        V3Stats::addStatPerf("Graph, Peak memory (MB), " + suffix,
+                             m_peakBytes / 1024.0 / 1024.0);
+    }
+    // Called when the algorithm's data structures are largest
+    void sampleMemory() {
+        if (v3Global.opt.stats()) m_peakBytes = std::max(m_peakBytes, V3Os::memUsageBytes());
+    }
+};
+
 //######################################################################
 //######################################################################
 // Algorithms - weakly connected components
@@ -103,6 +264,7 @@ public:
     explicit GraphAlgRemoveTransitiveEdges(V3Graph* graphp)
         : GraphAlg<>(graphp, nullptr) {}
     void go() {
+        if (m_graphp->useParallel() && goParallel()) return;
         GraphPathChecker checker(m_graphp);
         for (V3GraphVertex* vxp = m_graphp->verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
             V3GraphEdge* deletep = nullptr;
@@ -119,6 +281,105 @@ public:
     }
 
 private:
+    bool goParallel() {
+        // As go(), but checking the edges of each vertex in parallel.
+        // Returns false if there is a loop.
+        GraphAlgStats stats{"removeTransitiveEdges"};
+        const GraphCsr csr{m_graphp, GraphWay::FORWARD, &V3GraphEdge::followAlwaysTrue, true,
+                           true};
+        const uint32_t size = csr.size();
+        // Critical paths to and from each vertex, to prune the searches as
+        // GraphPathChecker does
+        std::unique_ptr<std::atomic<uint32_t>[]> cpFwd{new std::atomic<uint32_t>[size]};
+        GraphCsr::parallelRanges(size, [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) cpFwd[v].store(0, std::memory_order_relaxed);
+        });
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> levels;
+        if (!csr.peel(order, levels, [&](uint32_t from, uint32_t to) {
+                const uint32_t cp = cpFwd[from].load(std::memory_order_relaxed) + 1;
+                uint32_t old = cpFwd[to].load(std::memory_order_relaxed);
+                while (old < cp
+                       && !cpFwd[to].compare_exchange_weak(old, cp, std::memory_order_relaxed)) {}
+            })) {
+            return false;
+        }
+        std::vector<uint32_t> cpRev(size, 0);
+        for (size_t level = levels.size() - 1; level-- > 0;) {
+            const uint32_t levelBegin = levels[level];
+            GraphCsr::parallelRanges(levels[level + 1] - levelBegin, [&](size_t b, size_t e) {
+                for (size_t o = levelBegin + b; o < levelBegin + e; ++o) {
+                    const uint32_t v = order[o];
+                    uint32_t cp = 0;
+                    for (uint32_t i = csr.begin(v); i < csr.end(v); ++i) {
+                        cp = std::max(cp, cpRev[csr.neighbor(i)] + 1);
+                    }
+                    cpRev[v] = cp;
+                }
+            });
+        }
+        stats.sampleMemory();
+        // Each job claims vertices in blocks, with its own search state
+        std::vector<uint8_t> transitive(csr.edgeCount(), 0);
+        std::atomic<uint32_t> nextVertex{0};
+        V3ThreadPool& pool = V3ThreadPool::s();
+        pool.parallelFor(pool.jobs(), [&](size_t) {
+            std::vector<uint32_t> seenGeneration(size, 0);
+            uint32_t generation = 0;
+            std::vector<uint32_t> stack;
+            const auto pathExists = [&](uint32_t ap, uint32_t bp) {
+                stack.clear();
+                stack.push_back(ap);
+                while (!stack.empty()) {
+                    const uint32_t v = stack.back();
+                    stack.pop_back();
+                    if (seenGeneration[v] == generation) continue;
+                    seenGeneration[v] = generation;
+                    if (v == bp) return true;
+                    // Rule out a v->bp path based on their CPs
+                    if (cpRev[v] < cpRev[bp] + 1) continue;
+                    if (cpFwd[bp].load(std::memory_order_relaxed)
+                        < cpFwd[v].load(std::memory_order_relaxed) + 1) {
+                        continue;
+                    }
+                    for (uint32_t i = csr.begin(v); i < csr.end(v); ++i) {
+                        stack.push_back(csr.neighbor(i));
+                    }
+                }
+                return false;
+            };
+            constexpr uint32_t BLOCK = 64;
+            for (uint32_t first = nextVertex.fetch_add(BLOCK); first < size;
+                 first = nextVertex.fetch_add(BLOCK)) {
+                for (uint32_t v = first; v < std::min(size, first + BLOCK); ++v) {
+                    for (uint32_t i = csr.begin(v); i < csr.end(v); ++i) {
+                        const uint32_t top = csr.neighbor(i);
+                        ++generation;
+                        for (uint32_t j = csr.begin(v); j < csr.end(v); ++j) {
+                            if (j == i) continue;
+                            if (csr.neighbor(j) == top) {
+                                // go() keeps the last of duplicate edges
+                                if (j < i) continue;
+                                transitive[i] = true;
+                                break;
+                            }
+                            if (pathExists(csr.neighbor(j), top)) {
+                                transitive[i] = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+        });
+        for (uint32_t i = 0; i < csr.edgeCount(); ++i) {
+            if (!transitive[i]) continue;
+            V3GraphEdge* edgep = csr.edgep(i);
+            VL_DO_DANGLING(edgep->unlinkDelete(), edgep);
+        }
+        return true;
+    }
+
     VL_DEBUG_FUNC;  // Declare debug()
     VL_UNCOPYABLE(GraphAlgRemoveTransitiveEdges);
 };
@@ -181,6 +442,11 @@ private:
         //     Vertex::user     // DFS number indicating possible root of subtree, 0=not iterated
         //     Vertex::color    // Output subtree number (fully processed)
 
+        if (m_graphp->useParallel()) {
+            mainParallel();
+            return;
+        }
+
         // Clear info
         for (V3GraphVertex* vertexp = m_graphp->verticesBeginp(); vertexp;
              vertexp = vertexp->verticesNextp()) {
@@ -243,6 +509,94 @@ private:
         }
     }
 
+    void mainParallel() {
+        // As main(), but on a GraphCsr, and first peeling away in parallel
+        // the vertices which can't be in a loop as they have no
+        // predecessors or successors in a loop.  Only the remainder need
+        // Tarjan's algorithm, which is iterative here, not recursive.
+        GraphAlgStats stats{"stronglyConnected"};
+        const GraphCsr csr{m_graphp, GraphWay::FORWARD, m_edgeFuncp};
+        const uint32_t size = csr.size();
+        std::vector<uint8_t> maybeLoop(size, true);
+        {
+            const GraphCsr reverse = csr.reversed();
+            stats.sampleMemory();
+            std::vector<uint32_t> order;
+            std::vector<uint32_t> levels;
+            const auto noPush = [](uint32_t, uint32_t) {};
+            for (const GraphCsr* csrp : {&csr, &reverse}) {
+                csrp->peel(order, levels, noPush);
+                GraphCsr::parallelRanges(order.size(), [&](size_t b, size_t e) {
+                    for (size_t o = b; o < e; ++o) maybeLoop[order[o]] = false;
+                });
+            }
+        }
+        // Per vertex, DFS number (Vertex::user), and color
+        std::vector<uint32_t> dfsNums(size, 0);
+        std::vector<uint32_t> colors(size, 0);
+        struct Frame {
+            uint32_t m_vertex;  // Vertex being iterated
+            uint32_t m_next;  // Next neighbor index to consider
+            uint32_t m_thisDfsNum;  // DFS number on entry
+        };
+        std::vector<Frame> stack;
+        std::vector<uint32_t> callTrace;
+        const auto enter = [&](uint32_t v) {
+            const uint32_t thisDfsNum = m_currentDfs++;
+            dfsNums[v] = thisDfsNum;
+            stack.push_back({v, csr.begin(v), thisDfsNum});
+        };
+        for (uint32_t root = 0; root < size; ++root) {
+            if (!maybeLoop[root] || dfsNums[root]) continue;
+            m_currentDfs++;
+            enter(root);
+            while (!stack.empty()) {
+                Frame& frame = stack.back();
+                const uint32_t v = frame.m_vertex;
+                if (frame.m_next < csr.end(v)) {
+                    const uint32_t top = csr.neighbor(frame.m_next);
+                    if (!maybeLoop[top]) {
+                        ++frame.m_next;
+                    } else if (!dfsNums[top]) {  // Dest not computed yet; revisit edge after
+                        enter(top);
+                    } else {
+                        if (!colors[top]) {  // Dest not in a component
+                            if (dfsNums[v] > dfsNums[top]) dfsNums[v] = dfsNums[top];
+                        }
+                        ++frame.m_next;
+                    }
+                    continue;
+                }
+                const uint32_t thisDfsNum = frame.m_thisDfsNum;
+                stack.pop_back();
+                if (dfsNums[v] == thisDfsNum) {  // New head of subtree
+                    colors[v] = thisDfsNum;  // Mark as component
+                    while (!callTrace.empty() && dfsNums[callTrace.back()] >= thisDfsNum) {
+                        colors[callTrace.back()] = thisDfsNum;
+                        callTrace.pop_back();
+                    }
+                } else {  // In another subtree (maybe...)
+                    callTrace.push_back(v);
+                }
+            }
+        }
+        // If there's a single vertex of a color, it doesn't need a subgraph
+        GraphCsr::parallelRanges(size, [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                bool onecolor = true;
+                for (uint32_t i = csr.begin(v); i < csr.end(v); ++i) {
+                    if (colors[v] && colors[v] == colors[csr.neighbor(i)]) {
+                        onecolor = false;
+                        break;
+                    }
+                }
+                V3GraphVertex* const vertexp = csr.vertexp(v);
+                vertexp->color(onecolor ? 0 : colors[v]);
+                vertexp->user(dfsNums[v]);
+            }
+        });
+    }
+
 public:
     GraphAlgStrongly(V3Graph* graphp, V3EdgeFuncP edgeFuncp)
         : GraphAlg<>{graphp, edgeFuncp} {
@@ -261,6 +615,7 @@ void V3Graph::stronglyConnected(V3EdgeFuncP edgeFuncp) { GraphAlgStrongly(this,
 class GraphAlgRank final : GraphAlg<> {
 private:
     void main() {
+        if (m_graphp->useParallel() && mainParallel()) return;
         // Rank each vertex, ignoring cutable edges
         // Vertex::m_user begin: 1 indicates processing, 2 indicates completed
         // Clear existing ranks
@@ -297,6 +652,41 @@ private:
         vertexp->user(2);
     }
 
+    bool mainParallel() {
+        // As main(), but on a GraphCsr, ranking each level of vertices whose
+        // predecessors are all ranked in parallel.  Returns false if there
+        // is a loop, which main() will then report.
+        GraphAlgStats stats{"rank"};
+        const GraphCsr csr{m_graphp, GraphWay::FORWARD, m_edgeFuncp};
+        std::unique_ptr<std::atomic<uint32_t>[]> ranks{new std::atomic<uint32_t>[csr.size()]};
+        std::vector<uint32_t> adders(csr.size());
+        GraphCsr::parallelRanges(csr.size(), [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                ranks[v].store(1, std::memory_order_relaxed);
+                adders[v] = csr.vertexp(v)->rankAdder();
+            }
+        });
+        stats.sampleMemory();
+        std::vector<uint32_t> order;
+        std::vector<uint32_t> levels;
+        if (!csr.peel(order, levels, [&](uint32_t from, uint32_t to) {
+                const uint32_t rank = ranks[from].load(std::memory_order_relaxed) + adders[from];
+                uint32_t old = ranks[to].load(std::memory_order_relaxed);
+                while (old < rank
+                       && !ranks[to].compare_exchange_weak(old, rank, std::memory_order_relaxed)) {
+                }
+            })) {
+            return false;
+        }
+        GraphCsr::parallelRanges(csr.size(), [&](size_t b, size_t e) {
+            for (size_t v = b; v < e; ++v) {
+                csr.vertexp(v)->rank(ranks[v].load(std::memory_order_relaxed));
+                csr.vertexp(v)->user(2);
+            }
+        });
+        return true;
+    }
+
 public:
     GraphAlgRank(V3Graph* graphp, V3EdgeFuncP edgeFuncp)
         : GraphAlg<>{graphp, edgeFuncp} {
@@ -23,6 +23,9 @@
 #include "V3Global.h"
 #include "V3Graph.h"
 
+#include <functional>
+#include <vector>
+
 //=============================================================================
 // Algorithms - common class
 // For internal use, most graph algorithms use this as a base class
@@ -43,6 +46,63 @@ protected:
     }
 };
 
+//============================================================================
+// Compressed sparse row snapshot of a graph's followed edges.  Vertices
+// are numbered in vertex list order, and each vertex's neighbors are
+// stored contiguously, which is far more compact and cache friendly for
+// the large graph algorithms than walking the V3GraphEdge lists.
+// The graph must not change while the snapshot is in use.
+// Vertex::user() is set to the vertex number.
+
+class GraphCsr final {
+    // MEMBERS
+    std::vector<V3GraphVertex*> m_vertices;  // Vertex of each number
+    std::vector<uint32_t> m_begin;  // Index of each vertex's first neighbor, plus end
+    std::vector<uint32_t> m_neighbors;  // Neighbor vertex numbers
+    std::vector<V3GraphEdge*> m_edges;  // Edge of each neighbor, if requested
+    GraphCsr() = default;
+    VL_UNCOPYABLE(GraphCsr);
+
+public:
+    // CONSTRUCTORS
+    // Follow edges in the given direction, if edgeFuncp accepts them and
+    // they have non-zero weight (or regardless of weight if withZeroWeight)
+    GraphCsr(const V3Graph* graphp, GraphWay way, V3EdgeFuncP edgeFuncp,
+             bool withZeroWeight = false, bool withEdges = false);
+    GraphCsr(GraphCsr&&) = default;
+    ~GraphCsr() = default;
+
+    // ACCESSORS
+    uint32_t size() const { return static_cast<uint32_t>(m_vertices.size()); }
+    size_t edgeCount() const { return m_neighbors.size(); }
+    V3GraphVertex* vertexp(uint32_t v) const { return m_vertices[v]; }
+    uint32_t begin(uint32_t v) const { return m_begin[v]; }
+    uint32_t end(uint32_t v) const { return m_begin[v + 1]; }
+    uint32_t neighbor(uint32_t i) const { return m_neighbors[i]; }
+    V3GraphEdge* edgep(uint32_t i) const { return m_edges[i]; }
+    size_t memoryBytes() const {
+        return m_vertices.capacity() * sizeof(V3GraphVertex*)
+               + m_begin.capacity() * sizeof(uint32_t) + m_neighbors.capacity() * sizeof(uint32_t)
+               + m_edges.capacity() * sizeof(V3GraphEdge*);
+    }
+
+    // METHODS
+    // Snapshot with each edge reversed, without edgep()s
+    GraphCsr reversed() const;
+    // Call fn(begin, end) over ranges covering [0, n), possibly in parallel.
+    // Each range but the last is RANGE_SIZE long, and starts at a multiple of it.
+    static constexpr size_t RANGE_SIZE = 1024;
+    static void parallelRanges(size_t n, const std::function<void(size_t, size_t)>& fn);
+    // Topologically peel the graph: remove vertices with no remaining
+    // predecessors, level by level, processing each level in parallel.
+    // pushFn(from, to) is called for each neighbor as its edge is removed,
+    // perhaps concurrently for the same 'to'.  Vertex numbers are appended
+    // to order in peeling sequence, levels holds the start of each level
+    // and the end.  Returns false if vertices remain, i.e. there is a loop.
+    bool peel(std::vector<uint32_t>& order, std::vector<uint32_t>& levels,
+              const std::function<void(uint32_t, uint32_t)>& pushFn) const;
+};
+
 //============================================================================
 
 #endif  // Guard
@@ -21,6 +21,9 @@
 #include "V3Graph.h"
 #include "V3GraphDfa.h"
 
+#include <map>
+#include <vector>
+
 //######################################################################
 //######################################################################
 // Test class
@@ -113,6 +116,76 @@ public:
     }
 };
 
+class V3GraphTestParallel final : public V3GraphTest {
+    // Check the GraphCsr algorithms give the same results as the originals
+    static constexpr int VERTICES = 3000;
+    static void build(V3Graph* gp, bool acyclic) {
+        std::vector<V3GraphVertex*> vertices;
+        for (int i = 0; i < VERTICES; ++i) {
+            vertices.push_back(new V3GraphTestVertex(gp, "v" + cvtToStr(i)));
+        }
+        uint32_t seed = 1;
+        for (int i = 0; i < VERTICES * 3; ++i) {
+            seed = seed * 1103515245 + 12345;
+            int from = (seed >> 8) % VERTICES;
+            seed = seed * 1103515245 + 12345;
+            int to = (seed >> 8) % VERTICES;
+            if (acyclic) {
+                if (from == to) continue;
+                if (from > to) std::swap(from, to);
+            }
+            new V3GraphEdge(gp, vertices[from], vertices[to], (i % 7) ? 2 : 0, (i % 3) == 0);
+        }
+    }
+    static string edges(V3Graph* gp) {
+        string out;
+        for (V3GraphVertex* vxp = gp->verticesBeginp(); vxp; vxp = vxp->verticesNextp()) {
+            for (V3GraphEdge* edgep = vxp->outBeginp(); edgep; edgep = edgep->outNextp()) {
+                out += edgep->name() + " ";
+            }
+        }
+        return out;
+    }
+
+public:
+    virtual string name() override { return "parallel"; }
+    virtual void runTest() override {
+        const uint32_t oldMin = V3Graph::parallelMinVertices();
+        V3Graph serial[3];
+        V3Graph parallel[3];
+        for (int i = 0; i < 3; ++i) {
+            build(&serial[i], i != 0);
+            build(&parallel[i], i != 0);
+        }
+        V3Graph::parallelMinVertices(VERTICES + 1);
+        serial[0].stronglyConnected(&V3GraphEdge::followNotCutable);
+        serial[1].rank(&V3GraphEdge::followNotCutable);
+        serial[2].removeTransitiveEdges();
+        V3Graph::parallelMinVertices(0);
+        parallel[0].stronglyConnected(&V3GraphEdge::followNotCutable);
+        parallel[1].rank(&V3GraphEdge::followNotCutable);
+        parallel[2].removeTransitiveEdges();
+        V3Graph::parallelMinVertices(oldMin);
+
+        // Same components, perhaps with other colors
+        std::map<uint32_t, uint32_t> colorMap;
+        std::map<uint32_t, uint32_t> colorMapRev;
+        for (V3GraphVertex *sp = serial[0].verticesBeginp(), *pp = parallel[0].verticesBeginp();
+             sp; sp = sp->verticesNextp(), pp = pp->verticesNextp()) {
+            UASSERT(!sp->color() == !pp->color(), "SelfTest: Component mismatch " << sp);
+            UASSERT(colorMap.emplace(sp->color(), pp->color()).first->second == pp->color()
+                        && colorMapRev.emplace(pp->color(), sp->color()).first->second
+                               == sp->color(),
+                    "SelfTest: Component mismatch " << sp);
+        }
+        for (V3GraphVertex *sp = serial[1].verticesBeginp(), *pp = parallel[1].verticesBeginp();
+             sp; sp = sp->verticesNextp(), pp = pp->verticesNextp()) {
+            UASSERT(sp->rank() == pp->rank(), "SelfTest: Rank mismatch " << sp);
+        }
+        UASSERT(edges(&serial[2]) == edges(&parallel[2]), "SelfTest: Transitive edges mismatch");
+    }
+};
+
 class V3GraphTestAcyc final : public V3GraphTest {
 public:
     virtual string name() override { return "acyc"; }
@@ -356,6 +429,7 @@ void V3Graph::selfTest() {
     UINFO(2, __FUNCTION__ << ": " << endl);
     // clang-format off
     { V3GraphTestStrong test; test.run(); }
+    { V3GraphTestParallel test; test.run(); }
     { V3GraphTestAcyc test; test.run(); }
     { V3GraphTestVars test; test.run(); }
     { V3GraphTestDfa test; test.run(); }
@@ -58,6 +58,9 @@
 // 7) In V3HierBlock.cpp, relationship among hierarchical blocks are checked in run a).
 //    (which block uses other blocks..)
 // 8) In V3EmitMk.cpp, ${prefix}_hier.mk is created in run a).
+// 9) In run b), V3HierChildFingerprint hashes the preprocessed sources of the modules under
+//    the block and the options. If they match the previous run, the previous output is kept
+//    and the rest of Verilation is skipped, so make does not rebuild the block.
 //
 // There are two hidden command options.
 //   --hierarchical-child is added to Verilator run b).
@@ -71,7 +74,11 @@
 //       Used for b) and c).
 //       This options is repeated for all instantiating hierarchical blocks.
 
+#include <cstdio>
+#include <fstream>
+#include <map>
 #include <memory>
+#include <set>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -432,3 +439,131 @@ void V3HierBlockPlan::writeCommandArgsFiles(bool forCMake) const {
 string V3HierBlockPlan::topCommandArgsFileName(bool forCMake) {
     return V3HierCommandArgsFileName(v3Global.opt.prefix(), forCMake);
 }
+
+//######################################################################
+// Collect modules that make up the block of a --hierarchical-child run
+
+class HierChildSourceVisitor final : public AstNVisitor {
+    // STATE
+    std::set<const AstNodeModule*> m_modps;  // Modules of this block
+
+    // VISITORS
+    virtual void visit(AstNodeModule* nodep) override {
+        if (!m_modps.insert(nodep).second) return;
+        iterateChildren(nodep);
+    }
+    virtual void visit(AstCell* nodep) override {
+        iterateChildren(nodep);
+        if (nodep->modp()) iterate(nodep->modp());
+    }
+    virtual void visit(AstNodeMath*) override {}  // Accelerate
+    virtual void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    explicit HierChildSourceVisitor(AstNetlist* nodep) {
+        for (AstNodeModule* modp = nodep->modulesp(); modp;
+             modp = VN_CAST(modp->nextp(), NodeModule)) {
+            if (modp->name() == v3Global.opt.topModule()) {
+                iterate(modp);
+            } else if (!VN_IS(modp, Module) && !VN_IS(modp, Iface)) {
+                // Packages and classes may be referenced without a cell
+                m_modps.insert(modp);
+            }
+        }
+    }
+    VL_DEBUG_FUNC;  // Declare debug()
+    const std::set<const AstNodeModule*>& modps() const { return m_modps; }
+};
+
+//######################################################################
+// Fingerprint state
+
+class V3HierChildFingerprintImp final {
+public:
+    // TYPES
+    // Name when parsed, digest and name of the defining file
+    using Source = std::pair<string, string>;
+
+    // MEMBERS
+    static std::map<const AstNodeModule*, Source> s_sources;  // Where each module came from
+    static string s_fingerprint;  // Final fingerprint, once computed
+
+    // METHODS
+    static string filename() {
+        return v3Global.opt.makeDir() + "/" + v3Global.opt.prefix() + "__hierFingerprint.dat";
+    }
+    static bool exists(const string& filename) {
+        const std::unique_ptr<std::ifstream> ifp(V3File::new_ifstream_nodepend(filename));
+        return !ifp->fail();
+    }
+};
+
+std::map<const AstNodeModule*, V3HierChildFingerprintImp::Source>
+    V3HierChildFingerprintImp::s_sources;
+string V3HierChildFingerprintImp::s_fingerprint;
+
+//######################################################################
+// V3HierChildFingerprint
+
+bool V3HierChildFingerprint::enabled() {
+    return v3Global.opt.hierChild() && v3Global.opt.skipIdentical().isTrue();
+}
+
+void V3HierChildFingerprint::addSource(const string& filename, const string& text,
+                                       const AstNodeModule* lastModp) {
+    if (!enabled()) return;
+    const string digest = VHashSha256{text}.digestHex();
+    const AstNode* nodep = lastModp ? lastModp->nextp() : v3Global.rootp()->modulesp();
+    for (; nodep; nodep = nodep->nextp()) {
+        if (const AstNodeModule* modp = VN_CAST_CONST(nodep, NodeModule)) {
+            V3HierChildFingerprintImp::s_sources[modp]
+                = std::make_pair(modp->name(), digest + " " + filename);
+        }
+    }
+}
+
+bool V3HierChildFingerprint::unchanged() {
+    if (!enabled()) return false;
+    // Modules under the block, sorted so the order of parsing does not matter
+    std::set<string> lines;
+    const HierChildSourceVisitor visitor{v3Global.rootp()};
+    for (const AstNodeModule* modp : visitor.modps()) {
+        const auto it = V3HierChildFingerprintImp::s_sources.find(modp);
+        if (it != V3HierChildFingerprintImp::s_sources.end()
+            && it->second.first == modp->origName()) {
+            lines.insert(modp->origName() + " " + it->second.second);
+        } else {  // Not from a file we parsed
+            lines.insert(modp->origName());
+        }
+    }
+    string text = V3Options::version() + "\n" + v3Global.opt.allArgsString() + "\n";
+    for (const string& line : lines) text += line + "\n";
+    V3HierChildFingerprintImp::s_fingerprint = VHashSha256{text}.digestHex();
+    UINFO(9, "Hierarchical block fingerprint text:\n" << text);
+
+    // The make rules depend on the wrapper and makefile, so both must remain
+    const string filename = V3HierChildFingerprintImp::filename();
+    string previous;
+    const std::unique_ptr<std::ifstream> ifp(V3File::new_ifstream_nodepend(filename));
+    if (!ifp->fail()) std::getline(*ifp, previous);
+    if (previous == V3HierChildFingerprintImp::s_fingerprint
+        && V3HierChildFingerprintImp::exists(v3Global.opt.makeDir() + "/"
+                                             + v3Global.opt.prefix() + ".mk")
+        && V3HierChildFingerprintImp::exists(v3Global.opt.makeDir() + "/"
+                                             + v3Global.opt.protectLib() + ".sv")) {
+        UINFO(1, "Hierarchical block " << v3Global.opt.topModule()
+                                       << " unchanged, keeping previous output" << endl);
+        return true;
+    }
+    // Remove the stale fingerprint, so a run which fails part way can't match later
+    if (!ifp->fail()) std::remove(filename.c_str());
+    return false;
+}
+
+void V3HierChildFingerprint::write() {
+    if (!enabled() || V3HierChildFingerprintImp::s_fingerprint.empty()) return;
+    const std::unique_ptr<std::ofstream> ofp(
+        V3File::new_ofstream_nodepend(V3HierChildFingerprintImp::filename()));
+    if (ofp->fail()) v3fatal("Can't write " << V3HierChildFingerprintImp::filename());
+    *ofp << V3HierChildFingerprintImp::s_fingerprint << "\n";
+}
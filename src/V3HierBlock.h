@@ -127,4 +127,27 @@ public:
     static void createPlan(AstNetlist* nodep);
 };
 
+//######################################################################
+
+// Fingerprint of the sources, parameters and options of a hierarchical block,
+// so a --hierarchical-child run of an unchanged block can leave its previous
+// output in place, and make need not recompile it.
+class V3HierChildFingerprint final {
+public:
+    // True if this run is a --hierarchical-child that may be skipped
+    static bool enabled();
+    // Record the preprocessed text of a file, which defined the modules
+    // after lastModp (or all modules if nullptr) in the netlist
+    static void addSource(const string& filename, const string& text,
+                          const AstNodeModule* lastModp);
+    // Once all input is read and linked, true if the fingerprint matches the
+    // previous run's, so Verilation may be skipped
+    static bool unchanged();
+    // Save the fingerprint after successful Verilation
+    static void write();
+
+private:
+    VL_DEBUG_FUNC;  // Declare debug()
+};
+
 #endif  // guard
@@ -885,13 +885,18 @@ string V3Number::toString() const {
 
 uint32_t V3Number::toHash() const { return m_value[0]; }
 
-uint32_t V3Number::edataWord(int eword) const {
+vluint64_t V3Number::edataWord(int eword) const {
     UASSERT(!isFourState(), "edataWord with 4-state " << *this);
-    return m_value[eword];
+    if (v3Global.opt.wideWordSize() == 32) return m_value[eword];
+    // --wide-word-size 64, so two of our 32-bit words
+    const int lword = eword * 2;
+    const vluint64_t hi = (lword + 1 < words()) ? m_value[lword + 1] : 0;
+    return (hi << 32ULL) | m_value[lword];
 }
 
 uint8_t V3Number::dataByte(int byte) const {
-    return (edataWord(byte / (VL_EDATASIZE / 8)) >> ((byte * 8) % VL_EDATASIZE)) & 0xff;
+    UASSERT(!isFourState(), "dataByte with 4-state " << *this);
+    return (m_value[byte / 4] >> ((byte * 8) % 32)) & 0xff;
 }
 
 bool V3Number::isEqZero() const {
@@ -299,7 +299,7 @@ public:
     string toDecimalU() const;  // return ASCII unsigned decimal number
     double toDouble() const;
     uint32_t toHash() const;
-    uint32_t edataWord(int eword) const;
+    vluint64_t edataWord(int eword) const;  // Word of --wide-word-size bits
     uint8_t dataByte(int byte) const;
     uint32_t countBits(const V3Number& ctrl) const;
     uint32_t countBits(const V3Number& ctrl1, const V3Number& ctrl2, const V3Number& ctrl3) const;
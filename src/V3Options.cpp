@@ -1004,6 +1004,19 @@ void V3Options::notify() {
     if (m_outputSplitCFuncs < 0) m_outputSplitCFuncs = m_outputSplit;
     if (m_outputSplitCTrace < 0) m_outputSplitCTrace = m_outputSplit;
 
+    if (trace() && traceFormat().vtb() && systemC()) {
+        cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --trace-vtb with --sc. Suggest use --trace.");
+    }
+
+    if (batchLanes()) {
+        if (systemC()) cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --batch-lanes with --sc");
+        if (threads()) cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --batch-lanes with --threads");
+        if (trace()) cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --batch-lanes with --trace");
+        if (settleWorklist()) {
+            cmdfl->v3warn(E_UNSUPPORTED, "Unsupported: --batch-lanes with --settle-worklist");
+        }
+    }
+
     if (v3Global.opt.main() && v3Global.opt.systemC()) {
         cmdfl->v3warn(E_UNSUPPORTED,
                       "--main not usable with SystemC. Suggest see examples for sc_main().");
@@ -1193,12 +1206,17 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-assert", OnOff, &m_assert);
     DECL_OPTION("-autoflush", OnOff, &m_autoflush);
 
+    DECL_OPTION("-batch-lanes", CbVal, [this, fl](const char* valp) {
+        m_batchLanes = std::atoi(valp);
+        if (m_batchLanes < 1) fl->v3fatal("--batch-lanes must be >= 1: " << valp);
+    });
     DECL_OPTION("-bbox-sys", OnOff, &m_bboxSys);
     DECL_OPTION("-bbox-unsup", CbOnOff, [this](bool flag) {
         m_bboxUnsup = flag;
         FileLine::globalWarnOff(V3ErrorCode::E_UNSUPPORTED, true);
     });
     DECL_OPTION("-bin", Set, &m_bin);
+    DECL_OPTION("-cache-dir", Set, &m_cacheDir);
     DECL_OPTION("-build", Set, &m_build);
 
     DECL_OPTION("-CFLAGS", CbVal, {this, &V3Options::addCFlags});
@@ -1335,6 +1353,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     };
     DECL_OPTION("-default-language", CbVal, setLang);
     DECL_OPTION("-language", CbVal, setLang);
+    DECL_OPTION("-layout-affinity", OnOff, &m_layoutAffinity);
     DECL_OPTION("-lint-only", OnOff, &m_lintOnly);
     DECL_OPTION("-l2-name", Set, &m_l2Name);
     DECL_OPTION("-no-l2name", CbCall, [this]() { m_l2Name = ""; }).undocumented();  // Historical
@@ -1445,6 +1464,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-prof-cfuncs", OnOff, &m_profCFuncs);
     DECL_OPTION("-profile-cfuncs", OnOff, &m_profCFuncs).undocumented();  // Renamed
     DECL_OPTION("-prof-threads", OnOff, &m_profThreads);
+    DECL_OPTION("-prof-threads-data", Set, &m_profThreadsData);
     DECL_OPTION("-protect-ids", OnOff, &m_protectIds);
     DECL_OPTION("-protect-key", Set, &m_protectKey);
     DECL_OPTION("-protect-lib", CbVal, [this](const char* valp) {
@@ -1473,6 +1493,7 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         m_outFormatOk = true;
         m_systemC = true;
     });
+    DECL_OPTION("-settle-worklist", OnOff, &m_settleWorklist);
     DECL_OPTION("-skip-identical", OnOff, &m_skipIdentical);
     DECL_OPTION("-stats", OnOff, &m_stats);
     DECL_OPTION("-stats-vars", CbOnOff, [this](bool flag) {
@@ -1482,6 +1503,16 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-structs-unpacked", OnOff, &m_structsPacked);
     DECL_OPTION("-sv", CbCall, [this]() { m_defaultLanguage = V3LangCode::L1800_2017; });
 
+    DECL_OPTION("-table-max-bytes", CbVal, [this, fl](const char* valp) {
+        m_tableMaxBytes = std::atoi(valp);
+        if (m_tableMaxBytes < 0) fl->v3fatal("--table-max-bytes must be >= 0: " << valp);
+    });
+    DECL_OPTION("-table-min-instrs", Set, &m_tableMinInstrs);
+    DECL_OPTION("-table-total-bytes", CbVal, [this, fl](const char* valp) {
+        m_tableTotalBytes = std::atoi(valp);
+        if (m_tableTotalBytes < 0) fl->v3fatal("--table-total-bytes must be >= 0: " << valp);
+    });
+
     DECL_OPTION("-threads-coarsen", OnOff, &m_threadsCoarsen).undocumented();  // Debug
     DECL_OPTION("-no-threads", CbCall, [this]() { m_threads = 0; });
     DECL_OPTION("-threads", CbVal, [this, fl](const char* valp) {
@@ -1504,6 +1535,17 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
                         << fl->warnMore() << "... Suggest 'all', 'none', or 'pure'");
         }
     });
+    DECL_OPTION("-threads-schedule", CbVal, [this, fl](const char* valp) {
+        if (!strcmp(valp, "static")) {
+            m_threadsDynamic = false;
+        } else if (!strcmp(valp, "dynamic")) {
+            m_threadsDynamic = true;
+        } else {
+            fl->v3fatal("Unknown setting for --threads-schedule: '"
+                        << valp << "'\n"
+                        << fl->warnMore() << "... Suggest 'static' or 'dynamic'");
+        }
+    });
     DECL_OPTION("-threads-max-mtasks", CbVal, [this, fl](const char* valp) {
         m_threadsMaxMTasks = std::atoi(valp);
         if (m_threadsMaxMTasks < 1) fl->v3fatal("--threads-max-mtasks must be >= 1: " << valp);
@@ -1531,6 +1573,8 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-top-module", Set, &m_topModule);
     DECL_OPTION("-top", Set, &m_topModule);
     DECL_OPTION("-trace", OnOff, &m_trace);
+    DECL_OPTION("-trace-activity-fine", OnOff, &m_traceActivityFine);
+    DECL_OPTION("-trace-activity-stats", OnOff, &m_traceActivityStats);
     DECL_OPTION("-trace-coverage", OnOff, &m_traceCoverage);
     DECL_OPTION("-trace-depth", Set, &m_traceDepth);
     DECL_OPTION("-trace-fst", CbCall, [this]() {
@@ -1547,6 +1591,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         if (m_traceThreads == 0) m_traceThreads = 1;
     });
     DECL_OPTION("-trace-max-array", Set, &m_traceMaxArray);
+    DECL_OPTION("-trace-max-groups", CbVal, [this, fl](const char* valp) {
+        m_traceMaxGroups = std::atoi(valp);
+        if (m_traceMaxGroups < 0) fl->v3fatal("--trace-max-groups must be >= 0: " << valp);
+    });
     DECL_OPTION("-trace-max-width", Set, &m_traceMaxWidth);
     DECL_OPTION("-trace-params", OnOff, &m_traceParams);
     DECL_OPTION("-trace-structs", OnOff, &m_traceStructs);
@@ -1556,6 +1604,10 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         if (m_traceThreads < 0) fl->v3fatal("--trace-threads must be >= 0: " << valp);
     });
     DECL_OPTION("-trace-underscore", OnOff, &m_traceUnderscore);
+    DECL_OPTION("-trace-vtb", CbCall, [this]() {
+        m_trace = true;
+        m_traceFormat = TraceFormat::VTB;
+    });
 
     DECL_OPTION("-U", CbPartialMatch, &V3PreShell::undef);
     DECL_OPTION("-underline-zero", OnOff, &m_underlineZero);  // Deprecated
@@ -1571,11 +1623,16 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
         V3Options::addLibraryFile(parseFileArg(optdir, valp));
     });
     DECL_OPTION("-verilate", OnOff, &m_verilate);
+    DECL_OPTION("-verilate-jobs", CbVal, [this, fl](const char* valp) {
+        m_verilateJobs = std::atoi(valp);
+        if (m_verilateJobs < 0) fl->v3fatal("--verilate-jobs must be >= 0: " << valp);
+    });
     DECL_OPTION("-version", CbCall, [this]() {
         showVersion(false);
         std::exit(0);
     });
     DECL_OPTION("-vpi", OnOff, &m_vpi);
+    DECL_OPTION("-vpi-dirty", OnOff, &m_vpiDirty);
 
     DECL_OPTION("-Wpedantic", OnOff, &m_pedantic);
     DECL_OPTION("-Wall", CbCall, []() {
@@ -1628,6 +1685,14 @@ void V3Options::parseOptsList(FileLine* fl, const string& optdir, int argc, char
     DECL_OPTION("-Wwarn-lint", CbCall, []() { FileLine::globalWarnLintOff(false); });
     DECL_OPTION("-Wwarn-style", CbCall, []() { FileLine::globalWarnStyleOff(false); });
     DECL_OPTION("-waiver-output", Set, &m_waiverOutput);
+    DECL_OPTION("-wide-word-size", CbVal, [this, fl](const char* valp) {
+        m_wideWordSize = std::atoi(valp);
+        if (m_wideWordSize != 32 && m_wideWordSize != 64) {
+            fl->v3fatal("Unknown setting for --wide-word-size: '"
+                        << valp << "'\n"
+                        << fl->warnMore() << "... Suggest '32' or '64'");
+        }
+    });
 
     DECL_OPTION("-x-assign", CbVal, [this, fl](const char* valp) {
         if (!strcmp(valp, "0")) {
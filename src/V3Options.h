@@ -129,7 +129,7 @@ inline std::ostream& operator<<(std::ostream& os, const VTimescale& rhs) {
 
 class TraceFormat final {
 public:
-    enum en : uint8_t { VCD = 0, FST } m_e;
+    enum en : uint8_t { VCD = 0, FST, VTB } m_e;
     // cppcheck-suppress noExplicitConstructor
     inline TraceFormat(en _e = VCD)
         : m_e{_e} {}
@@ -137,12 +137,13 @@ public:
         : m_e(static_cast<en>(_e)) {}  // Need () or GCC 4.8 false warning
     operator en() const { return m_e; }
     bool fst() const { return m_e == FST; }
+    bool vtb() const { return m_e == VTB; }
     string classBase() const {
-        static const char* const names[] = {"VerilatedVcd", "VerilatedFst"};
+        static const char* const names[] = {"VerilatedVcd", "VerilatedFst", "VerilatedVtb"};
         return names[m_e];
     }
     string sourceName() const {
-        static const char* const names[] = {"verilated_vcd", "verilated_fst"};
+        static const char* const names[] = {"verilated_vcd", "verilated_fst", "verilated_vtb"};
         return names[m_e];
     }
 };
@@ -243,6 +244,7 @@ private:
     bool m_hierChild = false;       // main switch: --hierarchical-child
     bool m_ignc = false;            // main switch: --ignc
     bool m_inhibitSim = false;      // main switch: --inhibit-sim
+    bool m_layoutAffinity = false;  // main switch: --layout-affinity
     bool m_lintOnly = false;        // main switch: --lint-only
     bool m_gmake = false;           // main switch: --make gmake
     bool m_main = false;            // main swithc: --main
@@ -263,6 +265,7 @@ private:
     bool m_relativeIncludes = false; // main switch: --relative-includes
     bool m_reportUnoptflat = false; // main switch: --report-unoptflat
     bool m_savable = false;         // main switch: --savable
+    bool m_settleWorklist = false;  // main switch: --settle-worklist
     bool m_structsPacked = true;    // main switch: --structs-packed
     bool m_systemC = false;         // main switch: --sc: System C instead of simple C++
     bool m_stats = false;           // main switch: --stats
@@ -270,7 +273,10 @@ private:
     bool m_threadsCoarsen = true;   // main switch: --threads-coarsen
     bool m_threadsDpiPure = true;   // main switch: --threads-dpi all/pure
     bool m_threadsDpiUnpure = false;  // main switch: --threads-dpi all
+    bool m_threadsDynamic = false;  // main switch: --threads-schedule dynamic
     bool m_trace = false;           // main switch: --trace
+    bool m_traceActivityFine = false;  // main switch: --trace-activity-fine
+    bool m_traceActivityStats = false;  // main switch: --trace-activity-stats
     bool m_traceCoverage = false;   // main switch: --trace-coverage
     bool m_traceParams = true;      // main switch: --trace-params
     bool m_traceStructs = false;    // main switch: --trace-structs
@@ -278,9 +284,11 @@ private:
     bool m_underlineZero = false;   // main switch: --underline-zero; undocumented old Verilator 2
     bool m_verilate = true;         // main swith: --verilate
     bool m_vpi = false;             // main switch: --vpi
+    bool m_vpiDirty = false;        // main switch: --vpi-dirty
     bool m_xInitialEdge = false;    // main switch: --x-initial-edge
     bool m_xmlOnly = false;         // main switch: --xml-only
 
+    int         m_batchLanes = 0;   // main switch: --batch-lanes
     int         m_buildJobs = 1;    // main switch: -j
     int         m_convergeLimit = 100;  // main switch: --converge-limit
     int         m_coverageMaxWidth = 256; // main switch: --coverage-max-width
@@ -296,6 +304,9 @@ private:
     int         m_outputSplitCTrace = -1;  // main switch: --output-split-ctrace
     int         m_pinsBv = 65;       // main switch: --pins-bv
     VOptionBool m_skipIdentical;  // main switch: --skip-identical
+    int         m_tableMaxBytes = 1024 * 1024;  // main switch: --table-max-bytes
+    int         m_tableMinInstrs = 32;  // main switch: --table-min-instrs
+    int         m_tableTotalBytes = 64 * 1024 * 1024;  // main switch: --table-total-bytes
     int         m_threads = 0;      // main switch: --threads (0 == --no-threads)
     int         m_threadsMaxMTasks = 0;  // main switch: --threads-max-mtasks
     VTimescale  m_timeDefaultPrec;  // main switch: --timescale
@@ -305,16 +316,20 @@ private:
     int         m_traceDepth = 0;   // main switch: --trace-depth
     TraceFormat m_traceFormat;  // main switch: --trace or --trace-fst
     int         m_traceMaxArray = 32;  // main switch: --trace-max-array
+    int         m_traceMaxGroups = 0;  // main switch: --trace-max-groups
     int         m_traceMaxWidth = 256; // main switch: --trace-max-width
     int         m_traceThreads = 0; // main switch: --trace-threads
     int         m_unrollCount = 64;  // main switch: --unroll-count
     int         m_unrollStmts = 30000;  // main switch: --unroll-stmts
+    int         m_verilateJobs = 1;  // main switch: --verilate-jobs
+    int         m_wideWordSize = 32;  // main switch: --wide-word-size
 
     int         m_compLimitBlocks = 0;  // compiler selection; number of nested blocks
     int         m_compLimitMembers = 64;  // compiler selection; number of members in struct before make anon array
     int         m_compLimitParens = 0;  // compiler selection; number of nested parens
 
     string      m_bin;          // main switch: --bin {binary}
+    string      m_cacheDir;     // main switch: --cache-dir {dir}
     string      m_exeName;      // main switch: -o {name}
     string      m_flags;        // main switch: -f {name}
     string      m_l2Name;       // main switch: --l2name; "" for top-module's name
@@ -322,6 +337,7 @@ private:
     string      m_modPrefix;    // main switch: --mod-prefix
     string      m_pipeFilter;   // main switch: --pipe-filter
     string      m_prefix;       // main switch: --prefix
+    string      m_profThreadsData;  // main switch: --prof-threads-data {filename}
     string      m_protectKey;   // main switch: --protect-key
     string      m_protectLib;   // main switch: --protect-lib {lib_name}
     string      m_topModule;    // main switch: --top-module
@@ -408,9 +424,11 @@ public:
     bool preprocNoLine() const { return m_preprocNoLine; }
     bool underlineZero() const { return m_underlineZero; }
     string bin() const { return m_bin; }
+    string cacheDir() const { return m_cacheDir; }
     string flags() const { return m_flags; }
     bool systemC() const { return m_systemC; }
     bool savable() const { return m_savable; }
+    bool settleWorklist() const { return m_settleWorklist; }
     bool stats() const { return m_stats; }
     bool statsVars() const { return m_statsVars; }
     bool structsPacked() const { return m_structsPacked; }
@@ -446,7 +464,10 @@ public:
     bool threadsDpiPure() const { return m_threadsDpiPure; }
     bool threadsDpiUnpure() const { return m_threadsDpiUnpure; }
     bool threadsCoarsen() const { return m_threadsCoarsen; }
+    bool threadsDynamic() const { return m_threadsDynamic; }
     bool trace() const { return m_trace; }
+    bool traceActivityFine() const { return m_traceActivityFine; }
+    bool traceActivityStats() const { return m_traceActivityStats; }
     bool traceCoverage() const { return m_traceCoverage; }
     bool traceParams() const { return m_traceParams; }
     bool traceStructs() const { return m_traceStructs; }
@@ -465,6 +486,7 @@ public:
     bool protectIds() const { return m_protectIds; }
     bool allPublic() const { return m_public; }
     bool publicFlatRW() const { return m_publicFlatRW; }
+    bool layoutAffinity() const { return m_layoutAffinity; }
     bool lintOnly() const { return m_lintOnly; }
     bool ignc() const { return m_ignc; }
     bool inhibitSim() const { return m_inhibitSim; }
@@ -473,9 +495,11 @@ public:
     bool reportUnoptflat() const { return m_reportUnoptflat; }
     bool verilate() const { return m_verilate; }
     bool vpi() const { return m_vpi; }
+    bool vpiDirty() const { return m_vpiDirty; }
     bool xInitialEdge() const { return m_xInitialEdge; }
     bool xmlOnly() const { return m_xmlOnly; }
 
+    int batchLanes() const { return m_batchLanes; }
     int buildJobs() const { return m_buildJobs; }
     int convergeLimit() const { return m_convergeLimit; }
     int coverageMaxWidth() const { return m_coverageMaxWidth; }
@@ -492,6 +516,9 @@ public:
     int outputSplitCTrace() const { return m_outputSplitCTrace; }
     int pinsBv() const { return m_pinsBv; }
     VOptionBool skipIdentical() const { return m_skipIdentical; }
+    int tableMaxBytes() const { return m_tableMaxBytes; }
+    int tableMinInstrs() const { return m_tableMinInstrs; }
+    int tableTotalBytes() const { return m_tableTotalBytes; }
     int threads() const { return m_threads; }
     int threadsMaxMTasks() const { return m_threadsMaxMTasks; }
     bool mtasks() const { return (m_threads > 1); }
@@ -504,6 +531,7 @@ public:
     int traceDepth() const { return m_traceDepth; }
     TraceFormat traceFormat() const { return m_traceFormat; }
     int traceMaxArray() const { return m_traceMaxArray; }
+    int traceMaxGroups() const { return m_traceMaxGroups; }
     int traceMaxWidth() const { return m_traceMaxWidth; }
     int traceThreads() const { return m_traceThreads; }
     bool trueTraceThreads() const {
@@ -511,6 +539,9 @@ public:
     }
     int unrollCount() const { return m_unrollCount; }
     int unrollStmts() const { return m_unrollStmts; }
+    int verilateJobs() const { return m_verilateJobs; }
+    int wideWordSize() const { return m_wideWordSize; }
+    int wideWords(int nbits) const { return (nbits + m_wideWordSize - 1) / m_wideWordSize; }
 
     int compLimitBlocks() const { return m_compLimitBlocks; }
     int compLimitMembers() const { return m_compLimitMembers; }
@@ -522,6 +553,7 @@ public:
     string modPrefix() const { return m_modPrefix; }
     string pipeFilter() const { return m_pipeFilter; }
     string prefix() const { return m_prefix; }
+    string profThreadsData() const { return m_profThreadsData; }
     string protectKeyDefaulted();  // Set default key if not set by user
     string protectLib() const { return m_protectLib; }
     string protectLibName(bool shared) {
@@ -29,7 +29,9 @@
 #include "V3Global.h"
 #include "V3Os.h"
 #include "V3Ast.h"
+#include "V3Cache.h"
 #include "V3File.h"
+#include "V3HierBlock.h"
 #include "V3ParseImp.h"
 #include "V3PreShell.h"
 #include "V3LanguageWords.h"
@@ -307,9 +309,23 @@ void V3ParseImp::parseFile(FileLine* fileline, const string& modfilename, bool i
         }
     }
 
+    string ppText;
+    if (V3Cache::enabled() || V3HierChildFingerprint::enabled()) {
+        for (const string& buf : m_ppBuffers) ppText += buf;
+        V3Cache::addInput(modfilename, ppText);
+    }
+
     // Parse it
     if (!v3Global.opt.preprocOnly()) {
+        AstNodeModule* lastModp = nullptr;
+        if (V3HierChildFingerprint::enabled()) {
+            for (AstNodeModule* modp = v3Global.rootp()->modulesp(); modp;
+                 modp = VN_CAST(modp->nextp(), NodeModule)) {
+                lastModp = modp;
+            }
+        }
         lexFile(modfilename);
+        V3HierChildFingerprint::addSource(modfilename, ppText, lastModp);
     } else {
         m_ppBuffers.clear();
     }
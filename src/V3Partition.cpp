@@ -27,8 +27,11 @@
 #include "V3Scoreboard.h"
 #include "V3Stats.h"
 
+#include <algorithm>
+#include <fstream>
 #include <list>
 #include <memory>
+#include <sstream>
 #include <unordered_set>
 
 class MergeCandidate;
@@ -2478,14 +2481,168 @@ void V3Partition::go(V3Graph* mtasksp) {
     }
 }
 
+//######################################################################
+// PartMTaskHasher
+
+// Compute a hash of the logic in an mtask, for matching it against the
+// profile of an earlier Verilation (--prof-threads-data). Unlike V3Hashed
+// this must not depend on pointers, and must not depend on the mtask id
+// or the numbering of CFuncs, which both shift on unrelated RTL edits.
+class PartMTaskHasher final : public AstNVisitor {
+private:
+    // MEMBERS
+    string m_text;  // Text to digest
+    std::unordered_set<const AstCFunc*> m_funcps;  // CFuncs already included
+    // METHODS
+    VL_DEBUG_FUNC;
+
+    virtual void visit(AstNodeCCall* nodep) override {
+        m_text += nodep->typeName();
+        iterateChildren(nodep);
+        // Include the body of the called function, rather than its name
+        if (m_funcps.insert(nodep->funcp()).second) iterateChildren(nodep->funcp());
+    }
+    virtual void visit(AstNode* nodep) override {
+        string name = nodep->name();
+        // Temporaries are numbered across the whole design, ignore the number
+        if (name.compare(0, 3, "__V") == 0) {
+            name.erase(std::remove_if(name.begin(), name.end(), ::isdigit), name.end());
+        }
+        m_text += nodep->typeName();
+        m_text += ":" + name + ";";
+        iterateChildren(nodep);
+    }
+
+public:
+    // CONSTRUCTORS
+    explicit PartMTaskHasher(AstMTaskBody* nodep) { iterateChildren(nodep); }
+    virtual ~PartMTaskHasher() override = default;
+    // METHODS
+    string hashName() { return VHashSha256(m_text).digestHex().substr(0, 16); }
+};
+
+//######################################################################
+// PartProfileData
+
+// Measured mtask costs from a --prof-threads dump of an earlier
+// Verilation of the model, keyed by PartMTaskHasher hash.
+class PartProfileData final {
+    // TYPES
+    struct Measured {
+        double m_total = 0;  // Sum of elapsed times
+        vluint64_t m_count = 0;  // Number of samples
+    };
+    // MEMBERS
+    std::unordered_map<string, Measured> m_costs;  // Hash -> measured cost
+
+public:
+    // CONSTRUCTORS
+    explicit PartProfileData(const string& filename) {
+        const std::unique_ptr<std::ifstream> ifp{V3File::new_ifstream(filename)};
+        if (ifp->fail()) {
+            v3error("Cannot open --prof-threads-data file: " << filename);
+            return;
+        }
+        std::unordered_map<uint32_t, string> idHashes;  // Mtask id -> hash
+        std::unordered_map<uint32_t, Measured> idCosts;  // Mtask id -> measured
+        string line;
+        while (std::getline(*ifp, line)) {
+            std::istringstream is{line};
+            string prefix;
+            string kind;
+            uint32_t id = 0;
+            is >> prefix >> kind >> id;
+            if (prefix != "VLPROF" || is.fail()) continue;
+            if (kind == "mtask_hash") {
+                string hash;
+                if (is >> hash) idHashes[id] = hash;
+            } else if (kind == "mtask") {
+                string key;
+                vluint64_t value;
+                while (is >> key >> value) {
+                    if (key == "elapsed") {
+                        idCosts[id].m_total += value;
+                        ++idCosts[id].m_count;
+                        break;
+                    }
+                }
+            }
+        }
+        for (const auto& it : idCosts) {
+            const auto hit = idHashes.find(it.first);
+            if (hit == idHashes.end()) continue;
+            Measured& measured = m_costs[hit->second];
+            measured.m_total += it.second.m_total;
+            measured.m_count += it.second.m_count;
+        }
+        UINFO(4, "Read profile for " << m_costs.size() << " mtasks from " << filename << endl);
+    }
+    ~PartProfileData() = default;
+    // METHODS
+    // Return mean measured cost of the mtask with the given hash, or 0 if unknown
+    double cost(const string& hashName) const {
+        const auto it = m_costs.find(hashName);
+        if (it == m_costs.end() || !it->second.m_count) return 0;
+        return it->second.m_total / it->second.m_count;
+    }
+};
+
+//######################################################################
+// V3Partition
+
+void V3Partition::applyProfileCosts(V3Graph* execMTaskGraphp) {
+    const PartProfileData profile{v3Global.opt.profThreadsData()};
+    // The profile is in rdtsc ticks, while the estimates are in
+    // V3InstrCount units. Scale the measured costs so that the matched
+    // mtasks keep the same total cost; that way unmatched mtasks (new or
+    // edited logic) keep sensible estimates relative to the matched ones.
+    double estimatedTotal = 0;
+    double measuredTotal = 0;
+    for (V3GraphVertex* vxp = execMTaskGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        const ExecMTask* mtp = dynamic_cast<ExecMTask*>(vxp);
+        const double measured = profile.cost(mtp->hashName());
+        if (measured > 0) {
+            estimatedTotal += mtp->cost();
+            measuredTotal += measured;
+        }
+    }
+    uint32_t matched = 0;
+    uint32_t unmatched = 0;
+    for (V3GraphVertex* vxp = execMTaskGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        ExecMTask* mtp = dynamic_cast<ExecMTask*>(vxp);
+        const double measured = profile.cost(mtp->hashName());
+        if (measured > 0) {
+            const double scaled = measured * estimatedTotal / measuredTotal;
+            UINFO(6, "Profile cost for " << mtp->name() << " " << mtp->hashName() << " estimate "
+                                         << mtp->cost() << " measured " << scaled << endl);
+            const double clamped = std::min<double>(scaled, 0xffffffffU);
+            mtp->cost(std::max<uint32_t>(1, static_cast<uint32_t>(clamped)));
+            ++matched;
+        } else {
+            ++unmatched;
+        }
+    }
+    V3Stats::addStat("MTask graph, profile matched mtasks", matched);
+    V3Stats::addStat("MTask graph, profile unmatched mtasks", unmatched);
+}
+
 void V3Partition::finalizeCosts(V3Graph* execMTaskGraphp) {
+    for (V3GraphVertex* vxp = execMTaskGraphp->verticesBeginp(); vxp;
+         vxp = vxp->verticesNextp()) {
+        ExecMTask* mtp = dynamic_cast<ExecMTask*>(vxp);
+        mtp->cost(V3InstrCount::count(mtp->bodyp(), false));
+        mtp->hashName(PartMTaskHasher(mtp->bodyp()).hashName());
+    }
+    // Replace the estimates with measured costs where available
+    if (!v3Global.opt.profThreadsData().empty()) applyProfileCosts(execMTaskGraphp);
+
     GraphStreamUnordered ser(execMTaskGraphp, GraphWay::REVERSE);
 
     while (const V3GraphVertex* vxp = ser.nextp()) {
         ExecMTask* mtp = dynamic_cast<ExecMTask*>(const_cast<V3GraphVertex*>(vxp));
-        uint32_t costCount = V3InstrCount::count(mtp->bodyp(), false);
-        mtp->cost(costCount);
-        mtp->priority(costCount);
+        mtp->priority(mtp->cost());
 
         // "Priority" is the critical path from the start of the mtask, to
         // the end of the graph reachable from this mtask.  Given the
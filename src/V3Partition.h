@@ -64,6 +64,7 @@ public:
 
 private:
     static void finalizeCosts(V3Graph* execMTaskGraphp);
+    static void applyProfileCosts(V3Graph* execMTaskGraphp);
     static void setupMTaskDeps(V3Graph* mtasksp, const Vx2MTaskMap* vx2mtaskp);
 
     VL_DEBUG_FUNC;  // Declare debug()
@@ -65,6 +65,7 @@ private:
     // or 0xffffffff if not yet assigned.
     const ExecMTask* m_packNextp = nullptr;  // Next for static (pack_mtasks) scheduling
     bool m_threadRoot = false;  // Is root thread
+    string m_hashName;  // Hash of the logic, stable across Verilations
     VL_UNCOPYABLE(ExecMTask);
 
 public:
@@ -84,6 +85,8 @@ public:
     const ExecMTask* packNextp() const { return m_packNextp; }
     bool threadRoot() const { return m_threadRoot; }
     void threadRoot(bool threadRoot) { m_threadRoot = threadRoot; }
+    const string& hashName() const { return m_hashName; }
+    void hashName(const string& name) { m_hashName = name; }
     string cFuncName() const {
         // If this MTask maps to a C function, this should be the name
         return string("__Vmtask") + "__" + cvtToStr(m_id);
@@ -30,19 +30,20 @@
 #include "V3Global.h"
 #include "V3Premit.h"
 #include "V3Ast.h"
+#include "V3ThreadPool.h"
 
 #include <algorithm>
+#include <unordered_set>
 
 //######################################################################
 // Structure for global state
 
 class PremitAssignVisitor final : public AstNVisitor {
 private:
-    // NODE STATE
-    //  AstVar::user4()         // bool; occurs on LHS of current assignment
-    AstUser4InUse m_inuser4;
-
     // STATE
+    // Variables on LHS of current assignment.  Not user4(), as the variable
+    // may be shared with other modules being processed in parallel.
+    std::unordered_set<const AstVar*> m_lhsVars;
     bool m_noopt = false;  // Disable optimization of variables in this block
 
     // METHODS
@@ -50,7 +51,6 @@ private:
 
     // VISITORS
     virtual void visit(AstNodeAssign* nodep) override {
-        // AstNode::user4ClearTree();  // Implied by AstUser4InUse
         // LHS first as fewer varrefs
         iterateAndNextNull(nodep->lhsp());
         // Now find vars marked as lhs
@@ -59,9 +59,9 @@ private:
     virtual void visit(AstVarRef* nodep) override {
         // it's LHS var is used so need a deep temporary
         if (nodep->access().isWriteOrRW()) {
-            nodep->varp()->user4(true);
+            m_lhsVars.insert(nodep->varp());
         } else {
-            if (nodep->varp()->user4()) {
+            if (m_lhsVars.count(nodep->varp())) {
                 if (!m_noopt) UINFO(4, "Block has LHS+RHS var: " << nodep << endl);
                 m_noopt = true;
             }
@@ -88,7 +88,6 @@ private:
     //  AstNodeMath::user()     -> bool.  True if iterated already
     //  AstShiftL::user2()      -> bool.  True if converted to conditional
     //  AstShiftR::user2()      -> bool.  True if converted to conditional
-    //  *::user4()              -> See PremitAssignVisitor
     AstUser1InUse m_inuser1;
     AstUser2InUse m_inuser2;
 
@@ -398,7 +397,7 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit PremitVisitor(AstNetlist* nodep) { iterate(nodep); }
+    explicit PremitVisitor(AstNodeModule* nodep) { iterate(nodep); }
     virtual ~PremitVisitor() override = default;
 };
 
@@ -410,6 +409,7 @@ public:
 
 void V3Premit::premitAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    { PremitVisitor visitor(nodep); }  // Destruct before checking
+    // Module-local; each module gets its own visitor
+    V3ThreadPool::forEachModule(nodep, [](AstNodeModule* modp) { PremitVisitor visitor(modp); });
     V3Global::dumpCheckGlobalTree("premit", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
 }
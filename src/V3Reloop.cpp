@@ -25,7 +25,20 @@
 //      FOR(__Vilp = low; __Vilp <= high; ++__Vlip)
 //         ASSIGN(ARRAYREF(var, __Vilp), ARRAYREF(var, __Vilp))
 //
-//   Likewise vector assign to the same constant converted to a loop.
+//   More generally, consecutive assignments to a constant index select
+//   merge when their trees are identical except for the constant index of
+//   each select (WordSel or ArraySel), and each such index is an affine
+//   function of the assignment's position in the series, e.g.:
+//
+//      ASSIGN(WORDSEL(a, 2), AND(WORDSEL(b, 4), WORDSEL(c, 1)))
+//      ASSIGN(WORDSEL(a, 3), AND(WORDSEL(b, 6), WORDSEL(c, 1)))
+//      ->
+//      FOR(__Vilp = 0; __Vilp <= 1; ++__Vilp)
+//         ASSIGN(WORDSEL(a, 2 + __Vilp), AND(WORDSEL(b, 4 + 2 * __Vilp), WORDSEL(c, 1)))
+//
+//   The loop executes the assignments in their original order.  When all
+//   indices advance by one, the loop runs over the first index so simple
+//   copies keep the form above, which C++ compilers readily vectorize.
 //
 //*************************************************************************
 
@@ -36,10 +49,14 @@
 #include "V3Reloop.h"
 #include "V3Stats.h"
 #include "V3Ast.h"
+#include "V3ThreadPool.h"
 
 #include <algorithm>
+#include <mutex>
 
 constexpr unsigned RELOOP_MIN_ITERS = 40;  // Need at least this many loops to do this optimization
+constexpr unsigned RELOOP_MIN_BODY_ITERS = 8;  // Or at least this many loops of larger bodies
+constexpr unsigned RELOOP_MIN_NODES = 320;  // ... with at least this many nodes in total
 
 //######################################################################
 
@@ -49,21 +66,29 @@ private:
     // AstCFunc::user1p      -> Var* for temp var, 0=not set yet
     AstUser1InUse m_inuser1;
 
+    // TYPES
+    struct Shape {  // Flattened assignment tree
+        std::vector<AstNode*> m_nodeps;  // Each node, in pre-order
+        std::vector<AstConst*> m_indexps;  // Constant index of each select, in pre-order
+        std::vector<vlsint64_t> m_values;  // Value of each m_indexps
+        void clear() {
+            m_nodeps.clear();
+            m_indexps.clear();
+            m_values.clear();
+        }
+    };
+
     // STATE
     VDouble0 m_statReloops;  // Statistic tracking
     VDouble0 m_statReItems;  // Statistic tracking
     AstCFunc* m_cfuncp = nullptr;  // Current block
 
-    std::vector<AstNodeAssign*> m_mgAssignps;  // List of assignments merging
+    std::vector<AstNodeAssign*> m_mgAssignps;  // List of assignments merging, nullptr = idle
     AstCFunc* m_mgCfuncp = nullptr;  // Parent C function
     AstNode* m_mgNextp = nullptr;  // Next node
-    AstNodeSel* m_mgSelLp = nullptr;  // Parent select, nullptr = idle
-    AstNodeSel* m_mgSelRp = nullptr;  // Parent select, nullptr = constant
-    AstNodeVarRef* m_mgVarrefLp = nullptr;  // Parent varref
-    AstNodeVarRef* m_mgVarrefRp = nullptr;  // Parent varref, nullptr = constant
-    AstConst* m_mgConstRp = nullptr;  // Parent RHS constant, nullptr = sel
-    uint32_t m_mgIndexLo = 0;  // Merge range
-    uint32_t m_mgIndexHi = 0;  // Merge range
+    Shape m_mgShape;  // Shape of first assignment
+    std::vector<vlsint64_t> m_mgSteps;  // Change in each index per assignment
+    Shape m_shape;  // Shape of assignment being checked, kept to avoid reallocation
 
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
@@ -79,27 +104,98 @@ private:
         }
         return varp;
     }
+    static bool isIndex(const AstNode* nodep) {
+        // Is a constant select index that may vary between merged assignments
+        // (Assoc arrays can have wider constants)
+        const AstConst* constp = VN_CAST_CONST(nodep, Const);
+        return constp && constp->width() <= 32 && VN_IS(constp->backp(), NodeSel)
+               && VN_CAST_CONST(constp->backp(), NodeSel)->bitp() == constp;
+    }
+    static void shapeIterate(AstNode* nodep, Shape& shape) {
+        for (; nodep; nodep = nodep->nextp()) {
+            shape.m_nodeps.push_back(nodep);
+            if (isIndex(nodep)) {
+                AstConst* constp = VN_CAST(nodep, Const);
+                shape.m_indexps.push_back(constp);
+                shape.m_values.push_back(constp->toUInt());
+            }
+            shapeIterate(nodep->op1p(), shape);
+            shapeIterate(nodep->op2p(), shape);
+            shapeIterate(nodep->op3p(), shape);
+            shapeIterate(nodep->op4p(), shape);
+        }
+    }
+    static bool sameShape(const Shape& ashape, const Shape& bshape) {
+        // Return true if identical trees, ignoring the value of each index
+        if (ashape.m_nodeps.size() != bshape.m_nodeps.size()
+            || ashape.m_indexps.size() != bshape.m_indexps.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < ashape.m_nodeps.size(); ++i) {
+            const AstNode* ap = ashape.m_nodeps[i];
+            const AstNode* bp = bshape.m_nodeps[i];
+            if (ap->type() != bp->type() || ap->dtypep() != bp->dtypep()
+                || (!ap->op1p() != !bp->op1p()) || (!ap->op2p() != !bp->op2p())
+                || (!ap->op3p() != !bp->op3p()) || (!ap->op4p() != !bp->op4p())
+                || (i && !ap->nextp() != !bp->nextp())  // Assignment's own next is unrelated
+                || isIndex(ap) != isIndex(bp)) {
+                return false;
+            }
+            if (!isIndex(ap) && !ap->same(bp)) return false;
+        }
+        return true;
+    }
+    AstNode* newIndexp(FileLine* fl, AstVar* itp, vlsint64_t offset, vlsint64_t step) {
+        // Return expression offset + step * __Vilp
+        AstNode* termp = new AstVarRef(fl, itp, VAccess::READ);
+        const vlsint64_t absStep = step < 0 ? -step : step;
+        if (absStep != 1) {
+            termp = new AstMul(fl, new AstConst(fl, static_cast<uint32_t>(absStep)), termp);
+        }
+        if (step < 0) {
+            return new AstSub(fl, new AstConst(fl, static_cast<uint32_t>(offset)), termp);
+        } else if (offset > 0) {
+            return new AstAdd(fl, new AstConst(fl, static_cast<uint32_t>(offset)), termp);
+        } else if (offset < 0) {
+            return new AstSub(fl, termp, new AstConst(fl, static_cast<uint32_t>(-offset)));
+        } else {
+            return termp;
+        }
+    }
     void mergeEnd() {
         if (!m_mgAssignps.empty()) {
-            uint32_t items = m_mgIndexHi - m_mgIndexLo + 1;
-            UINFO(9, "End merge iter=" << items << " " << m_mgIndexHi << ":" << m_mgIndexLo << " "
-                                       << m_mgAssignps[0] << endl);
-            if (items >= RELOOP_MIN_ITERS) {
-                UINFO(6, "Reloop merging items=" << items << " " << m_mgIndexHi << ":"
-                                                 << m_mgIndexLo << " " << m_mgAssignps[0] << endl);
+            const uint32_t items = m_mgAssignps.size();
+            const size_t nodes = m_mgShape.m_nodeps.size();
+            UINFO(9, "End merge iter=" << items << " nodes=" << nodes << " " << m_mgAssignps[0]
+                                       << endl);
+            if (items >= RELOOP_MIN_ITERS
+                || (items >= RELOOP_MIN_BODY_ITERS && items * nodes >= RELOOP_MIN_NODES)) {
+                UINFO(6, "Reloop merging items=" << items << " " << m_mgAssignps[0] << endl);
                 ++m_statReloops;
                 m_statReItems += items;
 
                 // Transform first assign into for loop body
                 AstNodeAssign* bodyp = m_mgAssignps.front();
-                UASSERT_OBJ(bodyp->lhsp() == m_mgSelLp, bodyp, "Corrupt queue/state");
+                UASSERT_OBJ(bodyp == m_mgShape.m_nodeps.front(), bodyp, "Corrupt queue/state");
                 FileLine* fl = bodyp->fileline();
                 AstVar* itp = findCreateVarTemp(fl, m_mgCfuncp);
 
+                // If every varying index advances by one, loop over the first
+                // such index, else loop over the assignment number
+                bool unitSteps = true;
+                vlsint64_t base = -1;
+                for (size_t i = 0; i < m_mgSteps.size(); ++i) {
+                    if (!m_mgSteps[i]) continue;
+                    if (m_mgSteps[i] != 1) unitSteps = false;
+                    if (base < 0) base = m_mgShape.m_values[i];
+                }
+                if (!unitSteps) base = 0;
+
                 AstNode* initp = new AstAssign(fl, new AstVarRef(fl, itp, VAccess::WRITE),
-                                               new AstConst(fl, m_mgIndexLo));
-                AstNode* condp = new AstLte(fl, new AstVarRef(fl, itp, VAccess::READ),
-                                            new AstConst(fl, m_mgIndexHi));
+                                               new AstConst(fl, static_cast<uint32_t>(base)));
+                AstNode* condp
+                    = new AstLte(fl, new AstVarRef(fl, itp, VAccess::READ),
+                                 new AstConst(fl, static_cast<uint32_t>(base + items - 1)));
                 AstNode* incp = new AstAssign(
                     fl, new AstVarRef(fl, itp, VAccess::WRITE),
                     new AstAdd(fl, new AstConst(fl, 1), new AstVarRef(fl, itp, VAccess::READ)));
@@ -108,14 +204,14 @@ private:
                 bodyp->replaceWith(initp);
                 whilep->addBodysp(bodyp);
 
-                // Replace constant index with new loop index
-                AstNode* lbitp = m_mgSelLp->bitp();
-                lbitp->replaceWith(new AstVarRef(fl, itp, VAccess::READ));
-                VL_DO_DANGLING(lbitp->deleteTree(), lbitp);
-                if (m_mgSelRp) {  // else constant and no replace
-                    AstNode* rbitp = m_mgSelRp->bitp();
-                    rbitp->replaceWith(new AstVarRef(fl, itp, VAccess::READ));
-                    VL_DO_DANGLING(rbitp->deleteTree(), lbitp);
+                // Replace varying constant indices with function of loop index
+                for (size_t i = 0; i < m_mgSteps.size(); ++i) {
+                    const vlsint64_t step = m_mgSteps[i];
+                    if (!step) continue;
+                    AstConst* const bitp = m_mgShape.m_indexps[i];
+                    const vlsint64_t offset = m_mgShape.m_values[i] - step * base;
+                    bitp->replaceWith(newIndexp(fl, itp, offset, step));
+                    VL_DO_DANGLING(bitp->deleteTree(), bitp);
                 }
                 if (debug() >= 9) initp->dumpTree(cout, "-new: ");
                 if (debug() >= 9) whilep->dumpTree(cout, "-new: ");
@@ -129,13 +225,30 @@ private:
             }
             // Setup for next merge
             m_mgAssignps.clear();
-            m_mgSelLp = nullptr;
-            m_mgSelRp = nullptr;
-            m_mgVarrefLp = nullptr;
-            m_mgVarrefRp = nullptr;
-            m_mgConstRp = nullptr;
+            m_mgShape.clear();
+            m_mgSteps.clear();
         }
     }
+    bool mergeContinues(AstNodeAssign* nodep) {
+        // Return true if nodep, with shape m_shape, continues the current merge
+        if (m_mgAssignps.empty() || m_mgCfuncp != m_cfuncp || m_mgNextp != nodep
+            || !sameShape(m_mgShape, m_shape)) {
+            return false;
+        }
+        const vlsint64_t num = m_mgAssignps.size();
+        bool anyStep = false;
+        for (size_t i = 0; i < m_shape.m_values.size(); ++i) {
+            const vlsint64_t delta = m_shape.m_values[i] - m_mgShape.m_values[i];
+            if (num == 1) {
+                m_mgSteps[i] = delta;
+            } else if (delta != m_mgSteps[i] * num) {
+                return false;
+            }
+            anyStep |= (m_mgSteps[i] != 0);
+        }
+        // Identical assignments would not be a loop over anything
+        return anyStep;
+    }
 
     // VISITORS
     virtual void visit(AstCFunc* nodep) override {
@@ -143,6 +256,7 @@ private:
         {
             m_cfuncp = nodep;
             iterateChildren(nodep);
+            mergeEnd();  // Finish last pending merge, if any
         }
     }
     virtual void visit(AstNodeAssign* nodep) override {
@@ -150,84 +264,35 @@ private:
 
         // Left select WordSel or ArraySel
         AstNodeSel* lselp = VN_CAST(nodep->lhsp(), NodeSel);
-        if (!lselp) {  // Not ever merged
-            mergeEnd();
-            return;
-        }
         // Of a constant index
-        AstConst* lbitp = VN_CAST(lselp->bitp(), Const);
-        if (!lbitp) {
-            mergeEnd();
-            return;
-        }
-        if (lbitp->width() > 32) {  // Assoc arrays can do this
-            mergeEnd();
-            return;
-        }
-        uint32_t index = lbitp->toUInt();
-        // Of variable
-        AstNodeVarRef* lvarrefp = VN_CAST(lselp->fromp(), NodeVarRef);
-        if (!lvarrefp) {
+        if (!lselp || !isIndex(lselp->bitp())) {  // Not ever merged
             mergeEnd();
             return;
         }
 
-        // RHS is a constant or a select
-        AstConst* rconstp = VN_CAST(nodep->rhsp(), Const);
-        AstNodeSel* rselp = VN_CAST(nodep->rhsp(), NodeSel);
-        AstNodeVarRef* rvarrefp = nullptr;
-        if (rconstp) {  // Ok
-        } else {
-            if (!rselp) {
-                mergeEnd();
-                return;
-            }
-            AstConst* rbitp = VN_CAST(rselp->bitp(), Const);
-            rvarrefp = VN_CAST(rselp->fromp(), NodeVarRef);
-            if (!rbitp || rbitp->toUInt() != index || !rvarrefp
-                || lvarrefp->varp() == rvarrefp->varp()) {
-                mergeEnd();
-                return;
-            }
-        }
+        m_shape.clear();
+        m_shape.m_nodeps.push_back(nodep);
+        shapeIterate(nodep->lhsp(), m_shape);
+        shapeIterate(nodep->rhsp(), m_shape);
 
-        if (m_mgSelLp) {  // Old merge
-            if (m_mgCfuncp == m_cfuncp && m_mgNextp == nodep && m_mgSelLp->same(lselp)
-                && m_mgVarrefLp->same(lvarrefp)
-                && (m_mgConstRp
-                        ? (rconstp && m_mgConstRp->same(rconstp))
-                        : (rselp && m_mgSelRp->same(rselp) && m_mgVarrefRp->same(rvarrefp)))
-                && (index == m_mgIndexLo - 1 || index == m_mgIndexHi + 1)) {
-                // Sequentially next to last assign; continue merge
-                if (index == m_mgIndexLo - 1) {
-                    m_mgIndexLo = index;
-                } else if (index == m_mgIndexHi + 1) {
-                    m_mgIndexHi = index;
-                }
-                UINFO(9, "Continue merge i=" << index << " " << m_mgIndexHi << ":" << m_mgIndexLo
-                                             << " " << nodep << endl);
-                m_mgAssignps.push_back(nodep);
-                m_mgNextp = nodep->nextp();
-                return;
-            } else {
-                // This assign doesn't merge with previous assign,
-                // but should start a new merge
-                mergeEnd();
-            }
+        if (mergeContinues(nodep)) {
+            // Sequentially next to last assign; continue merge
+            UINFO(9, "Continue merge n=" << m_mgAssignps.size() << " " << nodep << endl);
+            m_mgAssignps.push_back(nodep);
+            m_mgNextp = nodep->nextp();
+            return;
         }
+        // This assign doesn't merge with previous assign,
+        // but should start a new merge
+        mergeEnd();
 
         // Merge start
         m_mgAssignps.push_back(nodep);
         m_mgCfuncp = m_cfuncp;
         m_mgNextp = nodep->nextp();
-        m_mgSelLp = lselp;
-        m_mgSelRp = rselp;
-        m_mgVarrefLp = lvarrefp;
-        m_mgVarrefRp = rvarrefp;
-        m_mgConstRp = rconstp;
-        m_mgIndexLo = index;
-        m_mgIndexHi = index;
-        UINFO(9, "Start merge i=" << index << " " << nodep << endl);
+        std::swap(m_mgShape, m_shape);
+        m_mgSteps.assign(m_mgShape.m_values.size(), 0);
+        UINFO(9, "Start merge " << nodep << endl);
     }
     //--------------------
     virtual void visit(AstVar*) override {}  // Accelerate
@@ -236,11 +301,11 @@ private:
 
 public:
     // CONSTRUCTORS
-    explicit ReloopVisitor(AstNetlist* nodep) { iterate(nodep); }
-    virtual ~ReloopVisitor() override {
-        V3Stats::addStat("Optimizations, Reloops", m_statReloops);
-        V3Stats::addStat("Optimizations, Reloop iterations", m_statReItems);
-    }
+    explicit ReloopVisitor(AstNodeModule* nodep) { iterate(nodep); }
+    virtual ~ReloopVisitor() override = default;
+    // ACCESSORS
+    double statReloops() const { return m_statReloops; }
+    double statReItems() const { return m_statReItems; }
 };
 
 //######################################################################
@@ -248,6 +313,19 @@ public:
 
 void V3Reloop::reloopAll(AstNetlist* nodep) {
     UINFO(2, __FUNCTION__ << ": " << endl);
-    { ReloopVisitor visitor(nodep); }  // Destruct before checking
+    {
+        // Module-local; each module gets its own visitor, and their statistics are summed
+        std::mutex mutex;
+        double statReloops = 0;
+        double statReItems = 0;
+        V3ThreadPool::forEachModule(nodep, [&](AstNodeModule* modp) {
+            const ReloopVisitor visitor{modp};
+            const std::lock_guard<std::mutex> lock(mutex);
+            statReloops += visitor.statReloops();
+            statReItems += visitor.statReItems();
+        });
+        V3Stats::addStat("Optimizations, Reloops", statReloops);
+        V3Stats::addStat("Optimizations, Reloop iterations", statReItems);
+    }
     V3Global::dumpCheckGlobalTree("reloop", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 6);
 }
@@ -28,6 +28,7 @@
 #include "V3Graph.h"
 #include "V3TSP.h"
 
+#include <atomic>
 #include <cmath>
 #include <list>
 #include <memory>
@@ -42,7 +43,7 @@
 // Support classes
 
 namespace V3TSP {
-static unsigned edgeIdNext = 0;
+static std::atomic<unsigned> edgeIdNext{0};  // Atomic as V3EmitC may sort in parallel
 
 static void selfTestStates();
 static void selfTestString();
@@ -18,6 +18,9 @@
 //      Count # of input bits and # of output bits, and # of statements
 //      If high # of statements relative to inpbits*outbits,
 //      replace with lookup table
+//      Statements are weighted by each node's instrCount() cost
+//      If several narrow outputs fit in one word, pack them into one table
+//      Identical tables are shared, found by hashing their values
 //
 //*************************************************************************
 
@@ -29,20 +32,20 @@
 #include "V3Simulate.h"
 #include "V3Stats.h"
 #include "V3Ast.h"
+#include "V3Hashed.h"
 
 #include <cmath>
 #include <deque>
+#include <map>
 
 //######################################################################
 // Table class functions
 
 // CONFIG
-// 1MB is max table size (better be lots of instructs to be worth it!)
-static const double TABLE_MAX_BYTES = 1 * 1024 * 1024;
-// 64MB is close to max memory of some systems (256MB or so), so don't get out of control
-static const double TABLE_TOTAL_BYTES = 64 * 1024 * 1024;
+// Table size limits and minimum instruction count are set by --table-max-bytes,
+// --table-total-bytes and --table-min-instrs
 static const double TABLE_SPACE_TIME_MULT = 8;  // Worth 8 bytes of data to replace a instruction
-static const int TABLE_MIN_NODE_COUNT = 32;  // If < 32 instructions, not worth the effort
+static const int TABLE_MAX_INPUT_BITS = 30;  // Index must fit in an int, whatever the budget
 
 //######################################################################
 
@@ -73,11 +76,13 @@ private:
     // STATE
     double m_totalBytes = 0;  // Total bytes in tables created
     VDouble0 m_statTablesCre;  // Statistic tracking
+    VDouble0 m_statTablesPacked;  // Statistic tracking
+    VDouble0 m_statTablesShared;  // Statistic tracking
+    std::multimap<vluint32_t, AstVarScope*> m_tableVscs;  // All tables created, by value hash
 
     //  State cleared on each module
     AstNodeModule* m_modp = nullptr;  // Current MODULE
     int m_modTables = 0;  // Number of tables created in this module
-    std::deque<AstVarScope*> m_modTableVscs;  // All tables created
 
     //  State cleared on each scope
     AstScope* m_scopep = nullptr;  // Current SCOPE
@@ -86,6 +91,7 @@ private:
     bool m_assignDly = false;  // Consists of delayed assignments instead of normal assignments
     int m_inWidth = 0;  // Input table width
     int m_outWidth = 0;  // Output table width
+    int m_packedWidth = 0;  // Width of packed output table, 0 if one table per output
     std::deque<AstVarScope*> m_inVarps;  // Input variable list
     std::deque<AstVarScope*> m_outVarps;  // Output variable list
     std::deque<bool> m_outNotSet;  // True if output variable is not set at some point
@@ -96,6 +102,23 @@ private:
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
 
+    static int bytesForWidth(int width) {
+        return width <= 8 ? 1 : width <= 16 ? 2 : width <= VL_IDATASIZE ? 4 : 8;
+    }
+    int packedWidth() const {
+        // Return width of all outputs packed into one word, if that is smaller
+        // than a table for each output, else 0
+        if (m_outVarps.size() < 2) return 0;
+        int width = 0;
+        for (const AstVarScope* vscp : m_outVarps) {
+            const AstBasicDType* basicp = VN_CAST(vscp->varp()->dtypeSkipRefp(), BasicDType);
+            if (!basicp || basicp->isOpaque()) return 0;
+            width += vscp->width();
+        }
+        if (width > VL_QUADSIZE || bytesForWidth(width) >= m_outWidth) return 0;
+        return width;
+    }
+
     bool treeTest(AstAlways* nodep) {
         // Process alw/assign tree
         m_inWidth = 0;
@@ -113,25 +136,33 @@ private:
         // Also sets m_inVarps
         // Also sets m_outVarps
 
+        // Pack outputs into one table if that takes less space than one table each
+        m_packedWidth = packedWidth();
+        const int outBytes = m_packedWidth ? bytesForWidth(m_packedWidth) : m_outWidth;
+
         // Calc data storage in bytes
         size_t chgWidth = m_outVarps.size();  // Width of one change-it-vector
         if (chgWidth < 8) chgWidth = 8;
         double space = (std::pow(static_cast<double>(2.0), static_cast<double>(m_inWidth))
-                        * static_cast<double>(m_outWidth + chgWidth));
+                        * static_cast<double>(outBytes + chgWidth));
         // Instruction count bytes (ok, it's space also not time :)
+        // Summed over all branches, as decoders become deep branch trees
         double bytesPerInst = 4;
         double time = ((chkvis.instrCount() * bytesPerInst + chkvis.dataCount())
                        + 1);  // +1 so won't div by zero
-        if (chkvis.instrCount() < TABLE_MIN_NODE_COUNT) {
+        if (chkvis.instrCount() < v3Global.opt.tableMinInstrs()) {
             chkvis.clearOptimizable(nodep, "Table has too few nodes involved");
         }
-        if (space > TABLE_MAX_BYTES) {
+        if (m_inWidth > TABLE_MAX_INPUT_BITS) {
+            chkvis.clearOptimizable(nodep, "Table has too many input bits");
+        }
+        if (space > v3Global.opt.tableMaxBytes()) {
             chkvis.clearOptimizable(nodep, "Table takes too much space");
         }
         if (space > time * TABLE_SPACE_TIME_MULT) {
             chkvis.clearOptimizable(nodep, "Table has bad tradeoff");
         }
-        if (m_totalBytes > TABLE_TOTAL_BYTES) {
+        if (m_totalBytes + space > v3Global.opt.tableTotalBytes()) {
             chkvis.clearOptimizable(nodep, "Table out of memory");
         }
         if (!m_outWidth || !m_inWidth) {  //
@@ -140,7 +171,8 @@ private:
         UINFO(4, "  Test: Opt=" << (chkvis.optimizable() ? "OK" : "NO")
                                 << ", Instrs=" << chkvis.instrCount()
                                 << " Data=" << chkvis.dataCount() << " inw=" << m_inWidth
-                                << " outw=" << m_outWidth << " Spacetime=" << (space / time) << "("
+                                << " outw=" << m_outWidth << " packw=" << m_packedWidth
+                                << " Spacetime=" << (space / time) << "("
                                 << space << "/" << time << ")"
                                 << ": " << nodep << endl);
         if (chkvis.optimizable()) {
@@ -172,6 +204,7 @@ private:
         // We've determined this table of nodes is optimizable, do it.
         ++m_modTables;
         ++m_statTablesCre;
+        if (m_packedWidth) ++m_statTablesPacked;
 
         // Index into our table
         AstVar* indexVarp
@@ -220,6 +253,24 @@ private:
     }
 
     void createTableVars(AstNode* nodep) {
+        if (m_packedWidth) {
+            // Create one table holding all outputs, first output in the LSBs
+            FileLine* fl = nodep->fileline();
+            AstNodeArrayDType* dtypep = new AstUnpackArrayDType(
+                fl, nodep->findBitDType(m_packedWidth, m_packedWidth, VSigning::UNSIGNED),
+                new AstRange(fl, VL_MASK_I(m_inWidth), 0));
+            v3Global.rootp()->typeTablep()->addTypesp(dtypep);
+            const string name = "__Vtable" + cvtToStr(m_modTables) + "__packed";
+            AstVar* tablevarp = new AstVar(fl, AstVarType::MODULETEMP, name, dtypep);
+            tablevarp->isConst(true);
+            tablevarp->isStatic(true);
+            tablevarp->valuep(new AstInitArray(nodep->fileline(), dtypep, nullptr));
+            m_modp->addStmtp(tablevarp);
+            AstVarScope* tablevscp = new AstVarScope(tablevarp->fileline(), m_scopep, tablevarp);
+            m_scopep->addVarp(tablevscp);
+            m_tableVarps.push_back(tablevscp);
+            return;
+        }
         // Create table for each output
         std::map<const std::string, int> namecounts;
         for (const AstVarScope* outvscp : m_outVarps) {
@@ -308,7 +359,9 @@ private:
 
             // If a output changed, add it to table
             int outnum = 0;
+            int outlsb = 0;
             V3Number outputChgMask(nodep, m_outVarps.size(), 0);
+            V3Number packedNum(nodep, m_packedWidth ? m_packedWidth : 1, 0);
             for (AstVarScope* outvscp : m_outVarps) {
                 V3Number* outnump = simvis.fetchOutNumberNull(outvscp);
                 AstNode* setp;
@@ -325,10 +378,20 @@ private:
                     outputChgMask.setBit(outnum, 1);
                     setp = new AstConst(outnump->fileline(), *outnump);
                 }
-                // Note InitArray requires us to have the values in inValue order
-                VN_CAST(m_tableVarps[outnum]->varp()->valuep(), InitArray)->addValuep(setp);
+                if (m_packedWidth) {
+                    packedNum.opSelInto(VN_CAST(setp, Const)->num(), outlsb, outvscp->width());
+                    VL_DO_DANGLING(setp->deleteTree(), setp);
+                } else {
+                    // Note InitArray requires us to have the values in inValue order
+                    VN_CAST(m_tableVarps[outnum]->varp()->valuep(), InitArray)->addValuep(setp);
+                }
+                outlsb += outvscp->width();
                 outnum++;
             }
+            if (m_packedWidth) {
+                AstNode* setp = new AstConst(nodep->fileline(), packedNum);
+                VN_CAST(m_tableVarps[0]->varp()->valuep(), InitArray)->addValuep(setp);
+            }
 
             {  // Set changed table
                 UASSERT_OBJ(inValue == inValueNextInitArray, nodep,
@@ -340,11 +403,24 @@ private:
         }  // each value
     }
 
+    static V3Hash tableHash(const AstVar* varp) {
+        // Hash of the table's values.  Not V3Hashed::uncachedHash of the
+        // InitArray itself, as that includes the per-table array dtype.
+        V3Hash hash(varp->width());
+        const AstInitArray* initp = VN_CAST(varp->valuep(), InitArray);
+        for (const AstNode* itemp = initp->initsp(); itemp; itemp = itemp->nextp()) {
+            hash = V3Hash(hash, V3Hashed::uncachedHash(itemp));
+        }
+        return hash;
+    }
     AstVarScope* findDuplicateTable(AstVarScope* vsc1p) {
-        // See if another table we've created is identical, if so use it for both.
-        // (A more 'modern' way would be to instead use V3Hashed::findDuplicate)
+        // See if another table we've created, in any module, is identical,
+        // if so use it for both.
         AstVar* var1p = vsc1p->varp();
-        for (AstVarScope* vsc2p : m_modTableVscs) {
+        const vluint32_t hash = tableHash(var1p).fullValue();
+        const auto range = m_tableVscs.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            AstVarScope* vsc2p = it->second;
             AstVar* var2p = vsc2p->varp();
             if (var1p->width() == var2p->width()
                 && (var1p->dtypep()->arrayUnpackedElements()
@@ -354,11 +430,12 @@ private:
                 if (init1p->sameGateTree(init2p)) {
                     UINFO(8, "   Duplicate table var " << vsc2p << " == " << vsc1p << endl);
                     VL_DO_DANGLING(vsc1p->unlinkFrBack()->deleteTree(), vsc1p);
+                    ++m_statTablesShared;
                     return vsc2p;
                 }
             }
         }
-        m_modTableVscs.push_back(vsc1p);
+        m_tableVscs.emplace(hash, vsc1p);
         return vsc1p;
     }
 
@@ -370,12 +447,19 @@ private:
         // elimination will remove it for us.
         // Set each output from array ref into our table
         int outnum = 0;
+        int outlsb = 0;
         for (AstVarScope* outvscp : m_outVarps) {
             AstNode* alhsp = new AstVarRef(nodep->fileline(), outvscp, VAccess::WRITE);
             AstNode* arhsp = new AstArraySel(
                 nodep->fileline(),
-                new AstVarRef(nodep->fileline(), m_tableVarps[outnum], VAccess::READ),
+                new AstVarRef(nodep->fileline(), m_tableVarps[m_packedWidth ? 0 : outnum],
+                              VAccess::READ),
                 new AstVarRef(nodep->fileline(), indexVscp, VAccess::READ));
+            if (m_packedWidth) {
+                // Extract this output's field from the packed table word
+                arhsp = new AstSel(nodep->fileline(), arhsp, outlsb, outvscp->width());
+                outlsb += outvscp->width();
+            }
             AstNode* outasnp
                 = (m_assignDly
                        ? static_cast<AstNode*>(new AstAssignDly(nodep->fileline(), alhsp, arhsp))
@@ -407,11 +491,9 @@ private:
     virtual void visit(AstNodeModule* nodep) override {
         VL_RESTORER(m_modp);
         VL_RESTORER(m_modTables);
-        VL_RESTORER(m_modTableVscs);
         {
             m_modp = nodep;
             m_modTables = 0;
-            m_modTableVscs.clear();
             iterateChildren(nodep);
         }
     }
@@ -441,6 +523,8 @@ public:
     explicit TableVisitor(AstNetlist* nodep) { iterate(nodep); }
     virtual ~TableVisitor() override {  //
         V3Stats::addStat("Optimizations, Tables created", m_statTablesCre);
+        V3Stats::addStat("Optimizations, Tables packed", m_statTablesPacked);
+        V3Stats::addStat("Optimizations, Tables shared", m_statTablesShared);
     }
 };
 
@@ -706,7 +706,7 @@ private:
         int cwidth = VL_IDATASIZE;
         if (!useSetWSvlv && portp->basicp()) {
             if (portp->basicp()->keyword().isBitLogic()) {
-                cwidth = VL_EDATASIZE * portp->widthWords();
+                cwidth = v3Global.opt.wideWordSize() * portp->widthWords();
             } else {
                 cwidth = portp->basicp()->keyword().width();
             }
@@ -718,7 +718,7 @@ private:
                                              : dimStrides.front().first->elementsConst()
                                                    * dimStrides.front().second;
         AstNode* newp = nullptr;
-        const int widthWords = portp->basicp()->widthWords();
+        const int widthWords = portp->basicp()->widthWordsDpi();
         for (int i = 0; i < total; ++i) {
             AstNode* srcp = new AstVarRef(portvscp->fileline(), portvscp, VAccess::WRITE);
             // extract a scalar from multi-dimensional array (internal format)
@@ -1632,8 +1632,8 @@ string V3Task::assignInternalToDpi(AstVar* portp, bool isPtr, const string& frSu
         stmt += (isBit ? "VL_SET_SVBV_" : "VL_SET_SVLV_")
                 + string(portp->dtypep()->skipRefp()->charIQWN()) + "(" + cvtToStr(portp->width())
                 + ", ";
-        stmt += toName + " + " + cvtToStr(portp->dtypep()->skipRefp()->widthWords()) + " * " + idx
-                + ", ";
+        stmt += toName + " + " + cvtToStr(portp->dtypep()->skipRefp()->widthWordsDpi()) + " * "
+                + idx + ", ";
         if (unpackDim > 0) {  // Access multi-dimensional array as a 1D array
             stmt += "(&" + frName;
             for (int i = 0; i < unpackDim; ++i) stmt += "[0]";
@@ -1687,7 +1687,7 @@ string V3Task::assignDpiToInternal(const string& lhsName, AstVar* varp) {
     const int total = dimStrides.empty()
                           ? 1
                           : dimStrides.front().first->elementsConst() * dimStrides.front().second;
-    const int widthWords = varp->basicp()->widthWords();
+    const int widthWords = varp->basicp()->widthWordsDpi();
     string statements;
     for (int i = 0; i < total; ++i) {
         string lhs = lhsName;
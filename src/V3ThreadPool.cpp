@@ -0,0 +1,114 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Thread pool for parallel verilation
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Global.h"
+#include "V3Ast.h"
+#include "V3ThreadPool.h"
+
+#include <atomic>
+
+//######################################################################
+// V3ThreadPool
+
+thread_local bool V3ThreadPool::t_inParallel = false;
+
+V3ThreadPool::V3ThreadPool(unsigned jobs) {
+    for (unsigned i = 1; i < jobs; ++i) m_workers.emplace_back(&V3ThreadPool::workerLoop, this);
+}
+
+V3ThreadPool::~V3ThreadPool() {
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_shutdown = true;
+    }
+    m_wakeCv.notify_all();
+    for (auto& thread : m_workers) {
+        // An error exit from inside a job destructs us on a worker thread
+        if (thread.get_id() == std::this_thread::get_id()) {
+            thread.detach();
+        } else {
+            thread.join();
+        }
+    }
+}
+
+V3ThreadPool& V3ThreadPool::s() {
+    static V3ThreadPool s_pool(
+        v3Global.opt.verilateJobs() ? v3Global.opt.verilateJobs()
+                                    : std::max(1U, std::thread::hardware_concurrency()));
+    return s_pool;
+}
+
+void V3ThreadPool::runJob(const std::function<void()>& job) {
+    t_inParallel = true;
+    job();
+    t_inParallel = false;
+}
+
+void V3ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wakeCv.wait(lock, [this] { return m_shutdown || !m_queue.empty(); });
+            if (m_queue.empty()) return;  // Shutdown
+            job = std::move(m_queue.front());
+            m_queue.pop_front();
+            ++m_running;
+        }
+        runJob(job);
+        {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            --m_running;
+        }
+        m_doneCv.notify_all();
+    }
+}
+
+void V3ThreadPool::parallelFor(size_t n, const std::function<void(size_t)>& fn) {
+    if (m_workers.empty() || n < 2 || inParallel()) {
+        for (size_t i = 0; i < n; ++i) fn(i);
+        return;
+    }
+    // Each job claims the next index until all are taken, so long items
+    // don't leave the other threads idle
+    std::atomic<size_t> next{0};
+    const auto drain = [&]() {
+        for (size_t i = next++; i < n; i = next++) fn(i);
+    };
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        const size_t helpers = std::min(m_workers.size(), n - 1);
+        for (size_t i = 0; i < helpers; ++i) m_queue.emplace_back(drain);
+    }
+    m_wakeCv.notify_all();
+    runJob(drain);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_doneCv.wait(lock, [this] { return m_queue.empty() && !m_running; });
+}
+
+void V3ThreadPool::forEachModule(AstNetlist* nodep,
+                                 const std::function<void(AstNodeModule*)>& fn) {
+    std::vector<AstNodeModule*> modps;
+    for (AstNodeModule* modp = nodep->modulesp(); modp;
+         modp = VN_CAST(modp->nextp(), NodeModule)) {
+        modps.push_back(modp);
+    }
+    s().parallelFor(modps.size(), [&](size_t i) { fn(modps[i]); });
+}
@@ -0,0 +1,74 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Thread pool for parallel verilation
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#ifndef VERILATOR_V3THREADPOOL_H_
+#define VERILATOR_V3THREADPOOL_H_
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class AstNetlist;
+class AstNodeModule;
+
+//============================================================================
+// Pool of worker threads used by passes which can process independent
+// parts of the netlist concurrently.  Sized by --verilate-jobs; with the
+// default of one job everything runs in the calling thread.
+
+class V3ThreadPool final {
+    // MEMBERS
+    std::vector<std::thread> m_workers;  // Worker threads, caller is the extra job
+    std::mutex m_mutex;  // Protects below
+    std::condition_variable m_wakeCv;  // Signaled on new work or shutdown
+    std::condition_variable m_doneCv;  // Signaled when a job completes
+    std::deque<std::function<void()>> m_queue;  // Jobs not yet started
+    size_t m_running = 0;  // Jobs started but not completed
+    bool m_shutdown = false;  // Workers should exit
+    static thread_local bool t_inParallel;  // Thread is executing a parallel job
+
+    // CONSTRUCTORS
+    explicit V3ThreadPool(unsigned jobs);
+    ~V3ThreadPool();
+    VL_UNCOPYABLE(V3ThreadPool);
+
+    // METHODS
+    void workerLoop();
+    void runJob(const std::function<void()>& job);
+
+public:
+    // Singleton, created on first use from --verilate-jobs
+    static V3ThreadPool& s();
+    // Number of concurrent jobs, including the calling thread
+    unsigned jobs() const { return static_cast<unsigned>(m_workers.size()) + 1; }
+    // True when called from within a parallelFor job; nested requests run serially
+    static bool inParallel() { return t_inParallel; }
+    // Call fn(i) for each i in [0, n), returning when all calls completed.
+    // Calls may run concurrently and in any order.
+    void parallelFor(size_t n, const std::function<void(size_t)>& fn);
+    // Call fn on each module of the netlist.  For passes which are
+    // module-local: fn must only modify nodes under the module it is given,
+    // and may only read (or find/create data types in) the rest of the tree.
+    static void forEachModule(AstNetlist* nodep, const std::function<void(AstNodeModule*)>& fn);
+};
+
+#endif  // Guard
@@ -26,6 +26,8 @@
 //
 //  Pass 2:
 //      Add edges from CFunc -> VarRef being written
+//      With --trace-activity-fine, writes in a branch of an if instead
+//      get an edge from an activity vertex set in that branch
 //
 //  Finally:
 //      Process graph to determine when traced variables can change, allocate
@@ -45,9 +47,11 @@
 #include "V3Hashed.h"
 #include "V3Stats.h"
 
+#include <algorithm>
 #include <map>
 #include <limits>
 #include <set>
+#include <vector>
 
 //######################################################################
 // Graph vertexes
@@ -172,7 +176,9 @@ private:
     AstScope* m_topScopep = nullptr;  // Scope to add variables to
     AstCFunc* m_cfuncp = nullptr;  // C function adding to graph
     AstTraceDecl* m_tracep = nullptr;  // Trace function adding to graph
+    TraceActivityVertex* m_branchVtxp = nullptr;  // Activity of the branch adding to graph
     AstVarScope* m_activityVscp = nullptr;  // Activity variable
+    AstCFunc* m_initFuncp = nullptr;  // Trace init function
     uint32_t m_activityNumber = 0;  // Count of fields in activity variable
     uint32_t m_code = 0;  // Trace ident code# being assigned
     V3Graph m_graph;  // Var/CFunc tracking
@@ -182,12 +188,24 @@ private:
     VDouble0 m_statChgSigs;  // Statistic tracking
     VDouble0 m_statUniqSigs;  // Statistic tracking
     VDouble0 m_statUniqCodes;  // Statistic tracking
+    VDouble0 m_statActivityFlags;  // Statistic tracking
+    VDouble0 m_statActivityGroups;  // Statistic tracking
 
     // All activity numbers applying to a given trace
     using ActCodeSet = std::set<uint32_t>;
     // For activity set, what traces apply
     using TraceVec = std::multimap<ActCodeSet, TraceTraceVertex*>;
 
+    // Block of signals checked under one activity condition, for --trace-activity-stats
+    struct ActivityStatsBlock {
+        AstIf* m_ifp;  // Condition checking the activity flags
+        string m_group;  // Activity flags, for reporting
+        uint32_t m_signals;  // Number of signals checked
+        uint32_t m_beginCode;  // First code checked
+        uint32_t m_endCode;  // One past the last code checked
+    };
+    std::vector<ActivityStatsBlock> m_statsBlocks;
+
     // METHODS
     VL_DEBUG_FUNC;  // Declare debug()
 
@@ -382,6 +400,12 @@ private:
         // For each activity set with only a small number of signals, make those
         // signals always traced, as it's cheaper to check a few value changes
         // than to test a lot of activity flags
+        struct Group {
+            uint32_t m_complexity;
+            TraceVec::iterator m_begin;
+            TraceVec::iterator m_end;
+        };
+        std::vector<Group> groups;  // Remaining groups that may be made always traced
         auto it = traces.begin();
         const auto end = traces.end();
         while (it != end) {
@@ -403,17 +427,33 @@ private:
                     complexity += cost;
                 }
             }
-            // Leave alone always changing, never changing and signals only set in slow code
+            // Leave alone always changing and never changing signals
             if (actSet.count(TraceActivityVertex::ACTIVITY_ALWAYS)) continue;
             if (actSet.count(TraceActivityVertex::ACTIVITY_NEVER)) continue;
-            if (actSet.count(TraceActivityVertex::ACTIVITY_SLOW)) continue;
             // If the value comparisons are cheaper to perform than checking the
-            // activity flags make the signals always traced. Note this cost
-            // equation is heuristic.
-            if (complexity <= actSet.size() * 2) {
+            // activity flags make the signals always traced, unless only set in
+            // slow code. Note this cost equation is heuristic.
+            if (!actSet.count(TraceActivityVertex::ACTIVITY_SLOW)
+                && complexity <= actSet.size() * 2) {
                 for (; head != it; ++head) {
                     new V3GraphEdge(&m_graph, m_alwaysVtxp, head->second, 1);
                 }
+            } else {
+                groups.push_back({complexity, head, it});
+            }
+        }
+
+        // With --trace-max-groups, also make the cheapest groups always
+        // traced, until no more than the maximum remain
+        const size_t maxGroups = v3Global.opt.traceMaxGroups();
+        if (maxGroups && groups.size() > maxGroups) {
+            std::stable_sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) {
+                return a.m_complexity < b.m_complexity;
+            });
+            for (auto git = groups.begin(); git != groups.end() - maxGroups; ++git) {
+                for (auto head = git->m_begin; head != git->m_end; ++head) {
+                    new V3GraphEdge(&m_graph, m_alwaysVtxp, head->second, 1);
+                }
             }
         }
 
@@ -432,6 +472,9 @@ private:
             callp->addNextHere(setterp);
         } else if (AstCFunc* const funcp = VN_CAST(insertp, CFunc)) {
             funcp->addStmtsp(setterp);
+        } else if (VN_IS(insertp, NodeStmt)) {
+            // First statement of a branch, see visit(AstNodeIf)
+            insertp->addHereThisAsNext(setterp);
         } else {
             insertp->v3fatalSrc("Bad trace activity vertex");
         }
@@ -440,6 +483,7 @@ private:
     void createActivityFlags() {
         // Assign final activity numbers
         m_activityNumber = assignactivityNumbers();
+        m_statActivityFlags += m_activityNumber;
 
         // Create an array of bytes, not a bit vector, as they can be set
         // atomically by mtasks, and are cheaper to set (no need for
@@ -600,6 +644,7 @@ private:
                                                                 : std::numeric_limits<int>::max();
         int topFuncNum = 0;
         int subFuncNum = 0;
+        const ActCodeSet* prevGroupSet = nullptr;
         TraceVec::const_iterator it = traces.begin();
         while (it != traces.end()) {
             AstCFunc* topFuncp = nullptr;
@@ -650,6 +695,17 @@ private:
                     subFuncp->addStmtsp(ifp);
                     subStmts += EmitCBaseCounterVisitor(ifp).count();
                     prevActSet = &actSet;
+                    if (v3Global.opt.traceActivityStats()) {
+                        m_statsBlocks.push_back({ifp, activityGroupName(actSet), 0, 0, 0});
+                    }
+                }
+                // Count the groups checked under activity flags, as limited
+                // by --trace-max-groups
+                if (!prevGroupSet || actSet != *prevGroupSet) {
+                    if (!actSet.count(TraceActivityVertex::ACTIVITY_ALWAYS)) {
+                        ++m_statActivityGroups;
+                    }
+                    prevGroupSet = &actSet;
                 }
 
                 // Add TraceInc node
@@ -657,6 +713,14 @@ private:
                 AstTraceInc* const incp = new AstTraceInc(declp->fileline(), declp, VAccess::READ);
                 ifp->addIfsp(incp);
                 subStmts += EmitCBaseCounterVisitor(incp).count();
+                if (v3Global.opt.traceActivityStats()) {
+                    ActivityStatsBlock& block = m_statsBlocks.back();
+                    if (!block.m_signals) block.m_beginCode = declp->code();
+                    block.m_signals += declp->arrayRange().ranged()
+                                           ? declp->arrayRange().elements()
+                                           : 1;
+                    block.m_endCode = declp->code() + declp->codeInc();
+                }
 
                 // Track partitioning
                 nCodes += declp->codeInc();
@@ -668,6 +732,66 @@ private:
         }
     }
 
+    static string activityGroupName(const ActCodeSet& actSet) {
+        if (actSet.count(TraceActivityVertex::ACTIVITY_ALWAYS)) return "always";
+        if (actSet.count(TraceActivityVertex::ACTIVITY_SLOW)) return "slow";
+        string name;
+        for (const uint32_t actCode : actSet) {
+            if (!name.empty()) name += "|";
+            name += cvtToStr(actCode);
+        }
+        return name;
+    }
+
+    void createActivityStats() {
+        if (m_statsBlocks.empty()) return;
+        FileLine* const flp = m_topScopep->fileline();
+
+        // Count of times each block was checked
+        AstNodeDType* const newScalarDtp = new AstBasicDType(flp, VFlagLogicPacked(), 64);
+        v3Global.rootp()->typeTablep()->addTypesp(newScalarDtp);
+        AstRange* const newArange
+            = new AstRange{flp, VNumRange{static_cast<int>(m_statsBlocks.size()) - 1, 0}};
+        AstNodeDType* const newArrDtp = new AstUnpackArrayDType(flp, newScalarDtp, newArange);
+        v3Global.rootp()->typeTablep()->addTypesp(newArrDtp);
+        AstVar* const newvarp
+            = new AstVar(flp, AstVarType::MODULETEMP, "__Vm_traceActivityChecks", newArrDtp);
+        m_topModp->addStmtp(newvarp);
+        AstVarScope* const newvscp = new AstVarScope(flp, m_topScopep, newvarp);
+        m_topScopep->addVarp(newvscp);
+
+        // Register the blocks with the trace file when it is opened, as
+        // that assigns the base code
+        UASSERT_OBJ(m_initFuncp, m_topScopep, "No trace init function");
+        AstCFunc* const funcp = new AstCFunc(flp, "traceInitActivityStats", m_topScopep);
+        funcp->argTypes("void* userp, " + v3Global.opt.traceClassBase() + "* tracep");
+        funcp->funcType(AstCFuncType::TRACE_INIT_SUB);
+        funcp->symProlog(true);
+        funcp->slow(true);
+        funcp->declPrivate(true);
+        m_topScopep->addActivep(funcp);
+        AstCCall* const callp = new AstCCall(flp, funcp);
+        callp->argTypes("userp, tracep");
+        m_initFuncp->addStmtsp(callp);
+
+        for (uint32_t i = 0; i < m_statsBlocks.size(); ++i) {
+            const ActivityStatsBlock& block = m_statsBlocks[i];
+            block.m_ifp->addIfsp(new AstAssign(
+                flp, new AstArraySel(flp, new AstVarRef(flp, newvscp, VAccess::WRITE), i),
+                new AstAdd(flp, new AstArraySel(flp, new AstVarRef(flp, newvscp, VAccess::READ), i),
+                           new AstConst(flp, AstConst::WidthedValue(), 64, 1))));
+            AstCStmt* const stmtp
+                = new AstCStmt(flp, "tracep->addActivityStats(\"" + block.m_group + "\", &");
+            stmtp->addBodysp(new AstArraySel(flp, new AstVarRef(flp, newvscp, VAccess::READ), i));
+            stmtp->addBodysp(new AstText(flp,
+                                         ", " + cvtToStr(block.m_signals) + ", c + "
+                                             + cvtToStr(block.m_beginCode) + ", c + "
+                                             + cvtToStr(block.m_endCode) + ");\n",
+                                         true));
+            funcp->addStmtsp(stmtp);
+        }
+    }
+
     void createCleanupFunction(AstCFunc* regFuncp) {
         FileLine* const fl = m_topScopep->fileline();
         AstCFunc* const cleanupFuncp = new AstCFunc(fl, "traceCleanup", m_topScopep);
@@ -734,7 +858,14 @@ private:
         regFuncp->declPrivate(true);
         m_topScopep->addActivep(regFuncp);
 
-        const int parallelism = 1;  // Note: will bump this later, code below works for any value
+        // With --trace-threads and --threads, the change functions are run in
+        // parallel on the model's thread pool, one function per thread.
+        const bool parallel = v3Global.opt.trueTraceThreads() && v3Global.opt.threads() > 1;
+        const int parallelism = parallel ? v3Global.opt.threads() : 1;
+        if (parallel) {
+            regFuncp->addStmtsp(new AstCStmt(m_topScopep->fileline(),
+                                             "tracep->threadPool(__Vm_threadPoolp);\n"));
+        }
 
         // Create the full dump functions, also allocates signal numbers
         createFullTraceFunction(traces, nFullCodes, parallelism, regFuncp);
@@ -752,6 +883,9 @@ private:
 
         // Create the trace cleanup function clearing the activity flags
         createCleanupFunction(regFuncp);
+
+        // Count the signals checked, with --trace-activity-stats
+        createActivityStats();
     }
 
     TraceCFuncVertex* getCFuncVertexp(AstCFunc* nodep) {
@@ -822,6 +956,7 @@ private:
     virtual void visit(AstCFunc* nodep) override {
         UINFO(8, "   CFUNC " << nodep << endl);
         V3GraphVertex* const funcVtxp = getCFuncVertexp(nodep);
+        if (nodep->funcType() == AstCFuncType::TRACE_INIT) m_initFuncp = nodep;
         if (!m_finding) {  // If public, we need a unique activity code to allow for sets
                            // directly in this func
             if (nodep->funcPublic() || nodep->dpiExport() || nodep == v3Global.rootp()->evalp()) {
@@ -830,8 +965,10 @@ private:
             }
         }
         VL_RESTORER(m_cfuncp);
+        VL_RESTORER(m_branchVtxp);
         {
             m_cfuncp = nodep;
+            m_branchVtxp = nullptr;
             iterateChildren(nodep);
         }
     }
@@ -864,13 +1001,37 @@ private:
             }
         } else if (m_cfuncp && m_finding && nodep->access().isWriteOrRW()) {
             UASSERT_OBJ(nodep->varScopep(), nodep, "No var scope?");
-            V3GraphVertex* const funcVtxp = getCFuncVertexp(m_cfuncp);
+            V3GraphVertex* const funcVtxp
+                = m_branchVtxp ? static_cast<V3GraphVertex*>(m_branchVtxp)
+                               : getCFuncVertexp(m_cfuncp);
             V3GraphVertex* const varVtxp = nodep->varScopep()->user1u().toGraphVertex();
             if (varVtxp) {  // else we're not tracing this signal
                 new V3GraphEdge(&m_graph, funcVtxp, varVtxp, 1);
             }
         }
     }
+    TraceActivityVertex* getBranchVertexp(AstNode* stmtsp, TraceActivityVertex* outerVtxp) {
+        // The flag is set before the first statement of the branch, or after
+        // it if a call, sharing the call's flag
+        if (!VN_IS(stmtsp, NodeStmt)) return outerVtxp;
+        return getActivityVertexp(stmtsp, false);
+    }
+    virtual void visit(AstNodeIf* nodep) override {
+        if (!m_finding || !m_cfuncp || m_cfuncp->slow() || !v3Global.opt.traceActivityFine()) {
+            iterateChildren(nodep);
+            return;
+        }
+        // With --trace-activity-fine, a variable written in a branch is
+        // active when the branch is taken, rather than whenever the function
+        // is called
+        iterateAndNextNull(nodep->condp());
+        VL_RESTORER(m_branchVtxp);
+        TraceActivityVertex* const outerVtxp = m_branchVtxp;
+        m_branchVtxp = getBranchVertexp(nodep->ifsp(), outerVtxp);
+        iterateAndNextNull(nodep->ifsp());
+        m_branchVtxp = getBranchVertexp(nodep->elsesp(), outerVtxp);
+        iterateAndNextNull(nodep->elsesp());
+    }
     //--------------------
     virtual void visit(AstNode* nodep) override { iterateChildren(nodep); }
 
@@ -884,6 +1045,8 @@ public:
         V3Stats::addStat("Tracing, Unique changing signals", m_statChgSigs);
         V3Stats::addStat("Tracing, Unique traced signals", m_statUniqSigs);
         V3Stats::addStat("Tracing, Unique trace codes", m_statUniqCodes);
+        V3Stats::addStat("Tracing, Activity flags", m_statActivityFlags);
+        V3Stats::addStat("Tracing, Activity groups", m_statActivityGroups);
     }
 };
 
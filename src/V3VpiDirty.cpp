@@ -0,0 +1,135 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+// DESCRIPTION: Verilator: Dirty flags for VPI observed signals
+//
+// Code available from: https://verilator.org
+//
+//*************************************************************************
+//
+// Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+// can redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+// V3VpiDirty's Transformations:
+//
+// For each public_flat_rw variable (that the model itself writes):
+//      Add __Vvpidirty__{var} byte to the variable's module and scope
+//      After each statement writing the variable, set the byte
+//      V3EmitCSyms then registers the byte with the variable, so
+//      VPI value change callbacks need only compare written variables.
+//
+//*************************************************************************
+
+#include "config_build.h"
+#include "verilatedos.h"
+
+#include "V3Global.h"
+#include "V3VpiDirty.h"
+#include "V3Ast.h"
+#include "V3Stats.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+//######################################################################
+
+class VpiDirtyVisitor final : public AstNVisitor {
+private:
+    // NODE STATE
+    //  AstVar::user1p()        -> AstVar*. Dirty flag variable in module
+    //  AstVarScope::user2p()   -> AstVarScope*. Dirty flag variable in scope
+    AstUser1InUse m_inuser1;
+    AstUser2InUse m_inuser2;
+
+    // TYPES
+    using Write = std::pair<AstNodeStmt*, AstVarScope*>;  // Statement, and variable it writes
+
+    // STATE
+    AstNodeStmt* m_stmtp = nullptr;  // Current statement
+    std::vector<AstVarScope*> m_vscps;  // Observed variables, in tree order
+    std::vector<Write> m_writes;  // Statements writing observed variables, in tree order
+    std::set<Write> m_writeSet;  // Members of m_writes
+    VDouble0 m_statVars;  // Statistic tracking
+    VDouble0 m_statSetters;  // Statistic tracking
+
+    // METHODS
+    VL_DEBUG_FUNC;  // Declare debug()
+
+    static bool isObserved(const AstVar* varp) {
+        // Primary inputs are written by the user's C++, so can't be flagged here
+        return varp->isSigUserRWPublic() && !varp->isParam() && !varp->isPrimaryIO();
+    }
+    void createDirtyVars() {
+        for (AstVarScope* const vscp : m_vscps) {
+            AstVar* const varp = vscp->varp();
+            FileLine* const fl = vscp->fileline();
+            AstVar* dirtyVarp = VN_CAST(varp->user1p(), Var);
+            if (!dirtyVarp) {
+                dirtyVarp = new AstVar(fl, AstVarType::MODULETEMP, varp->vpiDirtyName(),
+                                       varp->findBitDType());
+                dirtyVarp->sigPublic(true);  // Only read through the VPI, so keep it
+                vscp->scopep()->modp()->addStmtp(dirtyVarp);
+                varp->user1p(dirtyVarp);
+                varp->vpiDirty(true);
+                ++m_statVars;
+            }
+            AstVarScope* const dirtyVscp = new AstVarScope(fl, vscp->scopep(), dirtyVarp);
+            vscp->scopep()->addVarp(dirtyVscp);
+            vscp->user2p(dirtyVscp);
+        }
+    }
+    void addSetters() {
+        for (const Write& write : m_writes) {
+            AstVarScope* const dirtyVscp = VN_CAST(write.second->user2p(), VarScope);
+            UASSERT_OBJ(dirtyVscp, write.second, "Written VPI observed variable not in a scope");
+            FileLine* const fl = write.first->fileline();
+            AstAssign* const setterp
+                = new AstAssign(fl, new AstVarRef(fl, dirtyVscp, VAccess::WRITE),
+                                new AstConst(fl, AstConst::BitTrue()));
+            write.first->addNextHere(setterp);
+            ++m_statSetters;
+        }
+    }
+
+    // VISITORS
+    virtual void visit(AstVarScope* nodep) override {
+        if (isObserved(nodep->varp())) m_vscps.push_back(nodep);
+    }
+    virtual void visit(AstNodeStmt* nodep) override {
+        VL_RESTORER(m_stmtp);
+        m_stmtp = nodep;
+        iterateChildren(nodep);
+    }
+    virtual void visit(AstVarRef* nodep) override {
+        if (!nodep->access().isWriteOrRW() || !isObserved(nodep->varp())) return;
+        UASSERT_OBJ(m_stmtp, nodep, "VPI observed variable written outside a statement");
+        const Write write{m_stmtp, nodep->varScopep()};
+        if (m_writeSet.insert(write).second) m_writes.push_back(write);
+    }
+    virtual void visit(AstNode* nodep) override { iterateChildren(nodep); }
+
+public:
+    // CONSTRUCTORS
+    explicit VpiDirtyVisitor(AstNetlist* nodep) {
+        iterate(nodep);
+        createDirtyVars();
+        addSetters();
+    }
+    virtual ~VpiDirtyVisitor() override {
+        V3Stats::addStat("VPI dirty, variables", m_statVars);
+        V3Stats::addStat("VPI dirty, setters", m_statSetters);
+    }
+};
+
+//######################################################################
+// VpiDirty class functions
+
+void V3VpiDirty::vpiDirtyAll(AstNetlist* nodep) {
+    UINFO(2, __FUNCTION__ << ": " << endl);
+    { VpiDirtyVisitor visitor(nodep); }  // Destruct before checking
+    V3Global::dumpCheckGlobalTree("vpidirty", 0, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
+}
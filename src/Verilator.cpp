@@ -24,6 +24,7 @@
 #include "V3Begin.h"
 #include "V3Branch.h"
 #include "V3Broken.h"
+#include "V3Cache.h"
 #include "V3CCtors.h"
 #include "V3CUse.h"
 #include "V3Case.h"
@@ -96,6 +97,7 @@
 #include "V3Undriven.h"
 #include "V3Unknown.h"
 #include "V3Unroll.h"
+#include "V3VpiDirty.h"
 #include "V3Waiver.h"
 #include "V3Width.h"
 
@@ -402,6 +404,11 @@ static void process() {
         // "effectively" activate the same way.)
         if (v3Global.opt.trace()) V3Trace::traceAll(v3Global.rootp());
 
+        // Flag writes of public_flat_rw variables for VPI value change callbacks
+        if (v3Global.opt.vpi() && v3Global.opt.vpiDirty()) {
+            V3VpiDirty::vpiDirtyAll(v3Global.rootp());
+        }
+
         if (v3Global.opt.stats()) V3Stats::statsStageAll(v3Global.rootp(), "Scoped");
 
         // Remove scopes; make varrefs/funccalls relative to current module
@@ -513,6 +520,7 @@ static void process() {
     if (!v3Global.opt.xmlOnly()
         && !v3Global.opt.dpiHdrOnly()) {  // Unfortunately we have some lint checks in emitc.
         V3EmitC::emitc();
+        if (v3Global.opt.batchLanes() && !v3Global.opt.lintOnly()) V3EmitC::emitcBatch();
     }
     if (v3Global.opt.xmlOnly()
         // Check XML when debugging to make sure no missing node types
@@ -581,10 +589,12 @@ static void verilate(const string& argString) {
     // Read first filename
     v3Global.readFiles();
 
-    // Link, etc, if needed
-    if (!v3Global.opt.preprocOnly()) {  //
-        process();
-    }
+    // An unchanged hierarchical block keeps its previous output
+    if (!v3Global.opt.preprocOnly() && V3HierChildFingerprint::unchanged()) return;
+
+    // Link, etc, if needed, unless a previous run's output is in --cache-dir
+    const bool cacheHit = !v3Global.opt.preprocOnly() && V3Cache::restore(argString);
+    if (!v3Global.opt.preprocOnly() && !cacheHit) process();
 
     // Final steps
     V3Global::dumpCheckGlobalTree("final", 990, v3Global.opt.dumpTreeLevel(__FILE__) >= 3);
@@ -616,7 +626,8 @@ static void verilate(const string& argString) {
         filename += v3Global.opt.hierTop() ? "__hierVer.d" : "__ver.d";
         V3File::writeDepend(filename);
     }
-    if (v3Global.opt.protectIds()) {
+    if (v3Global.opt.protectIds() && !cacheHit) {
+        // On a --cache-dir hit the map was restored, as nothing was protected this run
         VIdProtect::writeMapFile(v3Global.opt.hierTopDataDir() + "/" + v3Global.opt.prefix()
                                  + "__idmap.xml");
     }
@@ -626,6 +637,8 @@ static void verilate(const string& argString) {
                                + "__verFiles.dat",
                            argString);
     }
+    V3Cache::store();
+    V3HierChildFingerprint::write();
 
     // Final writing shouldn't throw warnings, but...
     V3Error::abortIfWarnings();
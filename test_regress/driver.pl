@@ -887,9 +887,11 @@ sub compile_vlt_flags {
                           @{$param{verilator_flags3}});
     $self->{sc} = 1 if ($checkflags =~ /-sc\b/);
     $self->{trace} = ($opt_trace || $checkflags =~ /-trace\b/
-                      || $checkflags =~ /-trace-fst\b/);
+                      || $checkflags =~ /-trace-fst\b/
+                      || $checkflags =~ /-trace-vtb\b/);
     $self->{trace_format} = (($checkflags =~ /-trace-fst/ && $self->{sc} && 'fst-sc')
                              || ($checkflags =~ /-trace-fst/ && !$self->{sc} && 'fst-c')
+                             || ($checkflags =~ /-trace-vtb/ && 'vtb-c')
                              || ($self->{sc} && 'vcd-sc')
                              || (!$self->{sc} && 'vcd-c'));
     $self->{savable} = 1 if ($checkflags =~ /-savable\b/);
@@ -1502,6 +1504,7 @@ sub cmake_version {
 sub trace_filename {
     my $self = shift;
     return "$self->{obj_dir}/simx.fst" if $self->{trace_format} =~ /^fst/;
+    return "$self->{obj_dir}/simx.vtb" if $self->{trace_format} =~ /^vtb/;
     return "$self->{obj_dir}/simx.vcd";
 }
 
@@ -1751,6 +1754,7 @@ sub _make_main {
     print $fh "#include \"verilated_fst_sc.h\"\n" if $self->{trace} && $self->{trace_format} eq 'fst-sc';
     print $fh "#include \"verilated_vcd_c.h\"\n" if $self->{trace} && $self->{trace_format} eq 'vcd-c';
     print $fh "#include \"verilated_vcd_sc.h\"\n" if $self->{trace} && $self->{trace_format} eq 'vcd-sc';
+    print $fh "#include \"verilated_vtb_c.h\"\n" if $self->{trace} && $self->{trace_format} eq 'vtb-c';
     print $fh "#include \"verilated_save.h\"\n" if $self->{savable};
 
     print $fh "std::unique_ptr<$VM_PREFIX> topp;\n";
@@ -1813,6 +1817,7 @@ sub _make_main {
         $fh->print("    std::unique_ptr<VerilatedFstSc> tfp{new VerilatedFstSc};\n") if $self->{trace_format} eq 'fst-sc';
         $fh->print("    std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC};\n") if $self->{trace_format} eq 'vcd-c';
         $fh->print("    std::unique_ptr<VerilatedVcdSc> tfp{new VerilatedVcdSc};\n") if $self->{trace_format} eq 'vcd-sc';
+        $fh->print("    std::unique_ptr<VerilatedVtbC> tfp{new VerilatedVtbC};\n") if $self->{trace_format} eq 'vtb-c';
         $fh->print("    topp->trace(tfp.get(), 99);\n");
         $fh->print("    tfp->open(\"".$self->trace_filename."\");\n");
         if ($self->{trace} && !$self->sc) {
@@ -0,0 +1,70 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Compare --batch-lanes lanes against separate models
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+
+#include <cstdio>
+#include <memory>
+
+#include VM_PREFIX_INCLUDE
+#include "Vt_batch_lanes__Batch.h"
+
+constexpr int LANES = Vt_batch_lanes__Batch::LANES;
+constexpr int DISABLED_LANE = 3;
+
+int errors = 0;
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<Vt_batch_lanes__Batch> batchp{new Vt_batch_lanes__Batch};
+    std::unique_ptr<VerilatedContext> contextps[LANES];
+    std::unique_ptr<VM_PREFIX> modelps[LANES];
+    for (int lane = 0; lane < LANES; ++lane) {
+        contextps[lane].reset(new VerilatedContext);
+        modelps[lane].reset(new VM_PREFIX{contextps[lane].get()});
+        batchp->seed[lane] = modelps[lane]->seed = 0x1234567U * (lane + 1);
+        batchp->limit[lane] = modelps[lane]->limit = 50 + 13 * lane;
+    }
+
+    int cyc = 0;
+    for (; cyc < 1000 && !batchp->gotFinish(); ++cyc) {
+        // Mask one lane for a while; its model is not evaluated either
+        const bool enabled = cyc < 20 || cyc >= 40;
+        batchp->laneEnable(DISABLED_LANE, enabled);
+        for (int lane = 0; lane < LANES; ++lane) {
+            batchp->clk[lane] = modelps[lane]->clk = cyc & 1;
+        }
+        batchp->eval();
+        for (int lane = 0; lane < LANES; ++lane) {
+            if ((lane != DISABLED_LANE || enabled) && !contextps[lane]->gotFinish()) {
+                modelps[lane]->eval();
+            }
+            if (batchp->count[lane] != modelps[lane]->count
+                || batchp->sum[lane] != modelps[lane]->sum
+                || batchp->done[lane] != modelps[lane]->done
+                || batchp->laneFinished(lane) != contextps[lane]->gotFinish()) {
+                if (++errors < 10) {
+                    VL_PRINTF("%%Error: cyc %d lane %d: count %d/%d sum %" VL_PRI64
+                              "x/%" VL_PRI64 "x finished %d/%d\n",
+                              cyc, lane, batchp->count[lane], modelps[lane]->count,
+                              batchp->sum[lane], modelps[lane]->sum,
+                              batchp->laneFinished(lane), contextps[lane]->gotFinish());
+                }
+            }
+        }
+    }
+    if (!batchp->gotFinish()) {
+        VL_PRINTF("%%Error: lanes did not finish\n");
+        ++errors;
+    }
+    batchp->final();
+    for (int lane = 0; lane < LANES; ++lane) modelps[lane]->final();
+
+    if (errors) return 10;
+    VL_PRINTF("*-* All Finished *-*\n");
+    return 0;
+}
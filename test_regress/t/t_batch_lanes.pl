@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+compile(
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/$Self->{name}.cpp --batch-lanes 8"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Logic is emitted as loops over the lanes, not per-lane model calls
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Batch.h", qr/static constexpr int LANES = 8;/);
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Batch.cpp",
+          qr/for \(int __Vl = 0; __Vl < LANES; \+\+__Vl\)/);
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Batch.cpp", qr/_sequent__TOP__\d+\(__Vm\d+\);/);
+
+ok(1);
+1;
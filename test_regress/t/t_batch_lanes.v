@@ -0,0 +1,49 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   count, sum, done,
+   // Inputs
+   clk, seed, limit
+   );
+   input clk;
+   input [31:0] seed;
+   input [15:0] limit;
+   output reg [15:0] count;
+   output reg [63:0] sum;
+   output wire       done;
+
+   reg [31:0]  lfsr;
+
+   initial begin
+      count = 0;
+      sum = 0;
+      lfsr = 0;
+   end
+
+   assign done = (count >= limit);
+
+   always @ (posedge clk) begin
+      // Lanes take different branches depending on their seed
+      if (count == 0) begin
+         lfsr <= seed | 32'h1;
+      end
+      else if (lfsr[0]) begin
+         lfsr <= {1'b0, lfsr[31:1]} ^ 32'h80200003;
+         sum <= sum + {32'h0, lfsr};
+      end
+      else begin
+         lfsr <= {1'b0, lfsr[31:1]};
+         sum <= sum ^ {lfsr, 32'h0};
+      end
+      sum[3:0] <= lfsr[7:4];
+      if (!done) count <= count + 16'd1;
+      // Lanes finish at different cycles
+      if (count == limit) $finish;
+   end
+
+endmodule
@@ -0,0 +1,25 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+compile(
+    verilator_flags2 => ["--batch-lanes 4"],
+    fails => 1,
+    );
+
+my $log = "$Self->{obj_dir}/vlt_compile.log";
+file_grep($log, qr/%Error-UNSUPPORTED: .*Unsupported: --batch-lanes with DPI import call/);
+file_grep($log, qr/%Error-UNSUPPORTED: .*Unsupported: --batch-lanes with loops/);
+file_grep($log, qr/%Error-UNSUPPORTED: .*Unsupported: --batch-lanes with DISPLAY/);
+file_grep($log, qr/%Error-UNSUPPORTED: .*Unsupported: --batch-lanes with wide.*'wide'/);
+
+ok(1);
+1;
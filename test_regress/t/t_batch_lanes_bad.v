@@ -0,0 +1,36 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   out, bits, wide,
+   // Inputs
+   clk, in
+   );
+   input clk;
+   input [31:0] in;
+   output reg [31:0] out;
+   output reg [31:0] bits;
+   output reg [127:0] wide;
+
+   import "DPI-C" function int dpii_add_one(input int a);
+
+   integer n;
+
+   always @ (posedge clk) begin
+      out <= dpii_add_one(in);
+      wide <= {4{in}};
+      // Loop count depends on the lane's data
+      n = in;
+      bits = 0;
+      while (n != 0) begin
+         n = n >> 1;
+         bits = bits + 1;
+      end
+      $display("out=%0d", out);
+   end
+
+endmodule
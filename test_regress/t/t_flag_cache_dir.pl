@@ -0,0 +1,63 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_inst_tree.v");
+
+my $cache_dir = "$Self->{obj_dir}/cache";
+my $out_dir = "$Self->{obj_dir}/out";
+my @cmd = ("../bin/verilator", "--cc", "--Mdir $out_dir", "--cache-dir $cache_dir",
+           "--debugi-V3Cache 1", $Self->{top_filename});
+
+run(cmd => \@cmd,
+    logfile => "$Self->{obj_dir}/vlt1.log",
+    verilator_run => 1,
+    );
+file_grep("$Self->{obj_dir}/vlt1.log", qr/--cache-dir: Miss/);
+file_grep("$Self->{obj_dir}/vlt1.log", qr/--cache-dir: Saved/);
+
+# Remove an output file; the second run must restore it without Verilating
+my ($file) = glob("$out_dir/*.cpp");
+$file or error("No output files");
+rename($file, "$file.orig");
+
+run(cmd => \@cmd,
+    logfile => "$Self->{obj_dir}/vlt2.log",
+    verilator_run => 1,
+    );
+file_grep("$Self->{obj_dir}/vlt2.log", qr/--cache-dir: Hit/);
+files_identical($file, "$file.orig");
+
+# With --protect-ids, a hit must restore the identifier map, not empty it
+my $pcache_dir = "$Self->{obj_dir}/pcache";
+my $pout_dir = "$Self->{obj_dir}/pout";
+my $idmap = "$pout_dir/V$Self->{name}__idmap.xml";
+my @pcmd = ("../bin/verilator", "--cc", "--Mdir $pout_dir", "--cache-dir $pcache_dir",
+            "--protect-ids", "--protect-key SECRET_KEY", "--prefix V$Self->{name}",
+            "--debugi-V3Cache 1", $Self->{top_filename});
+
+run(cmd => \@pcmd,
+    logfile => "$Self->{obj_dir}/vlt3.log",
+    verilator_run => 1,
+    );
+file_grep("$Self->{obj_dir}/vlt3.log", qr/--cache-dir: Saved/);
+file_grep($idmap, qr/<map from=/);
+rename($idmap, "$idmap.orig");
+
+run(cmd => \@pcmd,
+    logfile => "$Self->{obj_dir}/vlt4.log",
+    verilator_run => 1,
+    );
+file_grep("$Self->{obj_dir}/vlt4.log", qr/--cache-dir: Hit/);
+files_identical($idmap, "$idmap.orig");
+
+ok(1);
+1;
@@ -17,6 +17,7 @@ foreach my $prog (
     "../bin/verilator_difftree",
     "../bin/verilator_gantt",
     "../bin/verilator_profcfunc",
+    "../bin/verilator_vtb2vcd",
     ) {
     run(fails => 0,
         cmd => ["perl", $prog,
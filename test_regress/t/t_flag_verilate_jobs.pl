@@ -0,0 +1,44 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+my @flags = ("--cc", "--stats", "--prefix $Self->{VM_PREFIX}", $Self->{top_filename});
+
+# Passes run per module in parallel must give the model of a serial run
+foreach my $jobs (1, 4) {
+    run(cmd => ["../bin/verilator", "--Mdir $Self->{obj_dir}/jobs$jobs",
+                "--verilate-jobs $jobs", @flags],
+        verilator_run => 1,
+        );
+}
+
+my $n = 0;
+foreach my $file (glob("$Self->{obj_dir}/jobs1/*.cpp $Self->{obj_dir}/jobs1/*.h")) {
+    (my $base = $file) =~ s!.*/!!;
+    files_identical("$Self->{obj_dir}/jobs4/$base", $file);
+    ++$n;
+}
+$n > 3 or error("Expected model files, found $n");
+
+# Check re-rolling, one of the parallel passes, had work to do
+file_grep("$Self->{obj_dir}/jobs4/$Self->{VM_PREFIX}__stats.txt",
+          qr/Optimizations, Reloops\s+[1-9]\d*/i);
+
+compile(
+    verilator_flags2 => ["--verilate-jobs 4"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
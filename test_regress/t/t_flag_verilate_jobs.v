@@ -0,0 +1,58 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [95:0]  outa;
+   wire [199:0] outb;
+   wire [31:0]  outc;
+
+   // Differently parameterized, so separate modules each passes works on
+   sub #(.WIDTH(96)) a (.clk(clk), .in({crc[31:0], crc}), .out(outa));
+   sub #(.WIDTH(200)) b (.clk(clk), .in({crc[7:0], crc, crc, crc}), .out(outb));
+   sub #(.WIDTH(32)) c (.clk(clk), .in(crc[31:0]), .out(outc));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      // Wider copies hold the narrower copy's value in their low bits
+      if (cyc > 3 && outa[31:0] !== outc) $stop;
+      if (cyc > 3 && outb[31:0] !== outc) $stop;
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
+
+module sub #(parameter WIDTH = 32)
+   (input clk,
+    input [WIDTH-1:0]      in,
+    output reg [WIDTH-1:0] out);
+   /*verilator no_inline_module*/
+
+   reg [WIDTH-1:0] mem [0:63];
+   integer         i;
+
+   initial begin
+      // Unrolled, then re-rolled
+      for (i = 0; i < 64; i = i + 1) mem[i] = 0;
+   end
+
+   always @ (posedge clk) begin
+      mem[in[5:0]] <= in ^ (in << 3);
+      out <= mem[in[11:6]] ^ (mem[in[17:12]] << 1);
+   end
+
+endmodule
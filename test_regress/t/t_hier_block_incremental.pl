@@ -0,0 +1,49 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+clean_objs();
+
+scenarios(vlt => 1);
+
+top_filename("t/t_hier_block.v");
+
+my @flags = ('--hierarchical', '--Wno-TIMESCALEMOD',
+             '--CFLAGS', '"-pipe -DCPP_MACRO=cplusplus"');
+
+compile(
+    v_flags2 => ['t/t_hier_block.cpp'],
+    verilator_flags2 => \@flags,
+    );
+
+my $mk = "$Self->{obj_dir}/Vsub0/Vsub0.mk";
+my $lib = "$Self->{obj_dir}/Vsub0/libsub0.a";
+my $mk_mtime = (stat($mk))[9];
+my $lib_mtime = (stat($lib))[9];
+$mk_mtime or error("Missing $mk");
+
+# Make sure a rebuild would be visible in the timestamps
+sleep(1);
+
+# Nothing changed, so the blocks must keep their previous output
+compile(
+    v_flags2 => ['t/t_hier_block.cpp'],
+    verilator_flags2 => \@flags,
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+(stat($mk))[9] == $mk_mtime or error("$mk was regenerated");
+(stat($lib))[9] == $lib_mtime or error("$lib was rebuilt");
+file_grep("$Self->{obj_dir}/Vsub0/Vsub0__hierFingerprint.dat", qr/^[0-9a-f]+$/m);
+
+ok(1);
+1;
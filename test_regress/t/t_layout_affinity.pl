@@ -0,0 +1,47 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    verilator_flags2 => ['--cc --layout-affinity'],
+    );
+
+my $hdr = "$Self->{obj_dir}/$Self->{VM_PREFIX}.h";
+if ($Self->{vltmt}) {
+    # Each mtask footprint starts on its own cache line
+    file_grep($hdr, qr/char __VlayoutPad0\[VL_CACHE_LINE_BYTES\];/);
+} else {
+    file_grep_not($hdr, qr/__VlayoutPad/);
+    # The posedge and negedge variables, declared interleaved, are clustered apart
+    my @lines = split /\n/, file_contents($hdr);
+    my %line;
+    for (my $i = 0; $i <= $#lines; ++$i) {
+        $line{$1} = $i if $lines[$i] =~ /\bt__DOT__([ab][123]);/;
+    }
+    my @pos = map { $line{"a$_"} } (1..3);
+    my @neg = map { $line{"b$_"} } (1..3);
+    if (grep { !defined $_ } (@pos, @neg)) {
+        error("Variables missing from $hdr");
+    } else {
+        @pos = sort { $a <=> $b } @pos;
+        @neg = sort { $a <=> $b } @neg;
+        if (!($pos[2] < $neg[0] || $neg[2] < $pos[0])) {
+            error("Variables not clustered by accessing function in $hdr");
+        }
+    }
+}
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
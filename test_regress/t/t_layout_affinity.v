@@ -0,0 +1,47 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   // Declared interleaved; a* are only used on posedge, b* on negedge,
+   // so --layout-affinity should cluster them apart
+   reg [7:0] a1 = 0;
+   reg [7:0] b1 = 0;
+   reg [7:0] a2 = 0;
+   reg [7:0] b2 = 0;
+   reg [7:0] a3 = 0;
+   reg [7:0] b3 = 0;
+
+   always @(posedge clk) begin
+      cyc <= cyc + 1;
+      a1 <= a1 + 8'd1;
+      a2 <= a2 ^ a1;
+      a3 <= a3 + a2;
+      if (cyc == 20) begin
+         if (a1 != 8'h14) $stop;
+         if (a2 != 8'h00) $stop;
+         if (a3 != 8'h64) $stop;
+         if (b1 != 8'h3c) $stop;
+         if (b2 != 8'h3c) $stop;
+         if (b3 != 8'h78) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+   always @(negedge clk) begin
+      b1 <= b1 + 8'd3;
+      b2 <= b2 ^ b1;
+      b3 <= b3 + b2;
+   end
+
+endmodule
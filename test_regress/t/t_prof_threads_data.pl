@@ -0,0 +1,43 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# Test for --prof-threads-data
+scenarios(vltmt => 1);
+
+top_filename("t/t_gen_alw.v");
+
+compile(
+    v_flags2 => ["--prof-threads --threads 2"]
+    );
+
+execute(
+    all_run_flags => ["+verilator+prof+threads+start+2",
+                      " +verilator+prof+threads+window+2",
+                      " +verilator+prof+threads+file+$Self->{obj_dir}/profile_threads.dat",
+                      ],
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/profile_threads.dat", qr/VLPROF mtask_hash \d+ [0-9a-f]+/);
+
+# Re-Verilate the unchanged design with the profile, every mtask should match
+compile(
+    v_flags2 => ["--threads 2 --stats",
+                 "--prof-threads-data $Self->{obj_dir}/profile_threads.dat"]
+    );
+
+file_grep($Self->{stats}, qr/MTask graph, profile unmatched mtasks\s+(\d+)/i, 0);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
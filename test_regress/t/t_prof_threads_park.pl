@@ -0,0 +1,54 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+use IO::File;
+
+# Test threads waiting on mtasks park, and that --prof-threads reports it
+scenarios(vltmt => 1);
+
+compile(
+    # No spinning, so every wait on an unfinished mtask parks
+    v_flags2 => ["--prof-threads --threads 2 -CFLAGS -DVL_WAIT_SPINS=0"],
+    );
+
+execute(
+    all_run_flags => ["+verilator+prof+threads+start+2",
+                      " +verilator+prof+threads+window+2",
+                      " +verilator+prof+threads+file+$Self->{obj_dir}/profile_threads.dat",
+                      ],
+    check_finished => 1,
+    );
+
+# A record for the worker thread and the eval thread
+my $parks = 0;
+my $records = 0;
+{
+    my $fh = IO::File->new("<$Self->{obj_dir}/profile_threads.dat")
+        or error("$! $Self->{obj_dir}/profile_threads.dat");
+    while (my $line = ($fh && $fh->getline)) {
+        next if $line !~ /^VLPROF wait thread \d+ spin \d+ park \d+ parks (\d+)/;
+        ++$records;
+        $parks += $1;
+    }
+}
+$records == 2 or error("Expected 2 wait records, found $records");
+$parks > 0 or error("Expected threads to park");
+
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_gantt",
+            "$Self->{obj_dir}/profile_threads.dat",
+            "--no-vcd",
+            "| tee $Self->{obj_dir}/gantt.log"],
+    verilator_run => 1,
+    );
+
+file_grep("$Self->{obj_dir}/gantt.log", qr/Total parks\s+=\s+[1-9]\d*/);
+
+ok(1);
+1;
@@ -0,0 +1,55 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+   reg [63:0] crc = 64'h5aef0c8d_d70a4497;
+
+   wire [63:0] h0, h1, h2, h3;
+
+   // Independent logic, so the mtasks are spread over the threads;
+   // pairs are identical so the results can be checked
+   hash #(.SEED(1)) u0 (.in(crc), .out(h0));
+   hash #(.SEED(1)) u1 (.in(crc), .out(h1));
+   hash #(.SEED(2)) u2 (.in(crc), .out(h2));
+   hash #(.SEED(2)) u3 (.in(crc), .out(h3));
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      crc <= {crc[62:0], crc[63] ^ crc[2] ^ crc[0]};
+      if (h0 !== h1) $stop;
+      if (h2 !== h3) $stop;
+      if (h0 === h2) $stop;
+      if (cyc == 99) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
+
+module hash #(parameter SEED = 1)
+   (input [63:0]      in,
+    output reg [63:0] out);
+
+   integer r;
+
+   always @* begin
+      out = in ^ SEED;
+      for (r = 0; r < 16; r = r + 1) begin
+         out = out ^ (out << 13);
+         out = out ^ (out >> 7);
+         out = out ^ (out << 17);
+         out = out + 64'h9e3779b97f4a7c15;
+      end
+   end
+
+endmodule
@@ -0,0 +1,70 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   reg [2047:0] a;
+   reg [2047:0] b;
+
+   // Word operations with a body larger than a copy
+   wire [2047:0] andn = a & ~b;
+   // Word operations with an index offset
+   wire [2047:0] shifted = {a[2015:0], 32'h0};
+
+   // Word operations with descending and strided indices
+   reg [2047:0] reversed;
+   reg [4095:0] spread;
+   always_comb begin
+      for (int i = 0; i < 64; i = i + 1) reversed[i*32 +: 32] = a[(63 - i)*32 +: 32];
+   end
+   always_comb begin
+      spread = 0;
+      for (int i = 0; i < 64; i = i + 1) spread[(2*i)*32 +: 32] = a[i*32 +: 32];
+   end
+
+   // Array operations with strided and descending indices
+   reg [31:0] mem [0:127];
+   reg [31:0] memEven [0:63];
+   reg [31:0] memRev [0:63];
+   initial begin
+      for (int i = 0; i < 128; i = i + 1) mem[i] = i * 5 + 3;
+   end
+   always_comb begin
+      for (int i = 0; i < 64; i = i + 1) memEven[i] = mem[2*i];
+   end
+   always_comb begin
+      for (int i = 0; i < 64; i = i + 1) memRev[i] = mem[127 - i];
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 0) begin
+         for (int i = 0; i < 64; i = i + 1) begin
+            a[i*32 +: 32] <= i * 7 + 1;
+            b[i*32 +: 32] <= i * 3;
+         end
+      end
+      else if (cyc == 2) begin
+         for (int i = 0; i < 64; i = i + 1) begin
+            if (andn[i*32 +: 32] !== ((i * 7 + 1) & ~(i * 3))) $stop;
+            if (shifted[i*32 +: 32] !== (i == 0 ? 0 : (i - 1) * 7 + 1)) $stop;
+            if (reversed[i*32 +: 32] !== (63 - i) * 7 + 1) $stop;
+            if (spread[(2*i)*32 +: 32] !== i * 7 + 1) $stop;
+            if (spread[(2*i+1)*32 +: 32] !== 0) $stop;
+            if (memEven[i] !== (2*i) * 5 + 3) $stop;
+            if (memRev[i] !== (127 - i) * 5 + 3) $stop;
+         end
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+endmodule
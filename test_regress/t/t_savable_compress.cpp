@@ -0,0 +1,69 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <memory>
+
+#include <verilated.h>
+#include <verilated_save.h>
+#include VM_PREFIX_INCLUDE
+
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+std::unique_ptr<VM_PREFIX> topp;
+
+static const char* const filename = VL_STRINGIFY(TEST_OBJ_DIR) "/saved.vltsv";
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+    contextp->debug(0);
+    topp.reset(new VM_PREFIX{"top"});
+
+    const bool restore = contextp->commandArgsPlusMatch("save_restore")[0];
+    if (restore) {
+        // Compression and chunk count are read from the file
+        VerilatedRestore os;
+        os.open(filename);
+        TEST_CHECK_EQ(os.isOpen(), true);
+        os >> *topp;
+        os.close();
+    } else {
+        topp->clk = 0;
+        topp->eval();
+        contextp->timeInc(10);
+    }
+
+    while (contextp->time() < 1000 && !contextp->gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        if (!restore && contextp->time() == 40) {
+            VerilatedSave os;
+#ifdef VL_SAVE_ZLIB
+            os.compress(6);
+#else
+            os.compress(0);
+#endif
+            os.chunks(3);
+            os.open(filename);
+            TEST_CHECK_EQ(os.isOpen(), true);
+            os << *topp;
+            os.close();
+        }
+        contextp->timeInc(1);
+    }
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    topp.reset();
+    return errors ? 10 : 0;
+}
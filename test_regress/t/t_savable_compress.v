@@ -0,0 +1,63 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   // 4 MB of state, in quarters that are zero, patterned, random and zero,
+   // so the save frames use zero run, zlib and stored methods
+   localparam WORDS = 1 << 20;
+   localparam QUARTER = WORDS / 4;
+
+   reg [31:0] mem [0:WORDS-1];
+
+   integer    cyc = 0;
+   integer    i;
+   integer    bad;
+
+   function [31:0] expect_word(input integer idx);
+      reg [31:0] x;
+      begin
+         x = idx;
+         case (idx / QUARTER)
+           1: expect_word = {x[7:0], 8'h5a, x[15:8], 8'ha5};
+           2: begin
+              x = x * 32'h9e3779b1;
+              x = x ^ (x >> 15);
+              x = x * 32'h85ebca6b;
+              x = x ^ (x >> 13);
+              expect_word = x;
+           end
+           default: expect_word = 32'h0;
+         endcase
+      end
+   endfunction
+
+   initial begin
+      for (i = 0; i < WORDS; i = i + 1) mem[i] = expect_word(i);
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      // Saved at time 40, so after restore the initial block is not rerun
+      if (cyc == 20) begin
+         bad = 0;
+         for (i = 0; i < WORDS; i = i + 1) begin
+            if (mem[i] !== expect_word(i)) bad = bad + 1;
+         end
+         if (bad != 0) begin
+            $write("%%Error: %0d words differ after restore\n", bad);
+            $stop;
+         end
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,53 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_savable_compress.v");
+
+compile(
+    v_flags2 => ["--savable --exe $Self->{t_dir}/t_savable_compress.cpp"],
+    make_main => 0,
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Each chunk should hold several frames
+my %methods;
+foreach my $chunk (0 .. 2) {
+    my $filename = "$Self->{obj_dir}/saved.vltsv" . ($chunk ? ".$chunk" : "");
+    my $frames = 0;
+    my $fh = IO::File->new("<$filename") or error("$filename not created\n");
+    binmode($fh);
+    read($fh, my $header, 24) == 24 or error("$filename: short header\n");
+    while (read($fh, my $frame, 24) == 24) {
+        my ($size, $storedSize, $method) = unpack("Q<Q<Q<", $frame);
+        last if !$size;
+        ++$frames;
+        ++$methods{$method};
+        seek($fh, $storedSize, 1);
+    }
+    $frames >= 3 or error("$filename: only $frames frames\n");
+}
+# Stored and zero run, as without VL_SAVE_ZLIB there is no zlib
+foreach my $method (0 .. 1) {
+    $methods{$method} or error("No frames written with method $method\n");
+}
+!$methods{2} or error("Frames written with zlib method without VL_SAVE_ZLIB\n");
+
+execute(
+    all_run_flags => ['+save_restore=1'],
+    check_finished => 1,
+    );
+
+ok(1);
+1;
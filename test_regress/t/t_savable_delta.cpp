@@ -0,0 +1,81 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <memory>
+
+#include <verilated.h>
+#include <verilated_save.h>
+#include VM_PREFIX_INCLUDE
+
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+std::unique_ptr<VM_PREFIX> topp;
+
+static std::string filename(int num) {
+    return std::string(VL_STRINGIFY(TEST_OBJ_DIR) "/saved") + std::to_string(num) + ".vltsv";
+}
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+    contextp->debug(0);
+    topp.reset(new VM_PREFIX{"top"});
+
+    const bool restore = contextp->commandArgsPlusMatch("save_restore")[0];
+    if (restore) {
+        // Reads the whole chain of delta checkpoints
+        VerilatedRestore os;
+        os.open(filename(2));
+        TEST_CHECK_EQ(os.isOpen(), true);
+        os >> *topp;
+        os.close();
+    } else {
+        topp->clk = 0;
+        topp->eval();
+        contextp->timeInc(10);
+    }
+
+    while (contextp->time() < 1000 && !contextp->gotFinish()) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        if (!restore) {
+            if (contextp->time() == 40) {
+                VerilatedSave os;
+                os.open(filename(0));
+                os << *topp;
+                os.close();
+            } else if (contextp->time() == 60) {
+                VerilatedSave os;
+                os.deltaBase(filename(0));
+                os.open(filename(1));
+                os << *topp;
+                os.close();
+            } else if (contextp->time() == 80) {
+                // Child writes the checkpoint while this process continues
+                VerilatedSave os;
+                os.deltaBase(filename(1));
+                if (os.openFork(filename(2))) {
+                    os << *topp;
+                    os.close();  // Exits child
+                }
+            }
+        }
+        contextp->timeInc(1);
+    }
+    TEST_CHECK_EQ(VerilatedSave::forkWait(), true);
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    topp.reset();
+    return errors ? 10 : 0;
+}
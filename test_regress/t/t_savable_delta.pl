@@ -0,0 +1,34 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_savable.v");
+
+compile(
+    v_flags2 => ["--savable --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    make_main => 0,
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+foreach my $num (0 .. 2) {
+    -r "$Self->{obj_dir}/saved${num}.vltsv" or error("saved${num}.vltsv not created\n");
+}
+
+execute(
+    all_run_flags => ['+save_restore=1'],
+    check_finished => 1,
+    );
+
+ok(1);
+1;
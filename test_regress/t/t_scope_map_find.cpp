@@ -0,0 +1,88 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include <verilated_syms.h>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Vt_scope_map_find.h"
+
+int errors = 0;
+
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            VL_PRINTF("%%Error: %s:%d: Check failed: %s\n", __FILE__, __LINE__, #cond); \
+            ++errors; \
+        } \
+    } while (0)
+
+// Check every scope and variable is found by name, and iterates in order
+static int checkScopes(VerilatedContext* contextp, const char* prefixp) {
+    int found = 0;
+    const char* lastScopep = nullptr;
+    for (const auto& scopeit : *contextp->scopeNameMap()) {
+        if (lastScopep) CHECK(std::strcmp(lastScopep, scopeit.first) < 0);
+        lastScopep = scopeit.first;
+        CHECK(contextp->scopeFind(scopeit.first) == scopeit.second);
+        if (std::strncmp(scopeit.first, prefixp, std::strlen(prefixp)) != 0) continue;
+        ++found;
+        VerilatedVarNameMap* const varsp = scopeit.second->varsp();
+        if (!varsp) continue;
+        const char* lastVarp = nullptr;
+        for (auto& varit : *varsp) {
+            if (lastVarp) CHECK(std::strcmp(lastVarp, varit.first) < 0);
+            lastVarp = varit.first;
+            // Look up with a copy of the name, so only the hash finds it
+            const std::string name = varit.first;
+            CHECK(scopeit.second->varFind(name.c_str()) == &varit.second);
+            CHECK(varsp->find(name.c_str()) != varsp->end());
+        }
+        CHECK(scopeit.second->varFind("__no_such_var") == nullptr);
+    }
+    return found;
+}
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->debug(0);
+
+    std::unique_ptr<Vt_scope_map_find> topap{new Vt_scope_map_find{contextp.get(), "topa"}};
+    const int scopes = checkScopes(contextp.get(), "topa");
+    CHECK(scopes > 10);
+    CHECK(contextp->scopeFind("topa.t.foo8") != nullptr);
+    CHECK(contextp->scopeFind("topb.t.foo8") == nullptr);
+
+    // Insert a second model's scopes
+    std::unique_ptr<Vt_scope_map_find> topbp{new Vt_scope_map_find{contextp.get(), "topb"}};
+    CHECK(checkScopes(contextp.get(), "topa") == scopes);
+    CHECK(checkScopes(contextp.get(), "topb") == scopes);
+    const VerilatedScope* const scopep = contextp->scopeFind("topb.t.foo8");
+    CHECK(scopep && scopep->varFind("value_q"));
+
+    // Erase the first model's scopes
+    topap.reset();
+    CHECK(checkScopes(contextp.get(), "topa") == 0);
+    CHECK(checkScopes(contextp.get(), "topb") == scopes);
+    CHECK(contextp->scopeFind("topa.t.foo8") == nullptr);
+    CHECK(contextp->scopeFind("topb.t.foo8") == scopep);
+
+    // Insert again after the erase
+    topap.reset(new Vt_scope_map_find{contextp.get(), "topa"});
+    CHECK(checkScopes(contextp.get(), "topa") == scopes);
+    CHECK(checkScopes(contextp.get(), "topb") == scopes);
+
+    topap->final();
+    topbp->final();
+    if (errors) return 10;
+    VL_PRINTF("*-* All Finished *-*\n");
+    return 0;
+}
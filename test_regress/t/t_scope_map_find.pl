@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_scope_map.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--public-flat-rw --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+# Variable tables generated at Verilation time
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Syms.cpp", qr/varHashTable\(__Vfinal, /);
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,43 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <memory>
+
+#include <verilated.h>
+#include VM_PREFIX_INCLUDE
+
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+    contextp->debug(0);
+    const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get(), "top"}};
+
+    topp->clk = 0;
+    topp->eval();
+    int edges = 0;  // Rising edges of clk, each incrementing cyc
+    while (contextp->time() < 1000 && !contextp->gotFinish()) {
+        contextp->timeInc(1);
+        topp->clk = !topp->clk;
+        topp->eval();
+        if (topp->clk) ++edges;
+    }
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    // Each change of cyc changes all 8 stages, so at least 8 changes are detected
+    const vluint32_t count = topp->__Vsettlechg__TOP__t__DOT__stage;
+    TEST_CHECK(count, 8 * (edges - 1), count >= 8 * (edges - 1));
+    topp->final();
+    return errors ? 10 : 0;
+}
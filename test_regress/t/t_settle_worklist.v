@@ -0,0 +1,43 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   localparam STAGES = 8;
+
+   integer cyc = 0;
+
+   // Chain through one array, so it is an UNOPTFLAT loop that needs
+   // several settle iterations whenever cyc changes
+   reg [31:0] stage [STAGES-1:0];
+
+   genvar  g;
+   generate
+      for (g = 0; g < STAGES; g++) begin
+         always_comb begin
+            if (g == 0) stage[g] = cyc;
+            else stage[g] = stage[g-1] + 1;
+         end
+      end
+   endgenerate
+
+   wire [31:0] out = stage[STAGES-1];
+
+   always @ (posedge clk) begin
+      $write("cyc=%0d out=%0d\n", cyc, out);
+      if (out !== cyc + STAGES - 1) $stop;
+      cyc <= cyc + 1;
+      if (cyc == 20) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
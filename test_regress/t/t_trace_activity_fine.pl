@@ -0,0 +1,34 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_complex.v");
+golden_filename("t/t_trace_complex.out");
+
+compile(
+    verilator_flags2 => ['--cc --trace --trace-activity-fine --trace-max-groups 4'
+                         . ' --trace-activity-stats --stats'],
+    );
+
+my ($groups) = (file_contents($Self->{stats}) =~ /Tracing, Activity groups\s+(\d+)/i);
+defined $groups && $groups >= 1 && $groups <= 4
+    or error("Expected 1 to 4 activity groups, got " . ($groups // "none") . "\n");
+file_grep("$Self->{obj_dir}/V$Self->{name}__Trace__Slow.cpp", qr/addActivityStats\(/);
+
+execute(
+    check_finished => 1,
+    expect => qr/Trace activity statistics/,
+    );
+
+vcd_identical ("$Self->{obj_dir}/simx.vcd", $Self->{golden_filename});
+
+ok(1);
+1;
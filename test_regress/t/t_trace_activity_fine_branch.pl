@@ -0,0 +1,52 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+my @flags = ("--cc", "--trace", "--stats", "--prefix $Self->{VM_PREFIX}", $Self->{top_filename});
+
+sub activity_stats {
+    my $dir = shift;
+    my $stats = file_contents("$Self->{obj_dir}/$dir/$Self->{VM_PREFIX}__stats.txt");
+    my ($flags) = ($stats =~ /Tracing, Activity flags\s+(\d+)/i);
+    my ($groups) = ($stats =~ /Tracing, Activity groups\s+(\d+)/i);
+    defined $flags && defined $groups or error("No activity statistics in $dir\n");
+    return ($flags // 0, $groups // 0);
+}
+
+run(cmd => ["../bin/verilator", "--Mdir $Self->{obj_dir}/coarse", @flags],
+    verilator_run => 1,
+    );
+run(cmd => ["../bin/verilator", "--Mdir $Self->{obj_dir}/fine", "--trace-activity-fine", @flags],
+    verilator_run => 1,
+    );
+
+# Each branch should have its own flag and group, rather than sharing the
+# flag of the function
+my ($coarseFlags, $coarseGroups) = activity_stats("coarse");
+my ($fineFlags, $fineGroups) = activity_stats("fine");
+$fineFlags >= $coarseFlags + 7 or error("Expected a flag per branch, $coarseFlags -> $fineFlags\n");
+$fineGroups >= 8 or error("Expected a group per branch, got $fineGroups\n");
+$fineGroups > $coarseGroups or error("Expected more groups, $coarseGroups -> $fineGroups\n");
+
+compile(
+    verilator_flags2 => ['--trace --trace-activity-fine --trace-max-groups 4 --stats'],
+    );
+
+my ($groups) = (file_contents($Self->{stats}) =~ /Tracing, Activity groups\s+(\d+)/i);
+defined $groups && $groups >= 1 && $groups <= 4
+    or error("Expected 1 to 4 activity groups, got " . ($groups // "none") . "\n");
+
+execute(
+    check_finished => 1,
+    );
+
+ok(1);
+1;
@@ -0,0 +1,49 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   // Each register is written in its own branch, so with
+   // --trace-activity-fine each gets its own activity flag.  Blocking
+   // assignments keep the writes in the branch, rather than in delayed
+   // assignment copies after it.
+   reg [127:0] r0 = 0;
+   reg [127:0] r1 = 0;
+   reg [127:0] r2 = 0;
+   reg [127:0] r3 = 0;
+   reg [127:0] r4 = 0;
+   reg [127:0] r5 = 0;
+   reg [127:0] r6 = 0;
+   reg [127:0] r7 = 0;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      case (cyc[2:0])
+        3'd0: r0 = r0 + 128'd1;
+        3'd1: r1 = r1 + 128'd2;
+        3'd2: r2 = r2 + 128'd3;
+        3'd3: r3 = r3 + 128'd4;
+        3'd4: r4 = r4 + 128'd5;
+        3'd5: r5 = r5 + 128'd6;
+        3'd6: r6 = r6 + 128'd7;
+        default: r7 = r7 + 128'd8;
+      endcase
+      if (cyc == 40) begin
+         // Branch 0 has also just run for cyc 40
+         if (r0 != 128'd6 || r1 != 128'd10 || r2 != 128'd15 || r3 != 128'd20
+             || r4 != 128'd25 || r5 != 128'd30 || r6 != 128'd35 || r7 != 128'd40) $stop;
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -28,6 +28,9 @@ int main(int argc, char** argv, char** env) {
     Verilated::traceEverOn(true);
 
     std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC};
+#if defined(T_TRACE_CAT_ASYNC)
+    tfp->asyncBuffers(2);
+#endif
     top->trace(tfp.get(), 99);
 
     tfp->open(trace_name());
@@ -41,7 +44,7 @@ int main(int argc, char** argv, char** env) {
         if ((main_time % 100) == 0) {
 #if defined(T_TRACE_CAT)
             tfp->openNext(true);
-#elif defined(T_TRACE_CAT_REOPEN)
+#elif defined(T_TRACE_CAT_REOPEN) || defined(T_TRACE_CAT_ASYNC)
             tfp->close();
             tfp->open(trace_name());
 #elif defined(T_TRACE_CAT_RENEW)
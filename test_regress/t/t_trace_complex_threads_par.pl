@@ -0,0 +1,31 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vltmt => 1);
+
+top_filename("t/t_trace_complex.v");
+golden_filename("t/t_trace_complex.out");
+
+compile(
+    verilator_flags2 => ['--cc --trace --trace-threads 1 --threads 4']
+    );
+
+# Change callbacks split for parallel dump
+file_grep("$Self->{obj_dir}/V$Self->{name}__Trace__Slow.cpp", qr/threadPool\(__Vm_threadPoolp\)/);
+file_grep("$Self->{obj_dir}/V$Self->{name}__Trace__Slow.cpp", qr/addChgCb\(&traceChgTop1,/);
+
+execute(
+    check_finished => 1,
+    );
+
+vcd_identical ("$Self->{obj_dir}/simx.vcd", $Self->{golden_filename});
+
+ok(1);
+1;
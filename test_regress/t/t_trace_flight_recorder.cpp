@@ -0,0 +1,51 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <memory>
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    std::unique_ptr<VM_PREFIX> top{new VM_PREFIX("top")};
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+    // With +all, dump everything, to check the recording against
+    const bool all = Verilated::commandArgsPlusMatch("all")[0];
+
+    std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC};
+    top->trace(tfp.get(), 99);
+
+    // Else keep only the last 6 dumps
+    if (!all) tfp->flightRecorder(6);
+    tfp->open(all ? VL_STRINGIFY(TEST_OBJ_DIR) "/simall.vcd"
+                  : VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vcd");
+
+    top->clk = 0;
+
+    while (!Verilated::gotFinish()) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        // Written on request, then again by the $stop
+        if (!all && main_time == 20) tfp->flightRecorderWrite();
+        ++main_time;
+    }
+    tfp->close();
+    top->final();
+    tfp.reset();
+    top.reset();
+    return Verilated::gotError() ? 10 : 0;
+}
@@ -0,0 +1,78 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace --exe $Self->{t_dir}/t_trace_flight_recorder.cpp"],
+    );
+
+execute(
+    fails => $Self->{vlt_all},
+    );
+
+# The same run dumping everything
+execute(
+    all_run_flags => ['+all'],
+    fails => $Self->{vlt_all},
+    );
+
+# Values after each dump, keyed by time, from the given file.  A gap in
+# the times starts a new recording, in which the first dump must give the
+# value of every signal.
+sub dump_states {
+    my $filename = shift;
+    my %states;
+    my %values;
+    my $time;
+    my $fh = IO::File->new("<$filename") or error("$filename not created\n");
+    my $save = sub {
+        $states{$time} = join(" ", map { "$_=$values{$_}" } sort keys %values)
+            if defined $time;
+    };
+    while (defined(my $line = $fh->getline)) {
+        if ($line =~ /^#(\d+)$/) {
+            $save->();
+            %values = () if defined $time && $1 != $time + 1;
+            $time = $1;
+        } elsif ($line =~ /^([01xz])(\S+)$/) {
+            $values{$2} = $1;
+        } elsif ($line =~ /^([br]\S+) (\S+)$/) {
+            $values{$2} = $1;
+        }
+    }
+    $save->();
+    return %states;
+}
+
+if ($Self->{vlt_all}) {
+    my %all = dump_states("$Self->{obj_dir}/simall.vcd");
+    my %recorded = dump_states("$Self->{obj_dir}/simx.vcd");
+    foreach my $time (sort { $a <=> $b } keys %recorded) {
+        if (($all{$time} // "") ne $recorded{$time}) {
+            error("Recording differs from full dump at time $time:\n"
+                  . "  recorded: $recorded{$time}\n  expected: " . ($all{$time} // "") . "\n");
+        }
+    }
+
+    my @times = (file_contents("$Self->{obj_dir}/simx.vcd") =~ /^#(\d+)$/mg);
+    # The dumps up to the flightRecorderWrite(), then those before the $stop
+    if ("@times[0..5]" ne "15 16 17 18 19 20") {
+        error("Requested recording has wrong times: @times");
+    }
+    if ($#times != 11 || $times[11] - $times[6] != 5 || $times[6] <= 20) {
+        error("Recording at \$stop has wrong times: @times");
+    }
+}
+
+ok(1);
+1;
@@ -0,0 +1,31 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t
+  (
+   input wire clk
+   );
+
+   integer    cyc; initial cyc = 0;
+
+   // Signals changing at different rates, some only before the recorded
+   // dumps, so a recording must rebuild their values
+   reg         early_bit = 0;
+   reg [7:0]   early_byte = 0;
+   reg [47:0]  quad = 0;
+   reg [95:0]  wide = 0;
+   real        v_real = 0;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      if (cyc == 2) early_bit <= 1;
+      if (cyc == 3) early_byte <= 8'h5a;
+      if (cyc % 3 == 0) quad <= quad + 48'h1_0000_0001;
+      if (cyc % 4 == 1) wide <= {wide[94:0], ~wide[95]};
+      if (cyc % 5 == 2) v_real <= v_real + 1.5;
+      if (cyc == 30) $stop;
+   end
+endmodule
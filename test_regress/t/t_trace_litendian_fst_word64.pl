@@ -0,0 +1,28 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_trace_litendian.v");
+golden_filename("t/t_trace_litendian_fst.out");
+
+compile(
+    verilator_flags2 => ['--cc --trace-fst --trace-params -Wno-LITENDIAN --wide-word-size 64',
+                        ($Self->{vltmt} ? '--threads 6' : '')],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+fst_identical("$Self->{obj_dir}/simx.fst", $Self->{golden_filename});
+
+ok(1);
+1;
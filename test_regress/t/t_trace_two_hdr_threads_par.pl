@@ -0,0 +1,46 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2003-2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# Test parallel change dumps with two models traced to one file, so there
+# are more change callbacks than pool threads
+scenarios(vltmt => 1);
+
+top_filename("t_trace_two_a.v");
+golden_filename("t/t_trace_two_hdr_cc.out");
+
+compile(
+    make_main => 0,
+    verilator_make_gmake => 0,
+    top_filename => 't_trace_two_b.v',
+    VM_PREFIX => 'Vt_trace_two_b',
+    verilator_flags2 => ['-trace --trace-threads 1 --threads 2'],
+    );
+
+compile(
+    make_main => 0,
+    top_filename => 't_trace_two_a.v',
+    make_flags => 'CPPFLAGS_ADD=-DTEST_HDR_TRACE=1',
+    verilator_flags2 => ['-exe', '-trace --trace-threads 1 --threads 2',
+                         "$Self->{t_dir}/t_trace_two_cc.cpp"],
+    );
+
+# Each model registers two change callbacks with the shared trace file
+file_grep("$Self->{obj_dir}/Vt_trace_two_b__Trace__Slow.cpp", qr/addChgCb\(&traceChgTop1,/);
+file_grep("$Self->{obj_dir}/$Self->{VM_PREFIX}__Trace__Slow.cpp", qr/addChgCb\(&traceChgTop1,/);
+
+execute(
+    check_finished => 1,
+    );
+
+file_grep("$Self->{obj_dir}/simx.vcd", qr/\$enddefinitions/x);
+vcd_identical("$Self->{obj_dir}/simx.vcd", $Self->{golden_filename});
+
+ok(1);
+1;
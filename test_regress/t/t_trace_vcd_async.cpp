@@ -0,0 +1,70 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <fstream>
+#include <memory>
+
+#include <verilated.h>
+#include <verilated_vcd_c.h>
+#include VM_PREFIX_INCLUDE
+
+#include "TestCheck.h"
+
+//======================================================================
+
+int errors = 0;
+
+static vluint64_t fileSize(const char* filenamep) {
+    std::ifstream file{filenamep, std::ios::binary | std::ios::ate};
+    return file ? static_cast<vluint64_t>(file.tellg()) : 0;
+}
+
+int main(int argc, char** argv, char** env) {
+    const std::unique_ptr<VerilatedContext> contextp{new VerilatedContext};
+    contextp->commandArgs(argc, argv);
+    contextp->debug(0);
+    contextp->traceEverOn(true);
+    const std::unique_ptr<VM_PREFIX> topp{new VM_PREFIX{contextp.get(), "top"}};
+
+    const char* const filename0p = VL_STRINGIFY(TEST_OBJ_DIR) "/simpart_0.vcd";
+    const char* const filename1p = VL_STRINGIFY(TEST_OBJ_DIR) "/simpart_1.vcd";
+
+    // A single background buffer, so flushes must reuse the returned
+    // buffer, or wait for the writer to return it
+    const std::unique_ptr<VerilatedVcdC> tfp{new VerilatedVcdC};
+    tfp->asyncBuffers(1);
+    topp->trace(tfp.get(), 99);
+    tfp->open(filename0p);
+
+    topp->clk = 0;
+    while (!contextp->gotFinish() && contextp->time() < 10000) {
+        topp->clk = !topp->clk;
+        topp->eval();
+        // Reopening waits for the buffers in flight to be written
+        if (contextp->time() == 3000) {
+            tfp->close();
+            tfp->open(filename1p);
+        }
+        tfp->dump(contextp->time());
+        contextp->timeInc(1);
+    }
+    if (!contextp->gotFinish()) {
+        vl_fatal(__FILE__, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+    tfp->close();
+
+    const vluint64_t size0 = fileSize(filename0p);
+    const vluint64_t size1 = fileSize(filename1p);
+    TEST_CHECK_EQ(tfp->statBytesWritten(), size0 + size1);
+    // Each file should take many of the 48 KiB flushes
+    TEST_CHECK_EQ(size0 > 20 * 48 * 1024, true);
+    TEST_CHECK_EQ(size1 > 20 * 48 * 1024, true);
+
+    return errors ? 10 : 0;
+}
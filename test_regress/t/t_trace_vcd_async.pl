@@ -0,0 +1,60 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+# Background writing needs VL_THREADED
+scenarios(vltmt => 1);
+
+compile(
+    make_main => 0,
+    v_flags2 => ["--trace --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Check the values in the trace, so a buffer written out of order, twice
+# or not at all is caught
+foreach my $part (0, 1) {
+    my $filename = "$Self->{obj_dir}/simpart_$part.vcd";
+    my $fh = IO::File->new("<$filename") or error("$filename not created\n");
+    my %names;
+    my %values;
+    my $times = 0;
+    my $check = sub {
+        my $cyc = $values{cyc};
+        defined $cyc or return;
+        foreach my $k (0 .. 31) {
+            my $got = $values{"r($k)"};
+            my $exp = $cyc * ($k + 1);
+            if (!defined $got || $got != $exp) {
+                error("$filename: at cyc $cyc r($k) is " . ($got // "unset") . " not $exp\n");
+                return;
+            }
+        }
+        ++$times;
+    };
+    while (defined(my $line = $fh->getline)) {
+        if ($line =~ /^\s*\$var \S+\s+\d+ (\S+) (\S+)/) {
+            $names{$1} = $2;
+        } elsif ($line =~ /^#\d+/) {
+            $check->();
+        } elsif ($line =~ /^b([01]+) (\S+)/) {
+            my $name = $names{$2};
+            (my $bits = $1) =~ s/^0+(?=.)//;
+            $values{$name} = oct("0b$bits") if defined $name;
+        }
+    }
+    $check->();
+    $times > 1000 or error("$filename: only $times time steps\n");
+}
+
+ok(1);
+1;
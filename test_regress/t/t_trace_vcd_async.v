@@ -0,0 +1,34 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+   input clk;
+
+   integer cyc = 0;
+
+   // Every element changes every cycle, so the trace fills many buffers.
+   // After each cycle r(k) == cyc * (k + 1), which the test checks in the
+   // trace.
+   reg [127:0] r [0:31];
+   integer     k;
+
+   initial begin
+      for (k = 0; k < 32; k = k + 1) r[k] = 0;
+   end
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      for (k = 0; k < 32; k = k + 1) r[k] <= r[k] + 128'(k + 1);
+      if (cyc == 3000) begin
+         $write("*-* All Finished *-*\n");
+         $finish;
+      end
+   end
+
+endmodule
@@ -0,0 +1,59 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <verilated.h>
+#include <verilated_vtb_c.h>
+
+#include VM_PREFIX_INCLUDE
+
+unsigned long long main_time = 0;
+double sc_time_stamp() { return (double)main_time; }
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    std::unique_ptr<VM_PREFIX> top{new VM_PREFIX("top")};
+
+    Verilated::debug(0);
+    Verilated::traceEverOn(true);
+
+    // With +unclosed, flush part way, then exit as if killed, so the file
+    // has no index
+    const bool unclosed = Verilated::commandArgsPlusMatch("unclosed")[0];
+
+    std::unique_ptr<VerilatedVtbC> tfp{new VerilatedVtbC};
+    top->trace(tfp.get(), 99);
+
+    // Many small chunks, none spanning a multiple of 50
+    tfp->chunkBytes(40);
+    tfp->chunkTime(50);
+    tfp->open(unclosed ? VL_STRINGIFY(TEST_OBJ_DIR) "/simunclosed.vtb"
+                       : VL_STRINGIFY(TEST_OBJ_DIR) "/simx.vtb");
+
+    top->clk = 0;
+
+    while (main_time < 400) {
+        top->clk = !top->clk;
+        top->eval();
+        tfp->dump((unsigned int)(main_time));
+        if (unclosed && main_time == 301) tfp->flush();
+        ++main_time;
+    }
+    printf("*-* All Finished *-*\n");
+    if (unclosed) {
+        fflush(stdout);
+        std::_Exit(0);
+    }
+    tfp->close();
+    top->final();
+    tfp.reset();
+    top.reset();
+    return 0;
+}
@@ -0,0 +1,127 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    v_flags2 => ["--trace-vtb --exe $Self->{t_dir}/$Self->{name}.cpp"],
+    );
+
+execute(
+    check_finished => 1,
+    );
+
+# Values after each dump, keyed by time then signal name
+sub vcd_states {
+    my $filename = shift;
+    my %states;
+    my %names;
+    my %values;
+    my @scopes;
+    my $time;
+    my $fh = IO::File->new("<$filename") or error("$filename not created\n");
+    my $save = sub {
+        return if !defined $time;
+        foreach my $code (keys %values) {
+            $states{$time}{$_} = $values{$code} foreach @{$names{$code}};
+        }
+    };
+    while (defined(my $line = $fh->getline)) {
+        if ($line =~ /^\s*\$scope \S+ (\S+)/) {
+            push @scopes, $1;
+        } elsif ($line =~ /^\s*\$upscope/) {
+            pop @scopes;
+        } elsif ($line =~ /^\s*\$var \S+\s+\d+ (\S+) (\S+)/) {
+            push @{$names{$1}}, join(".", @scopes, $2);
+        } elsif ($line =~ /^#(\d+)$/) {
+            $save->();
+            $time = $1;
+        } elsif ($line =~ /^([01xz])(\S+)$/) {
+            $values{$2} = $1;
+        } elsif ($line =~ /^b0*(\d+?) (\S+)$/) {
+            $values{$2} = "b$1";
+        }
+    }
+    $save->();
+    return %states;
+}
+
+sub check_states {
+    my $filename = shift;
+    my $golden = shift;
+    my $exactTimes = shift;  # Else output may stop early
+    my %got = vcd_states($filename);
+    my %exp = vcd_states($golden);
+    foreach my $time (sort { $a <=> $b } keys %got) {
+        foreach my $name (sort keys %{$exp{$time}}) {
+            my $g = $got{$time}{$name} // "unset";
+            if ($g ne $exp{$time}{$name}) {
+                error("$filename: at time $time $name is $g not $exp{$time}{$name}\n");
+                return;
+            }
+        }
+    }
+    if ($exactTimes) {
+        my $gotTimes = join(" ", sort { $a <=> $b } keys %got);
+        my $expTimes = join(" ", sort { $a <=> $b } keys %exp);
+        $gotTimes eq $expTimes or error("$filename: times are $gotTimes not $expTimes\n");
+    }
+    return %got;
+}
+
+# Each chunk decodes from its own snapshot, and is within a multiple of 50
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_vtb2vcd", "--info",
+            "$Self->{obj_dir}/simx.vtb"],
+    logfile => "$Self->{obj_dir}/info.log",
+    verilator_run => 1,
+    );
+my @chunks = (file_contents("$Self->{obj_dir}/info.log") =~ /times (\d+) to (\d+)/g);
+@chunks >= 2 * 16 or error("Expected many chunks, got " . (@chunks / 2) . "\n");
+while (my ($start, $end) = splice(@chunks, 0, 2)) {
+    int($start / 50) == int($end / 50) or error("Chunk from $start to $end spans a multiple of 50\n");
+}
+
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_vtb2vcd",
+            "$Self->{obj_dir}/simx.vtb",
+            "$Self->{obj_dir}/simx.vcd"],
+    verilator_run => 1,
+    );
+vcd_identical("$Self->{obj_dir}/simx.vcd", "t/$Self->{name}.out");
+check_states("$Self->{obj_dir}/simx.vcd", "t/$Self->{name}.out", 1);
+
+# A window, starting part way through a chunk, found using the index
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_vtb2vcd", "--begin 123", "--end 187",
+            "$Self->{obj_dir}/simx.vtb",
+            "$Self->{obj_dir}/simwindow.vcd"],
+    verilator_run => 1,
+    );
+vcd_identical("$Self->{obj_dir}/simwindow.vcd", "t/$Self->{name}_window.out");
+check_states("$Self->{obj_dir}/simwindow.vcd", "t/$Self->{name}_window.out", 1);
+
+# A file flushed at time 301 but never closed, so with no index
+execute(
+    all_run_flags => ['+unclosed'],
+    check_finished => 1,
+    );
+run(cmd => ["$ENV{VERILATOR_ROOT}/bin/verilator_vtb2vcd",
+            "$Self->{obj_dir}/simunclosed.vtb",
+            "$Self->{obj_dir}/simunclosed.vcd"],
+    logfile => "$Self->{obj_dir}/unclosed.log",
+    verilator_run => 1,
+    );
+file_grep("$Self->{obj_dir}/unclosed.log", qr/No index, reading chunks written before last flush/);
+my %unclosed = check_states("$Self->{obj_dir}/simunclosed.vcd", "t/$Self->{name}.out", 0);
+my ($lastTime) = sort { $b <=> $a } keys %unclosed;
+($lastTime // 0) >= 301 or error("Unclosed file recovered only to time " . ($lastTime // "none") . "\n");
+
+ok(1);
+1;
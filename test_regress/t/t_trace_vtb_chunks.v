@@ -0,0 +1,20 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t
+  (
+   input wire clk
+   );
+
+   integer    cyc; initial cyc = 0;
+   // Multi-word value, so chunk snapshots hold several words
+   reg [95:0] wide; initial wide = 0;
+
+   always @ (posedge clk) begin
+      cyc <= cyc + 1;
+      wide <= {wide[63:0], cyc};
+   end
+endmodule
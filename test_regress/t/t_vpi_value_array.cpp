@@ -0,0 +1,150 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+//*************************************************************************
+//
+// Copyright 2021 by Wilson Snyder. This program is free software; you can
+// redistribute it and/or modify it under the terms of either the GNU
+// Lesser General Public License Version 3 or the Perl Artistic License
+// Version 2.0.
+// SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+//
+//*************************************************************************
+
+#include "Vt_vpi_value_array.h"
+#include "verilated.h"
+#include "verilated_vpi.h"
+
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+#include "TestSimulator.h"
+#include "TestVpi.h"
+
+// __FILE__ is too long
+#define FILENM "t_vpi_value_array.cpp"
+
+unsigned int main_time = 0;
+
+//======================================================================
+
+#define CHECK_RESULT_NZ(got) \
+    if (!(got)) { \
+        printf("%%Error: %s:%d: GOT = NULL  EXP = !NULL\n", FILENM, __LINE__); \
+        return __LINE__; \
+    }
+
+// Use cout to avoid issues with %d/%lx etc
+#define CHECK_RESULT_HEX(got, exp) \
+    if ((got) != (exp)) { \
+        std::cout << std::dec << "%Error: " << FILENM << ":" << __LINE__ << std::hex \
+                  << ": GOT = " << (got) << "   EXP = " << (exp) << std::endl; \
+        return __LINE__; \
+    }
+
+int _mon_check_int() {
+    TestVpiHandle mem_h = vpi_handle_by_name((PLI_BYTE8*)TestSimulator::rooted("mem32"), NULL);
+    CHECK_RESULT_NZ(mem_h);
+    s_vpi_arrayvalue arrayvalue;
+    arrayvalue.format = vpiIntVal;
+    arrayvalue.flags = 0;
+    PLI_INT32 index = 15;
+    // Reads wrap around from the highest index to the lowest
+    vpi_get_value_array(mem_h, &arrayvalue, &index, 4);
+    CHECK_RESULT_HEX(arrayvalue.value.integers[0], 0x10f);
+    CHECK_RESULT_HEX(arrayvalue.value.integers[1], 0x110);
+    CHECK_RESULT_HEX(arrayvalue.value.integers[2], 0x101);
+    CHECK_RESULT_HEX(arrayvalue.value.integers[3], 0x102);
+    PLI_INT32 values[16];
+    for (int i = 0; i < 16; ++i) values[i] = 0x201 + i;
+    arrayvalue.value.integers = values;
+    index = 1;
+    vpi_put_value_array(mem_h, &arrayvalue, &index, 16);
+    PLI_INT32 readback[16];
+    arrayvalue.value.integers = readback;
+    arrayvalue.flags = vpiUserAllocFlag;
+    vpi_get_value_array(mem_h, &arrayvalue, &index, 16);
+    for (int i = 0; i < 16; ++i) CHECK_RESULT_HEX(readback[i], values[i]);
+    return 0;
+}
+
+int _mon_check_raw() {
+    TestVpiHandle mem_h = vpi_handle_by_name((PLI_BYTE8*)TestSimulator::rooted("mem70"), NULL);
+    CHECK_RESULT_NZ(mem_h);
+    s_vpi_arrayvalue arrayvalue;
+    arrayvalue.format = vpiRawTwoStateVal;
+    arrayvalue.flags = 0;
+    // Each element is three 32-bit words, least significant first
+    PLI_UINT32 raw[6] = {1, 2, 0xffffffff, 4, 5, 6};
+    arrayvalue.value.rawvals = reinterpret_cast<PLI_BYTE8*>(raw);
+    PLI_INT32 index = 1;
+    vpi_put_value_array(mem_h, &arrayvalue, &index, 2);
+    arrayvalue.format = vpiVectorVal;
+    vpi_get_value_array(mem_h, &arrayvalue, &index, 2);
+    CHECK_RESULT_HEX(arrayvalue.value.vectors[0].aval, 1);
+    CHECK_RESULT_HEX(arrayvalue.value.vectors[2].aval, 0x3f);
+    CHECK_RESULT_HEX(arrayvalue.value.vectors[5].aval, 6);
+    CHECK_RESULT_HEX(arrayvalue.value.vectors[5].bval, 0);
+    return 0;
+}
+
+int _mon_check_narrow() {
+    TestVpiHandle mem_h = vpi_handle_by_name((PLI_BYTE8*)TestSimulator::rooted("mem5"), NULL);
+    CHECK_RESULT_NZ(mem_h);
+    s_vpi_arrayvalue arrayvalue;
+    arrayvalue.format = vpiShortIntVal;
+    arrayvalue.flags = vpiOneValue;
+    PLI_INT16 value = 0x7f;  // Masked to the width
+    arrayvalue.value.shortints = &value;
+    PLI_INT32 index = 2;
+    vpi_put_value_array(mem_h, &arrayvalue, &index, 2);
+    arrayvalue.flags = 0;
+    vpi_get_value_array(mem_h, &arrayvalue, &index, 3);
+    CHECK_RESULT_HEX(arrayvalue.value.shortints[0], 0x1f);
+    CHECK_RESULT_HEX(arrayvalue.value.shortints[1], 0x1f);
+    CHECK_RESULT_HEX(arrayvalue.value.shortints[2], 4);
+    // Out of range index
+    index = 7;
+    vpi_get_value_array(mem_h, &arrayvalue, &index, 1);
+    s_vpi_error_info e;
+    CHECK_RESULT_HEX(vpi_chk_error(&e), vpiError);
+    return 0;
+}
+
+int mon_check() {
+    // Callback from initial block in monitor
+    if (int status = _mon_check_int()) return status;
+    if (int status = _mon_check_raw()) return status;
+    if (int status = _mon_check_narrow()) return status;
+    return 0;  // Ok
+}
+
+//======================================================================
+
+double sc_time_stamp() { return main_time; }
+int main(int argc, char** argv, char** env) {
+    vluint64_t sim_time = 1100;
+    Verilated::commandArgs(argc, argv);
+    Verilated::debug(0);
+    // we're going to be checking for these errors do don't crash out
+    Verilated::fatalOnVpiError(0);
+
+    VM_PREFIX* topp = new VM_PREFIX("");  // Note null name - we're flattening it out
+
+    topp->eval();
+    topp->clk = 0;
+    main_time += 10;
+
+    while (vl_time_stamp64() < sim_time && !Verilated::gotFinish()) {
+        main_time += 1;
+        topp->eval();
+        VerilatedVpi::callValueCbs();
+        topp->clk = !topp->clk;
+    }
+    if (!Verilated::gotFinish()) {
+        vl_fatal(FILENM, __LINE__, "main", "%Error: Timeout; never got a $finish");
+    }
+    topp->final();
+
+    VL_DO_DANGLING(delete topp, topp);
+    return 0;
+}
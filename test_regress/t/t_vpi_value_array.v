@@ -0,0 +1,45 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Inputs
+   clk
+   );
+
+`systemc_header
+extern "C" int mon_check();
+`verilog
+
+   input clk;
+
+   reg [31:0] mem32 [16:1] /*verilator public_flat_rw @(posedge clk) */;
+   reg [69:0] mem70 [0:3] /*verilator public_flat_rw @(posedge clk) */;
+   reg [4:0]  mem5 [1:6] /*verilator public_flat_rw @(posedge clk) */;
+   integer    i, status;
+
+   initial begin
+      for (i = 1; i <= 16; i++) mem32[i] = 32'h100 + i;
+      for (i = 1; i <= 6; i++) mem5[i] = i[4:0];
+      status = $c32("mon_check()");
+      if (status != 0) begin
+         $write("%%Error: t_vpi_value_array.cpp:%0d: C Test failed\n", status);
+         $stop;
+      end
+      // Values written by mon_check
+      for (i = 1; i <= 16; i++) begin
+         if (mem32[i] !== 32'h200 + i) begin
+            $write("%%Error: mem32[%0d] = %x\n", i, mem32[i]);
+            $stop;
+         end
+      end
+      if (mem70[1] !== 70'h3f_00000002_00000001) $stop;
+      if (mem70[2] !== 70'h06_00000005_00000004) $stop;
+      if (mem5[2] !== 5'h1f || mem5[3] !== 5'h1f || mem5[4] !== 5'h4) $stop;
+      $write("*-* All Finished *-*\n");
+      $finish;
+   end
+
+endmodule : t
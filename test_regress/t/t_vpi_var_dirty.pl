@@ -0,0 +1,36 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt_all => 1);
+
+top_filename("t/t_vpi_var.v");
+
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    make_pli => 1,
+    v_flags2 => ["+define+USE_VPI_NOT_DPI"],
+    verilator_flags2 => ["-CFLAGS '-DVL_DEBUG -ggdb' --exe --vpi --vpi-dirty --stats --no-l2name"
+                         . " $Self->{t_dir}/t_vpi_var.cpp"],
+    );
+
+if ($Self->{vlt_all}) {
+    file_grep($Self->{stats}, qr/VPI dirty, variables\s+[1-9]/i);
+    file_grep($Self->{stats}, qr/VPI dirty, setters\s+[1-9]/i);
+}
+
+execute(
+    use_libvpi => 1,
+    check_finished => 1,
+    all_run_flags => ['+PLUS +INT=1234 +STRSTR']
+    );
+
+ok(1);
+1;
@@ -0,0 +1,180 @@
+// -*- mode: C++; c-file-style: "cc-mode" -*-
+// DESCRIPTION: Verilator: Check and time wide operations against scalar loops
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+#include <verilated.h>
+#include "Vt_wide_simd.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+double sc_time_stamp() { return 0; }
+
+static int errors = 0;
+static vluint32_t seed = 1;
+
+// Scalar loops, as verilated.h had before vectorization
+static void refAnd(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) {
+    for (int i = 0; i < words; ++i) owp[i] = lwp[i] & rwp[i];
+}
+static void refXor(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) {
+    for (int i = 0; i < words; ++i) owp[i] = lwp[i] ^ rwp[i];
+}
+static IData refEq(int words, WDataInP lwp, WDataInP rwp) {
+    EData nequal = 0;
+    for (int i = 0; i < words; ++i) nequal |= lwp[i] ^ rwp[i];
+    return nequal == 0;
+}
+static IData refRedXor(int words, WDataInP lwp) {
+    EData r = lwp[0];
+    for (int i = 1; i < words; ++i) r ^= lwp[i];
+    return VL_REDXOR_32(r);
+}
+static void refAdd(int words, WDataOutP owp, WDataInP lwp, WDataInP rwp) {
+    QData carry = 0;
+    for (int i = 0; i < words; ++i) {
+        carry = carry + static_cast<QData>(lwp[i]) + static_cast<QData>(rwp[i]);
+        owp[i] = carry & 0xffffffffULL;
+        carry = (carry >> 32ULL) & 0xffffffffULL;
+    }
+}
+static void refShiftR(int obits, WDataOutP owp, WDataInP lwp, IData rd) {
+    const int words = VL_WORDS_I(obits);
+    for (int i = 0; i < words; ++i) owp[i] = 0;
+    for (int bit = rd; bit < obits; ++bit) {
+        if (VL_BITISSET_W(lwp, bit)) owp[VL_BITWORD_E(bit - rd)] |= 1U << VL_BITBIT_E(bit - rd);
+    }
+}
+static void refShiftL(int obits, WDataOutP owp, WDataInP lwp, IData rd) {
+    const int words = VL_WORDS_I(obits);
+    for (int i = 0; i < words; ++i) owp[i] = 0;
+    for (int bit = 0; bit + static_cast<int>(rd) < obits; ++bit) {
+        if (VL_BITISSET_W(lwp, bit)) owp[VL_BITWORD_E(bit + rd)] |= 1U << VL_BITBIT_E(bit + rd);
+    }
+}
+
+static EData rnd() {
+    seed = seed * 1103515245U + 12345U;
+    return (seed >> 16) | (seed << 16);
+}
+
+static void check(const char* what, int words, WDataInP gotp, WDataInP expp) {
+    for (int i = 0; i < words; ++i) {
+        if (gotp[i] != expp[i]) {
+            printf("%%Error: %s words=%d word %d: got %08x exp %08x\n", what, words, i, gotp[i],
+                   expp[i]);
+            ++errors;
+            return;
+        }
+    }
+}
+
+static void checkWidths() {
+    for (int obits = 1; obits <= 1100; obits += (obits < 140) ? 1 : 37) {
+        const int words = VL_WORDS_I(obits);
+        WData l[40], r[40], o[40], e[40];
+        for (int i = 0; i < words; ++i) {
+            l[i] = rnd();
+            r[i] = (i % 5) ? l[i] : rnd();
+        }
+        l[words - 1] &= VL_MASK_E(obits);
+        r[words - 1] &= VL_MASK_E(obits);
+        VL_AND_W(words, o, l, r);
+        refAnd(words, e, l, r);
+        check("VL_AND_W", words, o, e);
+        vl_wide_kernelsp->m_and(words, o, l, r);
+        check("m_and", words, o, e);
+        VL_XOR_W(words, o, l, r);
+        refXor(words, e, l, r);
+        check("VL_XOR_W", words, o, e);
+        vl_wide_kernelsp->m_xor(words, o, l, r);
+        check("m_xor", words, o, e);
+        if (VL_EQ_W(words, l, r) != refEq(words, l, r)) {
+            printf("%%Error: VL_EQ_W words=%d\n", words);
+            ++errors;
+        }
+        if (VL_EQ_W(words, l, l) != 1 || (vl_wide_kernelsp->m_changexor(words, l, l) != 0)) {
+            printf("%%Error: VL_EQ_W self words=%d\n", words);
+            ++errors;
+        }
+        if (VL_REDXOR_W(words, l) != refRedXor(words, l)) {
+            printf("%%Error: VL_REDXOR_W words=%d\n", words);
+            ++errors;
+        }
+        VL_ADD_W(words, o, l, r);
+        refAdd(words, e, l, r);
+        check("VL_ADD_W", words, o, e);
+        for (IData rd = 0; rd < static_cast<IData>(obits); rd += 1 + rd / 3) {
+            VL_SHIFTR_WWI(obits, obits, 32, o, l, rd);
+            refShiftR(obits, e, l, rd);
+            check("VL_SHIFTR_WWI", words, o, e);
+            VL_SHIFTL_WWI(obits, obits, 32, o, l, rd);
+            refShiftL(obits, e, l, rd);
+            check("VL_SHIFTL_WWI", words, o, e);
+        }
+    }
+}
+
+// Time each variant on 512 and 1024 bit vectors; only meaningful when
+// compiled with optimization (driver.pl --benchmark)
+#define BENCH(name, stmt) \
+    do { \
+        const auto start = std::chrono::steady_clock::now(); \
+        for (int n = 0; n < iters; ++n) { \
+            stmt; \
+            l[n & 7] ^= o[0]; /* Prevent hoisting */ \
+        } \
+        const std::chrono::duration<double, std::nano> took \
+            = std::chrono::steady_clock::now() - start; \
+        printf("  %-24s %4d bits %8.2f ns/op\n", name, words * 32, took.count() / iters); \
+    } while (false)
+
+static void bench(int iters) {
+    printf("Wide kernels: %s\n", vl_wide_kernelsp->m_name);
+    for (int words = 16; words <= 32; words *= 2) {
+        WData l[32], r[32], o[32];
+        for (int i = 0; i < words; ++i) l[i] = r[i] = rnd();
+        BENCH("scalar AND", refAnd(words, o, l, r));
+        BENCH("VL_AND_W", VL_AND_W(words, o, l, r));
+        BENCH("dispatched AND", vl_wide_kernelsp->m_and(words, o, l, r));
+        BENCH("scalar EQ", o[0] += refEq(words, l, r));
+        BENCH("VL_EQ_W", o[0] += VL_EQ_W(words, l, r));
+        BENCH("dispatched CHANGEXOR", o[0] += vl_wide_kernelsp->m_changexor(words, l, r));
+        BENCH("scalar REDXOR", o[0] += refRedXor(words, l));
+        BENCH("VL_REDXOR_W", o[0] += VL_REDXOR_W(words, l));
+        BENCH("scalar ADD", refAdd(words, o, l, r));
+        BENCH("VL_ADD_W", VL_ADD_W(words, o, l, r));
+        BENCH("VL_SHIFTR_WWI", VL_SHIFTR_WWI(words * 32, words * 32, 32, o, l, 7));
+        BENCH("VL_SHIFTL_WWI", VL_SHIFTL_WWI(words * 32, words * 32, 32, o, l, 7));
+    }
+}
+
+int main(int argc, char** argv, char** env) {
+    Verilated::commandArgs(argc, argv);
+    checkWidths();
+
+    // Also run the Verilated model, which uses the same operations
+    Vt_wide_simd* topp = new Vt_wide_simd;
+    for (int i = 0; i < 32; ++i) {
+        topp->a[i] = rnd();
+        topp->b[i] = rnd();
+    }
+    topp->s = 33;
+    topp->eval();
+    topp->final();
+    VL_DO_DANGLING(delete topp, topp);
+
+    const char* itersp = Verilated::commandArgsPlusMatch("iters=");
+    bench(itersp[0] ? std::atoi(itersp + std::strlen("+iters=")) : 1000);
+
+    if (errors) {
+        vl_stop(__FILE__, __LINE__, "TOP-cpp");
+        return 10;
+    }
+    printf("*-* All Finished *-*\n");
+    return 0;
+}
@@ -0,0 +1,19 @@
+// DESCRIPTION: Verilator: Verilog Test module
+//
+// This file ONLY is placed under the Creative Commons Public Domain, for
+// any use, without warranty, 2021 by Wilson Snyder.
+// SPDX-License-Identifier: CC0-1.0
+
+module t (/*AUTOARG*/
+   // Outputs
+   o,
+   // Inputs
+   a, b, s
+   );
+   input [1023:0] a;
+   input [1023:0] b;
+   input [9:0]    s;
+   output [1023:0] o;
+
+   assign o = ((a & b) ^ (a | b)) + (a << s) - (b >> s);
+endmodule
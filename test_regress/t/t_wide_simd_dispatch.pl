@@ -0,0 +1,29 @@
+#!/usr/bin/env perl
+if (!$::Driver) { use FindBin; exec("$FindBin::Bin/bootstrap.pl", @ARGV, $0); die; }
+# DESCRIPTION: Verilator: Verilog Test driver/expect definition
+#
+# Copyright 2021 by Wilson Snyder. This program is free software; you
+# can redistribute it and/or modify it under the terms of either the GNU
+# Lesser General Public License Version 3 or the Perl Artistic License
+# Version 2.0.
+# SPDX-License-Identifier: LGPL-3.0-only OR Artistic-2.0
+
+scenarios(vlt => 1);
+
+top_filename("t/t_wide_simd.v");
+
+# Send even the smallest wide operations through the run time dispatch
+compile(
+    make_top_shell => 0,
+    make_main => 0,
+    verilator_flags2 => ["--exe $Self->{t_dir}/t_wide_simd.cpp",
+                         "-CFLAGS -DVL_SIMD_DISPATCH -CFLAGS -DVL_SIMD_DISPATCH_WORDS=1"],
+    );
+
+execute(
+    all_run_flags => ["+iters=" . ($Self->{benchmark} ? 1000000 : 1000)],
+    check_finished => 1,
+    );
+
+ok(1);
+1;